@@ -550,11 +550,8 @@ void screen_update(Uint32 timestamp, SDL_Renderer* renderer) {
     if (g_screen_size_changed) {
         g_screen_size_changed = 0;
         for (int i = 0; i < MAX_TIMELINE_BUFS; i++) {
-            free_RawTimelineValuesBuf(&g_timeline_min[i]);
-            free_RawTimelineValuesBuf(&g_timeline_max[i]);
-            alloc_RawTimelineValuesBuf(&g_timeline_min[i], g_screen_w, 8, 16, 16, TR_SIMD_sint16x8);
-            alloc_RawTimelineValuesBuf(&g_timeline_max[i], g_screen_w, 8, 16, 16, TR_SIMD_sint16x8);
-            prepare_AggregationMinMax(&g_timeline_bufs[i], &g_timeline_min[0], &g_timeline_max[0], g_screen_w);
+            // the allocations are kept when they are large enough
+            prepare_AggregationMinMax(&g_timeline_bufs[i], &g_timeline_min[i], &g_timeline_max[i], g_screen_w);
         }
         g_signal_curves_view.middle_offset = g_screen_h / 2;
         g_signal_curves_view.height = g_screen_h - g_signal_curves_view.start_y - 50; // 50px for bottom margin
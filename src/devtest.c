@@ -11,15 +11,52 @@
 #include <string.h>
 #include <unistd.h>
 #include <math.h>
+#include <limits.h>
 #include <sys/time.h>
+#include <pthread.h>
 
 #include "timelinedb.h"
 #include "timelinedb_util.h"
 
+// Snapshot test writer: sample i of channel c is (int16_t)(i * 7 + c), appended in uneven batches
+#define SNAPSHOT_TEST_SAMPLES 2000000
+static void *snapshot_writer(void *arg) {
+    TimelineSharedBuf *shared = (TimelineSharedBuf*)arg;
+    int16_t batch[8 * 777];
+    uint64_t i = 0;
+    while (i < SNAPSHOT_TEST_SAMPLES) {
+        uint32_t n = 1 + (uint32_t)(i % 777);
+        if (i + n > SNAPSHOT_TEST_SAMPLES) n = (uint32_t)(SNAPSHOT_TEST_SAMPLES - i);
+        for (uint32_t k = 0; k < n; ++k) {
+            for (uint32_t c = 0; c < 8; ++c) {
+                batch[k * 8 + c] = (int16_t)((i + k) * 7 + c);
+            }
+        }
+        if (append_TimelineSharedBuf(shared, batch, n) != 0) {
+            return (void*)1;
+        }
+        i += n;
+    }
+    return NULL;
+}
+
+static int check_TimelineSnapshot(const TimelineSnapshot *snap) {
+    const int16_t *v = (const int16_t*)snap->buf.valueBuffer;
+    for (uint32_t k = 0; k < snap->buf.nr_of_samples; ++k) {
+        for (uint32_t c = 0; c < 8; ++c) {
+            if (v[(size_t)k * 8 + c] != (int16_t)((snap->first_sample + k) * 7 + c)) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
 int main(int argc, char *argv[]) {
     (void)argc; // Unused parameter
     (void)argv; // Unused parameter
     int res= 0;
+    int errors = 0; // failed self-checks
     RawTimelineValuesBuf buf;
     init_RawTimelineValuesBuf(&buf);
     buf.value_type = TR_analog_sint8;
@@ -106,25 +143,106 @@ int main(int argc, char *argv[]) {
     init_RawTimelineValuesBuf(&simd_output);
     prepare_SampleRateConversion(&simd_input, 1200000, &simd_output); // pass1
     const char *bename="Unknown Backend";
-    getBackendName(-1, &bename);
     struct timeval t0, t1;
     long elapsed_us = 0;
 
-    gettimeofday(&t0, NULL);
-    convert_sample_rate(&simd_input, &simd_output);
-    gettimeofday(&t1, NULL);
-    elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
-    printf("%s sample rate conversion took %ld microseconds\n", bename, elapsed_us);
+    // 1 MHz -> 1.2 MHz: the prepared interpolation table is one period of 6 outputs over 5 input samples
+    const SampleInterpTable *table = simd_output.prepared_data_src;
+    if (!table || table->period_outputs != 6 || table->period_inputs != 5 || table->nr_of_phases != 6) {
+        fprintf(stderr, "Interpolation table is not one period of the 6 / 5 ratio\n");
+        errors++;
+    } else {
+        for (uint32_t j = 0; j < table->nr_of_phases; ++j) {
+            const SampleInterpInfo *p = &table->phases[j];
+            if (p->idx0 != j * 5 / 6 || p->frac != ((j * 5 % 6) << 16) / 6 || p->frac + p->inv_frac != 0x10000) {
+                fprintf(stderr, "Interpolation table phase %u is wrong\n", j);
+                errors++;
+            }
+        }
+    }
 
-    setBackend(1); // Switch to SIMD backend
-    getBackendName(-1, &bename);
+    // Every backend detected on this CPU: index 0 is the C backend, index 1 the best SIMD variant
+    // All of them interpolate at the prepared positions with the same Q16 formula, the outputs are identical
+    uint8_t nr_backends = getBackendsCount();
+    const uint32_t conv_values = simd_output.nr_of_samples * 8;
+    int16_t *conv_ref = (int16_t*)malloc(conv_values * sizeof(int16_t));
+    for (uint8_t b = 0; b < nr_backends; ++b) {
+        setBackend(b);
+        getBackendName(-1, &bename);
+        gettimeofday(&t0, NULL);
+        convert_sample_rate(&simd_input, &simd_output);
+        gettimeofday(&t1, NULL);
+        elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+        printf("%s sample rate conversion took %ld microseconds\n", bename, elapsed_us);
+        const int16_t *conv = (const int16_t*)simd_output.valueBuffer;
+        if (b == 0) {
+            memcpy(conv_ref, conv, conv_values * sizeof(int16_t));
+            continue;
+        }
+        for (uint32_t v = 0; v < conv_values; ++v) {
+            if (conv[v] != conv_ref[v]) {
+                fprintf(stderr, "%s sample rate conversion differs from the C Backend at value %u: %d != %d\n", bename, v, conv[v], conv_ref[v]);
+                errors++;
+                break;
+            }
+        }
+    }
+    free(conv_ref);
 
-    gettimeofday(&t0, NULL);
-    convert_sample_rate(&simd_input, &simd_output);
-    gettimeofday(&t1, NULL);
-    elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
-    printf("%s sample rate conversion took %ld microseconds\n", bename, elapsed_us);
-    
+    // Downsampling 1 MHz -> 300 kHz advances the input by 3 or 4 samples per output: output i sits at input i * 10 / 3
+    const uint8_t down_channels[3] = { 3, 8, 12 };
+    for (uint32_t t = 0; t < 3; ++t) {
+        const uint32_t ch = down_channels[t];
+        const uint32_t in_samples = 20000;
+        RawTimelineValuesBuf down_in, down_out;
+        init_RawTimelineValuesBuf(&down_in);
+        init_RawTimelineValuesBuf(&down_out);
+        alloc_RawTimelineValuesBuf(&down_in, in_samples, ch, 16, 16, TR_SIMD_sint16x8);
+        down_in.time_exponent = -6;
+        down_in.time_step = 1;
+        int16_t *fill = (int16_t*)down_in.valueBuffer;
+        for (size_t v = 0; v < (size_t)in_samples * ch; ++v) {
+            fill[v] = (int16_t)(20000.0 * sin((double)v * 0.001));
+        }
+        if (prepare_SampleRateConversion(&down_in, 300000, &down_out) != 0) {
+            fprintf(stderr, "Downsampling (%u channels) could not be prepared\n", ch);
+            errors++;
+        } else {
+            const int16_t *src = (const int16_t*)down_in.valueBuffer;
+            for (uint8_t b = 0; b < nr_backends; ++b) {
+                setBackend(b);
+                getBackendName(-1, &bename);
+                memset(down_out.valueBuffer, 0, (size_t)down_out.nr_of_samples * ch * sizeof(int16_t));
+                int rc = convert_sample_rate(&down_in, &down_out);
+                const int16_t *dst = (const int16_t*)down_out.valueBuffer;
+                for (uint32_t i = 0; i < down_out.nr_of_samples && rc == 0; ++i) {
+                    uint32_t idx0 = i * 10 / 3;
+                    int64_t frac = ((int64_t)(i * 10 % 3) << 16) / 3;
+                    if (idx0 + 1 >= in_samples) {
+                        idx0 = in_samples - 2;
+                        frac = 0x10000;
+                    }
+                    for (uint32_t c = 0; c < ch && rc == 0; ++c) {
+                        int64_t v = ((int64_t)src[(size_t)idx0 * ch + c] * (0x10000 - frac) +
+                                     (int64_t)src[(size_t)(idx0 + 1) * ch + c] * frac + 0x8000) >> 16;
+                        if (dst[(size_t)i * ch + c] != v) {
+                            fprintf(stderr, "%s downsampling (%u channels) output %u channel %u: %d != %lld\n",
+                                    bename, ch, i, c, dst[(size_t)i * ch + c], (long long)v);
+                            rc = -1;
+                        }
+                    }
+                }
+                if (rc != 0) {
+                    fprintf(stderr, "%s downsampling 1 MHz -> 300 kHz (%u channels) failed\n", bename, ch);
+                    errors++;
+                }
+            }
+        }
+        free_RawTimelineValuesBuf(&down_out);
+        free_RawTimelineValuesBuf(&down_in);
+    }
+    setBackend(1); // Switch to the best SIMD backend (stays on C if there is none)
+    getBackendName(-1, &bename);
 
     RawTimelineValuesBuf so_min, so_max;
     init_RawTimelineValuesBuf(&so_min);
@@ -136,10 +254,1620 @@ int main(int argc, char *argv[]) {
     free_RawTimelineValuesBuf(&so_min);
     free_RawTimelineValuesBuf(&so_max);
 
+    // Min/max aggregation performance: C backend vs. SIMD backend, the result must be identical
+    RawTimelineValuesBuf raw_min, raw_max;
+    init_RawTimelineValuesBuf(&raw_min);
+    init_RawTimelineValuesBuf(&raw_max);
+    prepare_AggregationMinMax(&simd_input, &raw_min, &raw_max, 800);
+    prepare_AggregationMinMax(&simd_input, &so_min, &so_max, 800);
+    const char *c_bename = "Unknown Backend";
+    setBackend(0);
+    getBackendName(-1, &c_bename);
+    gettimeofday(&t0, NULL);
+    aggregate_MinMax(&simd_input, &so_min, &so_max, simd_input.nr_of_samples, 0);
+    gettimeofday(&t1, NULL);
+    elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+    printf("%s min/max aggregation (raw scan) took %ld microseconds\n", c_bename, elapsed_us);
+
+    // Zoomed-out aggregation: raw scan of every SIMD backend vs. the C backend, the result must be identical
+    for (uint8_t b = 1; b < nr_backends; ++b) {
+        setBackend(b);
+        getBackendName(-1, &bename);
+        gettimeofday(&t0, NULL);
+        aggregate_MinMax(&simd_input, &raw_min, &raw_max, simd_input.nr_of_samples, 0);
+        gettimeofday(&t1, NULL);
+        elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+        printf("%s min/max aggregation (raw scan) took %ld microseconds\n", bename, elapsed_us);
+        if (memcmp(raw_min.valueBuffer, so_min.valueBuffer, 800 * raw_min.bytes_per_sample) != 0 ||
+            memcmp(raw_max.valueBuffer, so_max.valueBuffer, 800 * raw_max.bytes_per_sample) != 0) {
+            fprintf(stderr, "%s min/max aggregation differs from the %s\n", bename, c_bename);
+            errors++;
+        }
+    }
+    setBackend(1);
+    getBackendName(-1, &bename);
+    if (nr_backends == 1) {
+        memcpy(raw_min.valueBuffer, so_min.valueBuffer, 800 * raw_min.bytes_per_sample);
+        memcpy(raw_max.valueBuffer, so_max.valueBuffer, 800 * raw_max.bytes_per_sample);
+    }
+
+    // Zoomed-out aggregation: raw scan vs. min/max pyramid, the result must be identical
+    gettimeofday(&t0, NULL);
+    init_MinMaxPyramid(&simd_input, 0);
+    gettimeofday(&t1, NULL);
+    elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+    printf("Min/max pyramid build took %ld microseconds\n", elapsed_us);
+    gettimeofday(&t0, NULL);
+    aggregate_MinMax(&simd_input, &so_min, &so_max, simd_input.nr_of_samples, 0);
+    gettimeofday(&t1, NULL);
+    elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+    printf("Min/max aggregation (pyramid) took %ld microseconds\n", elapsed_us);
+    if (memcmp(raw_min.valueBuffer, so_min.valueBuffer, 800 * raw_min.bytes_per_sample) != 0 ||
+        memcmp(raw_max.valueBuffer, so_max.valueBuffer, 800 * raw_max.bytes_per_sample) != 0) {
+        fprintf(stderr, "Pyramid aggregation differs from the raw scan\n");
+        errors++;
+    }
+    free_MinMaxPyramid(&simd_input);
+    free_RawTimelineValuesBuf(&raw_min);
+    free_RawTimelineValuesBuf(&raw_max);
+    free_RawTimelineValuesBuf(&so_min);
+    free_RawTimelineValuesBuf(&so_max);
+
+    // 8-bit and 24-bit min/max aggregation: every SIMD backend vs. the C backend
+    {
+        const uint32_t nr = 1000000;
+        const uint32_t cols = 700; // not a divisor of nr, so the columns have odd and even widths
+        uint32_t lcg = 12345;
+        RawTimelineValuesBuf in8, in24, ref_min, ref_max, out_min, out_max;
+        init_RawTimelineValuesBuf(&in8);
+        init_RawTimelineValuesBuf(&in24);
+        alloc_RawTimelineValuesBuf(&in8, nr, 8, 8, 64, TR_analog_sint8);
+        alloc_RawTimelineValuesBuf(&in24, nr, 8, 24, 64, TR_SIMD_sint24x8);
+        for (uint32_t v = 0; v < nr * 8; ++v) {
+            lcg = lcg * 1664525u + 1013904223u;
+            in8.valueBuffer[v] = (uint8_t)(lcg >> 24);
+            in24.valueBuffer[v * 3 + 0] = (uint8_t)(lcg >> 8);
+            in24.valueBuffer[v * 3 + 1] = (uint8_t)(lcg >> 16);
+            in24.valueBuffer[v * 3 + 2] = (uint8_t)(lcg >> 24);
+        }
+        init_RawTimelineValuesBuf(&ref_min);
+        init_RawTimelineValuesBuf(&ref_max);
+        init_RawTimelineValuesBuf(&out_min);
+        init_RawTimelineValuesBuf(&out_max);
+        prepare_AggregationMinMax(&in8, &ref_min, &ref_max, cols);
+        prepare_AggregationMinMax(&in8, &out_min, &out_max, cols);
+        for (uint8_t b = 0; b < nr_backends; ++b) {
+            setBackend(b);
+            getBackendName(-1, &bename);
+            RawTimelineValuesBuf *dmin = (b == 0) ? &ref_min : &out_min;
+            RawTimelineValuesBuf *dmax = (b == 0) ? &ref_max : &out_max;
+            gettimeofday(&t0, NULL);
+            aggregate_MinMax(&in8, dmin, dmax, nr, 0);
+            gettimeofday(&t1, NULL);
+            elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+            printf("%s min/max aggregation (s8) took %ld microseconds\n", bename, elapsed_us);
+            if (b > 0 && (memcmp(ref_min.valueBuffer, out_min.valueBuffer, cols * 8) != 0 ||
+                          memcmp(ref_max.valueBuffer, out_max.valueBuffer, cols * 8) != 0)) {
+                fprintf(stderr, "%s min/max aggregation (s8) differs from the C Backend\n", bename);
+                errors++;
+            }
+        }
+        free_RawTimelineValuesBuf(&ref_min);
+        free_RawTimelineValuesBuf(&ref_max);
+        free_RawTimelineValuesBuf(&out_min);
+        free_RawTimelineValuesBuf(&out_max);
+        // 24-bit input, 8-bit (>> 16) output
+        prepare_AggregationMinMax(&in24, &ref_min, &ref_max, cols);
+        prepare_AggregationMinMax(&in24, &out_min, &out_max, cols);
+        for (uint8_t b = 0; b < nr_backends; ++b) {
+            setBackend(b);
+            getBackendName(-1, &bename);
+            RawTimelineValuesBuf *dmin = (b == 0) ? &ref_min : &out_min;
+            RawTimelineValuesBuf *dmax = (b == 0) ? &ref_max : &out_max;
+            gettimeofday(&t0, NULL);
+            aggregate_MinMax(&in24, dmin, dmax, nr, 0);
+            gettimeofday(&t1, NULL);
+            elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+            printf("%s min/max aggregation (s24x8) took %ld microseconds\n", bename, elapsed_us);
+            if (b > 0 && (memcmp(ref_min.valueBuffer, out_min.valueBuffer, cols * 8) != 0 ||
+                          memcmp(ref_max.valueBuffer, out_max.valueBuffer, cols * 8) != 0)) {
+                fprintf(stderr, "%s min/max aggregation (s24x8) differs from the C Backend\n", bename);
+                errors++;
+            }
+        }
+        init_MinMaxPyramid(&in24, 0);
+        aggregate_MinMax(&in24, &out_min, &out_max, nr, 0);
+        if (memcmp(ref_min.valueBuffer, out_min.valueBuffer, cols * 8) != 0 ||
+            memcmp(ref_max.valueBuffer, out_max.valueBuffer, cols * 8) != 0) {
+            fprintf(stderr, "Pyramid aggregation (s24x8) differs from the raw scan\n");
+            errors++;
+        }
+        setBackend(1);
+        getBackendName(-1, &bename);
+        free_RawTimelineValuesBuf(&in8);
+        free_RawTimelineValuesBuf(&in24);
+        free_RawTimelineValuesBuf(&ref_min);
+        free_RawTimelineValuesBuf(&ref_max);
+        free_RawTimelineValuesBuf(&out_min);
+        free_RawTimelineValuesBuf(&out_max);
+    }
+
+    // Batch decoding of big-endian 24-bit payloads (80 and 77 channels) into 8-channel ring buffers, every backend vs. C
+    {
+        const uint32_t nr_packets = 100000;
+        const uint32_t max_channels = 80;
+        const uint32_t nr_bufs = max_channels / 8;
+        uint8_t *packets = (uint8_t*)malloc((size_t)nr_packets * max_channels * 3);
+        const uint8_t **payloads = (const uint8_t**)malloc(nr_packets * sizeof(uint8_t*));
+        uint32_t lcg = 777;
+        for (uint32_t v = 0; v < nr_packets * max_channels * 3; ++v) {
+            lcg = lcg * 1664525u + 1013904223u;
+            packets[v] = (uint8_t)(lcg >> 24);
+        }
+        for (uint32_t k = 0; k < nr_packets; ++k) {
+            payloads[k] = &packets[(size_t)k * max_channels * 3];
+        }
+        RawTimelineValuesBuf ref[10], out[10];
+        const RawTimelineValueEnum types[2] = { TR_SIMD_sint16x8, TR_SIMD_sint24x8 };
+        const uint32_t channel_counts[2] = { 80, 77 };
+        for (int t = 0; t < 2; ++t) {
+            uint8_t bitwidth = (types[t] == TR_SIMD_sint16x8) ? 16 : 24;
+            for (uint32_t b = 0; b < nr_bufs; ++b) {
+                init_RawTimelineValuesBuf(&ref[b]);
+                init_RawTimelineValuesBuf(&out[b]);
+                alloc_RingTimelineValuesBuf(&ref[b], nr_packets, 8, bitwidth, 16, types[t]);
+                alloc_RingTimelineValuesBuf(&out[b], nr_packets, 8, bitwidth, 16, types[t]);
+                memset(ref[b].valueBuffer, 0, (size_t)nr_packets * ref[b].bytes_per_sample); // pre-fault, keeps the timings comparable
+                memset(out[b].valueBuffer, 0, (size_t)nr_packets * out[b].bytes_per_sample);
+            }
+            for (int c = 0; c < 2; ++c) {
+                for (uint8_t be = 0; be < nr_backends; ++be) {
+                    setBackend(be);
+                    getBackendName(-1, &bename);
+                    RawTimelineValuesBuf *dst = (be == 0) ? ref : out;
+                    for (uint32_t b = 0; b < nr_bufs; ++b) {
+                        clear_RawTimelineValuesBuf(&dst[b]);
+                    }
+                    gettimeofday(&t0, NULL);
+                    append_BE24_Payloads(payloads, nr_packets, channel_counts[c], dst, nr_bufs);
+                    gettimeofday(&t1, NULL);
+                    elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+                    printf("%s decoding %u x %u channel payloads to %s took %ld microseconds\n", bename, nr_packets, channel_counts[c],
+                           (types[t] == TR_SIMD_sint16x8) ? "s16x8" : "s24x8", elapsed_us);
+                    for (uint32_t b = 0; be > 0 && b < nr_bufs; ++b) {
+                        if (memcmp(ref[b].valueBuffer, out[b].valueBuffer, (size_t)nr_packets * ref[b].bytes_per_sample) != 0) {
+                            fprintf(stderr, "%s payload decoding differs from the C Backend (buffer %u)\n", bename, b);
+                            errors++;
+                            break;
+                        }
+                    }
+                }
+                // one wide buffer with all channels must hold the same values as the 8-channel buffers
+                {
+                    RawTimelineValuesBuf wide;
+                    init_RawTimelineValuesBuf(&wide);
+                    alloc_RingTimelineValuesBuf(&wide, nr_packets, (uint8_t)channel_counts[c], bitwidth, 16, types[t]);
+                    memset(wide.valueBuffer, 0, (size_t)nr_packets * wide.bytes_per_sample);
+                    gettimeofday(&t0, NULL);
+                    append_BE24_Payloads(payloads, nr_packets, channel_counts[c], &wide, 1);
+                    gettimeofday(&t1, NULL);
+                    elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+                    printf("%s decoding %u x %u channel payloads to one wide buffer took %ld microseconds\n", bename, nr_packets, channel_counts[c], elapsed_us);
+                    for (uint32_t k = 0; k < nr_packets; ++k) {
+                        const uint8_t *wrow = &wide.valueBuffer[(size_t)k * wide.bytes_per_sample];
+                        uint32_t lane_bytes = bitwidth / 8;
+                        int same = 1;
+                        for (uint32_t b = 0; b < nr_bufs && same; ++b) {
+                            uint32_t lanes = (channel_counts[c] - b * 8 < 8) ? channel_counts[c] - b * 8 : 8;
+                            same = memcmp(&wrow[b * 8 * lane_bytes], &ref[b].valueBuffer[(size_t)k * ref[b].bytes_per_sample], lanes * lane_bytes) == 0;
+                        }
+                        if (!same) {
+                            fprintf(stderr, "Payload decoding into one wide buffer differs at sample %u\n", k);
+                            errors++;
+                            break;
+                        }
+                    }
+                    free_RawTimelineValuesBuf(&wide);
+                }
+                // spot check against the scalar formula used by pcap24 before: upper 16 bits of the sign-extended value
+                if (types[t] == TR_SIMD_sint16x8) {
+                    const uint8_t *p = &packets[(size_t)(nr_packets - 1) * max_channels * 3 + 13 * 3];
+                    int32_t val = (int32_t)((p[0] << 16) | (p[1] << 8) | p[2]);
+                    if (val & 0x00800000) val |= ~0x00FFFFFF;
+                    int16_t got = 0;
+                    getSampleValue_SIMD_sint16x8(&ref[1], nr_packets - 1, 5, &got);
+                    if (got != (int16_t)(val >> 8)) {
+                        fprintf(stderr, "Payload decoding of channel 13 is wrong: %d != %d\n", got, (int16_t)(val >> 8));
+                        errors++;
+                    }
+                }
+            }
+            for (uint32_t b = 0; b < nr_bufs; ++b) {
+                free_RawTimelineValuesBuf(&ref[b]);
+                free_RawTimelineValuesBuf(&out[b]);
+            }
+        }
+        setBackend(1);
+        getBackendName(-1, &bename);
+        free(payloads);
+        free(packets);
+    }
+
+    // Channel counts other than 8 in one buffer: conversion and min/max of every backend vs. C
+    {
+        const uint32_t nr = 200000;
+        const uint32_t cols = 700;
+        const uint8_t channel_counts[6] = { 3, 4, 12, 16, 24, 80 };
+        for (int c = 0; c < 6; ++c) {
+            const uint8_t ch = channel_counts[c];
+            uint32_t lcg = 4242 + ch;
+            RawTimelineValuesBuf in16, in24, conv, ref_min, ref_max, out_min, out_max;
+            init_RawTimelineValuesBuf(&in16);
+            init_RawTimelineValuesBuf(&in24);
+            init_RawTimelineValuesBuf(&conv);
+            alloc_RawTimelineValuesBuf(&in16, nr, ch, 16, 16, TR_SIMD_sint16x8);
+            alloc_RawTimelineValuesBuf(&in24, nr, ch, 24, 16, TR_SIMD_sint24x8);
+            in16.time_exponent = -6;
+            in16.time_step = 1;
+            for (uint32_t v = 0; v < nr * ch; ++v) {
+                lcg = lcg * 1664525u + 1013904223u;
+                ((int16_t*)in16.valueBuffer)[v] = (int16_t)(lcg >> 16);
+                in24.valueBuffer[v * 3 + 0] = (uint8_t)(lcg >> 8);
+                in24.valueBuffer[v * 3 + 1] = (uint8_t)(lcg >> 16);
+                in24.valueBuffer[v * 3 + 2] = (uint8_t)(lcg >> 24);
+            }
+            prepare_SampleRateConversion(&in16, 1200000, &conv);
+            const uint32_t conv_values = conv.nr_of_samples * ch;
+            int16_t *conv_ref = (int16_t*)malloc(conv_values * sizeof(int16_t));
+            for (uint8_t b = 0; b < nr_backends; ++b) {
+                setBackend(b);
+                getBackendName(-1, &bename);
+                gettimeofday(&t0, NULL);
+                int rc = convert_sample_rate(&in16, &conv);
+                gettimeofday(&t1, NULL);
+                elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+                printf("%s sample rate conversion (%u channels) took %ld microseconds\n", bename, ch, elapsed_us);
+                const int16_t *cv = (const int16_t*)conv.valueBuffer;
+                if (rc != 0) {
+                    fprintf(stderr, "%s sample rate conversion (%u channels) failed\n", bename, ch);
+                    errors++;
+                } else if (b == 0) {
+                    memcpy(conv_ref, cv, conv_values * sizeof(int16_t));
+                } else {
+                    for (uint32_t v = 0; v < conv_values; ++v) {
+                        if (abs(cv[v] - conv_ref[v]) > 1) {
+                            fprintf(stderr, "%s sample rate conversion (%u channels) differs from the C Backend at value %u\n", bename, ch, v);
+                            errors++;
+                            break;
+                        }
+                    }
+                }
+            }
+            free(conv_ref);
+            free_RawTimelineValuesBuf(&conv);
+            RawTimelineValuesBuf *inputs[2] = { &in16, &in24 };
+            for (int t = 0; t < 2; ++t) {
+                init_RawTimelineValuesBuf(&ref_min);
+                init_RawTimelineValuesBuf(&ref_max);
+                init_RawTimelineValuesBuf(&out_min);
+                init_RawTimelineValuesBuf(&out_max);
+                prepare_AggregationMinMax(inputs[t], &ref_min, &ref_max, cols);
+                prepare_AggregationMinMax(inputs[t], &out_min, &out_max, cols);
+                for (uint8_t b = 0; b < nr_backends; ++b) {
+                    setBackend(b);
+                    getBackendName(-1, &bename);
+                    RawTimelineValuesBuf *dmin = (b == 0) ? &ref_min : &out_min;
+                    RawTimelineValuesBuf *dmax = (b == 0) ? &ref_max : &out_max;
+                    gettimeofday(&t0, NULL);
+                    aggregate_MinMax(inputs[t], dmin, dmax, nr, 0);
+                    gettimeofday(&t1, NULL);
+                    elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+                    printf("%s min/max aggregation (%s, %u channels) took %ld microseconds\n", bename, t ? "s24" : "s16", ch, elapsed_us);
+                    if (b > 0 && (memcmp(ref_min.valueBuffer, out_min.valueBuffer, cols * ref_min.bytes_per_sample) != 0 ||
+                                  memcmp(ref_max.valueBuffer, out_max.valueBuffer, cols * ref_max.bytes_per_sample) != 0)) {
+                        fprintf(stderr, "%s min/max aggregation (%s, %u channels) differs from the C Backend\n", bename, t ? "s24" : "s16", ch);
+                        errors++;
+                    }
+                }
+                free_RawTimelineValuesBuf(&ref_min);
+                free_RawTimelineValuesBuf(&ref_max);
+                free_RawTimelineValuesBuf(&out_min);
+                free_RawTimelineValuesBuf(&out_max);
+            }
+            free_RawTimelineValuesBuf(&in16);
+            free_RawTimelineValuesBuf(&in24);
+        }
+        setBackend(1);
+        getBackendName(-1, &bename);
+    }
+
+    // Streaming sample rate conversion: ~1000 random sized chunks must give the same samples as one call, on every backend
+    {
+        const uint32_t rates[3][2] = { { 1000000, 1200000 }, { 1500000, 1000000 }, { 44100, 48000 } };
+        const uint8_t channel_counts[2] = { 8, 3 };
+        const uint32_t nr = simd_input.nr_of_samples;
+        for (int c = 0; c < 2; ++c) {
+            const uint8_t ch = channel_counts[c];
+            RawTimelineValuesBuf in;
+            init_RawTimelineValuesBuf(&in);
+            alloc_RawTimelineValuesBuf(&in, nr, ch, 16, 16, TR_SIMD_sint16x8);
+            for (uint32_t i = 0; i < nr; ++i) {
+                memcpy(&in.valueBuffer[i * in.bytes_per_sample], &simd_input.valueBuffer[i * simd_input.bytes_per_sample], in.bytes_per_sample);
+            }
+            for (int r = 0; r < 3; ++r) {
+                SampleRateStream stream;
+                RawTimelineValuesBuf whole, chunk;
+                init_RawTimelineValuesBuf(&whole);
+                init_RawTimelineValuesBuf(&chunk);
+                init_SampleRateStream(&stream, ch, rates[r][0], rates[r][1]);
+                alloc_RawTimelineValuesBuf(&whole, getSampleRateStreamMaxOutput(&stream, nr), ch, 16, 16, TR_SIMD_sint16x8);
+                alloc_RawTimelineValuesBuf(&chunk, getSampleRateStreamMaxOutput(&stream, 2 * nr / 1000), ch, 16, 16, TR_SIMD_sint16x8);
+                int16_t *ref = NULL;
+                uint32_t ref_count = 0;
+                for (uint8_t b = 0; b < nr_backends; ++b) {
+                    setBackend(b);
+                    getBackendName(-1, &bename);
+                    reset_SampleRateStream(&stream);
+                    gettimeofday(&t0, NULL);
+                    int rc = convert_sample_rate_stream(&stream, &in, &whole);
+                    gettimeofday(&t1, NULL);
+                    elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+                    printf("%s streaming sample rate conversion (%u channels, %u -> %u Hz) took %ld microseconds\n",
+                           bename, ch, rates[r][0], rates[r][1], elapsed_us);
+                    if (rc != 0) {
+                        fprintf(stderr, "%s streaming sample rate conversion failed\n", bename);
+                        errors++;
+                        continue;
+                    }
+                    const uint32_t values = whole.nr_of_samples * ch;
+                    if (b == 0) {
+                        ref_count = whole.nr_of_samples;
+                        ref = (int16_t*)malloc(values * sizeof(int16_t));
+                        memcpy(ref, whole.valueBuffer, values * sizeof(int16_t));
+                    } else if (whole.nr_of_samples != ref_count || memcmp(ref, whole.valueBuffer, values * sizeof(int16_t)) != 0) {
+                        fprintf(stderr, "%s streaming sample rate conversion (%u channels) differs from the C Backend\n", bename, ch);
+                        errors++;
+                    }
+                    // the same signal in chunks of 0 .. 2 * nr / 1000 samples
+                    reset_SampleRateStream(&stream);
+                    uint32_t lcg = 99 + r, pos = 0, produced = 0;
+                    int chunk_ok = 1;
+                    while (pos < nr && chunk_ok) {
+                        lcg = lcg * 1664525u + 1013904223u;
+                        uint32_t len = (lcg >> 8) % (2 * nr / 1000 + 1);
+                        if (len > nr - pos) len = nr - pos;
+                        RawTimelineValuesView part;
+                        make_RawTimelineValuesView(&in, pos, len, &part);
+                        if (convert_sample_rate_stream_view(&stream, &part, &chunk) != 0 ||
+                            produced + chunk.nr_of_samples > whole.nr_of_samples ||
+                            memcmp(chunk.valueBuffer, &whole.valueBuffer[produced * whole.bytes_per_sample], chunk.nr_of_samples * chunk.bytes_per_sample) != 0) {
+                            chunk_ok = 0;
+                        }
+                        produced += chunk.nr_of_samples;
+                        pos += len;
+                    }
+                    if (!chunk_ok || produced != whole.nr_of_samples) {
+                        fprintf(stderr, "%s chunked streaming sample rate conversion (%u channels) differs from one call at output %u\n", bename, ch, produced);
+                        errors++;
+                    }
+                }
+                free(ref);
+                free_RawTimelineValuesBuf(&whole);
+                free_RawTimelineValuesBuf(&chunk);
+            }
+            free_RawTimelineValuesBuf(&in);
+        }
+        setBackend(1);
+        getBackendName(-1, &bename);
+    }
+
+    // Polyphase FIR resampling (1 MHz -> 48 kHz and 44.1 kHz -> 48 kHz ratios): every backend vs. C, timed next to the linear converter
+    {
+        const uint32_t rates[2][2] = { { 1000000, 48000 }, { 44100, 48000 } };
+        for (int r = 0; r < 2; ++r) {
+            PolyphaseFilterBank bank;
+            RawTimelineValuesBuf fir_ref, fir_out, linear;
+            init_RawTimelineValuesBuf(&fir_ref);
+            init_RawTimelineValuesBuf(&fir_out);
+            init_RawTimelineValuesBuf(&linear);
+            if (init_PolyphaseFilterBank(&bank, rates[r][0], rates[r][1], 0, fir_out.allocator) != 0 ||
+                prepare_PolyphaseResampling(&simd_input, &bank, &fir_ref) != 0 ||
+                prepare_PolyphaseResampling(&simd_input, &bank, &fir_out) != 0) {
+                fprintf(stderr, "Failed to prepare polyphase resampling\n");
+                errors++;
+                continue;
+            }
+            prepare_SampleRateConversion(&simd_input, (uint32_t)((uint64_t)1000000 * rates[r][1] / rates[r][0]), &linear);
+            for (uint8_t b = 0; b < nr_backends; ++b) {
+                setBackend(b);
+                getBackendName(-1, &bename);
+                RawTimelineValuesBuf *dst = (b == 0) ? &fir_ref : &fir_out;
+                gettimeofday(&t0, NULL);
+                int rc = convert_sample_rate_polyphase(&simd_input, &bank, dst);
+                gettimeofday(&t1, NULL);
+                elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+                gettimeofday(&t0, NULL);
+                convert_sample_rate(&simd_input, &linear);
+                gettimeofday(&t1, NULL);
+                long linear_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+                printf("%s polyphase resampling (%u -> %u Hz ratio, CIC by %u, %u taps) took %ld microseconds, linear took %ld microseconds\n",
+                       bename, rates[r][0], rates[r][1], 1u << bank.pre_shift, bank.taps, elapsed_us, linear_us);
+                if (rc != 0) {
+                    fprintf(stderr, "%s polyphase resampling failed\n", bename);
+                    errors++;
+                } else if (b > 0 && memcmp(fir_ref.valueBuffer, fir_out.valueBuffer, fir_ref.nr_of_samples * fir_ref.bytes_per_sample) != 0) {
+                    fprintf(stderr, "%s polyphase resampling differs from the C Backend\n", bename);
+                    errors++;
+                }
+            }
+            free_PolyphaseFilterBank(&bank);
+            free_RawTimelineValuesBuf(&fir_ref);
+            free_RawTimelineValuesBuf(&fir_out);
+            free_RawTimelineValuesBuf(&linear);
+        }
+        // Anti-aliasing of the CIC + FIR path at 1 MHz -> 48 kHz, 12 channels (an overlapping 8-channel group):
+        // 1 kHz must pass, 35 kHz (above the output Nyquist) and 104 kHz (next to the first CIC image) must not
+        {
+            const uint32_t ch = 12, n = 200000;
+            const double tone_hz[3] = { 1000.0, 35000.0, 104000.0 };
+            PolyphaseFilterBank bank;
+            RawTimelineValuesBuf tones, tones_ref, tones_out;
+            init_RawTimelineValuesBuf(&tones);
+            init_RawTimelineValuesBuf(&tones_ref);
+            init_RawTimelineValuesBuf(&tones_out);
+            alloc_RawTimelineValuesBuf(&tones, n, ch, 16, 16, TR_SIMD_sint16x8);
+            tones.time_exponent = -6;
+            tones.time_step = 1;
+            for (uint32_t i = 0; i < n; ++i) {
+                for (uint32_t c = 0; c < ch; ++c) {
+                    ((int16_t*)tones.valueBuffer)[(size_t)i * ch + c] = (int16_t)lrint(10000.0 * sin(2.0 * M_PI * tone_hz[c % 3] * i / 1e6 + c));
+                }
+            }
+            if (init_PolyphaseFilterBank(&bank, 1000000, 48000, 0, tones_out.allocator) != 0 || prepare_PolyphaseResampling(&tones, &bank, &tones_ref) != 0 ||
+                prepare_PolyphaseResampling(&tones, &bank, &tones_out) != 0) {
+                fprintf(stderr, "Failed to prepare polyphase resampling of the tones\n");
+                errors++;
+            } else {
+                setBackend(0);
+                convert_sample_rate_polyphase(&tones, &bank, &tones_ref);
+                setBackend(1);
+                convert_sample_rate_polyphase(&tones, &bank, &tones_out);
+                if (memcmp(tones_ref.valueBuffer, tones_out.valueBuffer, (size_t)tones_ref.nr_of_samples * tones_ref.bytes_per_sample) != 0) {
+                    fprintf(stderr, "Polyphase resampling of 12 channels differs from the C Backend\n");
+                    errors++;
+                }
+                for (uint32_t c = 0; c < 3; ++c) {
+                    double sum_sq = 0.0;
+                    uint32_t used = 0;
+                    for (uint32_t k = 100; k + 100 < tones_out.nr_of_samples; ++k, ++used) {
+                        double v = ((const int16_t*)tones_out.valueBuffer)[(size_t)k * ch + c];
+                        sum_sq += v * v;
+                    }
+                    double rms = sqrt(sum_sq / used);
+                    printf("Polyphase 1 MHz -> 48 kHz: %.0f Hz tone RMS %.1f (input 7071.1)\n", tone_hz[c], rms);
+                    if ((c == 0) ? (fabs(rms - 7071.1) > 0.03 * 7071.1) : (rms > 0.01 * 7071.1)) {
+                        fprintf(stderr, "Polyphase resampling does not pass / stop the %.0f Hz tone (RMS %.1f)\n", tone_hz[c], rms);
+                        errors++;
+                    }
+                }
+            }
+            free_PolyphaseFilterBank(&bank);
+            free_RawTimelineValuesBuf(&tones);
+            free_RawTimelineValuesBuf(&tones_ref);
+            free_RawTimelineValuesBuf(&tones_out);
+        }
+        setBackend(1);
+        getBackendName(-1, &bename);
+    }
+
+    // Fused resampling + min/max: every backend must give the columns of convert_sample_rate_stream + aggregate_MinMax
+    {
+        const uint32_t rates[2][2] = { { 1000000, 1200000 }, { 1000000, 48000 } };
+        const uint8_t channel_counts[3] = { 8, 3, 20 };
+        const uint32_t columns[2] = { 1920, 20000 }; // zoomed out, and zoomed in to ~1 resampled sample per column
+        const uint32_t nr = simd_input.nr_of_samples;
+        for (int c = 0; c < 3; ++c) {
+            const uint8_t ch = channel_counts[c];
+            RawTimelineValuesBuf in;
+            init_RawTimelineValuesBuf(&in);
+            alloc_RawTimelineValuesBuf(&in, nr, ch, 16, 16, TR_SIMD_sint16x8);
+            for (uint32_t i = 0; i < nr; ++i) {
+                for (uint32_t k = 0; k < ch; ++k) {
+                    int16_t v;
+                    getSampleValue_SIMD_sint16x8(&simd_input, i, k % 8, &v);
+                    ((int16_t*)in.valueBuffer)[(size_t)i * ch + k] = (int16_t)(v + 37 * k);
+                }
+            }
+            for (int r = 0; r < 2; ++r) {
+                for (int w = 0; w < 2; ++w) {
+                    // the zoomed in window is a short view in the middle of the buffer
+                    const uint32_t offset = (w == 0) ? 0 : nr / 3;
+                    const uint32_t length = (w == 0) ? nr : (uint32_t)((uint64_t)columns[w] * rates[r][0] / rates[r][1]);
+                    RawTimelineValuesView view;
+                    make_RawTimelineValuesView(&in, offset, length, &view);
+                    SampleRateStream stream;
+                    RawTimelineValuesBuf resampled, refMin, refMax, fusedMin, fusedMax;
+                    init_RawTimelineValuesBuf(&resampled);
+                    init_RawTimelineValuesBuf(&refMin);
+                    init_RawTimelineValuesBuf(&refMax);
+                    init_RawTimelineValuesBuf(&fusedMin);
+                    init_RawTimelineValuesBuf(&fusedMax);
+                    init_SampleRateStream(&stream, ch, rates[r][0], rates[r][1]);
+                    alloc_RawTimelineValuesBuf(&resampled, getSampleRateStreamMaxOutput(&stream, length), ch, 16, 16, TR_SIMD_sint16x8);
+                    prepare_AggregationMinMax(&in, &refMin, &refMax, columns[w]);
+                    prepare_AggregationMinMax(&in, &fusedMin, &fusedMax, columns[w]);
+                    for (uint8_t b = 0; b < nr_backends; ++b) {
+                        setBackend(b);
+                        getBackendName(-1, &bename);
+                        // best of 7 runs of each path, the timings of a single run are too noisy to compare
+                        long separate_us = LONG_MAX;
+                        long fused_us = LONG_MAX;
+                        int rc = 0;
+                        for (int run = 0; run < 7; ++run) {
+                            reset_SampleRateStream(&stream);
+                            gettimeofday(&t0, NULL);
+                            rc |= convert_sample_rate_stream_view(&stream, &view, &resampled);
+                            rc |= aggregate_MinMax(&resampled, &refMin, &refMax, 0, 0);
+                            gettimeofday(&t1, NULL);
+                            elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+                            if (elapsed_us < separate_us) separate_us = elapsed_us;
+                            gettimeofday(&t0, NULL);
+                            rc |= aggregate_MinMax_resampled_view(&view, rates[r][0], rates[r][1], &fusedMin, &fusedMax);
+                            gettimeofday(&t1, NULL);
+                            elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+                            if (elapsed_us < fused_us) fused_us = elapsed_us;
+                        }
+                        printf("%s fused resample + min/max (%u channels, %u -> %u Hz, %u columns) took %ld microseconds, separate took %ld microseconds\n",
+                               bename, ch, rates[r][0], rates[r][1], columns[w], fused_us, separate_us);
+                        // Upsampling: the separate path writes and reads back more samples than the window has, fused must win.
+                        // Downsampling reads the same scattered input rows on both paths, which bounds both, so it is only printed.
+                        if (rates[r][1] >= rates[r][0] && fused_us >= separate_us) {
+                            fprintf(stderr, "%s fused resample + min/max (%u channels, %u -> %u Hz, %u columns) is not faster than convert + aggregate\n",
+                                    bename, ch, rates[r][0], rates[r][1], columns[w]);
+                            errors++;
+                        }
+                        const size_t bytes = (size_t)columns[w] * refMin.bytes_per_sample;
+                        if (rc != 0 || memcmp(refMin.valueBuffer, fusedMin.valueBuffer, bytes) != 0 || memcmp(refMax.valueBuffer, fusedMax.valueBuffer, bytes) != 0) {
+                            fprintf(stderr, "%s fused resample + min/max (%u channels, %u columns) differs from convert + aggregate\n", bename, ch, columns[w]);
+                            errors++;
+                        }
+                    }
+                    free_RawTimelineValuesBuf(&resampled);
+                    free_RawTimelineValuesBuf(&refMin);
+                    free_RawTimelineValuesBuf(&refMax);
+                    free_RawTimelineValuesBuf(&fusedMin);
+                    free_RawTimelineValuesBuf(&fusedMax);
+                }
+            }
+            free_RawTimelineValuesBuf(&in);
+        }
+        setBackend(1);
+        getBackendName(-1, &bename);
+    }
+
+    // Mean / RMS aggregation with fused min/max: every backend vs. C, min/max vs. aggregate_MinMax, a few columns vs. double sums
+    {
+        const RawTimelineValueEnum types[3] = { TR_analog_sint8, TR_SIMD_sint16x8, TR_SIMD_sint24x8 };
+        const uint8_t channel_counts[3][3] = { { 1, 8, 20 }, { 3, 8, 20 }, { 8, 12, 80 } };
+        const uint32_t nr = 200000, columns = 1920;
+        for (int t = 0; t < 3; ++t) {
+            for (int c = 0; c < 3; ++c) {
+                const uint8_t ch = channel_counts[t][c];
+                const uint8_t bits = (t == 0) ? 8 : ((t == 1) ? 16 : 24);
+                RawTimelineValuesBuf in, mean, rms, mean_ref, rms_ref, smin, smax, mmin, mmax;
+                init_RawTimelineValuesBuf(&in);
+                init_RawTimelineValuesBuf(&mean);
+                init_RawTimelineValuesBuf(&rms);
+                init_RawTimelineValuesBuf(&mean_ref);
+                init_RawTimelineValuesBuf(&rms_ref);
+                init_RawTimelineValuesBuf(&smin);
+                init_RawTimelineValuesBuf(&smax);
+                init_RawTimelineValuesBuf(&mmin);
+                init_RawTimelineValuesBuf(&mmax);
+                alloc_RawTimelineValuesBuf(&in, nr, ch, bits, 16, types[t]);
+                uint32_t lcg = 7 + ch;
+                for (uint32_t i = 0; i < nr; ++i) {
+                    for (uint32_t k = 0; k < ch; ++k) {
+                        lcg = lcg * 1664525u + 1013904223u;
+                        // full scale noise around a per-channel offset, clipped to the type
+                        int32_t v = (int32_t)(lcg >> (8 + 24 - bits)) - (1 << (bits - 1)) + (int32_t)(k << (bits - 4));
+                        int32_t lim = (1 << (bits - 1)) - 1;
+                        v = (v > lim) ? lim : ((v < -lim - 1) ? -lim - 1 : v);
+                        uint8_t *p = &in.valueBuffer[(size_t)i * in.bytes_per_sample + k * (bits / 8)];
+                        for (uint32_t b = 0; b < bits / 8; ++b) p[b] = (uint8_t)(v >> (8 * b));
+                    }
+                }
+                prepare_AggregationStats(&in, &mean_ref, &rms_ref, columns);
+                prepare_AggregationStats(&in, &mean, &rms, columns);
+                prepare_AggregationMinMax(&in, &smin, &smax, columns);
+                prepare_AggregationMinMax(&in, &mmin, &mmax, columns);
+                for (uint8_t b = 0; b < nr_backends; ++b) {
+                    setBackend(b);
+                    getBackendName(-1, &bename);
+                    gettimeofday(&t0, NULL);
+                    int rc = aggregate_Stats(&in, (b == 0) ? &mean_ref : &mean, (b == 0) ? &rms_ref : &rms, &smin, &smax, 0, 0);
+                    gettimeofday(&t1, NULL);
+                    elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+                    gettimeofday(&t0, NULL);
+                    rc |= aggregate_MinMax(&in, &mmin, &mmax, 0, 0);
+                    gettimeofday(&t1, NULL);
+                    long minmax_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+                    printf("%s mean/rms/min/max aggregation (%u channels, %u-bit) took %ld microseconds, min/max alone took %ld microseconds\n",
+                           bename, ch, bits, elapsed_us, minmax_us);
+                    const size_t stat_bytes = (size_t)columns * mean.bytes_per_sample;
+                    const size_t minmax_bytes = (size_t)columns * mmin.bytes_per_sample;
+                    if (rc != 0 || (b > 0 && (memcmp(mean.valueBuffer, mean_ref.valueBuffer, stat_bytes) != 0 ||
+                                              memcmp(rms.valueBuffer, rms_ref.valueBuffer, stat_bytes) != 0))) {
+                        fprintf(stderr, "%s mean/rms aggregation (%u channels, %u-bit) differs from the C Backend\n", bename, ch, bits);
+                        errors++;
+                    }
+                    if (memcmp(smin.valueBuffer, mmin.valueBuffer, minmax_bytes) != 0 || memcmp(smax.valueBuffer, mmax.valueBuffer, minmax_bytes) != 0) {
+                        fprintf(stderr, "%s fused min/max of the statistics (%u channels, %u-bit) differs from aggregate_MinMax\n", bename, ch, bits);
+                        errors++;
+                    }
+                }
+                // spot check: column 5, last channel, against a double precision sum
+                const float stride = (float)nr / (float)columns;
+                const uint32_t col_start = (uint32_t)floorf(5 * stride);
+                const uint32_t per_col = (uint32_t)floorf(6 * stride) - col_start;
+                double s = 0, s2 = 0;
+                for (uint32_t i = col_start; i < col_start + per_col; ++i) {
+                    const uint8_t *p = &in.valueBuffer[(size_t)i * in.bytes_per_sample + (ch - 1) * (bits / 8)];
+                    int32_t v = (bits == 8) ? (int8_t)p[0] : ((bits == 16) ? (int16_t)(p[0] | p[1] << 8) : ((int32_t)((uint32_t)p[0] << 8 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 24) >> 8));
+                    s += v;
+                    s2 += (double)v * v;
+                }
+                float m, r;
+                getSampleValue_float32(&mean_ref, 5, ch - 1, &m);
+                getSampleValue_float32(&rms_ref, 5, ch - 1, &r);
+                if (fabs(m - s / per_col) > 1e-3 * (1 << (bits - 8)) || fabs(r - sqrt(s2 / per_col)) > 1e-3 * (1 << (bits - 8))) {
+                    fprintf(stderr, "Statistics aggregation is wrong: mean %f (%f), rms %f (%f)\n", m, s / per_col, r, sqrt(s2 / per_col));
+                    errors++;
+                }
+                free_RawTimelineValuesBuf(&in);
+                free_RawTimelineValuesBuf(&mean);
+                free_RawTimelineValuesBuf(&rms);
+                free_RawTimelineValuesBuf(&mean_ref);
+                free_RawTimelineValuesBuf(&rms_ref);
+                free_RawTimelineValuesBuf(&smin);
+                free_RawTimelineValuesBuf(&smax);
+                free_RawTimelineValuesBuf(&mmin);
+                free_RawTimelineValuesBuf(&mmax);
+            }
+        }
+        setBackend(1);
+        getBackendName(-1, &bename);
+    }
+
+    // Statistics kernels of 1..7 channels (consecutive values as the lanes): odd ranges against the C Backend
+    {
+        const RawTimelineValueEnum types[3] = { TR_analog_sint8, TR_SIMD_sint16x8, TR_SIMD_sint24x8 };
+        const uint32_t nr = 100003;
+        const uint32_t ranges[6][2] = { { 0, 0 }, { 3, 1 }, { 5, 17 }, { 1, 40 }, { 11, 70001 }, { nr - 9, 9 } }; // { offset, length }, 0: all
+        for (int t = 0; t < 3; ++t) {
+            const uint8_t bits = (t == 0) ? 8 : ((t == 1) ? 16 : 24);
+            for (uint8_t ch = 1; ch < 8; ++ch) {
+                RawTimelineValuesBuf in;
+                init_RawTimelineValuesBuf(&in);
+                alloc_RawTimelineValuesBuf(&in, nr, ch, bits, 16, types[t]);
+                uint32_t lcg = 31 + ch * bits;
+                for (uint32_t i = 0; i < nr * ch; ++i) {
+                    lcg = lcg * 1664525u + 1013904223u;
+                    int32_t v = (int32_t)lcg >> (32 - bits); // full scale, the extremes included
+                    for (uint32_t b = 0; b < bits / 8; ++b) in.valueBuffer[(size_t)i * (bits / 8) + b] = (uint8_t)(v >> (8 * b));
+                }
+                TimelineChannelStats ref[8], got[8];
+                for (int r = 0; r < 6; ++r) {
+                    for (uint8_t b = 0; b < nr_backends; ++b) {
+                        setBackend(b);
+                        getBackendName(-1, &bename);
+                        gettimeofday(&t0, NULL);
+                        int rc = aggregate_RangeStats(&in, ranges[r][1], ranges[r][0], (b == 0) ? ref : got);
+                        gettimeofday(&t1, NULL);
+                        if (r == 0) {
+                            elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+                            printf("%s range statistics (%u channels, %u-bit) took %ld microseconds\n", bename, ch, bits, elapsed_us);
+                        }
+                        if (rc != 0 || (b > 0 && memcmp(ref, got, ch * sizeof(ref[0])) != 0)) {
+                            fprintf(stderr, "%s range statistics (%u channels, %u-bit, offset %u, length %u) differ from the C Backend\n",
+                                    bename, ch, bits, ranges[r][0], ranges[r][1]);
+                            errors++;
+                        }
+                    }
+                }
+                free_RawTimelineValuesBuf(&in);
+            }
+        }
+        setBackend(1);
+        getBackendName(-1, &bename);
+    }
+
+    // Block statistics sidecar: range queries on a ring (16-bit, wrapped) and a linear buffer (24-bit) vs. a brute force scan
+    {
+        for (int t = 0; t < 2; ++t) {
+            const uint8_t bits = (t == 0) ? 16 : 24;
+            const uint8_t ch = (t == 0) ? 20 : 12;
+            const uint32_t total = 350000, capacity = 100000, chunk = 777;
+            const int32_t clip = (t == 0) ? 30000 : 0; // 24-bit: full scale
+            const int32_t clip_high = clip ? clip : 0x7FFFFF, clip_low = -clip_high - 1;
+            const uint32_t bps = (bits / 8) * ch;
+            uint8_t *all = (uint8_t*)malloc((size_t)total * bps);
+            uint32_t lcg = 99 + bits;
+            for (uint32_t i = 0; i < total; ++i) {
+                for (uint32_t k = 0; k < ch; ++k) {
+                    lcg = lcg * 1664525u + 1013904223u;
+                    int32_t v = (int32_t)(lcg >> (32 - bits)) - (1 << (bits - 1));
+                    // a few bursts at the clip levels on channel 7
+                    if (k == 7 && (i % 50000) < 3) v = (i & 1) ? clip_high : clip_low;
+                    for (uint32_t b = 0; b < bits / 8; ++b) all[(size_t)i * bps + k * (bits / 8) + b] = (uint8_t)(v >> (8 * b));
+                }
+            }
+            RawTimelineValuesBuf buf;
+            init_RawTimelineValuesBuf(&buf);
+            uint32_t base = 0; // linear index of the first sample of the buffer
+            if (t == 0) {
+                alloc_RingTimelineValuesBuf(&buf, capacity, ch, bits, bps, TR_SIMD_sint16x8);
+                init_BlockStats(&buf, 1024, clip);
+                for (uint32_t i = 0; i < total; i += chunk) {
+                    append_RawTimelineValues(&buf, &all[(size_t)i * bps], (total - i < chunk) ? total - i : chunk);
+                }
+                base = total - capacity;
+            } else {
+                alloc_RawTimelineValuesBuf(&buf, total, ch, bits, bps, TR_SIMD_sint24x8);
+                memcpy(buf.valueBuffer, all, (size_t)total * bps);
+                buf.nr_of_samples = total / 2;
+                init_BlockStats(&buf, 4096, clip);
+                buf.nr_of_samples = total;
+                update_BlockStats(&buf);
+            }
+            TimelineChannelStats stats[TIMELINE_STREAM_MAX_CHANNELS];
+            for (int q = 0; q < 40; ++q) {
+                lcg = lcg * 1664525u + 1013904223u;
+                uint32_t len = (q == 0) ? buf.nr_of_samples : 1 + (lcg >> 8) % (buf.nr_of_samples - 1);
+                lcg = lcg * 1664525u + 1013904223u;
+                uint32_t off = (q == 0) ? 0 : (lcg >> 8) % (buf.nr_of_samples - len + 1);
+                RawTimelineValuesView v;
+                make_RawTimelineValuesView(&buf, off, len, &v);
+                if (aggregate_RangeStats_view(&v, stats) != 0) {
+                    fprintf(stderr, "Range statistics failed (%u-bit)\n", bits);
+                    errors++;
+                    break;
+                }
+                for (uint32_t k = 0; k < ch; ++k) {
+                    int64_t sum = 0;
+                    double sum_sq = 0;
+                    int32_t mn = INT32_MAX, mx = INT32_MIN;
+                    uint32_t clipped = 0;
+                    for (uint32_t i = base + off; i < base + off + len; ++i) {
+                        const uint8_t *p = &all[(size_t)i * bps + k * (bits / 8)];
+                        int32_t x = (bits == 16) ? (int16_t)(p[0] | p[1] << 8) : ((int32_t)((uint32_t)p[0] << 8 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 24) >> 8);
+                        sum += x;
+                        sum_sq += (double)x * x;
+                        mn = (x < mn) ? x : mn;
+                        mx = (x > mx) ? x : mx;
+                        clipped += (x <= clip_low || x >= clip_high);
+                    }
+                    double got_sq = (double)stats[k].sum_sq_hi * 18446744073709551616.0 + (double)stats[k].sum_sq;
+                    if (stats[k].sum != sum || stats[k].min != mn || stats[k].max != mx || stats[k].clip_count != clipped ||
+                        stats[k].count != len || fabs(got_sq - sum_sq) > 1e-9 * sum_sq) {
+                        fprintf(stderr, "Range statistics (%u-bit, channel %u, %u+%u) differ from the scan: min %d/%d max %d/%d clip %u/%u\n",
+                                bits, k, off, len, stats[k].min, mn, stats[k].max, mx, stats[k].clip_count, clipped);
+                        errors++;
+                        q = 40;
+                        break;
+                    }
+                }
+            }
+            // the whole buffer from the sidecar vs. the same query as a plain scan
+            RawTimelineValuesView v;
+            make_RawTimelineValuesView(&buf, 0, buf.nr_of_samples, &v);
+            gettimeofday(&t0, NULL);
+            aggregate_RangeStats_view(&v, stats);
+            gettimeofday(&t1, NULL);
+            elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+            TimelineBlockStats *sidecar = buf.block_stats;
+            buf.block_stats = NULL;
+            gettimeofday(&t0, NULL);
+            aggregate_RangeStats_view(&v, stats);
+            gettimeofday(&t1, NULL);
+            buf.block_stats = sidecar;
+            printf("Range statistics of %u samples (%u channels, %u-bit) took %ld microseconds, %ld without the block sidecar\n",
+                   buf.nr_of_samples, ch, bits, elapsed_us, (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec));
+            free_RawTimelineValuesBuf(&buf);
+            free(all);
+        }
+    }
+
+    // Parallel min/max of 10 buffers (a pcap24 frame) on the worker pool vs. the serial calls, every backend
+    {
+        const uint32_t nr = 500000, columns = 1920, nr_bufs = 10;
+        RawTimelineValuesBuf bufs[10], smin[10], smax[10], pmin[10], pmax[10];
+        RawTimelineValuesView views[10];
+        for (uint32_t v = 0; v < nr_bufs; ++v) {
+            // mixed types and channel counts, the last buffer keeps a pyramid and is zoomed out through it
+            const RawTimelineValueEnum type = (v % 3 == 0) ? TR_SIMD_sint24x8 : ((v % 3 == 1) ? TR_SIMD_sint16x8 : TR_analog_sint8);
+            const uint8_t bits = (type == TR_SIMD_sint24x8) ? 24 : ((type == TR_SIMD_sint16x8) ? 16 : 8);
+            const uint8_t ch = (v == 0) ? 80 : (uint8_t)(8 + v);
+            init_RawTimelineValuesBuf(&bufs[v]);
+            init_RawTimelineValuesBuf(&smin[v]);
+            init_RawTimelineValuesBuf(&smax[v]);
+            init_RawTimelineValuesBuf(&pmin[v]);
+            init_RawTimelineValuesBuf(&pmax[v]);
+            alloc_RawTimelineValuesBuf(&bufs[v], nr, ch, bits, 16, type);
+            uint32_t lcg = 3 + v;
+            for (size_t b = 0; b < (size_t)nr * bufs[v].bytes_per_sample; ++b) {
+                lcg = lcg * 1664525u + 1013904223u;
+                bufs[v].valueBuffer[b] = (uint8_t)(lcg >> 24);
+            }
+            if (v == nr_bufs - 1) init_MinMaxPyramid(&bufs[v], 0);
+            prepare_AggregationMinMax(&bufs[v], &smin[v], &smax[v], columns);
+            prepare_AggregationMinMax(&bufs[v], &pmin[v], &pmax[v], columns);
+            make_RawTimelineValuesView(&bufs[v], 1000 * v, nr - 1000 * v - 7, &views[v]);
+        }
+        init_TimelineWorkers(0);
+        for (uint8_t b = 0; b < nr_backends; ++b) {
+            setBackend(b);
+            getBackendName(-1, &bename);
+            gettimeofday(&t0, NULL);
+            for (uint32_t v = 0; v < nr_bufs; ++v) {
+                aggregate_MinMax_view(&views[v], &smin[v], &smax[v]);
+            }
+            gettimeofday(&t1, NULL);
+            long serial_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+            gettimeofday(&t0, NULL);
+            int rc = aggregate_MinMax_parallel(views, pmin, pmax, nr_bufs);
+            gettimeofday(&t1, NULL);
+            elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+            printf("%s min/max of %u buffers took %ld microseconds serial, %ld microseconds on %u threads\n",
+                   bename, nr_bufs, serial_us, elapsed_us, getTimelineWorkersCount());
+            for (uint32_t v = 0; v < nr_bufs; ++v) {
+                const size_t bytes = (size_t)columns * smin[v].bytes_per_sample;
+                if (rc != 0 || memcmp(smin[v].valueBuffer, pmin[v].valueBuffer, bytes) != 0 || memcmp(smax[v].valueBuffer, pmax[v].valueBuffer, bytes) != 0) {
+                    fprintf(stderr, "%s parallel min/max of buffer %u differs from the serial aggregation\n", bename, v);
+                    errors++;
+                }
+            }
+        }
+        // more threads than CPUs, and a pool without workers (the caller runs every task): same result
+        const uint32_t thread_counts[2] = { 4, 1 };
+        for (int t = 0; t < 2; ++t) {
+            init_TimelineWorkers(thread_counts[t]);
+            for (int rep = 0; rep < 20; ++rep) {
+                for (uint32_t v = 0; v < nr_bufs; ++v) {
+                    memset(pmin[v].valueBuffer, 0, (size_t)columns * pmin[v].bytes_per_sample);
+                    memset(pmax[v].valueBuffer, 0, (size_t)columns * pmax[v].bytes_per_sample);
+                }
+                int rc = aggregate_MinMax_parallel(views, pmin, pmax, nr_bufs);
+                for (uint32_t v = 0; v < nr_bufs; ++v) {
+                    const size_t bytes = (size_t)columns * smin[v].bytes_per_sample;
+                    if (rc != 0 || memcmp(smin[v].valueBuffer, pmin[v].valueBuffer, bytes) != 0 || memcmp(smax[v].valueBuffer, pmax[v].valueBuffer, bytes) != 0) {
+                        fprintf(stderr, "Parallel min/max of buffer %u on %u threads differs from the serial aggregation\n", v, thread_counts[t]);
+                        errors++;
+                        rep = 20;
+                        break;
+                    }
+                }
+            }
+        }
+        // more views than one run of the pool takes (every view twice)
+        {
+            RawTimelineValuesView views2[20];
+            RawTimelineValuesBuf pmin2[20], pmax2[20];
+            for (uint32_t v = 0; v < 20; ++v) {
+                views2[v] = views[v % nr_bufs];
+                init_RawTimelineValuesBuf(&pmin2[v]);
+                init_RawTimelineValuesBuf(&pmax2[v]);
+                prepare_AggregationMinMax(&bufs[v % nr_bufs], &pmin2[v], &pmax2[v], columns);
+            }
+            int rc = aggregate_MinMax_parallel(views2, pmin2, pmax2, 20);
+            for (uint32_t v = 0; v < 20; ++v) {
+                const size_t bytes = (size_t)columns * smin[v % nr_bufs].bytes_per_sample;
+                if (rc != 0 || memcmp(smin[v % nr_bufs].valueBuffer, pmin2[v].valueBuffer, bytes) != 0 ||
+                    memcmp(smax[v % nr_bufs].valueBuffer, pmax2[v].valueBuffer, bytes) != 0) {
+                    fprintf(stderr, "Parallel min/max of view %u of 20 differs from the serial aggregation\n", v);
+                    errors++;
+                }
+                free_RawTimelineValuesBuf(&pmin2[v]);
+                free_RawTimelineValuesBuf(&pmax2[v]);
+            }
+        }
+        free_TimelineWorkers();
+        for (uint32_t v = 0; v < nr_bufs; ++v) {
+            free_RawTimelineValuesBuf(&bufs[v]);
+            free_RawTimelineValuesBuf(&smin[v]);
+            free_RawTimelineValuesBuf(&smax[v]);
+            free_RawTimelineValuesBuf(&pmin[v]);
+            free_RawTimelineValuesBuf(&pmax[v]);
+        }
+        setBackend(1);
+        getBackendName(-1, &bename);
+    }
+
+    // Parallel sample rate conversion: chunks of the prepared table on the worker pool vs. the serial converter
+    {
+        const uint8_t channel_counts[3] = { 8, 20, 8 };
+        const uint32_t out_rates[3] = { 1200000, 2345678, 300000 }; // upsampling, and downsampling
+        for (int t = 0; t < 3; ++t) {
+            const uint8_t ch = channel_counts[t];
+            RawTimelineValuesBuf in, serial, parallel;
+            init_RawTimelineValuesBuf(&in);
+            init_RawTimelineValuesBuf(&serial);
+            init_RawTimelineValuesBuf(&parallel);
+            alloc_RawTimelineValuesBuf(&in, num_samples, ch, 16, 2 * ch, TR_SIMD_sint16x8);
+            in.time_exponent = -6;
+            in.time_step = 1;
+            for (uint32_t i = 0; i < num_samples; ++i) {
+                for (uint32_t k = 0; k < ch; ++k) {
+                    ((int16_t*)in.valueBuffer)[(size_t)i * ch + k] = (int16_t)(30000.0 * sin(2.0 * M_PI * (i + 7.0 * k) / (1000.0 + 37.0 * k)));
+                }
+            }
+            prepare_SampleRateConversion(&in, out_rates[t], &serial);
+            prepare_SampleRateConversion(&in, out_rates[t], &parallel);
+            const size_t values = (size_t)parallel.nr_of_samples * ch;
+            int16_t *ref = (int16_t*)malloc(values * sizeof(int16_t));
+            for (uint8_t b = 0; b < nr_backends; ++b) {
+                setBackend(b);
+                getBackendName(-1, &bename);
+                init_TimelineWorkers(0);
+                gettimeofday(&t0, NULL);
+                convert_sample_rate(&in, &serial);
+                gettimeofday(&t1, NULL);
+                long serial_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+                gettimeofday(&t0, NULL);
+                convert_sample_rate_parallel(&in, &parallel);
+                gettimeofday(&t1, NULL);
+                elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+                printf("%s sample rate conversion (%u channels, %u outputs) took %ld microseconds serial, %ld microseconds on %u threads\n",
+                       bename, ch, parallel.nr_of_samples, serial_us, elapsed_us, getTimelineWorkersCount());
+                // the compared result comes from 4 threads, whatever the machine has
+                init_TimelineWorkers(4);
+                memset(parallel.valueBuffer, 0, values * sizeof(int16_t));
+                if (convert_sample_rate_parallel(&in, &parallel) != 0) {
+                    fprintf(stderr, "%s parallel sample rate conversion failed\n", bename);
+                    errors++;
+                }
+                // the chunks walk the table of the serial converter, and every backend computes the same Q16 formula
+                const int16_t *p = (const int16_t*)parallel.valueBuffer;
+                const int16_t *s = (const int16_t*)serial.valueBuffer;
+                if (b == 0) {
+                    memcpy(ref, p, values * sizeof(int16_t));
+                } else if (memcmp(ref, p, values * sizeof(int16_t)) != 0) {
+                    fprintf(stderr, "%s parallel sample rate conversion (%u channels) differs from the C Backend\n", bename, ch);
+                    errors++;
+                }
+                for (size_t v = 0; v < values; ++v) {
+                    if (p[v] != s[v]) {
+                        fprintf(stderr, "%s parallel sample rate conversion (%u channels) differs from the serial one at value %zu: %d != %d\n",
+                                bename, ch, v, p[v], s[v]);
+                        errors++;
+                        break;
+                    }
+                }
+            }
+            free_TimelineWorkers();
+            free(ref);
+            free_RawTimelineValuesBuf(&in);
+            free_RawTimelineValuesBuf(&serial);
+            free_RawTimelineValuesBuf(&parallel);
+        }
+        setBackend(1);
+        getBackendName(-1, &bename);
+    }
+
+    // CIC decimation of 80 x 24-bit channels by 1000 (1 MHz -> 1 kHz): a constant channel must stay exact, a slow sine must pass
+    {
+        const uint32_t nr = 1000000, ratio = 1000;
+        const uint8_t ch = 80;
+        RawTimelineValuesBuf wide, archive;
+        init_RawTimelineValuesBuf(&wide);
+        init_RawTimelineValuesBuf(&archive);
+        alloc_RawTimelineValuesBuf(&wide, nr, ch, 24, 16, TR_SIMD_sint24x8);
+        wide.time_exponent = -6;
+        wide.time_step = 1;
+        for (uint32_t i = 0; i < nr; ++i) {
+            for (uint32_t c = 0; c < ch; ++c) {
+                // channel 0: constant, others: 10 Hz sine (0.02 x the output Nyquist frequency)
+                int32_t v = (c == 0) ? -1234567 : (int32_t)(4000000.0 * sin(2.0 * M_PI * 10.0 * i / 1e6));
+                uint8_t *p = &wide.valueBuffer[(size_t)i * wide.bytes_per_sample + c * 3];
+                p[0] = (uint8_t)v;
+                p[1] = (uint8_t)(v >> 8);
+                p[2] = (uint8_t)(v >> 16);
+            }
+        }
+        if (prepare_CicDecimation(&wide, ratio, 3, 1, &archive) != 0) {
+            fprintf(stderr, "Failed to prepare CIC decimation\n");
+            errors++;
+        } else {
+            gettimeofday(&t0, NULL);
+            int rc = convert_decimate_cic(&wide, &archive);
+            gettimeofday(&t1, NULL);
+            elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+            printf("CIC decimation (%u channels, 24-bit, %u -> %u samples, 3 stages) took %ld microseconds\n", ch, nr, archive.nr_of_samples, elapsed_us);
+            int32_t peak = 0, dc = 0;
+            for (uint32_t i = 0; i < archive.nr_of_samples; ++i) {
+                int32_t v;
+                getSampleValue_SIMD_sint24x8(&archive, i, 0, &v);
+                if (i == 0 || v != -1234567) dc = v;
+                getSampleValue_SIMD_sint24x8(&archive, i, 41, &v);
+                if (abs(v) > peak) peak = abs(v);
+            }
+            if (rc != 0 || dc != -1234567 || peak < 3960000 || peak > 4040000) {
+                fprintf(stderr, "CIC decimation result is wrong: constant %d, sine peak %d\n", dc, peak);
+                errors++;
+            }
+        }
+        free_RawTimelineValuesBuf(&wide);
+        free_RawTimelineValuesBuf(&archive);
+    }
+
+    // CIC accumulator bound: full scale steps (first sample at one end, the rest at the other) at the limit of
+    // bitwidth + 1 + N * ceil(log2 R) <= 63 must come out exact, one stage more must be rejected
+    {
+        const uint32_t cases[4][3] = { { 256, 4, 1 }, { 256, 5, 0 }, { 300000, 2, 1 }, { 300000, 3, 0 } }; // ratio, stages, accepted
+        const uint8_t ch = 8;
+        for (int t = 0; t < 4; ++t) {
+            const uint32_t ratio = cases[t][0], stages = cases[t][1], nr = ratio * (stages + 2);
+            RawTimelineValuesBuf in, out;
+            init_RawTimelineValuesBuf(&in);
+            init_RawTimelineValuesBuf(&out);
+            alloc_RawTimelineValuesBuf(&in, nr, ch, 24, 16, TR_SIMD_sint24x8);
+            for (uint32_t i = 0; i < nr; ++i) {
+                for (uint32_t c = 0; c < ch; ++c) {
+                    // even channels step from -2^23 to 2^23 - 1, odd channels the other way
+                    int32_t v = ((i == 0) == ((c & 1) == 0)) ? -0x800000 : 0x7FFFFF;
+                    uint8_t *p = &in.valueBuffer[(size_t)i * in.bytes_per_sample + c * 3];
+                    p[0] = (uint8_t)v;
+                    p[1] = (uint8_t)(v >> 8);
+                    p[2] = (uint8_t)(v >> 16);
+                }
+            }
+            int rc = prepare_CicDecimation(&in, ratio, (uint8_t)stages, 0, &out);
+            if ((rc == 0) != (cases[t][2] != 0)) {
+                fprintf(stderr, "CIC decimation by %u with %u stages was %s\n", ratio, stages, rc ? "rejected" : "accepted");
+                errors++;
+            } else if (rc == 0) {
+                rc = convert_decimate_cic(&in, &out);
+                for (uint32_t i = stages; i < out.nr_of_samples && rc == 0; ++i) {
+                    for (uint32_t c = 0; c < ch; ++c) {
+                        int32_t v;
+                        getSampleValue_SIMD_sint24x8(&out, i, c, &v);
+                        if (v != ((c & 1) ? -0x800000 : 0x7FFFFF)) {
+                            fprintf(stderr, "CIC decimation by %u with %u stages overflows: output %u channel %u is %d\n", ratio, stages, i, c, v);
+                            rc = -1;
+                            break;
+                        }
+                    }
+                }
+                if (rc != 0) errors++;
+            }
+            free_RawTimelineValuesBuf(&in);
+            free_RawTimelineValuesBuf(&out);
+        }
+    }
+
+    // Snapshots: a writer thread appends while this thread takes snapshots, holds some across version replacements
+    // and checks that each one is complete, unchanged and not older than the previous one
+    {
+        TimelineSharedBuf shared;
+        init_TimelineSharedBuf(&shared, 0, 50000, 8, 16, 16, TR_SIMD_sint16x8);
+        pthread_t writer;
+        TimelineSnapshot held[4];
+        memset(held, 0, sizeof(held));
+        uint64_t last_end = 0;
+        uint32_t nr_snapshots = 0;
+        int failed = 0, writer_failed = 0;
+        if (pthread_create(&writer, NULL, snapshot_writer, &shared) != 0) {
+            fprintf(stderr, "Failed to start the snapshot writer thread\n");
+            errors++;
+        } else {
+            while (last_end < SNAPSHOT_TEST_SAMPLES && !failed) {
+                TimelineSnapshot snap;
+                acquire_TimelineSnapshot(&shared, &snap);
+                uint64_t end = snap.first_sample + snap.buf.nr_of_samples;
+                if (end < last_end || snap.buf.nr_of_samples > 100000 || check_TimelineSnapshot(&snap) != 0) {
+                    failed = 1;
+                }
+                last_end = end;
+                // keep every 16th snapshot alive for a while, recheck it when it is released
+                TimelineSnapshot *h = &held[(nr_snapshots / 16) % 4];
+                if ((nr_snapshots % 16) == 0) {
+                    if (h->version && check_TimelineSnapshot(h) != 0) failed = 1;
+                    release_TimelineSnapshot(h);
+                    *h = snap;
+                } else {
+                    release_TimelineSnapshot(&snap);
+                }
+                nr_snapshots++;
+            }
+            void *ret = NULL;
+            pthread_join(writer, &ret);
+            writer_failed = (ret != NULL);
+        }
+        for (int k = 0; k < 4; ++k) {
+            if (held[k].version && check_TimelineSnapshot(&held[k]) != 0) failed = 1;
+            release_TimelineSnapshot(&held[k]);
+        }
+        printf("Snapshots: %u taken while appending %u samples\n", nr_snapshots, SNAPSHOT_TEST_SAMPLES);
+        if (failed || writer_failed) {
+            fprintf(stderr, "Snapshot check failed (writer %s, last end %llu)\n", writer_failed ? "failed" : "ok", (unsigned long long)last_end);
+            errors++;
+        }
+        free_TimelineSharedBuf(&shared);
+    }
+
+    // Ring buffer: append more than the capacity, then aggregate and convert a window without copying it
+    RawTimelineValuesBuf ring;
+    init_RawTimelineValuesBuf(&ring);
+    const uint32_t ring_capacity = 300000;
+    alloc_RingTimelineValuesBuf(&ring, ring_capacity, 8, 16, 16, TR_SIMD_sint16x8);
+    ring.time_exponent = simd_input.time_exponent;
+    ring.time_step = simd_input.time_step;
+    init_MinMaxPyramid(&ring, 0);
+    for (uint32_t i = 0; i < simd_input.nr_of_samples; i += 1000) {
+        append_RawTimelineValues(&ring, &simd_input.valueBuffer[i * simd_input.bytes_per_sample], 1000);
+        update_MinMaxPyramid(&ring);
+    }
+    // the ring keeps the last ring_capacity samples, the view starts 1000 samples after the oldest one
+    const uint32_t view_offset = 1000, view_length = 250000;
+    uint32_t lin_offset = simd_input.nr_of_samples - ring_capacity + view_offset;
+    RawTimelineValuesView view;
+    make_RawTimelineValuesView(&ring, view_offset, view_length, &view);
+    prepare_AggregationMinMax(&simd_input, &raw_min, &raw_max, 800);
+    prepare_AggregationMinMax(&simd_input, &so_min, &so_max, 800);
+    aggregate_MinMax(&simd_input, &raw_min, &raw_max, view_length, lin_offset);
+    aggregate_MinMax_view(&view, &so_min, &so_max);
+    if (memcmp(raw_min.valueBuffer, so_min.valueBuffer, 800 * raw_min.bytes_per_sample) != 0 ||
+        memcmp(raw_max.valueBuffer, so_max.valueBuffer, 800 * raw_max.bytes_per_sample) != 0) {
+        fprintf(stderr, "Ring view aggregation differs from the linear buffer\n");
+        errors++;
+    }
+    RawTimelineValuesBuf window;
+    map_RawTimelineValuesView(&view, &window);
+    if (memcmp(window.valueBuffer, &simd_input.valueBuffer[lin_offset * simd_input.bytes_per_sample], view_length * window.bytes_per_sample) != 0) {
+        fprintf(stderr, "Ring view does not map to the appended samples\n");
+        errors++;
+    }
+    RawTimelineValuesBuf ring_output;
+    init_RawTimelineValuesBuf(&ring_output);
+    prepare_SampleRateConversion(&window, 800000, &ring_output);
+    if (convert_sample_rate_view(&view, &ring_output) != 0) {
+        fprintf(stderr, "Failed to convert sample rate of a ring view\n");
+        errors++;
+    }
+    free_RawTimelineValuesBuf(&ring_output);
+
+    // Timeline file: write the ring window, map it back and aggregate straight from the mapping
+    {
+        const char *path = "devtest_ring.tldb";
+        TimelineFile file;
+        RawTimelineValuesView ring_all;
+        RawTimelineValuesBuf ring_window;
+        make_RawTimelineValuesView(&ring, 0, ring.nr_of_samples, &ring_all);
+        map_RawTimelineValuesView(&ring_all, &ring_window);
+        if (write_TimelineFile(path, &ring) != 0 || open_TimelineFile(path, &file) != 0) {
+            fprintf(stderr, "Failed to write / open timeline file %s\n", path);
+            errors++;
+        } else {
+            gettimeofday(&t0, NULL);
+            aggregate_MinMax(&file.buf, &raw_min, &raw_max, view_length, view_offset);
+            gettimeofday(&t1, NULL);
+            elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+            printf("Timeline file: %u samples mapped, min/max of %u samples took %ld microseconds\n", file.buf.nr_of_samples, view_length, elapsed_us);
+            if (file.buf.nr_of_samples != ring.nr_of_samples || file.buf.value_type != ring.value_type ||
+                file.buf.time_step != ring.time_step || file.buf.time_exponent != ring.time_exponent ||
+                ((uintptr_t)file.buf.valueBuffer % 64) != 0 ||
+                memcmp(file.buf.valueBuffer, ring_window.valueBuffer, ring_window.buffer_size) != 0 ||
+                memcmp(raw_min.valueBuffer, so_min.valueBuffer, 800 * raw_min.bytes_per_sample) != 0 ||
+                memcmp(raw_max.valueBuffer, so_max.valueBuffer, 800 * raw_max.bytes_per_sample) != 0) {
+                fprintf(stderr, "Timeline file does not match the ring it was written from\n");
+                errors++;
+            }
+            close_TimelineFile(&file);
+        }
+        // corrupted headers must be rejected: a row shorter than its channels, a bitwidth not matching the type
+        // (byte offsets of nr_of_channels, bitwidth and bytes_per_sample in the file header)
+        const struct { uint32_t offset, size, value; } corrupt[3] = { { 29, 1, 200 }, { 30, 1, 8 }, { 32, 2, 2 } };
+        for (int k = 0; k < 3; ++k) {
+            FILE *f = fopen(path, "r+b");
+            uint8_t saved[2], patch[2] = { (uint8_t)corrupt[k].value, (uint8_t)(corrupt[k].value >> 8) };
+            int patched = f && fseek(f, corrupt[k].offset, SEEK_SET) == 0 && fread(saved, 1, corrupt[k].size, f) == corrupt[k].size &&
+                          fseek(f, corrupt[k].offset, SEEK_SET) == 0 && fwrite(patch, 1, corrupt[k].size, f) == corrupt[k].size;
+            if (f) fclose(f);
+            if (!patched || open_TimelineFile(path, &file) == 0) {
+                fprintf(stderr, "Timeline file with a corrupted header (byte %u = %u) was opened\n", corrupt[k].offset, corrupt[k].value);
+                if (patched) close_TimelineFile(&file);
+                errors++;
+            }
+            f = patched ? fopen(path, "r+b") : NULL;
+            if (f) {
+                fseek(f, corrupt[k].offset, SEEK_SET);
+                fwrite(saved, 1, corrupt[k].size, f);
+                fclose(f);
+            }
+        }
+        remove(path);
+    }
+
+    // Segmented timeline: the same samples in 64K sample segments (uneven appends), aggregated across the boundaries
+    {
+        TimelineSegmentedBuf seg;
+        init_TimelineSegmentedBuf(&seg, 16, TIMELINE_SEGMENTS_PYRAMID | TIMELINE_SEGMENTS_BLOCKSTATS, 8, 16, 16, TR_SIMD_sint16x8);
+        for (uint32_t i = 0; i < simd_input.nr_of_samples; ) {
+            uint32_t n = 1 + (i * 7919u) % 100000;
+            if (n > simd_input.nr_of_samples - i) n = simd_input.nr_of_samples - i;
+            append_TimelineSegmentedBuf(&seg, &simd_input.valueBuffer[(size_t)i * simd_input.bytes_per_sample], n);
+            i += n;
+        }
+        // (column counts dividing the ranges: the float stride of aggregate_MinMax is exact there too)
+        const uint32_t seg_columns[2] = { 800, 4000 };
+        const uint32_t seg_offsets[2] = { 12345, 65000 };
+        const uint32_t seg_lengths[2] = { 960000, 400000 };
+        for (int t = 0; t < 2; ++t) {
+            RawTimelineValuesBuf lin_min, lin_max, seg_min, seg_max;
+            init_RawTimelineValuesBuf(&lin_min);
+            init_RawTimelineValuesBuf(&lin_max);
+            init_RawTimelineValuesBuf(&seg_min);
+            init_RawTimelineValuesBuf(&seg_max);
+            prepare_AggregationMinMax(&simd_input, &lin_min, &lin_max, seg_columns[t]);
+            prepare_AggregationMinMax(&seg.layout, &seg_min, &seg_max, seg_columns[t]);
+            aggregate_MinMax(&simd_input, &lin_min, &lin_max, seg_lengths[t], seg_offsets[t]);
+            gettimeofday(&t0, NULL);
+            int rc = aggregate_MinMax_segmented(&seg, &seg_min, &seg_max, seg_lengths[t], seg_offsets[t]);
+            gettimeofday(&t1, NULL);
+            elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+            printf("Segmented min/max (%u segments, %u columns of %u samples) took %ld microseconds\n",
+                   seg.nr_of_segments, seg_columns[t], seg_lengths[t] / seg_columns[t], elapsed_us);
+            const size_t bytes = (size_t)seg_columns[t] * lin_min.bytes_per_sample;
+            if (rc != 0 || memcmp(lin_min.valueBuffer, seg_min.valueBuffer, bytes) != 0 || memcmp(lin_max.valueBuffer, seg_max.valueBuffer, bytes) != 0) {
+                fprintf(stderr, "Segmented min/max differs from the linear buffer (%u columns)\n", seg_columns[t]);
+                errors++;
+            }
+            TimelineChannelStats lin_stats[8], seg_stats[8];
+            aggregate_RangeStats(&simd_input, seg_lengths[t], seg_offsets[t], lin_stats);
+            if (seg.nr_of_samples != simd_input.nr_of_samples ||
+                aggregate_RangeStats_segmented(&seg, seg_lengths[t], seg_offsets[t], seg_stats) != 0 ||
+                memcmp(lin_stats, seg_stats, sizeof(lin_stats)) != 0) {
+                fprintf(stderr, "Segmented range statistics differ from the linear buffer\n");
+                errors++;
+            }
+            free_RawTimelineValuesBuf(&lin_min);
+            free_RawTimelineValuesBuf(&lin_max);
+            free_RawTimelineValuesBuf(&seg_min);
+            free_RawTimelineValuesBuf(&seg_max);
+        }
+        free_TimelineSegmentedBuf(&seg);
+    }
+
+    // Compressed timeline: slowly varying 24-bit channels and a 20 channel 16-bit buffer (a partial channel group),
+    // lossless on every backend, min/max from the compressed blocks identical to the raw buffer
+    {
+        RawTimelineValuesBuf codec_in[2];
+        init_RawTimelineValuesBuf(&codec_in[0]);
+        init_RawTimelineValuesBuf(&codec_in[1]);
+        alloc_RawTimelineValuesBuf(&codec_in[0], 1000000, 8, 24, 16, TR_SIMD_sint24x8);
+        alloc_RawTimelineValuesBuf(&codec_in[1], 500000, 20, 16, 16, TR_SIMD_sint16x8);
+        for (uint32_t i = 0; i < codec_in[0].nr_of_samples; ++i) {
+            for (uint32_t c = 0; c < 8; ++c) {
+                int32_t v = (int32_t)(4000000.0 * sin(i * 0.0005 + c)) + (int32_t)((i * (c + 3)) % 17);
+                unsigned char *p = &codec_in[0].valueBuffer[(size_t)i * 24 + c * 3];
+                p[0] = (unsigned char)v;
+                p[1] = (unsigned char)(v >> 8);
+                p[2] = (unsigned char)(v >> 16);
+            }
+        }
+        for (uint32_t i = 0; i < codec_in[1].nr_of_samples; ++i) {
+            for (uint32_t c = 0; c < 20; ++c) {
+                ((int16_t*)codec_in[1].valueBuffer)[(size_t)i * 20 + c] = (int16_t)(30000.0 * sin(i * 0.001 * (c + 1)));
+            }
+        }
+        for (int t = 0; t < 2; ++t) {
+            const RawTimelineValuesBuf *in = &codec_in[t];
+            const size_t raw_size = (size_t)in->nr_of_samples * in->bytes_per_sample;
+            for (uint8_t b = 0; b < nr_backends; ++b) {
+                setBackend(b);
+                getBackendName(-1, &bename);
+                TimelineCompressedBuf packed;
+                RawTimelineValuesBuf unpacked;
+                init_RawTimelineValuesBuf(&unpacked);
+                gettimeofday(&t0, NULL);
+                int rc = compress_RawTimelineValues(in, &packed);
+                gettimeofday(&t1, NULL);
+                long encode_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+                gettimeofday(&t0, NULL);
+                if (rc == 0) rc = decompress_RawTimelineValues(&packed, &unpacked, 0, 0);
+                gettimeofday(&t1, NULL);
+                long decode_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+                if (rc == 0) {
+                    printf("%s codec %u x %u-bit: ratio %.2f, encode %.2f GB/s, decode %.2f GB/s\n", bename,
+                           in->nr_of_channels, in->bitwidth, (double)raw_size / packed.data_size,
+                           (double)raw_size / (encode_us + 1) / 1000.0, (double)raw_size / (decode_us + 1) / 1000.0);
+                }
+                if (rc != 0 || unpacked.nr_of_samples != in->nr_of_samples || memcmp(unpacked.valueBuffer, in->valueBuffer, raw_size) != 0) {
+                    fprintf(stderr, "%s codec roundtrip differs (%u channels)\n", bename, in->nr_of_channels);
+                    errors++;
+                }
+                // a range cut inside the blocks
+                free_RawTimelineValuesBuf(&unpacked);
+                if (rc == 0 && (decompress_RawTimelineValues(&packed, &unpacked, 70001, 1000) != 0 ||
+                    memcmp(unpacked.valueBuffer, &in->valueBuffer[(size_t)1000 * in->bytes_per_sample], (size_t)70001 * in->bytes_per_sample) != 0)) {
+                    fprintf(stderr, "%s codec range decode differs (%u channels)\n", bename, in->nr_of_channels);
+                    errors++;
+                }
+                // zoomed out (many blocks per column), zoomed in (columns inside a block) and more columns than rows
+                const uint32_t codec_columns[3] = { 800, 3000, 3000 };
+                const uint32_t codec_offsets[3] = { 0, 33333, 123456 };
+                const uint32_t codec_lengths[3] = { 0, 9000, 5 };
+                for (int z = 0; rc == 0 && z < 3; ++z) {
+                    RawTimelineValuesBuf lin_min, lin_max, cmp_min, cmp_max;
+                    init_RawTimelineValuesBuf(&lin_min);
+                    init_RawTimelineValuesBuf(&lin_max);
+                    init_RawTimelineValuesBuf(&cmp_min);
+                    init_RawTimelineValuesBuf(&cmp_max);
+                    prepare_AggregationMinMax(in, &lin_min, &lin_max, codec_columns[z]);
+                    prepare_AggregationMinMax(&packed.layout, &cmp_min, &cmp_max, codec_columns[z]);
+                    aggregate_MinMax(in, &lin_min, &lin_max, codec_lengths[z], codec_offsets[z]);
+                    gettimeofday(&t0, NULL);
+                    int arc = aggregate_MinMax_compressed(&packed, &cmp_min, &cmp_max, codec_lengths[z], codec_offsets[z]);
+                    gettimeofday(&t1, NULL);
+                    elapsed_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+                    if (b == 0) {
+                        printf("Compressed min/max (%u channels, %u columns) took %ld microseconds\n", in->nr_of_channels, codec_columns[z], elapsed_us);
+                    }
+                    const size_t bytes = (size_t)codec_columns[z] * lin_min.bytes_per_sample;
+                    if (arc != 0 || memcmp(lin_min.valueBuffer, cmp_min.valueBuffer, bytes) != 0 || memcmp(lin_max.valueBuffer, cmp_max.valueBuffer, bytes) != 0) {
+                        fprintf(stderr, "%s compressed min/max differs from the raw buffer (%u channels, %u columns)\n", bename, in->nr_of_channels, codec_columns[z]);
+                        errors++;
+                    }
+                    // a range past the last sample has nothing to aggregate
+                    if (z == 0 && aggregate_MinMax_compressed(&packed, &cmp_min, &cmp_max, 0, in->nr_of_samples) == 0) {
+                        fprintf(stderr, "%s compressed min/max of an empty range did not fail\n", bename);
+                        errors++;
+                    }
+                    free_RawTimelineValuesBuf(&lin_min);
+                    free_RawTimelineValuesBuf(&lin_max);
+                    free_RawTimelineValuesBuf(&cmp_min);
+                    free_RawTimelineValuesBuf(&cmp_max);
+                }
+                free_RawTimelineValuesBuf(&unpacked);
+                if (rc == 0) free_TimelineCompressedBuf(&packed);
+            }
+        }
+        // Planar copies of the same buffers: transposed and back on every backend, a plane mapped as a one channel
+        // buffer gives the same min/max columns as its channel of the interleaved buffer
+        for (int t = 0; t < 2; ++t) {
+            const RawTimelineValuesBuf *in = &codec_in[t];
+            const uint32_t ch = in->nr_of_channels;
+            const uint32_t lane_bytes = in->bitwidth / 8;
+            const size_t raw_size = (size_t)in->nr_of_samples * in->bytes_per_sample;
+            RawTimelineValuesBuf in_min, in_max;
+            init_RawTimelineValuesBuf(&in_min);
+            init_RawTimelineValuesBuf(&in_max);
+            prepare_AggregationMinMax(in, &in_min, &in_max, 800);
+            aggregate_MinMax(in, &in_min, &in_max, 0, 0);
+            for (uint8_t b = 0; b < nr_backends; ++b) {
+                setBackend(b);
+                getBackendName(-1, &bename);
+                RawTimelineValuesBuf planar, back;
+                init_RawTimelineValuesBuf(&planar);
+                init_RawTimelineValuesBuf(&back);
+                alloc_RawTimelineValuesBuf(&back, in->nr_of_samples, ch, in->bitwidth, 16, in->value_type);
+                if (prepare_PlanarBuffer(in, &planar) != 0) {
+                    fprintf(stderr, "%s planar buffer allocation failed\n", bename);
+                    errors++;
+                    free_RawTimelineValuesBuf(&back);
+                    continue;
+                }
+                gettimeofday(&t0, NULL);
+                int rc = convert_to_PlanarBuffer(in, &planar);
+                gettimeofday(&t1, NULL);
+                long to_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+                gettimeofday(&t0, NULL);
+                if (rc == 0) rc = convert_from_PlanarBuffer(&planar, &back);
+                gettimeofday(&t1, NULL);
+                long from_us = (t1.tv_sec - t0.tv_sec) * 1000000L + (t1.tv_usec - t0.tv_usec);
+                printf("%s planar transpose %u x %u-bit: to planar %.2f GB/s, back %.2f GB/s\n", bename, ch, in->bitwidth,
+                       (double)raw_size / (to_us + 1) / 1000.0, (double)raw_size / (from_us + 1) / 1000.0);
+                for (uint32_t c = 0; rc == 0 && c < ch; ++c) {
+                    const unsigned char *plane_values = &planar.valueBuffer[(size_t)c * planar.plane_stride];
+                    for (uint32_t i = 0; i < in->nr_of_samples; ++i) {
+                        if (memcmp(&plane_values[(size_t)i * lane_bytes], &in->valueBuffer[(size_t)i * in->bytes_per_sample + c * lane_bytes], lane_bytes) != 0) {
+                            rc = -1;
+                            break;
+                        }
+                    }
+                }
+                if (rc != 0 || memcmp(back.valueBuffer, in->valueBuffer, raw_size) != 0) {
+                    fprintf(stderr, "%s planar transpose differs (%u channels)\n", bename, ch);
+                    errors++;
+                }
+                RawTimelineValuesBuf plane, plane_min, plane_max;
+                init_RawTimelineValuesBuf(&plane_min);
+                init_RawTimelineValuesBuf(&plane_max);
+                const uint8_t c = (uint8_t)(ch - 3);
+                if (map_PlanarChannel(&planar, c, &plane) != 0 || prepare_AggregationMinMax(&plane, &plane_min, &plane_max, 800) != 0 ||
+                    aggregate_MinMax(&plane, &plane_min, &plane_max, 0, 0) != 0) {
+                    rc = -1;
+                }
+                for (uint32_t i = 0; rc == 0 && i < 800; ++i) {
+                    const size_t vb = plane_min.bytes_per_sample;
+                    if (memcmp(&plane_min.valueBuffer[i * vb], &in_min.valueBuffer[((size_t)i * ch + c) * vb], vb) != 0 ||
+                        memcmp(&plane_max.valueBuffer[i * vb], &in_max.valueBuffer[((size_t)i * ch + c) * vb], vb) != 0) {
+                        rc = -1;
+                    }
+                }
+                if (rc != 0) {
+                    fprintf(stderr, "%s min/max of a mapped plane differs from its channel (%u channels)\n", bename, ch);
+                    errors++;
+                }
+                free_RawTimelineValuesBuf(&plane_min);
+                free_RawTimelineValuesBuf(&plane_max);
+                free_RawTimelineValuesBuf(&planar);
+                free_RawTimelineValuesBuf(&back);
+            }
+            free_RawTimelineValuesBuf(&in_min);
+            free_RawTimelineValuesBuf(&in_max);
+        }
+        setBackend(1);
+        getBackendName(-1, &bename);
+        free_RawTimelineValuesBuf(&codec_in[0]);
+        free_RawTimelineValuesBuf(&codec_in[1]);
+    }
+
+    // Allocators: window resizes (prepare again in place) on pool backed buffers must stop reaching the heap after
+    // the first round and give the results of heap buffers; an arena hands out aligned scratch buffers until reset
+    {
+        TimelinePool pool;
+        init_TimelinePool(&pool);
+        RawTimelineValuesBuf heap_min, heap_max, heap_conv, pool_min, pool_max, pool_conv;
+        init_RawTimelineValuesBuf(&heap_min);
+        init_RawTimelineValuesBuf(&heap_max);
+        init_RawTimelineValuesBuf(&heap_conv);
+        init_RawTimelineValuesBuf(&pool_min);
+        init_RawTimelineValuesBuf(&pool_max);
+        init_RawTimelineValuesBuf(&pool_conv);
+        pool_min.allocator = pool_max.allocator = pool_conv.allocator = &pool.allocator;
+        const uint32_t widths[] = { 800, 1920, 640, 1920, 1280 };
+        const uint32_t rates[] = { 1200000, 48000, 1200000, 500000, 48000 };
+        uint64_t heap_after_first = 0;
+        for (int round = 0; round < 4; ++round) {
+            for (uint32_t w = 0; w < sizeof(widths) / sizeof(widths[0]); ++w) {
+                prepare_AggregationMinMax(&simd_input, &heap_min, &heap_max, widths[w]);
+                prepare_AggregationMinMax(&simd_input, &pool_min, &pool_max, widths[w]);
+                aggregate_MinMax(&simd_input, &heap_min, &heap_max, simd_input.nr_of_samples, 0);
+                aggregate_MinMax(&simd_input, &pool_min, &pool_max, simd_input.nr_of_samples, 0);
+                if (memcmp(heap_min.valueBuffer, pool_min.valueBuffer, widths[w] * heap_min.bytes_per_sample) != 0 ||
+                    memcmp(heap_max.valueBuffer, pool_max.valueBuffer, widths[w] * heap_max.bytes_per_sample) != 0) {
+                    fprintf(stderr, "Min/max into pool buffers differs (%u columns)\n", widths[w]);
+                    errors++;
+                }
+                if (prepare_SampleRateConversion(&simd_input, rates[w], &heap_conv) != 0 ||
+                    prepare_SampleRateConversion(&simd_input, rates[w], &pool_conv) != 0 ||
+                    convert_sample_rate(&simd_input, &heap_conv) != 0 || convert_sample_rate(&simd_input, &pool_conv) != 0 ||
+                    heap_conv.nr_of_samples != pool_conv.nr_of_samples ||
+                    memcmp(heap_conv.valueBuffer, pool_conv.valueBuffer, (size_t)heap_conv.nr_of_samples * heap_conv.bytes_per_sample) != 0) {
+                    fprintf(stderr, "Sample rate conversion into a pool buffer differs (%u Hz)\n", rates[w]);
+                    errors++;
+                }
+            }
+            // a closed and reopened display: everything goes back to the pool and comes out of it again
+            free_RawTimelineValuesBuf(&pool_min);
+            free_RawTimelineValuesBuf(&pool_max);
+            free_RawTimelineValuesBuf(&pool_conv);
+            if (round == 0) heap_after_first = pool.heap_allocations;
+        }
+        printf("Pool: %llu heap allocations, %llu reused blocks\n", (unsigned long long)pool.heap_allocations, (unsigned long long)pool.reused_allocations);
+        if (pool.heap_allocations != heap_after_first || pool.reused_allocations == 0) {
+            fprintf(stderr, "Pool reached the heap after the first round (%llu -> %llu allocations)\n",
+                    (unsigned long long)heap_after_first, (unsigned long long)pool.heap_allocations);
+            errors++;
+        }
+        free_RawTimelineValuesBuf(&heap_min);
+        free_RawTimelineValuesBuf(&heap_max);
+        free_RawTimelineValuesBuf(&heap_conv);
+        free_TimelinePool(&pool);
+
+        TimelineArena arena;
+        if (init_TimelineArena(&arena, 1u << 20) != 0) {
+            errors++;
+        } else {
+            size_t peak = 0;
+            for (int frame = 0; frame < 3; ++frame) {
+                RawTimelineValuesBuf scratch[4];
+                for (int k = 0; k < 4; ++k) {
+                    init_RawTimelineValuesBuf(&scratch[k]);
+                    scratch[k].allocator = &arena.allocator;
+                    // 24 byte samples ask for a 32 byte alignment, 160 byte ones are capped to a cache line
+                    alloc_RawTimelineValuesBuf(&scratch[k], 1000 + 333 * k, (k & 1) ? 80 : 8, 24, (k & 1) ? 160 : 24, TR_SIMD_sint24x8);
+                    if (((uintptr_t)scratch[k].valueBuffer & 31) != 0 ||
+                        ((k & 1) && ((uintptr_t)scratch[k].valueBuffer & 63) != 0)) {
+                        fprintf(stderr, "Arena buffer %d is misaligned\n", k);
+                        errors++;
+                    }
+                    memset(scratch[k].valueBuffer, k, scratch[k].buffer_size);
+                }
+                for (int k = 0; k < 4; ++k) {
+                    if (scratch[k].valueBuffer[scratch[k].buffer_size - 1] != k) {
+                        fprintf(stderr, "Arena buffers %d overlap\n", k);
+                        errors++;
+                    }
+                    free_RawTimelineValuesBuf(&scratch[k]);
+                }
+                if (frame > 0 && arena.used != peak) {
+                    fprintf(stderr, "Arena frame %d used %zu bytes instead of %zu\n", frame, arena.used, peak);
+                    errors++;
+                }
+                peak = arena.used;
+                reset_TimelineArena(&arena);
+            }
+            printf("Arena: %zu of %zu bytes used per frame\n", arena.peak, arena.size);
+            free_TimelineArena(&arena);
+        }
+    }
+
+    // Steady state: once prepared, CIC, polyphase and compressed min/max calls on pool backed outputs keep their
+    // working memory in the outputs and take nothing from the pool (nor the heap) on the next calls
+    {
+        TimelinePool pool;
+        init_TimelinePool(&pool);
+        PolyphaseFilterBank bank;
+        TimelineCompressedBuf packed;
+        RawTimelineValuesBuf cic_out, fir_out, packed_min, packed_max, first_min;
+        init_RawTimelineValuesBuf(&cic_out);
+        init_RawTimelineValuesBuf(&fir_out);
+        init_RawTimelineValuesBuf(&packed_min);
+        init_RawTimelineValuesBuf(&packed_max);
+        init_RawTimelineValuesBuf(&first_min);
+        cic_out.allocator = fir_out.allocator = packed_min.allocator = packed_max.allocator = &pool.allocator;
+        if (init_PolyphaseFilterBank(&bank, 1000000, 48000, 0, fir_out.allocator) != 0 || compress_RawTimelineValues(&simd_input, &packed) != 0) {
+            fprintf(stderr, "Failed to prepare the steady state test\n");
+            errors++;
+        } else {
+            uint64_t served = 0;
+            int rc = 0;
+            for (int round = 0; round < 3 && rc == 0; ++round) {
+                if (round == 0) {
+                    rc |= prepare_CicDecimation(&simd_input, 64, 4, 1, &cic_out);
+                    rc |= prepare_PolyphaseResampling(&simd_input, &bank, &fir_out);
+                    rc |= prepare_AggregationMinMax(&packed.layout, &packed_min, &packed_max, 1000);
+                }
+                rc |= convert_decimate_cic(&simd_input, &cic_out);
+                rc |= convert_sample_rate_polyphase(&simd_input, &bank, &fir_out);
+                rc |= aggregate_MinMax_compressed(&packed, &packed_min, &packed_max, packed.nr_of_samples - 1000, 123);
+                if (round == 0) {
+                    served = pool.heap_allocations + pool.reused_allocations;
+                    alloc_RawTimelineValuesBuf(&first_min, packed_min.nr_of_samples, packed_min.nr_of_channels, packed_min.bitwidth, 16, packed_min.value_type);
+                    memcpy(first_min.valueBuffer, packed_min.valueBuffer, first_min.buffer_size);
+                } else if (memcmp(first_min.valueBuffer, packed_min.valueBuffer, first_min.buffer_size) != 0) {
+                    fprintf(stderr, "Compressed min/max changed on a repeated call\n");
+                    errors++;
+                }
+            }
+            printf("Steady state: %llu pool blocks after the first call, %llu after three\n",
+                   (unsigned long long)served, (unsigned long long)(pool.heap_allocations + pool.reused_allocations));
+            if (rc != 0 || pool.heap_allocations + pool.reused_allocations != served) {
+                fprintf(stderr, "Prepared CIC / polyphase / compressed min/max calls allocated again (rc %d)\n", rc);
+                errors++;
+            }
+            free_TimelineCompressedBuf(&packed);
+        }
+        free_PolyphaseFilterBank(&bank);
+        free_RawTimelineValuesBuf(&cic_out);
+        free_RawTimelineValuesBuf(&fir_out);
+        free_RawTimelineValuesBuf(&packed_min);
+        free_RawTimelineValuesBuf(&packed_max);
+        free_RawTimelineValuesBuf(&first_min);
+        free_TimelinePool(&pool);
+    }
+    free_RawTimelineValuesBuf(&raw_min);
+    free_RawTimelineValuesBuf(&raw_max);
+    free_RawTimelineValuesBuf(&so_min);
+    free_RawTimelineValuesBuf(&so_max);
+    free_RawTimelineValuesBuf(&ring);
+
     free_RawTimelineValuesBuf(&simd_input);
     free_RawTimelineValuesBuf(&simd_output);
 
     free_RawTimelineValuesBuf(&buf);
     
-    return 0;
+    return (errors == 0) ? 0 : 1;
 }
\ No newline at end of file
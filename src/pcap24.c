@@ -10,8 +10,11 @@
     timeline database functions to be more efficient and easier to use, while we can also have a tool to visualize the
     ethernet traffic in a timeline view. The original problem of the pcap24.c file was to visualize an ethernet frame stream,
     which contains multiple 24 bit wide samples.
+    The pcap file is loaded incrementally by a background ingest thread, which parses only the packets appended to the
+    file and hands the decoded sample blocks to the render loop through a lock-free single-producer/single-consumer
+    queue. db_update (render thread) appends the published blocks to the timeline buffers, so a slow parse never stalls
+    input handling or drawing, and the timeline buffers are only touched by the render thread.
     TODO:
-     - pcap file partial loading, or continuous loading. Right now, the db_update reads the whole file, which is not efficient for large files.
      - navigation is very basic, we should implement a better navigation system, like zooming, panning, and following the current time.
 */
 #include <SDL.h>
@@ -22,6 +25,7 @@
 #include <stdio.h>
 #include <pcap.h>
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <limits.h>
 #include "timelinedb.h"
 #include "timelinedb_util.h"
@@ -29,7 +33,7 @@
 #define MAXBUFF 500
 #define MAX_TIMELINE_CHANNELS 80
 #define MAX_TIMELINE_BUFS (MAX_TIMELINE_CHANNELS >> 3) // 8 channels per buffer
-#define MAX_TIMELINE_SAMPLES (1000 * 1000)
+#define MAX_TIMELINE_SAMPLES (1000 * 1000) // ring capacity, older samples are dropped
 #define DELAY_SCREEN_REFRESH (1000 / 30 )
 
 #define MARGIN_TOP 100
@@ -68,8 +72,64 @@ SignalCurvesView g_signal_curves_view = {
     .right_margin = MARGIN_RIGHT // Right margin for scrollbar or other UI elements
 };
 
+/*
+    Persistent ingest cursor, so that every poll parses only the packets appended to the file.
+    file_offset belongs to the ingest thread, the rest to the render thread (updated from the published blocks).
+*/
+typedef struct {
+    long file_offset;           // byte offset just after the last complete pcap record
+    uint64_t sample_idx;        // absolute index of the next sample appended to g_timeline_bufs (does not wrap on long captures)
+    struct timeval first_ts;
+    struct timeval last_ts;
+    int got_first_ts;
+} PcapIngestCursor;
+
+/*
+    Decoded sample blocks from the ingest thread to the render loop, a single-producer/single-consumer ring of slots.
+    The ingest thread fills blocks[head % nr_of_slots], then publishes it by a release store of head + 1.
+    The render thread loads head with acquire (the block contents are visible from then on), appends the block and
+    releases the slot by a release store of tail + 1. Neither side takes a lock, a full queue makes the ingest wait.
+    A slot is one flat array: every packet is decoded straight into it (pcap_next_ex reuses its packet buffer, so it
+    is the only copy), the rows of timeline buffer b follow each other from data + b * INGEST_BLOCK_STRIDE.
+    The queue holds INGEST_QUEUE_MS of the capture at the nominal g_sample_rate, rounded up to a power of two slots
+    (head % nr_of_slots stays continuous when head wraps).
+*/
+#define INGEST_BATCH 256
+#define INGEST_ROW_BYTES 16     // one TR_SIMD_sint16x8 row
+#define INGEST_BLOCK_STRIDE (INGEST_BATCH * INGEST_ROW_BYTES)
+#define INGEST_QUEUE_MS 250
+#define INGEST_POLL_MS 10
+typedef struct {
+    uint8_t *data;              // MAX_TIMELINE_BUFS runs of INGEST_BATCH rows
+    int count;                  // samples in the block
+    int decoded_channels;       // channels decoded per packet, the runs past (decoded_channels + 7) / 8 are not written
+    int num_channels;           // channels of the stream when the block was decoded
+    int reset;                  // the capture was restarted: the render thread clears the timeline first
+    struct timeval first_ts;
+    struct timeval last_ts;
+} PcapIngestBlock;
+
+typedef struct {
+    PcapIngestBlock *blocks;
+    uint8_t *data;              // the blocks of all slots, one allocation
+    uint32_t nr_of_slots;       // power of two
+    uint32_t head;              // blocks published, written by the ingest thread only
+    uint32_t tail;              // blocks consumed, written by the render thread only
+    int stop;
+} PcapIngestQueue;
+
+/* The slot being filled by the ingest thread. */
+typedef struct {
+    PcapIngestBlock *block;     // acquired slot, NULL while no packet is pending
+    int stream_channels;        // channels of the stream: the minimum over the packets so far
+} PcapIngestBatch;
+
 pcap_t *g_pcap_handle;
 const char* g_pcap_filename = NULL;
+PcapIngestCursor g_ingest;
+PcapIngestBatch g_ingest_batch;
+PcapIngestQueue g_ingest_queue;
+SDL_Thread *g_ingest_thread = NULL;
 
 int g_screen_w = 800;
 int g_screen_h = 600;
@@ -84,7 +144,8 @@ uint16_t g_first_visible_channel = 0; // First visible channel index
 
 // Global variables for zoom/pan/follow
 float g_zoom_level = 1.0f; // 1.0 means full window
-int g_view_offset = 0;
+uint64_t g_view_offset = 0; // absolute index of the first visible sample
+int g_view_samples = 0; // number of samples in the visible window, starting at g_view_offset
 int g_follow_mode = 1;
 bool g_aggregation_changed = false;
 bool g_visible_channels_changed = false;
@@ -92,17 +153,23 @@ bool g_visible_channels_changed = false;
 RawTimelineValuesBuf g_timeline_bufs[MAX_TIMELINE_BUFS];
 RawTimelineValuesBuf g_timeline_min[MAX_TIMELINE_BUFS];
 RawTimelineValuesBuf g_timeline_max[MAX_TIMELINE_BUFS];
+TimelinePool g_display_pool; // min/max columns: resizing the window recycles their blocks instead of the heap
 TimelineDB g_timeline_db;
 TimelineEvent g_timeline_events[MAX_TIMELINE_CHANNELS];
 
 float g_sample_rate = 48000.0f; //move to buf later.
 uint32_t g_total_valid_samples = 0; // Total valid samples in the current buffer, move to buf later.
+uint64_t g_first_valid_sample = 0; // absolute index of the oldest sample still kept in the ring buffers
 
-uint32_t g_count_eth_ok = 0;
+uint32_t g_count_eth_ok = 0;       // packet counters, written by the ingest thread
 uint32_t g_count_eth_drop_mac = 0;
 uint32_t g_count_eth_drop_unk = 0;
 
-void db_init() {
+/**
+ * Sets up the timeline buffers and the ingest queue.
+ * @return 0 on success, -1 if the ingest queue can not be allocated.
+ */
+int db_init() {
     g_signal_curves_view.start_y = MARGIN_TOP;
     g_signal_curves_view.label_width = LABEL_WIDTH; // Width for channel labels
     g_signal_curves_view.right_margin = MARGIN_RIGHT; // Right margin for scrollbar or other UI elements
@@ -142,21 +209,51 @@ void db_init() {
     g_timeline_db.events = g_timeline_events;
     g_timeline_db.count = MAX_TIMELINE_CHANNELS;
     
+    init_TimelinePool(&g_display_pool);
     for (int i = 0; i < MAX_TIMELINE_BUFS; i++) {
         init_RawTimelineValuesBuf(&g_timeline_bufs[i]);
         init_RawTimelineValuesBuf(&g_timeline_min[i]);
         init_RawTimelineValuesBuf(&g_timeline_max[i]);
-        alloc_RawTimelineValuesBuf(&g_timeline_bufs[i], MAX_TIMELINE_SAMPLES, 8, 16, 16, TR_SIMD_sint16x8);
+        g_timeline_min[i].allocator = &g_display_pool.allocator;
+        g_timeline_max[i].allocator = &g_display_pool.allocator;
+        alloc_RingTimelineValuesBuf(&g_timeline_bufs[i], MAX_TIMELINE_SAMPLES, 8, 16, 16, TR_SIMD_sint16x8);
+        init_MinMaxPyramid(&g_timeline_bufs[i], 0);
         alloc_RawTimelineValuesBuf(&g_timeline_min[i], g_screen_w, 8, 16, 16, TR_SIMD_sint16x8);
         alloc_RawTimelineValuesBuf(&g_timeline_max[i], g_screen_w, 8, 16, 16, TR_SIMD_sint16x8);
     }
+    const uint32_t needed = (uint32_t)(g_sample_rate * INGEST_QUEUE_MS / 1000.0f) / INGEST_BATCH + 1;
+    uint32_t slots = 2;
+    while (slots < needed) slots <<= 1;
+    const size_t slot_bytes = (size_t)MAX_TIMELINE_BUFS * INGEST_BLOCK_STRIDE;
+    g_ingest_queue.blocks = (PcapIngestBlock*)calloc(slots, sizeof(PcapIngestBlock));
+    g_ingest_queue.data = (uint8_t*)malloc(slots * slot_bytes);
+    if (!g_ingest_queue.blocks || !g_ingest_queue.data) {
+        fprintf(stderr, "Failed to allocate the ingest queue (%u slots)\n", slots);
+        return -1;
+    }
+    for (uint32_t s = 0; s < slots; s++) {
+        g_ingest_queue.blocks[s].data = &g_ingest_queue.data[s * slot_bytes];
+    }
+    g_ingest_queue.nr_of_slots = slots;
+    g_ingest_queue.head = 0;
+    g_ingest_queue.tail = 0;
+    g_ingest_batch.block = NULL;
+    g_ingest_batch.stream_channels = MAX_TIMELINE_CHANNELS;
+    init_TimelineWorkers(0); // one thread per CPU for the frame aggregation
+    return 0;
 }
 void db_free() {
+    free_TimelineWorkers();
+    free(g_ingest_queue.blocks);
+    free(g_ingest_queue.data);
+    g_ingest_queue.blocks = NULL;
+    g_ingest_queue.data = NULL;
     for (int i = 0; i < MAX_TIMELINE_BUFS; i++) {
         free_RawTimelineValuesBuf(&g_timeline_bufs[i]);
         free_RawTimelineValuesBuf(&g_timeline_min[i]);
         free_RawTimelineValuesBuf(&g_timeline_max[i]);
     }
+    free_TimelinePool(&g_display_pool);
     for (int i = 0; i < MAX_TIMELINE_CHANNELS; i++) {
         free(g_timeline_events[i].name);
         free(g_timeline_events[i].description);
@@ -164,45 +261,81 @@ void db_free() {
 }
 
 /**
- * Parses the Ethernet payload for a single sample and stores it in the appropriate buffer.
+ * Ingest thread: waits for a free slot of the queue (the render thread is behind by nr_of_slots blocks).
+ * @return The slot to fill, NULL if the thread is asked to stop meanwhile.
+ */
+PcapIngestBlock *db_ingest_acquire_block() {
+    uint32_t head = g_ingest_queue.head; // only this thread writes head
+    while (head - __atomic_load_n(&g_ingest_queue.tail, __ATOMIC_ACQUIRE) >= g_ingest_queue.nr_of_slots) {
+        if (__atomic_load_n(&g_ingest_queue.stop, __ATOMIC_RELAXED)) {
+            return NULL;
+        }
+        SDL_Delay(1);
+    }
+    return &g_ingest_queue.blocks[head % g_ingest_queue.nr_of_slots];
+}
+
+/**
+ * Ingest thread: makes the filled slot visible to the render thread (release: the block is written before head moves).
+ */
+void db_ingest_publish_block() {
+    __atomic_store_n(&g_ingest_queue.head, g_ingest_queue.head + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Publishes the slot being filled, if any.
+ */
+void db_ingest_flush() {
+    PcapIngestBlock *block = g_ingest_batch.block;
+    if (!block) {
+        return;
+    }
+    block->num_channels = g_ingest_batch.stream_channels;
+    block->reset = 0;
+    db_ingest_publish_block();
+    g_ingest_batch.block = NULL;
+}
+
+/**
+ * Decodes the Ethernet payload of a single sample (big-endian 24-bit channels) into the slot being filled.
+ * A full slot, or a packet with a different channel count, publishes the slot.
  * @param payload Pointer to the Ethernet payload data.
  * @param num_channels Number of channels in the sample.
- * @param sample_idx Index of the sample to store in the buffer.
- * @return The next sample index after storing the current sample.
+ * @param ts Capture timestamp of the packet.
  */
-int parse_ethPayload1(const u_char *payload, int num_channels, int sample_idx) {
-    for (int ch = 0; ch < num_channels; ch++) {
-        int buf_idx = ch / 8;
-        int buf_ch = ch % 8;
-        RawTimelineValuesBuf* buf = &g_timeline_bufs[buf_idx];
-        int16_t* data = (int16_t*)buf->valueBuffer;
-        if (!data) {
-            fprintf(stderr, "Buffer not allocated for channel %d in buffer %d\n", ch, buf_idx);
-            continue;
-        }
-        int offset = ch * 3;
-        int32_t val = (int32_t)((payload[offset] << 16) | (payload[offset + 1] << 8) | payload[offset + 2]);
-        if (val & 0x00800000ul) val |= ~0x00FFFFFFul; // Sign extend
-        int16_t sval = (int16_t)(val >> 8); // Convert to 16-bit signed
-        // store the sample in the buffer
-        if (sample_idx < MAX_TIMELINE_SAMPLES) {
-            data[sample_idx * 8 + buf_ch] = sval;
-        }
+void db_ingest_payload(const u_char *payload, int num_channels, struct timeval ts) {
+    if (num_channels > MAX_TIMELINE_CHANNELS) num_channels = MAX_TIMELINE_CHANNELS;
+    PcapIngestBlock *block = g_ingest_batch.block;
+    if (block && block->decoded_channels != num_channels) {
+        db_ingest_flush();
+        block = NULL;
     }
-    for (int idx = 0 ; idx < num_channels/8; idx++) {
-        RawTimelineValuesBuf* buf = &g_timeline_bufs[idx];
-        if (sample_idx < MAX_TIMELINE_SAMPLES) {
-            buf->nr_of_samples = sample_idx + 1;
-        }else {
-            buf->nr_of_samples = MAX_TIMELINE_SAMPLES;
+    if (!block) {
+        block = db_ingest_acquire_block();
+        if (!block) {
+            return; // stopping
         }
+        block->count = 0;
+        block->decoded_channels = num_channels;
+        block->first_ts = ts;
+        g_ingest_batch.block = block;
+    }
+    if (decode_BE24_Samples(payload, num_channels, TR_SIMD_sint16x8, &block->data[block->count * INGEST_ROW_BYTES], INGEST_BLOCK_STRIDE) != 0) {
+        fprintf(stderr, "Failed to decode a sample of %d channels for the timeline buffers\n", num_channels);
+        return;
+    }
+    block->last_ts = ts;
+    if (++block->count == INGEST_BATCH) {
+        db_ingest_flush();
     }
-    return sample_idx + 1; // Return next sample index
 }
 
-void db_update(Uint32 timestamp){
-    (void)timestamp; // Not in use now
-
+/**
+ * Opens the pcap file (once) and resets the ingest cursor to the first packet.
+ * The render thread is told to drop the samples of the previous capture by a reset block.
+ * @return 0 on success, -1 if the file can not be opened.
+ */
+int db_ingest_open() {
     if (g_pcap_handle) {
         pcap_close(g_pcap_handle);
         g_pcap_handle = NULL;
@@ -211,31 +344,56 @@ void db_update(Uint32 timestamp){
     g_pcap_handle = pcap_open_offline(g_pcap_filename, errbuf);
     if (!g_pcap_handle) {
         fprintf(stderr, "Failed to open pcap file: %s\n", errbuf);
-        return;
+        return -1;
+    }
+    g_ingest_batch.block = NULL; // a pending slot was not published, the reset block reuses it
+    g_ingest_batch.stream_channels = MAX_TIMELINE_CHANNELS;
+    // The global pcap header was consumed by pcap_open_offline, the first record starts here.
+    g_ingest.file_offset = ftell(pcap_file(g_pcap_handle));
+    PcapIngestBlock *block = db_ingest_acquire_block();
+    if (block) {
+        block->count = 0;
+        block->decoded_channels = 0;
+        block->num_channels = MAX_TIMELINE_CHANNELS;
+        block->reset = 1;
+        db_ingest_publish_block();
+    }
+    return 0;
+}
+
+/**
+ * Parses only the packets appended to the pcap file since the previous call.
+ * The pcap handle is kept open, the stream is rewound to the end of the last complete record,
+ * so a half-written packet at the end of the file is simply retried on the next poll. Runs on the ingest thread.
+ * @return Number of new samples published to the render thread, or -1 on error.
+ */
+int db_ingest_tail() {
+    if (!g_pcap_handle && db_ingest_open() != 0) {
+        return -1;
+    }
+    FILE *fp = pcap_file(g_pcap_handle);
+    struct stat st;
+    if (fstat(fileno(fp), &st) == 0 && st.st_size < g_ingest.file_offset) {
+        // The capture was truncated or replaced, start over.
+        if (db_ingest_open() != 0) return -1;
+        fp = pcap_file(g_pcap_handle);
+    }
+    clearerr(fp);
+    if (fseek(fp, g_ingest.file_offset, SEEK_SET) != 0) {
+        return -1;
     }
 
     // Parameters
     int skip_bytes = 14; // Ethernet header, set it for the first data index!
     const int bytes_per_channel = 3;    // 24 bit/channel
 
-    // Buffer init
-    for (int b = 0; b < MAX_TIMELINE_BUFS; b++) {
-        RawTimelineValuesBuf* buf = &g_timeline_bufs[b];
-        //int16_t* data = (int16_t*)buf->valueBuffer;
-        buf->nr_of_samples = 0;
-    }
-
     struct pcap_pkthdr* header;
     const u_char* pkt_data;
-    int sample_idx = 0;
+    int new_samples = 0;
 
-    // Track first and last timestamps
-    struct timeval first_ts = {0};
-    struct timeval last_ts = {0};
-    int got_first_ts = 0;
-
-    // iterate through a pcap file, while there are data and space in the buffer
+    // iterate through the new part of the pcap file
     while (pcap_next_ex(g_pcap_handle, &header, &pkt_data) == 1) {
+        g_ingest.file_offset = ftell(fp);
         // DSTMAC ellenőrzése
         int is_filter_ok = 1;
         for (int i = 0; i < 6; i++) {
@@ -252,7 +410,7 @@ void db_update(Uint32 timestamp){
             }
         }
         if (!is_filter_ok) {
-            g_count_eth_drop_mac++;
+            __atomic_fetch_add(&g_count_eth_drop_mac, 1, __ATOMIC_RELAXED);
             continue; // skip non-broadcast packets
         }
 
@@ -264,7 +422,7 @@ void db_update(Uint32 timestamp){
             skip_bytes = 14;
         break;
         default:
-            g_count_eth_drop_unk++;
+            __atomic_fetch_add(&g_count_eth_drop_unk, 1, __ATOMIC_RELAXED);
             fprintf(stderr, "Unknown Ethertype: 0x%04X\n", ethertype);
             is_filter_ok = 0;
         break;
@@ -278,25 +436,98 @@ void db_update(Uint32 timestamp){
         if (detected_channels <= 0) {
             continue; // no valid sample data
         }
-        g_count_eth_ok++;
-        // Update global number of channels if needed
-        if (g_number_of_channels == 0 || g_number_of_channels > detected_channels) {
-            g_number_of_channels = detected_channels;
+        __atomic_fetch_add(&g_count_eth_ok, 1, __ATOMIC_RELAXED);
+        // Update the number of channels of the stream if needed (published with the blocks)
+        if (g_ingest_batch.stream_channels == 0 || g_ingest_batch.stream_channels > detected_channels) {
+            g_ingest_batch.stream_channels = detected_channels;
         }
-        // Use the minimum between g_number_of_channels and detected_channels for this packet
-        int use_channels = g_number_of_channels;
+        // Use the minimum between the stream channels and detected_channels for this packet
+        int use_channels = g_ingest_batch.stream_channels;
         if (use_channels > detected_channels) use_channels = detected_channels;
 
         const u_char* payload = pkt_data + skip_bytes;
-        // read the sample data from the payload
-        sample_idx = parse_ethPayload1(payload, use_channels, sample_idx);
-        // Track first and last timestamps
-        if (!got_first_ts) {
-            first_ts = header->ts;
-            got_first_ts = 1;
+        // decoded into the queue slot, published per INGEST_BATCH samples
+        db_ingest_payload(payload, use_channels, header->ts);
+        new_samples++;
+    }
+    db_ingest_flush();
+    return new_samples;
+}
+
+/**
+ * Ingest thread: polls the pcap file for appended packets until db_ingest_stop.
+ */
+int db_ingest_thread(void *data) {
+    (void)data;
+    while (!__atomic_load_n(&g_ingest_queue.stop, __ATOMIC_RELAXED)) {
+        if (db_ingest_tail() <= 0) {
+            SDL_Delay(INGEST_POLL_MS); // nothing new (or the file is not there yet)
+        }
+    }
+    return 0;
+}
+
+void db_ingest_start() {
+    __atomic_store_n(&g_ingest_queue.stop, 0, __ATOMIC_RELAXED);
+    g_ingest_thread = SDL_CreateThread(db_ingest_thread, "pcap ingest", NULL);
+    if (!g_ingest_thread) {
+        fprintf(stderr, "Failed to start the ingest thread: %s\n", SDL_GetError());
+    }
+}
+
+void db_ingest_stop() {
+    __atomic_store_n(&g_ingest_queue.stop, 1, __ATOMIC_RELAXED);
+    if (g_ingest_thread) {
+        SDL_WaitThread(g_ingest_thread, NULL);
+        g_ingest_thread = NULL;
+    }
+}
+
+/**
+ * Render thread: appends every block published by the ingest thread to the timeline buffers.
+ * @return Number of new samples, or -1 if the capture was restarted (the timeline was cleared).
+ */
+int db_ingest_consume() {
+    int new_samples = 0;
+    uint32_t tail = g_ingest_queue.tail; // only this thread writes tail
+    uint32_t head = __atomic_load_n(&g_ingest_queue.head, __ATOMIC_ACQUIRE);
+    for (; tail != head; tail++) {
+        PcapIngestBlock *block = &g_ingest_queue.blocks[tail % g_ingest_queue.nr_of_slots];
+        if (block->reset) {
+            g_ingest.sample_idx = 0;
+            g_ingest.got_first_ts = 0;
+            g_number_of_channels = MAX_TIMELINE_CHANNELS;
+            for (int b = 0; b < MAX_TIMELINE_BUFS; b++) {
+                clear_RawTimelineValuesBuf(&g_timeline_bufs[b]);
+            }
+            new_samples = -1;
+        } else {
+            const int nr_of_runs = (block->decoded_channels + 7) / 8;
+            for (int b = 0; b < nr_of_runs && b < MAX_TIMELINE_BUFS; b++) {
+                append_RawTimelineValues(&g_timeline_bufs[b], &block->data[b * INGEST_BLOCK_STRIDE], block->count);
+            }
+            g_ingest.sample_idx += block->count;
+            if (!g_ingest.got_first_ts) {
+                g_ingest.first_ts = block->first_ts;
+                g_ingest.got_first_ts = 1;
+            }
+            g_ingest.last_ts = block->last_ts;
+            if (new_samples >= 0) new_samples += block->count;
+        }
+        if (g_number_of_channels > block->num_channels) {
+            g_number_of_channels = block->num_channels;
         }
-        last_ts = header->ts;
-        if (sample_idx >= MAX_TIMELINE_SAMPLES) break;
+        __atomic_store_n(&g_ingest_queue.tail, tail + 1, __ATOMIC_RELEASE); // the slot can be refilled
+    }
+    return new_samples;
+}
+
+void db_update(Uint32 timestamp){
+    (void)timestamp; // Not in use now
+
+    int new_samples = db_ingest_consume();
+    if (new_samples < 0) {
+        new_samples = g_timeline_bufs[0].nr_of_samples; // restarted capture: everything is new
     }
     if (g_number_of_channels < g_number_of_visible_channels) {
         g_number_of_visible_channels = g_number_of_channels;
@@ -304,61 +535,50 @@ void db_update(Uint32 timestamp){
     if (g_first_visible_channel + g_number_of_visible_channels > g_number_of_channels) {
         g_first_visible_channel = g_number_of_channels - g_number_of_visible_channels;
     }
-    // Apply zoom/pan/follow: select visible sample range
-    int total_samples = sample_idx;
+    // Apply zoom/pan/follow: select visible sample range within the samples kept by the ring buffers
+    int total_samples = g_timeline_bufs[0].nr_of_samples;
+    uint64_t first_sample = g_ingest.sample_idx - total_samples; // older samples were dropped by the ring
     g_total_valid_samples = total_samples;
+    g_first_valid_sample = first_sample;
     int visible_samples = (int)(total_samples / g_zoom_level);
+    if (visible_samples > total_samples) visible_samples = total_samples;
     int start_sample = 0;
     if (g_follow_mode) {
         start_sample = total_samples - visible_samples;
-        if (start_sample < 0) start_sample = 0;
+    } else {
+        // the offset may point before the oldest kept sample, the window is clamped into the ring
+        uint64_t rel = (g_view_offset > first_sample) ? g_view_offset - first_sample : 0;
+        start_sample = (rel < (uint64_t)total_samples) ? (int)rel : total_samples;
         if (start_sample + visible_samples > total_samples) {
             start_sample = total_samples - visible_samples;
-            if (start_sample < 0) start_sample = 0;
         }
-        g_view_offset = start_sample; // Update view offset to match follow mode
-    } else {
-        start_sample = g_view_offset;
     }
+    if (start_sample < 0) start_sample = 0;
+    // The samples stay in place, the visible window is passed to the aggregation as a view, nothing is copied.
+    g_view_offset = first_sample + start_sample;
+    g_view_samples = visible_samples;
 
+    if (new_samples == 0) {
+        return; // timing information did not change
+    }
+    // Fold the new samples into the min/max pyramids, used by aggregate_MinMax when zoomed out
+    for (int b = 0; b < MAX_TIMELINE_BUFS; b++) {
+        update_MinMaxPyramid(&g_timeline_bufs[b]);
+    }
     // After reading packets, compute total_time_sec for each buffer.
     double total_time_sec = 0.0;
-    int sample_count = sample_idx;
-    if (got_first_ts && sample_count > 1) {
-        total_time_sec = (last_ts.tv_sec - first_ts.tv_sec) + (last_ts.tv_usec - first_ts.tv_usec) / 1e6;
-    } else if (got_first_ts && sample_count == 1) {
-        total_time_sec = 0.0;
+    uint64_t sample_count = g_ingest.sample_idx;
+    if (g_ingest.got_first_ts && sample_count > 1) {
+        total_time_sec = (g_ingest.last_ts.tv_sec - g_ingest.first_ts.tv_sec) + (g_ingest.last_ts.tv_usec - g_ingest.first_ts.tv_usec) / 1e6;
     }
     g_sample_rate = (float)sample_count / total_time_sec; // Update sample rate based on actual samples read
 
     for (int b = 0; b < MAX_TIMELINE_BUFS; b++) {
         RawTimelineValuesBuf* buf = &g_timeline_bufs[b];
-        buf->total_time_sec = total_time_sec;
+        buf->total_time_sec = total_time_sec * total_samples / sample_count; // only the samples kept by the ring
         buf->time_step = (uint32_t)(total_time_sec * 1000000000.0 / sample_count); // in microseconds
         buf->time_exponent = -9; // microseconds
     }
-
-    // For each buffer, copy only the visible samples into the buffer's valueBuffer (in-place, so that aggregation uses only visible samples)
-    for (int b = 0; b < MAX_TIMELINE_BUFS; b++) {
-        RawTimelineValuesBuf* buf = &g_timeline_bufs[b];
-        int16_t* data = (int16_t*)buf->valueBuffer;
-        if (buf->nr_of_samples > 0) {
-            int nsamp = buf->nr_of_samples;
-            int nchan = buf->nr_of_channels;
-            int ncopy = visible_samples;
-            if (start_sample + ncopy > nsamp) ncopy = nsamp - start_sample;
-            if (ncopy < 0) ncopy = 0;
-            if (ncopy > 0 && (start_sample > 0 || ncopy < nsamp)) {
-                // Move only visible samples to the front of the buffer
-                for (int i = 0; i < ncopy; ++i) {
-                    for (int ch = 0; ch < nchan; ++ch) {
-                        data[i * nchan + ch] = data[(start_sample + i) * nchan + ch];
-                    }
-                }
-                buf->nr_of_samples = ncopy;
-            }
-        }
-    }
 }
 
 void init_fonts() {
@@ -482,13 +702,14 @@ void draw_time_label(SDL_Renderer *renderer, int x, int y, const char* label) {
 }
 
 void draw_timeline_overview(SDL_Renderer *renderer, const RawTimelineValuesBuf *buf, RawTimelineValuesBuf *aggr) {
-    (void)buf; // Unused, we use aggr for drawing
+    (void)buf; // Unused, the view window is taken from g_view_offset/g_view_samples
+    (void)aggr;
     const int bar_height = 8;
     const int bar_y = 50 - bar_height - 2;
 
     uint32_t total_samples = g_total_valid_samples;//buf->nr_of_samples;
-    uint32_t view_offset = g_view_offset;
-    uint32_t view_samples = aggr->nr_of_samples;
+    uint32_t view_offset = g_view_offset - g_first_valid_sample;
+    uint32_t view_samples = g_view_samples;
 
     float left_ratio = (float)view_offset / total_samples;
     float middle_ratio = (float)view_samples / total_samples;
@@ -526,7 +747,6 @@ void draw_time_axis(SDL_Renderer *renderer, Uint32 timestamp) {
     
     // Use the first buffer as reference
     RawTimelineValuesBuf* ref_buf = g_signal_curves[0].buf;
-    RawTimelineValuesBuf* ref_buf_min = g_signal_curves[0].min_buf;
 
     // How many original samples are visible on-screen?
     uint32_t total_samples = 0;
@@ -536,16 +756,14 @@ void draw_time_axis(SDL_Renderer *renderer, Uint32 timestamp) {
             total_samples = sampleshere;
     }
 
-    // Estimate the visible sample range (if following, offset is at the end)
-    int visible_samples = (int)( ref_buf_min->nr_of_samples / g_zoom_level);
-    int inOffset = (int)(g_view_offset / g_zoom_level);
+    // The visible sample range is selected by db_update (if following, offset is at the end)
+    int visible_samples = g_view_samples;
     if (total_samples & 0x80000000ul) {
         fprintf(stderr, "Error: Total samples number can not be indexed on signed int.\n");
         return;
     }
 
-    int start_sample = g_follow_mode ? ((int)total_samples - visible_samples) : inOffset;
-    if (start_sample < 0) start_sample = 0;
+    uint64_t start_sample = g_view_offset;
     // Each pixel represents how many samples?
     float samples_per_pixel = (visible_samples > 0) ? (float)visible_samples / plot_area_w : 1.0f;
     float pixels_per_sample = (visible_samples > 0) ? (float)plot_area_w / visible_samples : 1.0f;
@@ -576,7 +794,7 @@ found_spacing:;
     char label[64];
     snprintf(label, sizeof(label), "%.3f sec", time_ms);
     draw_time_label(renderer, label_width/2, 0, label);
-    snprintf(label, sizeof(label), "%d sample", start_sample);
+    snprintf(label, sizeof(label), "%llu sample", (unsigned long long)start_sample);
     draw_time_label(renderer, label_width/2, 16, label);
     double srate = 0;
     const char* srate_unit = "Hz";
@@ -588,11 +806,11 @@ found_spacing:;
     int show_ms = (g_sample_rate > 10.0f && samples_per_pixel < g_sample_rate/1000.0f);
 
     // Compute the first visible tick (aligned to tick_spacing_samples)
-    int first_tick_sample = ((start_sample + tick_spacing_samples - 1) / tick_spacing_samples) * tick_spacing_samples;
-    int last_visible_sample = start_sample + visible_samples;
+    uint64_t first_tick_sample = ((start_sample + tick_spacing_samples - 1) / tick_spacing_samples) * tick_spacing_samples;
+    uint64_t last_visible_sample = start_sample + visible_samples;
 
     // Draw ticks and labels
-    for (int tick_sample = first_tick_sample; tick_sample <= last_visible_sample; tick_sample += tick_spacing_samples) {
+    for (uint64_t tick_sample = first_tick_sample; tick_sample <= last_visible_sample; tick_sample += tick_spacing_samples) {
         int px = label_width + (int)((tick_sample - start_sample) * pixels_per_sample);
         if (px >= g_screen_w - right_margin) break;
         // Major tick every N ticks
@@ -630,7 +848,7 @@ void draw_curves(SDL_Renderer* renderer) {
 }
 
 void realloc_RawTimelineValuesBufs(RawTimelineValuesBuf *buf, uint32_t new_w) {
-    free_RawTimelineValuesBuf(buf);
+    // keeps the allocation when the window got narrower, a wider one gets a block from the pool
     alloc_RawTimelineValuesBuf(buf, new_w, // 8, 16, 16, TR_SIMD_sint16x8);
         buf->nr_of_channels, buf->bitwidth, buf->bytes_per_sample, buf->value_type);
 }
@@ -643,7 +861,7 @@ void screen_update(Uint32 timestamp, SDL_Renderer* renderer) {
         for (int i = 0; i < MAX_TIMELINE_BUFS; i++) {
             realloc_RawTimelineValuesBufs(&g_timeline_min[i], g_screen_w);
             realloc_RawTimelineValuesBufs(&g_timeline_max[i], g_screen_w);
-            prepare_AggregationMinMax(&g_timeline_bufs[i], &g_timeline_min[0], &g_timeline_max[0], g_screen_w);
+            prepare_AggregationMinMax(&g_timeline_bufs[i], &g_timeline_min[i], &g_timeline_max[i], g_screen_w);
         }
         g_signal_curves_view.height = g_screen_h - g_signal_curves_view.start_y - 50; // 50px for bottom margin
     }
@@ -657,10 +875,9 @@ void screen_update(Uint32 timestamp, SDL_Renderer* renderer) {
             g_signal_curves[idx].scale = (float)h / 65536.0f; // Scale to fit in height
         }     
     }
-    // Dynamic aggregation: aggregation width depends on zoom level
-    int agg_samples = g_screen_w;
-    int inSamples = (int)(agg_samples / g_zoom_level);
-    int inOffset = (int)(g_view_offset / g_zoom_level);
+    // Dynamic aggregation: the visible window (selected by zoom/pan/follow) is reduced to the screen width
+    int inSamples = g_view_samples;
+    int inOffset = g_view_offset - g_first_valid_sample;
     double window_time_sec = g_timeline_bufs[0].total_time_sec / g_zoom_level;
     int exp= g_timeline_bufs[0].time_exponent;
     int tsteps = g_timeline_bufs[0].time_step;
@@ -670,8 +887,13 @@ void screen_update(Uint32 timestamp, SDL_Renderer* renderer) {
         if (exp < -12) exp = -12;
         tsteps = (int)round(tstep * pow(10, -exp));
     }
+    // all buffers of the frame in one call, the columns are spread over the library's worker threads
+    RawTimelineValuesView views[MAX_TIMELINE_BUFS];
+    for (int i = 0; i < MAX_TIMELINE_BUFS; i++) {
+        make_RawTimelineValuesView(&g_timeline_bufs[i], inOffset, inSamples, &views[i]);
+    }
+    aggregate_MinMax_parallel(views, g_timeline_min, g_timeline_max, MAX_TIMELINE_BUFS);
     for (int i = 0; i < MAX_TIMELINE_BUFS; i++) {
-        aggregate_MinMax(&g_timeline_bufs[i], &g_timeline_min[i], &g_timeline_max[i], inSamples, inOffset);
         g_timeline_min[i].total_time_sec = window_time_sec;
         g_timeline_min[i].time_step = tsteps;
         g_timeline_min[i].time_exponent = exp;
@@ -716,8 +938,8 @@ void processWheel(int dy, bool zoom, int mouse_x) {
             if (g_zoom_level < 0.0001f) g_zoom_level = 0.0001f;
             g_aggregation_changed = true;
         } else {
-            g_view_offset += dy * 1000.0 * g_zoom_level; // Adjust the offset based on zoom level
-            if (g_view_offset < 0) g_view_offset = 0;
+            int64_t delta = (int64_t)(dy * 1000.0 * g_zoom_level); // Adjust the offset based on zoom level
+            g_view_offset = (delta < 0 && (uint64_t)-delta > g_view_offset) ? 0 : g_view_offset + delta;
             g_follow_mode = 0;
             g_aggregation_changed = true;
         }
@@ -759,7 +981,10 @@ int main(int argc, char *argv[]) {
     const char * bename= NULL;
     getBackendName(-1, &bename);
     printf("%s\n", bename);
-    db_init();
+    if (db_init() != 0) {
+        return 1;
+    }
+    db_ingest_start();
     db_update(now);
     screen_update(now, renderer);
 
@@ -808,7 +1033,8 @@ int main(int argc, char *argv[]) {
         }
 
     }
-    pcap_close(g_pcap_handle);
+    db_ingest_stop();
+    if (g_pcap_handle) pcap_close(g_pcap_handle);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     free_fonts(); 
@@ -11,25 +11,54 @@
 #include <math.h>
 #include <string.h>
 #include <stddef.h>
+#include <pthread.h>
 #include "timelinedb.h"
 #include "timelinedb_simd.h"
 
-const TimelineBackendFunctions *g_TimelineBackendFunctions = &gTimelineBackendFunctionsC;
+// Backends usable on this CPU, filled once on first use (from any thread). The active backend pointer is
+// published with release / read with acquire, setBackend may switch it while workers run.
+static const TimelineBackendFunctions *g_TimelineBackends[TIMELINE_MAX_BACKENDS];
+static uint8_t g_TimelineBackendsCount = 0;
+static pthread_once_t g_TimelineBackendsOnce = PTHREAD_ONCE_INIT;
+const TimelineBackendFunctions *g_TimelineBackendFunctions = NULL;
 
 // -------------------------------------
-static inline void* alloc_raw_aligned(size_t size, uint8_t alignment) {
-    void *ptr = NULL;
-    if (alignment <= 1) {
-        ptr = malloc(size);
-    } else {
-        size_t aligned_size = (size + alignment - 1) & ~(alignment - 1);
-        ptr = aligned_alloc(alignment, aligned_size);
+// Gives buf a valueBuffer of at least 'size' bytes, keeping the current allocation when it is large and aligned enough.
+int reserve_RawTimelineValuesBuf(RawTimelineValuesBuf *buf, size_t size, uint8_t alignment) {
+    // callers pass the sample size (e.g. 24 or 160 bytes), aligned_alloc needs a power of two
+    size_t align = 1;
+    while (align < alignment) align <<= 1;
+    if (buf->allocator && align > 64) align = 64; // the allocators align to a cache line at most, enough for SIMD
+    size_t aligned_size = (size + align - 1) & ~(align - 1);
+    if (buf->valueBuffer && buf->allocated_size >= aligned_size && ((uintptr_t)buf->valueBuffer & (align - 1)) == 0) {
+        return 0;
+    }
+    if (buf->allocated_size) {
+        free_TimelineMemory(buf->allocator, buf->valueBuffer);
     }
-    if (!ptr) {
+    buf->allocated_size = 0;
+    buf->valueBuffer = (aligned_size <= UINT32_MAX) ? (unsigned char*)alloc_TimelineMemory(buf->allocator, aligned_size, align) : NULL;
+    if (!buf->valueBuffer) {
         fprintf(stderr, "ERROR: Memory allocation failed for size %zu\n", size);
-        return NULL;
+        return -1;
     }
-    return ptr;
+    buf->allocated_size = (uint32_t)aligned_size;
+    return 0;
+}
+
+int reserve_TimelineScratch(RawTimelineValuesBuf *buf, size_t size) {
+    if (buf->scratch && buf->scratch_size >= size) {
+        return 0;
+    }
+    free_TimelineMemory(buf->allocator, buf->scratch);
+    buf->scratch_size = 0;
+    buf->scratch = (size <= UINT32_MAX) ? (unsigned char*)alloc_TimelineMemory(buf->allocator, size, 64) : NULL;
+    if (!buf->scratch) {
+        fprintf(stderr, "ERROR: Memory allocation failed for %zu bytes of scratch\n", size);
+        return -1;
+    }
+    buf->scratch_size = (uint32_t)size;
+    return 0;
 }
 
 void init_RawTimelineValuesBuf(RawTimelineValuesBuf *buf) {
@@ -39,65 +68,86 @@ void init_RawTimelineValuesBuf(RawTimelineValuesBuf *buf) {
         buf->bitwidth = 0;
         // buf->bytealignment = 0;
         buf->bytes_per_sample = 0;
+        buf->plane_stride = 0;
         buf->value_type = TR_undefined;
         buf->time_exponent = 0;
         buf->time_step = 0;
         buf->buffer_size = 0;
+        buf->capacity = 0;
+        buf->ring_head = 0;
+        buf->ring_tail = 0;
+        buf->ring_total = 0;
         buf->valueBuffer = NULL;
         buf->sample_rate_info = NULL; // This will be set when preparing the buffer for sample rate conversion
         buf->prepared_data_src = NULL; // This will be set when preparing the buffer for sample rate conversion
+        buf->minmax_pyramid = NULL; // This will be set by init_MinMaxPyramid
+        buf->block_stats = NULL; // This will be set by init_BlockStats
+        buf->allocator = NULL; // heap, set by the caller before alloc_* for an arena or pool
+        buf->allocated_size = 0;
+        buf->scratch = NULL;
+        buf->scratch_size = 0;
     }
 }
 void free_RawTimelineValuesBuf(RawTimelineValuesBuf *buf) {
     if (!buf) return;
     if (buf->valueBuffer) {
-        free(buf->valueBuffer);
+        // a valueBuffer not allocated by alloc_* was set by the caller from the heap
+        free_TimelineMemory(buf->allocated_size ? buf->allocator : NULL, buf->valueBuffer);
         buf->valueBuffer = NULL;
+        buf->allocated_size = 0;
     }
-    if (buf->prepared_data_src) {
-        free(buf->prepared_data_src);
-        buf->prepared_data_src = NULL;
+    free_InterpInfo(buf);
+    if (buf->scratch) {
+        free_TimelineMemory(buf->allocator, buf->scratch);
+        buf->scratch = NULL;
+        buf->scratch_size = 0;
     }
     if (buf->sample_rate_info) {
-        free(buf->sample_rate_info);
+        free_TimelineMemory(buf->allocator, buf->sample_rate_info);
         buf->sample_rate_info = NULL;
     }
+    free_MinMaxPyramid(buf);
+    free_BlockStats(buf);
     buf->nr_of_samples = 0;
 }
 
+// Detects the CPU features and selects the best backend (index 1 if there is any SIMD variant).
+static void init_ActiveBackend(void) {
+    g_TimelineBackendsCount = init_TimelineBackendRegistry(g_TimelineBackends, TIMELINE_MAX_BACKENDS);
+    __atomic_store_n(&g_TimelineBackendFunctions, g_TimelineBackends[(g_TimelineBackendsCount > 1) ? 1 : 0], __ATOMIC_RELEASE);
+}
+
+static const TimelineBackendFunctions *getActiveBackend() {
+    const TimelineBackendFunctions *active = __atomic_load_n(&g_TimelineBackendFunctions, __ATOMIC_ACQUIRE);
+    if (!active) {
+        pthread_once(&g_TimelineBackendsOnce, init_ActiveBackend); // the other callers wait for the first one
+        active = __atomic_load_n(&g_TimelineBackendFunctions, __ATOMIC_ACQUIRE);
+    }
+    return active;
+}
+
 uint8_t getBackendsCount() {
-    return 2; // Currently only one backend
+    getActiveBackend();
+    return g_TimelineBackendsCount;
 }
 int getBackendName(uint8_t index, const char **name) {
     if (!name) {
         return -1; // Invalid index
     }
-    switch (index) {
-    case 0:
-        *name = "C Backend";
-        break;
-    case 1:
-        *name = "SIMD Backend";
-        break;
-    default:
-        *name = g_TimelineBackendFunctions->name;
+    const TimelineBackendFunctions *active = getActiveBackend();
+    if (index < g_TimelineBackendsCount) {
+        *name = g_TimelineBackends[index]->name;
+    } else {
+        *name = active->name; // out of range (e.g. -1): the active one
     }
     return 0;
 }
 int setBackend(uint8_t index) {
-    if (index > 1) {
-        return -1; // Invalid index
-    }
-    switch (index) {
-    case 0:
-        g_TimelineBackendFunctions = &gTimelineBackendFunctionsC;
-        break;
-    case 1:
-        g_TimelineBackendFunctions = &gTimelineBackendFunctionsSIMD;
-        break;
-    default:
-        return -1; // Invalid index
+    getActiveBackend();
+    if (index >= g_TimelineBackendsCount) {
+        return -1; // Invalid index, or the CPU does not support it
     }
+    __atomic_store_n(&g_TimelineBackendFunctions, g_TimelineBackends[index], __ATOMIC_RELEASE);
     return 0;
 }
 
@@ -105,6 +155,10 @@ static inline int getSampleByteOffset(const RawTimelineValuesBuf *buf, uint32_t
     if (!buf || sample_index >= buf->nr_of_samples || channel >= buf->nr_of_channels) {
         return -1; // Invalid access
     }
+    if (buf->plane_stride) {
+        *offset = channel * buf->plane_stride + sample_index * (buf->bitwidth / 8);
+        return 0;
+    }
     *offset= (sample_index * buf->bytes_per_sample)+ (channel * buf->bitwidth / 8);
     return 0;
 }
@@ -167,17 +221,249 @@ void alloc_RawTimelineValuesBuf(RawTimelineValuesBuf *buf, uint32_t nr_of_sample
     buf->nr_of_channels = nr_of_channels;
     buf->bitwidth = bitwidth;
     buf->bytes_per_sample = (nr_of_channels*bitwidth+7)/8; // this is not for the array, but for the value elements.
+    buf->plane_stride = 0;
     buf->value_type = value_type;
-    buf->buffer_size = nr_of_samples * nr_of_channels * buf->bytes_per_sample;
+    const uint64_t buffer_size = (uint64_t)nr_of_samples * buf->bytes_per_sample;
+    if (buffer_size > UINT32_MAX) {
+        fprintf(stderr, "Buffer of %u samples x %u bytes exceeds 4 GB\n", nr_of_samples, buf->bytes_per_sample);
+        exit(1);
+    }
+    buf->buffer_size = (uint32_t)buffer_size;
 
 //    printf("Allocating RawTimelineValuesBuf: %u samples, %u channels, %u bytes/sample, total size: %u bytes\n",
 //           nr_of_samples, nr_of_channels, buf->bytes_per_sample, buf->buffer_size);
-    buf->valueBuffer = alloc_raw_aligned(buf->buffer_size, bytealignment);
-    if (!buf->valueBuffer) {
+    if (reserve_RawTimelineValuesBuf(buf, buf->buffer_size, bytealignment) != 0) {
         fprintf(stderr, "Memory allocation failed\n");
         exit(1);
     }
 }
+/*
+    RING BUFFER
+    Fixed capacity, append-only storage. When the ring is full, appending overwrites the oldest sample in O(1).
+    Every slot is written twice (slot and slot + capacity), so a window starting anywhere in the ring can be read
+    as one contiguous block by the unchanged conversion/aggregation kernels, without copying sample data.
+*/
+void alloc_RingTimelineValuesBuf(RawTimelineValuesBuf *buf, uint32_t capacity, uint8_t nr_of_channels, uint8_t bitwidth, uint8_t bytealignment, RawTimelineValueEnum value_type) {
+    if (!buf) return;
+    buf->nr_of_samples = 0;
+    buf->nr_of_channels = nr_of_channels;
+    buf->bitwidth = bitwidth;
+    buf->bytes_per_sample = (nr_of_channels*bitwidth+7)/8;
+    buf->plane_stride = 0;
+    buf->value_type = value_type;
+    buf->capacity = capacity;
+    buf->ring_head = 0;
+    buf->ring_tail = 0;
+    buf->ring_total = 0;
+    const uint64_t buffer_size = 2 * (uint64_t)capacity * buf->bytes_per_sample; // mirrored storage
+    if (buffer_size > UINT32_MAX) {
+        fprintf(stderr, "Ring of %u samples x %u bytes exceeds 4 GB\n", capacity, buf->bytes_per_sample);
+        exit(1);
+    }
+    buf->buffer_size = (uint32_t)buffer_size;
+    if (reserve_RawTimelineValuesBuf(buf, buf->buffer_size, bytealignment) != 0) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+}
+
+// Drops all samples but keeps the storage (and the ring capacity).
+void clear_RawTimelineValuesBuf(RawTimelineValuesBuf *buf) {
+    if (!buf) return;
+    buf->nr_of_samples = 0;
+    buf->ring_head = 0;
+    buf->ring_tail = 0;
+    buf->ring_total = 0;
+}
+
+/*
+    Appends 'count' interleaved samples (bytes_per_sample each) at the tail of a ring buffer.
+    An attached block statistics sidecar is updated as well (the pyramid is updated by the caller).
+    Returns 0 on success, -1 if the buffer is not in ring mode.
+*/
+int append_RawTimelineValues(RawTimelineValuesBuf *buf, const void *samples, uint32_t count) {
+    if (!buf || !buf->valueBuffer || buf->capacity == 0 || (!samples && count)) {
+        return -1;
+    }
+    const uint8_t *src = (const uint8_t*)samples;
+    uint32_t bps = buf->bytes_per_sample;
+    uint32_t cap = buf->capacity;
+    buf->ring_total += count;
+    if (count > cap) {
+        // only the last 'capacity' samples survive
+        src += (size_t)(count - cap) * bps;
+        buf->ring_tail = (buf->ring_tail + (count - cap)) % cap;
+        count = cap;
+    }
+    while (count > 0) {
+        uint32_t n = cap - buf->ring_tail;
+        if (n > count) n = count;
+        memcpy(&buf->valueBuffer[(size_t)buf->ring_tail * bps], src, (size_t)n * bps);
+        memcpy(&buf->valueBuffer[(size_t)(buf->ring_tail + cap) * bps], src, (size_t)n * bps);
+        src += (size_t)n * bps;
+        count -= n;
+        buf->ring_tail = (buf->ring_tail + n == cap) ? 0 : buf->ring_tail + n;
+        buf->nr_of_samples = (buf->nr_of_samples + n > cap) ? cap : buf->nr_of_samples + n;
+    }
+    if (buf->nr_of_samples == cap) {
+        buf->ring_head = buf->ring_tail;
+    }
+    if (buf->block_stats) {
+        return update_BlockStats(buf);
+    }
+    return 0;
+}
+
+/*
+    Creates a view of 'length' samples, starting 'offset' samples after the oldest one.
+    The view is clamped to the samples available in the buffer.
+*/
+int make_RawTimelineValuesView(const RawTimelineValuesBuf *buf, uint32_t offset, uint32_t length, RawTimelineValuesView *view) {
+    if (!buf || !view) {
+        return -1;
+    }
+    if (offset > buf->nr_of_samples) offset = buf->nr_of_samples;
+    if (length > buf->nr_of_samples - offset) length = buf->nr_of_samples - offset;
+    view->buf = buf;
+    view->offset = offset;
+    view->length = length;
+    return 0;
+}
+
+/*
+    Fills 'window' with a linear, read-only descriptor of the view, sharing the sample memory of the viewed buffer.
+    The window can be passed to every function which takes a const input buffer, but it must never be freed.
+*/
+int map_RawTimelineValuesView(const RawTimelineValuesView *view, RawTimelineValuesBuf *window) {
+    if (!view || !view->buf || !window || !view->buf->valueBuffer || view->buf->plane_stride) {
+        return -1; // planar buffers are read per channel (map_PlanarChannel)
+    }
+    const RawTimelineValuesBuf *buf = view->buf;
+    uint32_t first = (buf->capacity ? buf->ring_head : 0) + view->offset;
+    *window = *buf;
+    window->valueBuffer = buf->valueBuffer + (size_t)first * buf->bytes_per_sample;
+    window->nr_of_samples = view->length;
+    window->buffer_size = view->length * buf->bytes_per_sample;
+    window->capacity = 0;
+    window->ring_head = 0;
+    window->ring_tail = 0;
+    window->ring_total = 0;
+    window->sample_rate_info = NULL;
+    window->prepared_data_src = NULL;
+    window->minmax_pyramid = NULL;
+    window->block_stats = NULL;
+    window->allocated_size = 0;
+    window->scratch = NULL;
+    window->scratch_size = 0;
+    return 0;
+}
+
+/*
+    PAYLOAD DECODING
+    Packets of the capture hardware carry N channels as big-endian 24-bit values. Channel c belongs to the
+    8-channel block (buffer) c / 8. The decoding kernels come from the active backend (pshufb / vld3 shuffles).
+*/
+static fn_decode_be24 getDecoder(RawTimelineValueEnum value_type) {
+    if (value_type == TR_SIMD_sint16x8) return getActiveBackend()->decode_be24_s16x8;
+    if (value_type == TR_SIMD_sint24x8) return getActiveBackend()->decode_be24_s24x8;
+    return NULL;
+}
+
+/*
+    Decodes one payload of nr_of_channels values into (nr_of_channels + 7) / 8 blocks of the given type,
+    block b is written at dst + b * dst_stride. Lanes of the last block beyond nr_of_channels are set to 0.
+*/
+int decode_BE24_Samples(const uint8_t *payload, uint32_t nr_of_channels, RawTimelineValueEnum value_type, uint8_t *dst, uint32_t dst_stride) {
+    fn_decode_be24 decode = getDecoder(value_type);
+    if (!payload || !dst || !decode) {
+        fprintf(stderr, "Unsupported value type for 24-bit payload decoding\n");
+        return -1;
+    }
+    return decode(payload, nr_of_channels, dst, dst_stride);
+}
+
+/*
+    One buffer holding all channels of the packet: the 8-channel blocks of a sample follow each other, so the decoder
+    writes a whole sample with a block stride of 8 values. The zeroed lanes of a partial last block spill into
+    the next staging row, which is decoded afterwards (the staging keeps one block of slack for the last row).
+*/
+static int append_BE24_Interleaved(const uint8_t *const *payloads, uint32_t nr_of_payloads, uint32_t nr_of_channels, RawTimelineValuesBuf *buf, fn_decode_be24 decode) {
+    uint32_t bps = buf->bytes_per_sample;
+    uint32_t block = buf->bitwidth; // 8 lanes x bitwidth / 8 bytes
+    uint8_t staging[16384];
+    uint32_t chunk = (sizeof(staging) - block) / bps;
+    if (chunk == 0) {
+        fprintf(stderr, "Too many channels for payload decoding: %u\n", nr_of_channels);
+        return -1;
+    }
+    for (uint32_t first = 0; first < nr_of_payloads; first += chunk) {
+        uint32_t n = (nr_of_payloads - first < chunk) ? nr_of_payloads - first : chunk;
+        for (uint32_t k = 0; k < n; ++k) {
+            decode(payloads[first + k], nr_of_channels, &staging[k * bps], block);
+        }
+        if (append_RawTimelineValues(buf, staging, n) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/*
+    Batch ingest: decodes nr_of_payloads packets and appends one sample per packet to the ring buffers,
+    bufs[b] receives the channels 8*b .. 8*b+7. The packets are decoded into a staging area in chunks,
+    so every ring buffer is appended (and its bookkeeping updated) once per chunk instead of once per packet.
+    A single buffer with nr_of_channels channels receives the whole packet as one sample.
+    All buffers must have the same type: TR_SIMD_sint16x8 (upper 16 bits) or TR_SIMD_sint24x8 (full value).
+*/
+int append_BE24_Payloads(const uint8_t *const *payloads, uint32_t nr_of_payloads, uint32_t nr_of_channels, RawTimelineValuesBuf *bufs, uint32_t nr_of_bufs) {
+    if (!payloads || !bufs || nr_of_bufs == 0) {
+        return -1;
+    }
+    if (nr_of_payloads == 0 || nr_of_channels == 0) {
+        return 0;
+    }
+    RawTimelineValueEnum value_type = bufs[0].value_type;
+    fn_decode_be24 decode = getDecoder(value_type);
+    if (!decode) {
+        fprintf(stderr, "Unsupported value type for 24-bit payload decoding\n");
+        return -1;
+    }
+    if (nr_of_bufs == 1 && bufs[0].nr_of_channels == nr_of_channels) {
+        return append_BE24_Interleaved(payloads, nr_of_payloads, nr_of_channels, &bufs[0], decode);
+    }
+    uint32_t nr_of_blocks = (nr_of_channels + 7) / 8;
+    if (nr_of_blocks > nr_of_bufs) {
+        nr_of_blocks = nr_of_bufs;
+        nr_of_channels = nr_of_bufs * 8;
+    }
+    uint32_t bps = bufs[0].bytes_per_sample;
+    for (uint32_t b = 0; b < nr_of_blocks; ++b) {
+        if (bufs[b].value_type != value_type || bufs[b].bytes_per_sample != bps || bufs[b].nr_of_channels != 8) {
+            fprintf(stderr, "Buffer %u does not match the 8-channel %u bytes/sample layout\n", b, bps);
+            return -1;
+        }
+    }
+    uint8_t staging[16384];
+    uint32_t chunk = sizeof(staging) / (nr_of_blocks * bps);
+    if (chunk == 0) {
+        fprintf(stderr, "Too many channels for payload decoding: %u\n", nr_of_channels);
+        return -1;
+    }
+    for (uint32_t first = 0; first < nr_of_payloads; first += chunk) {
+        uint32_t n = (nr_of_payloads - first < chunk) ? nr_of_payloads - first : chunk;
+        // staging layout: block b of packet k at (b * n + k) * bps, so each buffer gets one contiguous run
+        for (uint32_t k = 0; k < n; ++k) {
+            decode(payloads[first + k], nr_of_channels, &staging[k * bps], n * bps);
+        }
+        for (uint32_t b = 0; b < nr_of_blocks; ++b) {
+            if (append_RawTimelineValues(&bufs[b], &staging[b * n * bps], n) != 0) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
 void getEngineeringSampleRateFrequency(const RawTimelineValuesBuf *buf, double *freq_val, const char **freq_unit) {
     static const char *units[] = {"Hz", "kHz", "MHz", "GHz", "THz", "PHz"};
     double freq_hz = 1.0 / (buf->time_step * pow(10.0, buf->time_exponent));
@@ -205,15 +491,9 @@ void getEngineeringTimeInterval(const RawTimelineValuesBuf *buf, double *time_va
     *time_val = buf->time_step;
 }
 
-int prepare_SampleRateConversion(const RawTimelineValuesBuf *input, uint32_t new_sample_rate_hz, RawTimelineValuesBuf *output) {
-    if (!input || !output) return -1;
-
-    double time_unit = pow(10.0, input->time_exponent);
-    double old_rate = 1.0 / (input->time_step * time_unit);
-    double rate_ratio = (double)new_sample_rate_hz / old_rate;
-    uint32_t new_nr_samples = (uint32_t)(input->nr_of_samples * rate_ratio);
-
-    double ideal_time = 1.0 / new_sample_rate_hz;
+// time_step / time_exponent of a buffer sampled at rate_hz (the largest engineering unit with a step >= 1)
+static void setTimeStepFromRate(RawTimelineValuesBuf *buf, uint32_t rate_hz) {
+    double ideal_time = 1.0 / rate_hz;
     int8_t exp = 0;
     uint32_t step = 0;
     for (int e = 15; e >= -15; e -= 3) {
@@ -226,14 +506,27 @@ int prepare_SampleRateConversion(const RawTimelineValuesBuf *input, uint32_t new
         }
     }
 
-    output->time_exponent = exp;
-    output->time_step = step;
+    buf->time_exponent = exp;
+    buf->time_step = step;
+}
+
+int prepare_SampleRateConversion(const RawTimelineValuesBuf *input, uint32_t new_sample_rate_hz, RawTimelineValuesBuf *output) {
+    if (!input || !output) return -1;
+
+    double time_unit = pow(10.0, input->time_exponent);
+    double old_rate = 1.0 / (input->time_step * time_unit);
+    double rate_ratio = (double)new_sample_rate_hz / old_rate;
+    uint32_t new_nr_samples = (uint32_t)(input->nr_of_samples * rate_ratio);
+
+    setTimeStepFromRate(output, new_sample_rate_hz);
 
     //later we can add more commmon sample parameters
-    output->sample_rate_info = (SampleRateInfo*)malloc(sizeof(SampleRateInfo));
-    if (!output->sample_rate_info) {
-        fprintf(stderr, "Memory allocation failed for SampleRateInfo\n");
-        return -1;
+    if (!output->sample_rate_info) { // a prepared output is prepared again in place
+        output->sample_rate_info = (SampleRateInfo*)alloc_TimelineMemory(output->allocator, sizeof(SampleRateInfo), 16);
+        if (!output->sample_rate_info) {
+            fprintf(stderr, "Memory allocation failed for SampleRateInfo\n");
+            return -1;
+        }
     }
     /*
     double in_time_unit = pow(10.0, input->time_exponent);
@@ -243,16 +536,26 @@ int prepare_SampleRateConversion(const RawTimelineValuesBuf *input, uint32_t new
     double rate2 = in_sample_time / out_sample_time;
     */
     output->sample_rate_info->rate_ratio = rate_ratio;
+    output->sample_rate_info->cic_ratio = 0;
     
     alloc_RawTimelineValuesBuf(output, new_nr_samples, input->nr_of_channels, input->bitwidth, input->bytes_per_sample, input->value_type);
+    if (output->valueBuffer == NULL) return -1;
     if (output->value_type == TR_SIMD_sint16x8) {
-        if (output->prepared_data_src) {
-            free(output->prepared_data_src);
-            output->prepared_data_src = NULL;
+        free_InterpInfo(output);
+        // integer rates give the shortest period (e.g. 1 MHz -> 1.2 MHz repeats after 6 outputs), otherwise the sample counts
+        double old_rate_hz = floor(old_rate + 0.5);
+        int rc;
+        if (old_rate_hz >= 1.0 && old_rate_hz <= UINT32_MAX && fabs(old_rate - old_rate_hz) <= 1e-6 * old_rate_hz) {
+            rc = init_InterpInfo(input, output, new_sample_rate_hz, (uint32_t)old_rate_hz);
+        } else {
+            rc = init_InterpInfo(input, output, new_nr_samples, input->nr_of_samples);
+        }
+        if (rc != 0) {
+            fprintf(stderr, "Sample rate conversion could not be prepared\n");
+            return -1;
         }
-        init_InterpInfo(input, output);
     }
-    return (output->valueBuffer == NULL) ? -1 : 0;
+    return 0;
 }
 
 int convert_sample_rate_analog_sint8(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *output, double rate_ratio, uint32_t new_nr_samples) {
@@ -273,7 +576,7 @@ int convert_sample_rate_analog_sint8(const RawTimelineValuesBuf *input, RawTimel
 }
 
 int convert_sample_rate(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *output) {
-    if (!input || !output) {
+    if (!input || !output || input->plane_stride || output->plane_stride) {
         fprintf(stderr, "Unsupported or invalid input\n");
         return -1;
     }
@@ -281,13 +584,357 @@ int convert_sample_rate(const RawTimelineValuesBuf *input, RawTimelineValuesBuf
     if ( input->value_type == TR_analog_sint8) {
         return convert_sample_rate_analog_sint8(input, output, output->sample_rate_info->rate_ratio, output->nr_of_samples);
     } else if (input->value_type == TR_SIMD_sint16x8) {
-        return g_TimelineBackendFunctions->convert_sample_rate_s16x8(input, output);
+        return getActiveBackend()->convert_sample_rate_s16x8(input, output, 0, output->nr_of_samples);
     } else {
         fprintf(stderr, "Unsupported value type for sample rate conversion\n");
         return -1;
     }
 }
 
+int convert_sample_rate_view(const RawTimelineValuesView *view, RawTimelineValuesBuf *output) {
+    RawTimelineValuesBuf window;
+    if (map_RawTimelineValuesView(view, &window) != 0) {
+        fprintf(stderr, "Unsupported or invalid input\n");
+        return -1;
+    }
+    return convert_sample_rate(&window, output);
+}
+
+/*
+    PARALLEL SAMPLE RATE CONVERSION
+    The prepared table gives the position of any output directly (seek_SampleInterpCursor), so the output is cut into
+    cache-sized chunks and the backend's converter runs each chunk on the worker pool. The chunks walk the same table
+    as the serial conversion, the result is identical to it (upsampling and downsampling).
+*/
+#define TIMELINE_PARALLEL_CHUNK_BYTES 65536
+
+typedef struct {
+    const RawTimelineValuesBuf *input;
+    RawTimelineValuesBuf *output;
+    fn_convert convert_fn;
+    uint32_t chunk;
+} SampleRateParallelJob;
+
+static void convert_sample_rate_task(void *ctx, uint32_t task) {
+    const SampleRateParallelJob *job = (const SampleRateParallelJob*)ctx;
+    const uint32_t first = task * job->chunk;
+    const uint32_t out = job->output->nr_of_samples;
+    const uint32_t count = (out - first > job->chunk) ? job->chunk : out - first;
+    job->convert_fn(job->input, job->output, first, count); // the table is checked before the tasks start
+}
+
+/*
+    convert_sample_rate of a prepared output (prepare_SampleRateConversion) on the worker pool.
+    TR_SIMD_sint16x8 only, other value types run serially.
+*/
+int convert_sample_rate_parallel(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *output) {
+    if (!input || !output || !input->valueBuffer || !output->valueBuffer) {
+        fprintf(stderr, "Unsupported or invalid input\n");
+        return -1;
+    }
+    if (input->value_type != TR_SIMD_sint16x8 || output->value_type != TR_SIMD_sint16x8 ||
+        input->nr_of_channels != output->nr_of_channels || input->plane_stride || output->plane_stride) {
+        return convert_sample_rate(input, output);
+    }
+    if (!get_SampleInterpTable(input, output)) {
+        return -1;
+    }
+    SampleRateParallelJob job;
+    job.input = input;
+    job.output = output;
+    job.convert_fn = getActiveBackend()->convert_sample_rate_s16x8;
+    job.chunk = TIMELINE_PARALLEL_CHUNK_BYTES / output->bytes_per_sample;
+    if (job.chunk < 256) job.chunk = 256;
+    run_TimelineWorkers(convert_sample_rate_task, &job, (output->nr_of_samples + job.chunk - 1) / job.chunk);
+    return 0;
+}
+
+/*
+    STREAMING SAMPLE RATE CONVERSION
+    Every output needs the input samples left and right of its position. The outputs between the last sample
+    of the previous chunk and the first one of this chunk are computed from the two-sample 'edge' copy,
+    the rest directly from the chunk, with the backend's resample_span kernel in both cases.
+*/
+int init_SampleRateStream(SampleRateStream *stream, uint8_t nr_of_channels, uint32_t in_rate_hz, uint32_t out_rate_hz) {
+    if (!stream || nr_of_channels == 0 || in_rate_hz == 0 || out_rate_hz == 0) {
+        return -1;
+    }
+    uint32_t g = gcd_u32(in_rate_hz, out_rate_hz);
+    stream->in_rate_hz = in_rate_hz;
+    stream->out_rate_hz = out_rate_hz;
+    stream->scale = out_rate_hz / g;
+    stream->step_int = (in_rate_hz / g) / stream->scale;
+    stream->step_rem = (in_rate_hz / g) % stream->scale;
+    stream->nr_of_channels = nr_of_channels;
+    reset_SampleRateStream(stream);
+    return 0;
+}
+
+// Restarts the stream at input sample 0 (phase 0), the rates are kept.
+void reset_SampleRateStream(SampleRateStream *stream) {
+    if (!stream) return;
+    stream->accum = 0;
+    stream->next_idx = 0;
+    stream->consumed = 0;
+}
+
+// Upper bound of the outputs produced by the next in_samples input samples (for sizing the output buffer).
+uint32_t getSampleRateStreamMaxOutput(const SampleRateStream *stream, uint32_t in_samples) {
+    if (!stream || stream->scale == 0) return 0;
+    uint64_t step = (uint64_t)stream->step_int * stream->scale + stream->step_rem;
+    return (uint32_t)((uint64_t)in_samples * stream->scale / step + 1);
+}
+
+/*
+    Converts the next chunk (all samples of input) and writes the produced samples to the start of output,
+    output->nr_of_samples is set to their number (it can be 0 for a short chunk when downsampling).
+    Returns 0 on success, -1 if the buffers do not match the stream or the output is too small
+    (see getSampleRateStreamMaxOutput), the stream is unchanged in that case.
+*/
+int convert_sample_rate_stream(SampleRateStream *stream, const RawTimelineValuesBuf *input, RawTimelineValuesBuf *output) {
+    if (!stream || !input || !output || !input->valueBuffer || !output->valueBuffer) {
+        return -1;
+    }
+    const uint32_t ch = stream->nr_of_channels;
+    if (input->value_type != TR_SIMD_sint16x8 || output->value_type != TR_SIMD_sint16x8 ||
+        input->nr_of_channels != ch || output->nr_of_channels != ch || output->capacity != 0) {
+        fprintf(stderr, "Unsupported buffers for streaming sample rate conversion\n");
+        return -1;
+    }
+    const uint32_t n = input->nr_of_samples;
+    const uint64_t end = stream->consumed + n;
+    // outputs k = 0.. with next_idx + floor((accum + k * step) / scale) + 1 < end
+    const uint64_t step = (uint64_t)stream->step_int * stream->scale + stream->step_rem;
+    uint64_t count = 0;
+    if (end >= stream->next_idx + 2) {
+        uint64_t limit = (end - 1 - stream->next_idx) * stream->scale - stream->accum;
+        count = (limit + step - 1) / step;
+    }
+    if (count > output->buffer_size / output->bytes_per_sample) {
+        fprintf(stderr, "Output buffer too small for streaming sample rate conversion: %llu samples\n", (unsigned long long)count);
+        return -1;
+    }
+    if (n == 0) {
+        output->nr_of_samples = 0;
+        return 0;
+    }
+    fn_resample_span resample = getActiveBackend()->resample_span_s16x8;
+    const int16_t *src = (const int16_t*)input->valueBuffer;
+    int16_t *dst = (int16_t*)output->valueBuffer;
+    SampleRatePhase phase = { 0, stream->accum, stream->step_int, stream->step_rem, stream->scale };
+    uint32_t done = 0;
+    if (count > 0 && stream->consumed > 0 && stream->next_idx + 1 == stream->consumed) {
+        // outputs between the previous chunk and this one: [previous last sample, first sample]
+        memcpy(&stream->edge[ch], src, ch * sizeof(int16_t));
+        uint64_t edge_count = (stream->scale - stream->accum + step - 1) / step;
+        if (edge_count > count) edge_count = count;
+        resample(stream->edge, ch, &phase, dst, (uint32_t)edge_count);
+        done = (uint32_t)edge_count;
+        stream->next_idx += phase.idx; // edge row 1 is row 0 of the chunk
+    }
+    if (done < count) {
+        phase.idx = (uint32_t)(stream->next_idx - stream->consumed);
+        resample(src, ch, &phase, &dst[(size_t)done * ch], (uint32_t)(count - done));
+        stream->next_idx = stream->consumed + phase.idx;
+    }
+    stream->accum = phase.accum;
+    stream->consumed = end;
+    memcpy(stream->edge, &src[(size_t)(n - 1) * ch], ch * sizeof(int16_t));
+    output->nr_of_samples = (uint32_t)count;
+    setTimeStepFromRate(output, stream->out_rate_hz);
+    return 0;
+}
+
+int convert_sample_rate_stream_view(SampleRateStream *stream, const RawTimelineValuesView *view, RawTimelineValuesBuf *output) {
+    RawTimelineValuesBuf window;
+    if (map_RawTimelineValuesView(view, &window) != 0) {
+        fprintf(stderr, "Unsupported or invalid input\n");
+        return -1;
+    }
+    return convert_sample_rate_stream(stream, &window, output);
+}
+
+/*
+    POLYPHASE FIR RESAMPLING
+    Output k sits at input position k * down / up = idx + p / up. Its filter is the windowed sinc centred on that
+    position, sampled at the input samples idx - taps / 2 + 1 .. idx + taps / 2. Every phase p is designed once
+    into the bank, the main loop is the backend's polyphase_span kernel. Outputs whose window reaches over either
+    end of the input are computed here with the edge samples repeated.
+    The taps grow with the decimation ratio (8 sinc lobes per side at the output rate: 372 taps for 1 MHz -> 48 kHz),
+    so a large decimation first goes through the CIC kernel (a few adds per input sample) by R = 1 << pre_shift,
+    and the FIR sees the R times lower rate: up / down are relative to it. R keeps 2.5x the output rate, the CIC
+    images fold back from above 1.5x the output rate, where 4 stages attenuate them by more than 50 dB.
+*/
+int init_PolyphaseFilterBank(PolyphaseFilterBank *bank, uint32_t in_rate_hz, uint32_t out_rate_hz, uint32_t taps, const TimelineAllocator *allocator) {
+    if (!bank || in_rate_hz == 0 || out_rate_hz == 0) {
+        return -1;
+    }
+    bank->coeffs = NULL;
+    bank->allocator = allocator;
+    uint32_t pre_shift = 0;
+    while (pre_shift < TIMELINE_POLYPHASE_CIC_MAX_SHIFT && (uint64_t)out_rate_hz * 5 * (2u << pre_shift) <= (uint64_t)in_rate_hz * 2) {
+        pre_shift++;
+    }
+    const uint32_t fir_out_rate = out_rate_hz << pre_shift; // output rate relative to the pre-decimated input
+    uint32_t g = gcd_u32(in_rate_hz, fir_out_rate);
+    bank->in_rate_hz = in_rate_hz;
+    bank->out_rate_hz = out_rate_hz;
+    bank->pre_shift = pre_shift;
+    bank->up = fir_out_rate / g;
+    bank->down = in_rate_hz / g;
+    bank->nr_of_phases = (bank->up < TIMELINE_POLYPHASE_MAX_PHASES) ? bank->up : TIMELINE_POLYPHASE_MAX_PHASES;
+    // cutoff relative to the input Nyquist frequency, a bit below the output Nyquist when decimating
+    double fc = (bank->up < bank->down) ? 0.9 * bank->up / bank->down : 1.0;
+    if (taps == 0) {
+        taps = (uint32_t)ceil(16.0 / fc);
+    }
+    taps = (taps + 1) & ~1u;
+    if (taps < 2) taps = 2;
+    if (taps > TIMELINE_POLYPHASE_MAX_TAPS) taps = TIMELINE_POLYPHASE_MAX_TAPS;
+    bank->taps = taps;
+    bank->coeffs = (int16_t*)alloc_TimelineMemory(allocator, (size_t)bank->nr_of_phases * taps * sizeof(int16_t), 64);
+    if (!bank->coeffs) {
+        return -1;
+    }
+    double h[TIMELINE_POLYPHASE_MAX_TAPS];
+    const double half_width = taps / 2.0;
+    const double unity = (double)(1 << TIMELINE_POLYPHASE_COEF_BITS);
+    for (uint32_t p = 0; p < bank->nr_of_phases; ++p) {
+        double frac = (double)p / bank->nr_of_phases;
+        double sum = 0.0;
+        for (uint32_t j = 0; j < taps; ++j) {
+            double t = (double)j - (taps / 2 - 1) - frac;
+            double x = M_PI * fc * t;
+            double sinc = (fabs(x) < 1e-12) ? 1.0 : sin(x) / x;
+            double w = 0.42 + 0.5 * cos(M_PI * t / half_width) + 0.08 * cos(2.0 * M_PI * t / half_width);
+            h[j] = sinc * w;
+            sum += h[j];
+        }
+        // quantize for unity DC gain, the rounding error goes to the largest tap
+        int16_t *row = &bank->coeffs[(size_t)p * taps];
+        int32_t total = 0, abs_total = 0;
+        uint32_t peak = 0;
+        for (uint32_t j = 0; j < taps; ++j) {
+            row[j] = (int16_t)lrint(h[j] * unity / sum);
+            total += row[j];
+            if (abs(row[j]) > abs(row[peak])) peak = j;
+        }
+        row[peak] = (int16_t)(row[peak] + (int32_t)unity - total);
+        for (uint32_t j = 0; j < taps; ++j) {
+            abs_total += abs(row[j]);
+        }
+        if (abs_total >= 4 * (int32_t)unity) { // the int32 sums of 16-bit samples must stay below 2^31
+            fprintf(stderr, "Polyphase filter gain too high for %u -> %u Hz, %u taps\n", in_rate_hz, out_rate_hz, taps);
+            free_PolyphaseFilterBank(bank);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void free_PolyphaseFilterBank(PolyphaseFilterBank *bank) {
+    if (!bank) return;
+    if (bank->coeffs) {
+        free_TimelineMemory(bank->allocator, bank->coeffs);
+        bank->coeffs = NULL;
+    }
+    bank->nr_of_phases = 0;
+    bank->taps = 0;
+}
+
+// Bytes of the pre-decimated rows the FIR runs on, 0 without a CIC stage
+static size_t scratch_size_Polyphase(const RawTimelineValuesBuf *input, const PolyphaseFilterBank *bank) {
+    if (!bank->pre_shift) return 0;
+    return (size_t)(((input->nr_of_samples - 1) >> bank->pre_shift) + 1) * input->nr_of_channels * sizeof(int16_t);
+}
+
+/*
+    Allocates the output for all positions k * down / up inside the input, at the output rate of the bank, and with a
+    CIC pre-decimation the scratch of the pre-decimated rows, so convert_sample_rate_polyphase does not allocate.
+*/
+int prepare_PolyphaseResampling(const RawTimelineValuesBuf *input, const PolyphaseFilterBank *bank, RawTimelineValuesBuf *output) {
+    if (!input || !bank || !output || input->nr_of_samples == 0 || input->value_type != TR_SIMD_sint16x8) {
+        fprintf(stderr, "Unsupported or invalid input\n");
+        return -1;
+    }
+    uint64_t count = (uint64_t)(input->nr_of_samples - 1) * bank->out_rate_hz / bank->in_rate_hz + 1;
+    alloc_RawTimelineValuesBuf(output, (uint32_t)count, input->nr_of_channels, input->bitwidth, input->bytes_per_sample, input->value_type);
+    if (!output->valueBuffer) {
+        return -1;
+    }
+    if (bank->pre_shift && reserve_TimelineScratch(output, scratch_size_Polyphase(input, bank)) != 0) {
+        return -1;
+    }
+    setTimeStepFromRate(output, bank->out_rate_hz);
+    return 0;
+}
+
+// One output row with the input rows clamped to [0, n)
+static void fir_edge_s16(const int16_t *src, uint32_t n, uint32_t ch, const int16_t *coef, uint32_t taps, int64_t first, int16_t *out) {
+    for (uint32_t c = 0; c < ch; ++c) {
+        int32_t acc = 0;
+        for (uint32_t j = 0; j < taps; ++j) {
+            int64_t r = first + j;
+            if (r < 0) r = 0;
+            if (r >= n) r = n - 1;
+            acc += coef[j] * src[(size_t)r * ch + c];
+        }
+        out[c] = round_fir_s16(acc);
+    }
+}
+
+int convert_sample_rate_polyphase(const RawTimelineValuesBuf *input, const PolyphaseFilterBank *bank, RawTimelineValuesBuf *output) {
+    if (!input || !bank || !output || !input->valueBuffer || !output->valueBuffer || !bank->coeffs) {
+        return -1;
+    }
+    if (input->value_type != TR_SIMD_sint16x8 || output->value_type != TR_SIMD_sint16x8 ||
+        input->nr_of_channels != output->nr_of_channels || input->nr_of_samples == 0 || output->capacity != 0) {
+        fprintf(stderr, "Unsupported buffers for polyphase resampling\n");
+        return -1;
+    }
+    const uint32_t ch = input->nr_of_channels;
+    uint32_t n = input->nr_of_samples;
+    const uint32_t count = output->nr_of_samples;
+    const uint32_t before = bank->taps / 2 - 1; // taps left of the output position
+    const int16_t *src = (const int16_t*)input->valueBuffer;
+    int16_t *dst = (int16_t*)output->valueBuffer;
+    if (bank->pre_shift) {
+        // the FIR runs on the pre-decimated rows: row j at input position j << pre_shift
+        if (!output->scratch || output->scratch_size < scratch_size_Polyphase(input, bank)) {
+            fprintf(stderr, "Output is not prepared for the polyphase pre-decimation\n");
+            return -1;
+        }
+        n = ((n - 1) >> bank->pre_shift) + 1;
+        int16_t *decimated = (int16_t*)output->scratch;
+        getActiveBackend()->cic_predecimate_s16x8(src, ch, input->nr_of_samples, bank->pre_shift, decimated, n);
+        src = decimated;
+    }
+    // outputs [head, tail) have their whole window inside the input: before <= idx <= n - 1 - taps / 2
+    uint64_t head = ((uint64_t)before * bank->up + bank->down - 1) / bank->down;
+    uint64_t tail = 0;
+    if (n > bank->taps / 2) {
+        tail = ((uint64_t)(n - bank->taps / 2) * bank->up + bank->down - 1) / bank->down;
+    }
+    if (head > count) head = count;
+    if (tail > count) tail = count;
+    if (tail < head) tail = head;
+    SampleRatePhase phase = { 0, 0, bank->down / bank->up, bank->down % bank->up, bank->up };
+    for (uint64_t k = 0; k < count; ++k) {
+        if (k == head && head < tail) {
+            uint64_t pos = head * bank->down;
+            phase.idx = (uint32_t)(pos / bank->up - before);
+            phase.accum = (uint32_t)(pos % bank->up);
+            getActiveBackend()->polyphase_span_s16x8(src, ch, bank, &phase, &dst[head * ch], (uint32_t)(tail - head));
+            k = tail - 1;
+            continue;
+        }
+        uint64_t pos = k * bank->down;
+        const int16_t *coef = coeffs_PolyphaseFilterBank(bank, &phase, (uint32_t)(pos % bank->up));
+        fir_edge_s16(src, n, ch, coef, bank->taps, (int64_t)(pos / bank->up) - before, &dst[k * ch]);
+    }
+    return 0;
+}
+
 int prepare_NeonAlignedBuffer(const RawTimelineValuesBuf *src, RawTimelineValuesBuf *dst) {
     if (!src || !dst || src->value_type != TR_analog_sint8 || src->bitwidth != 8) {
         return -1;
@@ -317,18 +964,20 @@ int convert_to_NeonAlignedBuffer(const RawTimelineValuesBuf *src, RawTimelineVal
         return -1; // Mismatch in sample count or too many channels
     }
    
+    if (src->nr_of_samples == 0) {
+        return 0;
+    }
+    // the offsets of sample 0 are checked once, then both sides advance by a fixed step (a planar side by one value)
+    uint32_t srcOffset, dstOffset;
+    if (getSampleByteOffset(src, 0, srcChannel, &srcOffset) != 0 || getSampleByteOffset(dst, 0, dstChannel, &dstOffset) != 0) {
+        return -1; // Invalid sample access
+    }
+    const size_t srcStep = src->plane_stride ? 1 : src->bytes_per_sample;
+    const size_t dstStep = dst->plane_stride ? 1 : dst->bytes_per_sample / sizeof(int16_t);
+    const int8_t *srcData = (const int8_t*)&src->valueBuffer[srcOffset];
+    int16_t *simd_data = (int16_t*)&dst->valueBuffer[dstOffset];
     for (uint32_t i = 0; i < src->nr_of_samples; ++i) {
-        uint32_t srcSampleOffset;
-        if (getSampleByteOffset(src, i, srcChannel, &srcSampleOffset) != 0) {
-            return -1; // Invalid sample access
-        }
-        uint32_t dstSampleOffset;
-        if (getSampleByteOffset(dst, i, dstChannel, &dstSampleOffset) != 0) {
-            return -1; // Invalid sample access
-        }
-        int8_t srcData= *(int8_t*)&src->valueBuffer[srcSampleOffset];
-        int16_t *simd_data = (int16_t*)&dst->valueBuffer[dstSampleOffset];
-        *simd_data = srcData;
+        simd_data[i * dstStep] = srcData[i * srcStep];
     }
 
     return 0;
@@ -363,23 +1012,31 @@ int prepare_AggregationMinMax(const RawTimelineValuesBuf *input, RawTimelineValu
     if (!input || !outMin || !outMax) {
         return -1; // Invalid input
     }
-    if (input->value_type != TR_analog_sint8 && input->value_type != TR_SIMD_sint16x8) {
+    if (input->value_type != TR_analog_sint8 && input->value_type != TR_SIMD_sint16x8 && input->value_type != TR_SIMD_sint24x8) {
         return -1; // Unsupported value type
     }
+    // 24-bit samples are aggregated into 8-bit display values (the upper byte, >> 16), see aggregate_minmax_SIMD_s24x8_c
+    RawTimelineValueEnum out_type = input->value_type;
+    uint8_t out_bitwidth = input->bitwidth;
+    if (input->value_type == TR_SIMD_sint24x8) {
+        out_type = TR_analog_sint8;
+        out_bitwidth = 8;
+    }
+    uint8_t out_alignment = (uint8_t)((input->nr_of_channels * out_bitwidth + 7) / 8);
 
     outMin->time_exponent = input->time_exponent;
     outMin->time_step = input->time_step;
-    outMin->value_type = input->value_type;
+    outMin->value_type = out_type;
     outMin->nr_of_samples = outSampleNr;
     outMin->nr_of_channels = input->nr_of_channels;
-    alloc_RawTimelineValuesBuf(outMin, outSampleNr, input->nr_of_channels, input->bitwidth, input->bytes_per_sample, input->value_type);
+    alloc_RawTimelineValuesBuf(outMin, outSampleNr, input->nr_of_channels, out_bitwidth, out_alignment, out_type);
     
     outMax->time_exponent = input->time_exponent;
     outMax->time_step = input->time_step;
-    outMax->value_type = input->value_type;
+    outMax->value_type = out_type;
     outMax->nr_of_samples = outSampleNr;
     outMax->nr_of_channels = input->nr_of_channels;
-    alloc_RawTimelineValuesBuf(outMax, outSampleNr, input->nr_of_channels, input->bitwidth, input->bytes_per_sample, input->value_type);
+    alloc_RawTimelineValuesBuf(outMax, outSampleNr, input->nr_of_channels, out_bitwidth, out_alignment, out_type);
 
     return (outMin->valueBuffer && outMax->valueBuffer) ? 0 : -1;
 }
@@ -388,29 +1045,390 @@ int aggregate_MinMax(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *ou
     if (!input || !outMin || !outMax) {
         return -1; // Invalid input
     }
-    if (input->value_type != TR_analog_sint8 && input->value_type != TR_SIMD_sint16x8) {
-        return -1; // Unsupported value type
-    }
-    // choose fn based on config and buffer type.
+    RawTimelineValuesView view;
+    make_RawTimelineValuesView(input, inOffset, (inSamples > 0) ? inSamples : input->nr_of_samples, &view);
+    return aggregate_MinMax_view(&view, outMin, outMax);
+}
+
+// The min/max kernel for columns of 'stride' samples of the buffer: the backend's, or the pyramid when it pays off.
+fn_aggregate_minmax getMinMaxKernel(const RawTimelineValuesBuf *input, double stride) {
     fn_aggregate_minmax minmax_fn;
     if (input->value_type == TR_analog_sint8) {
-        minmax_fn = g_TimelineBackendFunctions->aggregate_minmax_s8;
+        minmax_fn = getActiveBackend()->aggregate_minmax_s8;
     } else if (input->value_type == TR_SIMD_sint16x8) {
-        minmax_fn = g_TimelineBackendFunctions->aggregate_minmax_s16x8;
+        minmax_fn = getActiveBackend()->aggregate_minmax_s16x8;
+    } else if (input->value_type == TR_SIMD_sint24x8) {
+        minmax_fn = getActiveBackend()->aggregate_minmax_s24x8;
     } else {
         fprintf(stderr, "Unsupported value type for aggregation\n");
+        return NULL; // Unsupported value type
+    }
+    // zoomed out far enough: answer each column from the coarsest pyramid blocks instead of the raw samples
+    // (below ~16 blocks per column the vertical SIMD scan is faster than walking the pyramid)
+    // (a ring pyramid is only usable when it is up to date, stale blocks would hold overwritten samples)
+    const TimelineMinMaxPyramid *pyr = input->minmax_pyramid;
+    if (pyr && stride >= (double)(16u << pyr->base_shift) &&
+        (input->capacity == 0 || pyr->built_samples == input->ring_total)) {
+        minmax_fn = aggregate_minmax_pyramid;
+    }
+    return minmax_fn;
+}
+
+/*
+    The columns of one aggregate_MinMax_view call: the kernel (backend or pyramid) and the window in storage slots are
+    resolved once, every column is then independent of the others, so any subset of them can be computed on its own.
+*/
+typedef struct {
+    fn_aggregate_minmax minmax_fn;
+    RawTimelineValuesBuf window;
+    RawTimelineValuesBuf *outMin;
+    RawTimelineValuesBuf *outMax;
+    uint32_t first;
+    uint32_t in_samples;
+    float stride_f;
+} MinMaxColumns;
+
+static int prepare_MinMaxColumns(const RawTimelineValuesView *view, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, MinMaxColumns *cols) {
+    if (!view || !view->buf || !outMin || !outMax) {
+        return -1; // Invalid input
+    }
+    const RawTimelineValuesBuf *input = view->buf;
+    if (input->value_type != TR_analog_sint8 && input->value_type != TR_SIMD_sint16x8 && input->value_type != TR_SIMD_sint24x8) {
         return -1; // Unsupported value type
     }
-    // run multiple passes to aggregate min and max values
-    uint32_t in_samples = (inSamples > 0) ? inSamples : input->nr_of_samples;
+    // The kernels address the samples from valueBuffer, so the view is translated to storage slots.
+    // In ring mode the mirrored storage keeps [first, first + length) contiguous.
+    cols->first = (input->capacity ? input->ring_head : 0) + view->offset;
+    cols->in_samples = view->length;
+    cols->window = *input;
+    cols->window.nr_of_samples = cols->first + cols->in_samples; // kernels bound-check against the end of the view
+    cols->outMin = outMin;
+    cols->outMax = outMax;
+    cols->stride_f = (float)cols->in_samples / (float)outMin->nr_of_samples;
+    cols->minmax_fn = getMinMaxKernel(input, cols->stride_f);
+    return cols->minmax_fn ? 0 : -1;
+}
+
+static void aggregate_MinMaxColumns(const MinMaxColumns *cols, uint32_t col_lo, uint32_t col_hi) {
+    const uint32_t first = cols->first;
+    for (uint32_t i = col_lo; i < col_hi; ++i) {
+        uint32_t start = first + (uint32_t)floorf(i * cols->stride_f);
+        uint32_t end = first + (uint32_t)floorf((i + 1) * cols->stride_f);
+        if (end <= start) end = start + 1;
+        if (end > first + cols->in_samples) end = first + cols->in_samples;
+        cols->minmax_fn(&cols->window, cols->outMin, cols->outMax, i, start, end);
+    }
+}
+
+int aggregate_MinMax_view(const RawTimelineValuesView *view, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax) {
+    MinMaxColumns cols;
+    if (prepare_MinMaxColumns(view, outMin, outMax, &cols) != 0) {
+        return -1;
+    }
+    aggregate_MinMaxColumns(&cols, 0, outMin->nr_of_samples);
+    return 0;
+}
+
+/*
+    Parallel aggregation: the columns of every view are cut into chunks (about 4 chunks per thread over all views,
+    for load balance when the views differ in cost), each chunk is one task of the worker pool.
+    The view tables are on the stack, so a frame does not touch the heap: up to TIMELINE_PARALLEL_VIEWS views go to
+    the pool in one run, more views are split into runs of that many.
+*/
+#define TIMELINE_PARALLEL_MIN_COLUMNS 16
+#define TIMELINE_PARALLEL_VIEWS 16
+
+typedef struct {
+    MinMaxColumns cols[TIMELINE_PARALLEL_VIEWS];
+    uint32_t first_task[TIMELINE_PARALLEL_VIEWS + 1]; // first task index of every view, the last one is the task count
+    uint32_t chunk;
+} MinMaxParallelJob;
+
+static void aggregate_MinMax_task(void *ctx, uint32_t task) {
+    const MinMaxParallelJob *job = (const MinMaxParallelJob*)ctx;
+    uint32_t v = 0;
+    while (task >= job->first_task[v + 1]) v++;
+    const MinMaxColumns *cols = &job->cols[v];
+    uint32_t col_lo = (task - job->first_task[v]) * job->chunk;
+    uint32_t col_hi = col_lo + job->chunk;
+    if (col_hi > cols->outMin->nr_of_samples) col_hi = cols->outMin->nr_of_samples;
+    aggregate_MinMaxColumns(cols, col_lo, col_hi);
+}
+
+int aggregate_MinMax_parallel(const RawTimelineValuesView *views, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t nr_of_views) {
+    if (!views || !outMin || !outMax || nr_of_views == 0) {
+        return -1; // Invalid input
+    }
+    MinMaxParallelJob job;
+    for (uint32_t first = 0; first < nr_of_views; first += TIMELINE_PARALLEL_VIEWS) {
+        const uint32_t n = (nr_of_views - first < TIMELINE_PARALLEL_VIEWS) ? nr_of_views - first : TIMELINE_PARALLEL_VIEWS;
+        uint64_t total_columns = 0;
+        for (uint32_t v = 0; v < n; ++v) {
+            // kernels are resolved here, on the calling thread
+            if (prepare_MinMaxColumns(&views[first + v], &outMin[first + v], &outMax[first + v], &job.cols[v]) != 0) {
+                return -1;
+            }
+            total_columns += outMin[first + v].nr_of_samples;
+        }
+        uint64_t chunk = total_columns / (4 * (uint64_t)getTimelineWorkersCount());
+        if (chunk < TIMELINE_PARALLEL_MIN_COLUMNS) chunk = TIMELINE_PARALLEL_MIN_COLUMNS;
+        job.chunk = (uint32_t)chunk;
+        job.first_task[0] = 0;
+        for (uint32_t v = 0; v < n; ++v) {
+            job.first_task[v + 1] = job.first_task[v] + (uint32_t)((outMin[first + v].nr_of_samples + chunk - 1) / chunk);
+        }
+        run_TimelineWorkers(aggregate_MinMax_task, &job, job.first_task[n]);
+    }
+    return 0;
+}
+
+/*
+    AGGREGATION STATISTICS
+    Mean and RMS of every channel per output column, with the same column bounds as aggregate_MinMax. The backend's
+    aggregate_stats kernel returns the exact integer sum, sum of squares, min and max of the column, so the min/max
+    columns (optional, from prepare_AggregationMinMax) come from the same pass.
+*/
+int prepare_AggregationStats(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMean, RawTimelineValuesBuf *outRms, uint32_t outSampleNr) {
+    if (!input || !outMean || !outRms) {
+        return -1; // Invalid input
+    }
+    if (input->value_type != TR_analog_sint8 && input->value_type != TR_SIMD_sint16x8 && input->value_type != TR_SIMD_sint24x8) {
+        return -1; // Unsupported value type
+    }
+    RawTimelineValuesBuf *outs[2] = { outMean, outRms };
+    for (int k = 0; k < 2; ++k) {
+        alloc_RawTimelineValuesBuf(outs[k], outSampleNr, input->nr_of_channels, 32, 16, TR_analog_float32);
+        outs[k]->time_exponent = input->time_exponent;
+        outs[k]->time_step = input->time_step;
+    }
+    return (outMean->valueBuffer && outRms->valueBuffer) ? 0 : -1;
+}
+
+int aggregate_Stats(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMean, RawTimelineValuesBuf *outRms, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t inSamples, uint32_t inOffset) {
+    if (!input || !outMean || !outRms) {
+        return -1; // Invalid input
+    }
+    RawTimelineValuesView view;
+    make_RawTimelineValuesView(input, inOffset, (inSamples > 0) ? inSamples : input->nr_of_samples, &view);
+    return aggregate_Stats_view(&view, outMean, outRms, outMin, outMax);
+}
+
+// Statistics kernel of the active backend for the value type, NULL if the type has none (also used by the block sidecar)
+fn_aggregate_stats getStatsKernel(RawTimelineValueEnum value_type) {
+    if (value_type == TR_analog_sint8) return getActiveBackend()->aggregate_stats_s8;
+    if (value_type == TR_SIMD_sint16x8) return getActiveBackend()->aggregate_stats_s16x8;
+    if (value_type == TR_SIMD_sint24x8) return getActiveBackend()->aggregate_stats_s24x8;
+    return NULL;
+}
+
+int getCodecKernels(RawTimelineValueEnum value_type, fn_codec_encode *encode, fn_codec_decode *decode) {
+    if (value_type == TR_SIMD_sint16x8) {
+        *encode = getActiveBackend()->codec_encode_s16x8;
+        *decode = getActiveBackend()->codec_decode_s16x8;
+        return 0;
+    }
+    if (value_type == TR_SIMD_sint24x8) {
+        *encode = getActiveBackend()->codec_encode_s24x8;
+        *decode = getActiveBackend()->codec_decode_s24x8;
+        return 0;
+    }
+    return -1;
+}
+
+int getTransposeKernels(RawTimelineValueEnum value_type, fn_transpose *to_planar, fn_transpose *from_planar) {
+    if (value_type == TR_SIMD_sint16x8) {
+        *to_planar = getActiveBackend()->transpose_to_planar_s16x8;
+        *from_planar = getActiveBackend()->transpose_from_planar_s16x8;
+        return 0;
+    }
+    if (value_type == TR_SIMD_sint24x8) {
+        *to_planar = getActiveBackend()->transpose_to_planar_s24x8;
+        *from_planar = getActiveBackend()->transpose_from_planar_s24x8;
+        return 0;
+    }
+    return -1;
+}
+
+int aggregate_Stats_view(const RawTimelineValuesView *view, RawTimelineValuesBuf *outMean, RawTimelineValuesBuf *outRms, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax) {
+    if (!view || !view->buf || !outMean || !outRms || (!outMin) != (!outMax)) {
+        return -1; // Invalid input
+    }
+    const RawTimelineValuesBuf *input = view->buf;
+    const uint32_t ch = input->nr_of_channels;
+    fn_aggregate_stats stats_fn = getStatsKernel(input->value_type);
+    if (!stats_fn) {
+        fprintf(stderr, "Unsupported value type for aggregation\n");
+        return -1; // Unsupported value type
+    }
+    uint32_t out_samples = outMean->nr_of_samples;
+    if (outMean->value_type != TR_analog_float32 || outRms->value_type != TR_analog_float32 ||
+        outMean->nr_of_channels != ch || outRms->nr_of_channels != ch || outRms->nr_of_samples != out_samples ||
+        (outMin && (outMin->nr_of_channels != ch || outMin->nr_of_samples != out_samples || outMax->nr_of_samples != out_samples))) {
+        fprintf(stderr, "Output buffers do not match the statistics aggregation\n");
+        return -1;
+    }
+    // ring windows are contiguous in the mirrored storage, see aggregate_MinMax_view
+    uint32_t first = (input->capacity ? input->ring_head : 0) + view->offset;
+    uint32_t in_samples = view->length;
+    RawTimelineValuesBuf window = *input;
+    window.nr_of_samples = first + in_samples;
+
+    TimelineChannelSums sums[TIMELINE_STREAM_MAX_CHANNELS];
+    float stride_f = (float)in_samples / (float)out_samples;
+    for (uint32_t i = 0; i < out_samples; ++i) {
+        uint32_t start = first + (uint32_t)floorf(i * stride_f);
+        uint32_t end = first + (uint32_t)floorf((i + 1) * stride_f);
+        if (end <= start) end = start + 1;
+        if (end > first + in_samples) end = first + in_samples;
+        stats_fn(&window, start, end, sums);
+        const double count = (end > start) ? (double)(end - start) : 1.0;
+        float *mean = (float*)&outMean->valueBuffer[(size_t)i * outMean->bytes_per_sample];
+        float *rms = (float*)&outRms->valueBuffer[(size_t)i * outRms->bytes_per_sample];
+        for (uint32_t c = 0; c < ch; ++c) {
+            double sum_sq = (double)sums[c].sum_sq_hi * 18446744073709551616.0 + (double)sums[c].sum_sq;
+            mean[c] = (float)((double)sums[c].sum / count);
+            rms[c] = (float)sqrt(sum_sq / count);
+        }
+        if (!outMin) continue;
+        // same output types as aggregate_MinMax: s8 -> s8, s16 -> s16, s24 -> upper 8 bits
+        if (input->value_type == TR_SIMD_sint16x8) {
+            int16_t *dmin = (int16_t*)&outMin->valueBuffer[(size_t)i * outMin->bytes_per_sample];
+            int16_t *dmax = (int16_t*)&outMax->valueBuffer[(size_t)i * outMax->bytes_per_sample];
+            for (uint32_t c = 0; c < ch; ++c) {
+                dmin[c] = (int16_t)sums[c].min;
+                dmax[c] = (int16_t)sums[c].max;
+            }
+        } else {
+            const int shift = (input->value_type == TR_SIMD_sint24x8) ? 16 : 0;
+            int8_t *dmin = (int8_t*)&outMin->valueBuffer[(size_t)i * outMin->bytes_per_sample];
+            int8_t *dmax = (int8_t*)&outMax->valueBuffer[(size_t)i * outMax->bytes_per_sample];
+            for (uint32_t c = 0; c < ch; ++c) {
+                dmin[c] = (int8_t)(sums[c].min >> shift);
+                dmax[c] = (int8_t)(sums[c].max >> shift);
+            }
+        }
+    }
+    return 0;
+}
+
+/*
+    FUSED RESAMPLING AND MIN/MAX
+    Display path of a rate converted signal: the same columns as convert_sample_rate_stream over the view followed by
+    aggregate_MinMax of all converted samples, but the converted samples are never stored. Resampled sample k sits at
+    input position k * down / up, the positions are stepped a block at a time across the columns (one division per
+    block) and the backend's resample_minmax kernel folds the interpolated samples of a column into its min / max row.
+*/
+#define TIMELINE_RESAMPLE_NARROW_COLUMN 4.0f  // resampled samples per column below which the columns take the block path
+#define TIMELINE_RESAMPLE_NARROW_BLOCK  8192  // int16 values of the block of the narrow column path (16 KB)
+
+int aggregate_MinMax_resampled_view(const RawTimelineValuesView *view, uint32_t in_rate_hz, uint32_t out_rate_hz, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax) {
+    RawTimelineValuesBuf window;
+    if (!outMin || !outMax || in_rate_hz == 0 || out_rate_hz == 0 || map_RawTimelineValuesView(view, &window) != 0) {
+        return -1; // Invalid input
+    }
+    const uint32_t ch = window.nr_of_channels;
+    if (window.value_type != TR_SIMD_sint16x8 || outMin->value_type != TR_SIMD_sint16x8 || outMax->value_type != TR_SIMD_sint16x8 ||
+        outMin->nr_of_channels != ch || outMax->nr_of_channels != ch || !outMin->valueBuffer || !outMax->valueBuffer ||
+        outMax->nr_of_samples != outMin->nr_of_samples) {
+        fprintf(stderr, "Unsupported buffers for resampled aggregation\n");
+        return -1;
+    }
+    if (window.nr_of_samples < 2) {
+        fprintf(stderr, "Resampled aggregation needs at least 2 input samples\n");
+        return -1;
+    }
+    uint32_t g = gcd_u32(in_rate_hz, out_rate_hz);
+    const uint32_t up = out_rate_hz / g;
+    const uint32_t down = in_rate_hz / g;
+    // resampled samples k with floor(k * down / up) + 1 < nr_of_samples
+    uint64_t resampled = ((uint64_t)(window.nr_of_samples - 1) * up + down - 1) / down;
+    if (resampled > UINT32_MAX) {
+        fprintf(stderr, "Too many resampled samples for aggregation\n");
+        return -1;
+    }
+    const TimelineBackendFunctions *backend = getActiveBackend();
+    const int16_t *src = (const int16_t*)window.valueBuffer;
+    const uint32_t in_samples = (uint32_t)resampled;
     uint32_t out_samples = outMin->nr_of_samples;
     float stride_f = (float)in_samples / (float)out_samples;
+    SampleRatePhase phase = { 0, 0, down / up, down % up, up };
+    if (stride_f < TIMELINE_RESAMPLE_NARROW_COLUMN && ch <= TIMELINE_RESAMPLE_NARROW_BLOCK / 32) {
+        /*
+            Narrow columns (zoomed in, a few resampled samples each): a kernel call per column costs more than the
+            samples it folds. The resampled samples are produced a block at a time into an L1 buffer with
+            resample_span instead, and the columns take their min / max from it with the backend's min/max kernel.
+        */
+        int16_t block[TIMELINE_RESAMPLE_NARROW_BLOCK];
+        const uint32_t rows = TIMELINE_RESAMPLE_NARROW_BLOCK / ch; // >= 32, more than a narrow column
+        RawTimelineValuesBuf block_buf = window;
+        block_buf.valueBuffer = (unsigned char*)block;
+        block_buf.capacity = 0;
+        block_buf.ring_head = 0;
+        block_buf.minmax_pyramid = NULL;
+        uint32_t block_start = 0;
+        uint32_t block_end = 0;
+        for (uint32_t i = 0; i < out_samples; ++i) {
+            // same column bounds as aggregate_MinMax_view
+            uint32_t start = (uint32_t)floorf(i * stride_f);
+            uint32_t end = (uint32_t)floorf((i + 1) * stride_f);
+            if (end <= start) end = start + 1;
+            if (end > in_samples) end = in_samples;
+            if (start < block_start || end > block_end) {
+                if (start != block_end) { // consecutive blocks continue the phase
+                    uint64_t pos = (uint64_t)start * down;
+                    phase.idx = (uint32_t)(pos / up);
+                    phase.accum = (uint32_t)(pos % up);
+                }
+                block_start = start;
+                block_end = (in_samples - start > rows) ? start + rows : in_samples;
+                backend->resample_span_s16x8(src, ch, &phase, block, block_end - block_start);
+                block_buf.nr_of_samples = block_end - block_start;
+            }
+            backend->aggregate_minmax_s16x8(&block_buf, outMin, outMax, i, start - block_start, end - block_start);
+        }
+        return 0;
+    }
+    // positions of the resampled samples [pos_start, pos_end), stepped a block at a time across the columns
+    uint32_t pos_idx[TIMELINE_RESAMPLE_BLOCK];
+    uint32_t pos_frac[TIMELINE_RESAMPLE_BLOCK];
+    uint32_t pos_start = 0;
+    uint32_t pos_end = 0;
     for (uint32_t i = 0; i < out_samples; ++i) {
-        uint32_t start = inOffset + (uint32_t)floorf(i * stride_f);
-        uint32_t end = inOffset + (uint32_t)floorf((i + 1) * stride_f);
+        // same column bounds as aggregate_MinMax_view
+        uint32_t start = (uint32_t)floorf(i * stride_f);
+        uint32_t end = (uint32_t)floorf((i + 1) * stride_f);
         if (end <= start) end = start + 1;
-        if (end > inOffset + in_samples) end = inOffset + in_samples;
-        minmax_fn(input, outMin, outMax, i, start, end);
+        if (end > in_samples) end = in_samples;
+        int16_t *min = (int16_t*)&outMin->valueBuffer[(size_t)i * outMin->bytes_per_sample];
+        int16_t *max = (int16_t*)&outMax->valueBuffer[(size_t)i * outMax->bytes_per_sample];
+        for (uint32_t c = 0; c < ch; ++c) {
+            min[c] = INT16_MAX;
+            max[c] = INT16_MIN;
+        }
+        for (uint32_t k = start; k < end; ) {
+            if (k < pos_start || k >= pos_end) {
+                if (k != pos_end) { // the phase is at pos_end, a column start before it or far after it seeks
+                    uint64_t pos = (uint64_t)k * down;
+                    phase.idx = (uint32_t)(pos / up);
+                    phase.accum = (uint32_t)(pos % up);
+                }
+                pos_start = k;
+                pos_end = (in_samples - k > TIMELINE_RESAMPLE_BLOCK) ? k + TIMELINE_RESAMPLE_BLOCK : in_samples;
+                positions_SampleRatePhase(&phase, pos_end - pos_start, pos_idx, pos_frac);
+            }
+            const uint32_t n = ((end < pos_end) ? end : pos_end) - k;
+            backend->resample_minmax_s16x8(src, ch, &pos_idx[k - pos_start], &pos_frac[k - pos_start], n, min, max);
+            k += n;
+        }
     }
     return 0;
 }
+
+int aggregate_MinMax_resampled(const RawTimelineValuesBuf *input, uint32_t in_rate_hz, uint32_t out_rate_hz, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t inSamples, uint32_t inOffset) {
+    if (!input || !outMin || !outMax) {
+        return -1; // Invalid input
+    }
+    RawTimelineValuesView view;
+    make_RawTimelineValuesView(input, inOffset, (inSamples > 0) ? inSamples : input->nr_of_samples, &view);
+    return aggregate_MinMax_resampled_view(&view, in_rate_hz, out_rate_hz, outMin, outMax);
+}
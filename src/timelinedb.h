@@ -33,43 +33,284 @@ typedef enum {
 } RawTimelineValueEnum;
 
 typedef struct {
-    uint32_t idx0;
-    uint32_t idx1;
-    uint16_t frac;
-    uint16_t inv_frac;
+    uint32_t idx0;      // input sample left of the output, relative to the first input sample of its period
+    uint32_t frac;      // Q16 weight of sample idx0 + 1, 0 .. 0x10000
+    uint32_t inv_frac;  // Q16 weight of sample idx0, 0x10000 - frac (0x10000 does not fit in 16 bits)
 } SampleInterpInfo;
 
+/*
+ Prepared interpolation positions of a sample rate conversion with the rational ratio up / down (output / input rate).
+ Output i = q * period_outputs + j uses phases[j], shifted by q * period_inputs input samples,
+ so only one period is stored (nr_of_phases = min(period_outputs, output samples)) instead of one entry per output.
+*/
+typedef struct {
+    uint32_t period_outputs; // up / gcd: the phase pattern repeats after this many outputs ...
+    uint32_t period_inputs;  // down / gcd: ... which advance the input by this many samples
+    uint32_t nr_of_phases;
+    SampleInterpInfo phases[];
+} SampleInterpTable;
+
 typedef struct {
     double rate_ratio;
+    uint32_t cic_ratio;     // CIC decimation (prepare_CicDecimation): input samples per output sample, 0 otherwise
+    uint8_t  cic_stages;
+    uint8_t  cic_compensate;
 } SampleRateInfo;
 
+/*
+ Multi-resolution min/max index (mip-map) of a RawTimelineValuesBuf.
+ Level k stores the min and max of every 2^(base_shift+k) samples for each channel (interleaved, like the raw buffer).
+ Only complete blocks are stored; the not yet complete tail is always scanned from the raw samples.
+*/
+#define TIMELINE_PYRAMID_MAX_LEVELS 24
+#define TIMELINE_PYRAMID_BASE_SHIFT 5   // level 0 block is 32 samples
+
+typedef struct {
+    uint8_t  nr_of_levels;
+    uint8_t  base_shift;
+    uint8_t  nr_of_channels;
+    uint32_t capacity;                                  // samples covered by the allocated levels
+    uint32_t built_samples;                             // samples (ring: appended in total) already folded
+    uint32_t level_blocks[TIMELINE_PYRAMID_MAX_LEVELS]; // number of valid blocks per level
+    int32_t *level_min[TIMELINE_PYRAMID_MAX_LEVELS];
+    int32_t *level_max[TIMELINE_PYRAMID_MAX_LEVELS];
+} TimelineMinMaxPyramid;
+
+/*
+ Statistics of one channel over a range of samples (aggregate_RangeStats), also the entries of the block sidecar.
+ min / max are in the scale of the input. sum_sq is 128-bit (sum_sq_hi:sum_sq), 24-bit squares overflow 64 bits.
+ clip_count counts the samples at or beyond the clip level of the sidecar (full scale without a sidecar).
+*/
+typedef struct {
+    int64_t  sum;
+    uint64_t sum_sq;
+    uint64_t sum_sq_hi;
+    int32_t  min;
+    int32_t  max;
+    uint32_t clip_count;
+    uint32_t count;
+} TimelineChannelStats;
+
+/*
+ Per-block statistics sidecar (init_BlockStats): a TimelineChannelStats for every 2^block_shift samples per channel.
+ Like the pyramid it indexes storage slots, only complete blocks are stored. append_RawTimelineValues keeps it up to
+ date in ring mode, linear buffers call update_BlockStats after writing new samples.
+*/
+#define TIMELINE_BLOCKSTATS_DEFAULT_SHIFT 10   // 1024 samples per block
+
+typedef struct {
+    uint8_t  block_shift;
+    uint8_t  nr_of_channels;
+    int32_t  clip_low;       // a sample <= clip_low or >= clip_high is counted as clipped
+    int32_t  clip_high;
+    uint32_t capacity;       // samples covered by the allocated blocks
+    uint32_t built_samples;  // samples (ring: appended in total) already folded
+    uint32_t nr_of_blocks;   // number of valid blocks
+    TimelineChannelStats *blocks; // nr_of_blocks rows of nr_of_channels entries
+} TimelineBlockStats;
+
+/*
+ Allocator of the sample memory (valueBuffer), the prepared conversion state, the scratch and the indexes (pyramid,
+ block statistics) of a buffer. NULL is the heap
+ (malloc / aligned_alloc). A buffer uses the allocator set in its 'allocator' field, after init_RawTimelineValuesBuf and
+ before alloc_*; it must not change while the buffer holds memory. alloc returns memory aligned to 'alignment'
+ (a power of two, at most 64), free takes any pointer returned by alloc of the same allocator.
+*/
+typedef struct {
+    void *(*alloc)(void *ctx, size_t size, size_t alignment);
+    void  (*free)(void *ctx, void *ptr);
+    void  *ctx;
+} TimelineAllocator;
+
 /*
  Interlaved channel data is stored in a single buffer, where samples are stored in a linear sequence, and one sample may contains multiple channels.
+ The TR_SIMD_* types are not limited to 8 channels: the kernels process the channels in 8 (or 16) lane groups,
+ a remainder group is done with masks or overlapping loads, so one buffer can hold all channels of a device.
+ Ring mode (capacity > 0): the buffer keeps the last 'capacity' appended samples. The oldest one is at slot ring_head,
+ the next one is written at slot ring_tail. Every slot is stored twice (at s and s + capacity), so any window of the ring
+ is contiguous in memory, starting at valueBuffer + (ring_head + offset) * bytes_per_sample.
+ Planar mode (plane_stride > 0, prepare_PlanarBuffer): every channel is a contiguous plane of nr_of_samples values,
+ channel c starts at valueBuffer + c * plane_stride. bytes_per_sample stays the size of one interleaved sample.
 */
 typedef struct {
     uint32_t buffer_size;
     uint32_t nr_of_samples;
+    uint32_t capacity;   // ring mode: number of sample slots, 0 for a linear buffer
+    uint32_t ring_head;  // ring mode: slot of the oldest sample
+    uint32_t ring_tail;  // ring mode: slot of the next appended sample
+    uint32_t ring_total; // ring mode: number of samples appended since allocation (absolute index of the next sample)
     uint32_t time_step; // per sample in units given by time_exponent
     double   total_time_sec; // total duration covered by the raw samples
     int8_t   time_exponent;
     uint8_t  nr_of_channels;
     uint8_t  bitwidth;
-    uint8_t  bytes_per_sample; // (7+ channel * bitwidth) / 8
+    uint16_t bytes_per_sample; // (7+ channel * bitwidth) / 8, wide buffers (e.g. 80 x 24-bit) do not fit in a byte
+    uint32_t plane_stride;     // planar mode: bytes from one channel plane to the next, 0 for interleaved
     RawTimelineValueEnum value_type;
     unsigned char *valueBuffer;
     SampleRateInfo *sample_rate_info; // This is used for sample rate conversion
-    SampleInterpInfo *prepared_data_src;
+    SampleInterpTable *prepared_data_src; // one period of interpolation positions (prepare_SampleRateConversion)
+    TimelineMinMaxPyramid *minmax_pyramid; // optional, used by aggregate_MinMax for zoomed-out windows
+    TimelineBlockStats *block_stats;       // optional, used by aggregate_RangeStats
+    const TimelineAllocator *allocator;    // memory of valueBuffer and everything else the buffer owns, NULL: heap
+    uint32_t allocated_size;               // bytes of the owned valueBuffer allocation, 0 if none (views, mappings)
+    unsigned char *scratch;                // working memory of the calls writing this buffer (CIC state, polyphase pre-
+    uint32_t scratch_size;                 // decimation, compressed / segmented min/max), kept until free_RawTimelineValuesBuf
 } RawTimelineValuesBuf;
 
+/*
+ Read-only window of a buffer: 'length' samples starting 'offset' samples after the oldest one.
+ A view never owns or copies sample data.
+*/
+typedef struct {
+    const RawTimelineValuesBuf *buf;
+    uint32_t offset;
+    uint32_t length;
+} RawTimelineValuesView;
+
+/*
+ Shared buffer for concurrent readers: one writer appends, any number of readers take snapshots.
+ A snapshot is an immutable, reference-counted linear buffer of the samples committed when it was taken, usable with
+ every read-only call (aggregate_*, convert_*, map views). The samples live in versions: the writer appends into the
+ spare slots of the current version (never read by anyone yet), a full version is replaced by a new one holding the
+ kept samples, the old one is freed when the last snapshot is released and no reader can still be picking it up (epochs).
+ Readers never block the writer and the writer never blocks readers.
+*/
+#define TIMELINE_SNAPSHOT_READERS 64
+
+typedef struct TimelineSnapshotVersion TimelineSnapshotVersion;
+
+typedef struct {
+    RawTimelineValuesBuf layout;        // type, channels and timebase of the stream, set before sharing (no samples)
+    TimelineSnapshotVersion *current;   // version the writer appends to
+    TimelineSnapshotVersion *retired;   // replaced versions waiting for the readers' epochs
+    uint32_t initial_capacity;
+    uint32_t max_samples;               // samples kept when a version is replaced (0: all)
+    uint64_t epoch;                     // incremented by every version replacement
+    uint64_t reader_epochs[TIMELINE_SNAPSHOT_READERS]; // epoch pinned by a reader taking a snapshot, 0: free slot
+} TimelineSharedBuf;
+
+typedef struct {
+    RawTimelineValuesBuf buf;           // linear, nr_of_samples committed samples, owned by the snapshot (do not free)
+    uint64_t first_sample;              // absolute index of buf's first sample in the stream
+    TimelineSnapshotVersion *version;
+} TimelineSnapshot;
+
+/*
+ Segmented timeline: 64-bit sample addressing over a list of fixed size linear segments (2^segment_shift samples each,
+ SIMD aligned like any RawTimelineValuesBuf). Appending fills the last segment and adds new ones, sample memory is
+ never reallocated or copied, so a timeline can grow past the 32-bit sample count and the 4 GB buffer_size of a single
+ RawTimelineValuesBuf. Every segment is an ordinary linear buffer: the kernels run on it segment by segment.
+*/
+#define TIMELINE_SEGMENT_DEFAULT_SHIFT 20   // 1M samples per segment
+#define TIMELINE_SEGMENTS_PYRAMID    0x01   // every segment gets a min/max pyramid, kept up to date by the append
+#define TIMELINE_SEGMENTS_BLOCKSTATS 0x02   // every segment gets a block statistics sidecar (full scale clip level)
+
+typedef struct {
+    RawTimelineValuesBuf layout;    // type, channels and timebase of the samples (no samples)
+    RawTimelineValuesBuf *segments; // nr_of_segments linear buffers, all but the last one full
+    uint32_t nr_of_segments;
+    uint32_t max_segments;          // allocated entries of segments (the table grows, the segments never move)
+    uint8_t  segment_shift;
+    uint8_t  bytealignment;
+    uint8_t  flags;                 // TIMELINE_SEGMENTS_*
+    uint64_t nr_of_samples;
+} TimelineSegmentedBuf;
+
+/*
+ Compressed timeline (compress_RawTimelineValues): lossless blocks of TIMELINE_CODEC_BLOCK samples, every 8-channel
+ group of a block is coded on its own: per channel first-order delta, zigzag, frame of reference bit packing with the
+ group's bit width. Each group starts with the first value, min and max of its channels, so aggregate_MinMax_compressed
+ answers the blocks a column covers completely from the headers and decodes only the blocks at the column edges.
+ TR_SIMD_sint16x8 and TR_SIMD_sint24x8 buffers, any channel count.
+*/
+#define TIMELINE_CODEC_BLOCK 128
+
+typedef struct {
+    RawTimelineValuesBuf layout;    // type, channels and timebase of the decoded samples (no samples)
+    uint32_t nr_of_samples;
+    uint32_t nr_of_blocks;
+    uint32_t *block_offsets;        // nr_of_blocks + 1 byte offsets into data
+    uint8_t  *data;
+    uint32_t data_size;
+} TimelineCompressedBuf;
+
+/*
+ Timeline file (.tldb): a 64 byte header with the buffer metadata (value type, channels, bitwidth, sample size, timebase,
+ sample count), then the interleaved samples from offset 64, zero padded to a multiple of 64 bytes. Native byte order.
+ open_TimelineFile maps the file read-only and points buf.valueBuffer straight into the mapping: nothing is read
+ until a function touches the samples, the pages come in lazily (and can be evicted) under e.g. aggregate_MinMax.
+*/
+#define TIMELINE_FILE_HEADER_SIZE 64
+
+typedef struct {
+    RawTimelineValuesBuf buf;   // linear, read-only, valueBuffer inside the mapping (do not free, use close_TimelineFile)
+    void    *mapping;
+    uint64_t mapping_size;
+} TimelineFile;
+
+/*
+ Backends are detected at runtime (cpuid / getauxval). Index 0 is always the C backend,
+ the following ones are the SIMD variants supported by this CPU, the fastest first. The best one is active by default.
+ getBackendName with an out of range index (e.g. -1) returns the name of the active backend.
+*/
 uint8_t getBackendsCount();
 int getBackendName(uint8_t index, const char **name);
 int setBackend(uint8_t index);
 
 void init_RawTimelineValuesBuf(RawTimelineValuesBuf *buf);
+// Keeps the current allocation when it is large enough (e.g. display columns after a window resize), otherwise
+// it is replaced. The buffer must be initialized (init_RawTimelineValuesBuf) before the first call.
 void alloc_RawTimelineValuesBuf(RawTimelineValuesBuf *buf,
     uint32_t nr_of_samples, uint8_t nr_of_channels, uint8_t bitwidth, uint8_t bytealignment, RawTimelineValueEnum value_type);
 void free_RawTimelineValuesBuf(RawTimelineValuesBuf *buf);
 
+void alloc_RingTimelineValuesBuf(RawTimelineValuesBuf *buf,
+    uint32_t capacity, uint8_t nr_of_channels, uint8_t bitwidth, uint8_t bytealignment, RawTimelineValueEnum value_type);
+
+/*
+ Allocators with no heap traffic in the steady state (see TimelineAllocator). Neither is thread-safe: one owner thread
+ allocates and frees (workers only read and write the samples).
+ Arena: one aligned block, allocations are bumped off it, free does nothing, reset_TimelineArena releases everything
+ at once (the buffers allocated from it must be initialized again). For per-frame or per-query scratch buffers.
+ Pool: power of two size classes from 64 bytes, freed blocks are kept on per-class free lists and handed out again,
+ so freeing and allocating the same sizes again (window resizes, repeated prepare_* calls) never reaches the heap.
+ free_TimelinePool returns the cached blocks to the heap, the buffers still using the pool must be freed before.
+*/
+#define TIMELINE_POOL_CLASSES 32
+
+typedef struct {
+    TimelineAllocator allocator;    // pass &arena->allocator to the buffers
+    unsigned char *base;
+    size_t size;
+    size_t used;
+    size_t peak;                    // highest 'used' since init, for sizing the arena
+} TimelineArena;
+
+typedef struct {
+    TimelineAllocator allocator;    // pass &pool->allocator to the buffers
+    void *free_blocks[TIMELINE_POOL_CLASSES]; // per class list of released blocks
+    uint64_t heap_allocations;      // blocks taken from the heap, stops growing in the steady state
+    uint64_t reused_allocations;    // blocks served from the free lists
+} TimelinePool;
+
+void *alloc_TimelineMemory(const TimelineAllocator *allocator, size_t size, size_t alignment);
+void free_TimelineMemory(const TimelineAllocator *allocator, void *ptr);
+int init_TimelineArena(TimelineArena *arena, size_t size);
+void reset_TimelineArena(TimelineArena *arena);
+void free_TimelineArena(TimelineArena *arena);
+void init_TimelinePool(TimelinePool *pool);
+void free_TimelinePool(TimelinePool *pool);
+void clear_RawTimelineValuesBuf(RawTimelineValuesBuf *buf);
+int append_RawTimelineValues(RawTimelineValuesBuf *buf, const void *samples, uint32_t count);
+int make_RawTimelineValuesView(const RawTimelineValuesBuf *buf, uint32_t offset, uint32_t length, RawTimelineValuesView *view);
+int map_RawTimelineValuesView(const RawTimelineValuesView *view, RawTimelineValuesBuf *window);
+
+// Big-endian 24-bit channel payloads (capture hardware packets) -> 8-channel TR_SIMD_sint16x8 / TR_SIMD_sint24x8 blocks,
+// or one buffer with all channels of the packet
+int decode_BE24_Samples(const uint8_t *payload, uint32_t nr_of_channels, RawTimelineValueEnum value_type, uint8_t *dst, uint32_t dst_stride);
+int append_BE24_Payloads(const uint8_t *const *payloads, uint32_t nr_of_payloads, uint32_t nr_of_channels, RawTimelineValuesBuf *bufs, uint32_t nr_of_bufs);
+
 void getEngineeringSampleRateFrequency(const RawTimelineValuesBuf *buf, double *freq_val, const char **freq_unit);
 void getEngineeringTimeInterval(const RawTimelineValuesBuf *buf, double *time_val, const char **time_unit);
 
@@ -80,12 +321,173 @@ int getSampleValue_SIMD_sint24x8(const RawTimelineValuesBuf *buf, uint32_t sampl
 
 int prepare_SampleRateConversion(const RawTimelineValuesBuf *input, uint32_t new_sample_rate_hz, RawTimelineValuesBuf *output);
 int convert_sample_rate(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *output);
+int convert_sample_rate_view(const RawTimelineValuesView *view, RawTimelineValuesBuf *output);
+// convert_sample_rate split into cache-sized output chunks on the worker pool (TR_SIMD_sint16x8, other value types
+// run serially), the result is identical to convert_sample_rate
+int convert_sample_rate_parallel(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *output);
+
+/*
+ Streaming sample rate conversion of TR_SIMD_sint16x8 chunks (any channel count). The fractional phase, the input
+ position and the last input sample are carried between the calls, so a signal converted chunk by chunk gives
+ exactly the same output as one call with the whole signal. Output k is interpolated at input position
+ k * in_rate / out_rate. The state has a fixed size, nothing is allocated after init.
+*/
+#define TIMELINE_STREAM_MAX_CHANNELS 255
+
+typedef struct {
+    uint32_t in_rate_hz;
+    uint32_t out_rate_hz;
+    uint32_t step_int;   // input samples per output sample: step_int + step_rem / scale (ratio reduced by the gcd)
+    uint32_t step_rem;
+    uint32_t scale;
+    uint32_t accum;      // phase of the next output, in 1 / scale input samples
+    uint64_t next_idx;   // absolute index of the input sample left of the next output
+    uint64_t consumed;   // number of input samples fed so far
+    uint8_t  nr_of_channels;
+    int16_t  edge[2 * TIMELINE_STREAM_MAX_CHANNELS]; // last input sample of the previous chunk + first one of the current
+} SampleRateStream;
+
+int init_SampleRateStream(SampleRateStream *stream, uint8_t nr_of_channels, uint32_t in_rate_hz, uint32_t out_rate_hz);
+void reset_SampleRateStream(SampleRateStream *stream);
+uint32_t getSampleRateStreamMaxOutput(const SampleRateStream *stream, uint32_t in_samples);
+int convert_sample_rate_stream(SampleRateStream *stream, const RawTimelineValuesBuf *input, RawTimelineValuesBuf *output);
+int convert_sample_rate_stream_view(SampleRateStream *stream, const RawTimelineValuesView *view, RawTimelineValuesBuf *output);
+
+/*
+ Polyphase FIR resampling of TR_SIMD_sint16x8 buffers, the anti-aliased alternative of convert_sample_rate for
+ decimation (e.g. 1 MHz -> 48 kHz for storage). The rate ratio is reduced to up / down, the bank holds one
+ Blackman windowed sinc filter (Q14, unity DC gain) per output phase, cut off at the lower of the two Nyquist
+ frequencies. Ratios with more than TIMELINE_POLYPHASE_MAX_PHASES phases use the nearest stored phase.
+ Output k is taken at input position k * in_rate / out_rate, like the linear converter.
+ Large decimations (e.g. 1 MHz -> 48 kHz) run a CIC stage first: TIMELINE_POLYPHASE_CIC_STAGES moving sums decimate by
+ 1 << pre_shift (at most 8, keeping at least 2.5x the output rate), so the FIR works at the lower rate with far fewer taps.
+*/
+#define TIMELINE_POLYPHASE_MAX_PHASES 256
+#define TIMELINE_POLYPHASE_MAX_TAPS 1024
+#define TIMELINE_POLYPHASE_COEF_BITS 14
+#define TIMELINE_POLYPHASE_CIC_STAGES 4     // even: output j of the CIC stage is centred on input sample j << pre_shift
+#define TIMELINE_POLYPHASE_CIC_MAX_SHIFT 3  // 16-bit differences * 8^4 stay inside the int32 accumulators
+
+typedef struct {
+    uint32_t in_rate_hz;
+    uint32_t out_rate_hz;
+    uint32_t pre_shift;     // CIC pre-decimation by 1 << pre_shift, 0 without it
+    uint32_t up;            // out_rate / gcd, relative to the pre-decimated rate
+    uint32_t down;          // in_rate / gcd
+    uint32_t nr_of_phases;
+    uint32_t taps;          // per phase, always even
+    int16_t *coeffs;        // nr_of_phases rows of 'taps' coefficients, tap j weights input sample idx - taps / 2 + 1 + j
+    const TimelineAllocator *allocator; // memory of coeffs, NULL: heap
+} PolyphaseFilterBank;
+
+// taps 0: the default length, allocator: usually the one of the output buffers (NULL: heap)
+int init_PolyphaseFilterBank(PolyphaseFilterBank *bank, uint32_t in_rate_hz, uint32_t out_rate_hz, uint32_t taps, const TimelineAllocator *allocator);
+void free_PolyphaseFilterBank(PolyphaseFilterBank *bank);
+// Allocates the output and, with a CIC pre-decimation, the pre-decimated rows in its scratch
+int prepare_PolyphaseResampling(const RawTimelineValuesBuf *input, const PolyphaseFilterBank *bank, RawTimelineValuesBuf *output);
+int convert_sample_rate_polyphase(const RawTimelineValuesBuf *input, const PolyphaseFilterBank *bank, RawTimelineValuesBuf *output);
+
+/*
+ CIC (cascaded integrator-comb) decimation of TR_SIMD_sint16x8 / TR_SIMD_sint24x8 buffers by an integer ratio,
+ for 100x .. 10000x reductions where a full FIR costs too much per input sample: N adds per input sample and
+ channel, integer only, 64-bit accumulators. The output keeps the input type and scale (the R^N gain is divided out),
+ the optional 3-tap compensation FIR flattens the passband droop. Used like prepare_SampleRateConversion / convert_sample_rate.
+*/
+#define TIMELINE_CIC_MAX_STAGES 6
+
+int prepare_CicDecimation(const RawTimelineValuesBuf *input, uint32_t ratio, uint8_t stages, uint8_t compensate, RawTimelineValuesBuf *output);
+int convert_decimate_cic(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *output);
 
 int prepare_NeonAlignedBuffer(const RawTimelineValuesBuf *src, RawTimelineValuesBuf *dst);
 int convert_to_NeonAlignedBuffer(const RawTimelineValuesBuf *src, RawTimelineValuesBuf *dst, uint8_t srcChannel, uint8_t dstChannel);
 int convert_from_NeonAlignedBuffer(const RawTimelineValuesBuf *src, RawTimelineValuesBuf *dst);
 
+/*
+ Planar (structure of arrays) copies of TR_SIMD_sint16x8 / TR_SIMD_sint24x8 buffers. The transposes run on blocks of
+ 8 samples x 8 channels in SIMD registers. The interleaved kernels do not take planar buffers (map_RawTimelineValuesView
+ fails), map_PlanarChannel exposes one plane as a one channel linear buffer instead: aggregation, statistics and
+ compression of a single channel then stream contiguous memory. The mapped buffer must never be freed.
+ prepare_PlanarBuffer allocates dst like alloc_RawTimelineValuesBuf (initialized before, its allocator is used).
+*/
+int prepare_PlanarBuffer(const RawTimelineValuesBuf *src, RawTimelineValuesBuf *dst);
+int convert_to_PlanarBuffer(const RawTimelineValuesBuf *src, RawTimelineValuesBuf *dst);
+int convert_from_PlanarBuffer(const RawTimelineValuesBuf *src, RawTimelineValuesBuf *dst);
+int map_PlanarChannel(const RawTimelineValuesBuf *buf, uint8_t channel, RawTimelineValuesBuf *plane);
+
+// TR_SIMD_sint24x8 inputs are aggregated into TR_analog_sint8 outputs (upper 8 bits of the 24-bit min/max)
 int prepare_AggregationMinMax(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t outSampleNr);
 int aggregate_MinMax(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t inSamples, uint32_t inOffset);
+int aggregate_MinMax_view(const RawTimelineValuesView *view, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax);
+/*
+ Library-owned worker pool for the *_parallel calls. The threads start once (init_TimelineWorkers, or the first
+ parallel call with one thread per CPU) and sleep between calls. nr_of_threads counts the calling thread too.
+*/
+#define TIMELINE_WORKERS_MAX 64
+int init_TimelineWorkers(uint32_t nr_of_threads);
+void free_TimelineWorkers(void);
+uint32_t getTimelineWorkersCount(void);
+// aggregate_MinMax_view of nr_of_views windows (e.g. every buffer of a frame) into outMin[v] / outMax[v], with the
+// columns of all views split across the worker pool. The output is identical to the serial calls.
+int aggregate_MinMax_parallel(const RawTimelineValuesView *views, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t nr_of_views);
+/*
+ Per-column mean and RMS of every channel (TR_analog_float32 outputs from prepare_AggregationStats, in the scale of
+ the input samples), same windowing as aggregate_MinMax. outMin / outMax are optional (both or none, from
+ prepare_AggregationMinMax): they are filled from the same pass, identical to aggregate_MinMax.
+*/
+int prepare_AggregationStats(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMean, RawTimelineValuesBuf *outRms, uint32_t outSampleNr);
+int aggregate_Stats(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMean, RawTimelineValuesBuf *outRms, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t inSamples, uint32_t inOffset);
+int aggregate_Stats_view(const RawTimelineValuesView *view, RawTimelineValuesBuf *outMean, RawTimelineValuesBuf *outRms, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax);
+
+// TR_SIMD_sint16x8 only: min/max columns of the signal resampled from in_rate_hz to out_rate_hz (linear, as convert_sample_rate_stream)
+// without materializing the resampled buffer, outMin / outMax come from prepare_AggregationMinMax
+int aggregate_MinMax_resampled(const RawTimelineValuesBuf *input, uint32_t in_rate_hz, uint32_t out_rate_hz, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t inSamples, uint32_t inOffset);
+int aggregate_MinMax_resampled_view(const RawTimelineValuesView *view, uint32_t in_rate_hz, uint32_t out_rate_hz, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax);
+
+int init_MinMaxPyramid(RawTimelineValuesBuf *buf, uint32_t capacity);
+int update_MinMaxPyramid(RawTimelineValuesBuf *buf);
+void free_MinMaxPyramid(RawTimelineValuesBuf *buf);
+
+// block_size: power of two (0: 1024), clip_level: |sample| limit counted as clipping (0: full scale of the type)
+int init_BlockStats(RawTimelineValuesBuf *buf, uint32_t block_size, int32_t clip_level);
+int update_BlockStats(RawTimelineValuesBuf *buf);
+void free_BlockStats(RawTimelineValuesBuf *buf);
+// Statistics of every channel (stats[nr_of_channels]) over a window, full blocks come from the sidecar when there is one
+int aggregate_RangeStats(const RawTimelineValuesBuf *buf, uint32_t inSamples, uint32_t inOffset, TimelineChannelStats *stats);
+int aggregate_RangeStats_view(const RawTimelineValuesView *view, TimelineChannelStats *stats);
+
+// initial_capacity: samples of the first version, max_samples: retention (0: keep everything)
+int init_TimelineSharedBuf(TimelineSharedBuf *shared, uint32_t initial_capacity, uint32_t max_samples, uint8_t nr_of_channels, uint8_t bitwidth, uint16_t bytes_per_sample, RawTimelineValueEnum value_type);
+void free_TimelineSharedBuf(TimelineSharedBuf *shared); // every snapshot must be released before
+// Writer only (one thread): appends 'count' interleaved samples and commits them for the next snapshots
+int append_TimelineSharedBuf(TimelineSharedBuf *shared, const void *samples, uint32_t count);
+// Any thread: the committed samples at the time of the call, valid until release_TimelineSnapshot
+int acquire_TimelineSnapshot(TimelineSharedBuf *shared, TimelineSnapshot *snap);
+void release_TimelineSnapshot(TimelineSnapshot *snap);
+
+// segment_shift 0: TIMELINE_SEGMENT_DEFAULT_SHIFT, flags: TIMELINE_SEGMENTS_*
+int init_TimelineSegmentedBuf(TimelineSegmentedBuf *seg, uint8_t segment_shift, uint8_t flags,
+    uint8_t nr_of_channels, uint8_t bitwidth, uint8_t bytealignment, RawTimelineValueEnum value_type);
+void free_TimelineSegmentedBuf(TimelineSegmentedBuf *seg);
+int append_TimelineSegmentedBuf(TimelineSegmentedBuf *seg, const void *samples, uint64_t count);
+// Sample 'index' is sample *local of *segment (a linear buffer), -1 if the index is not stored
+int locate_TimelineSegmentedSample(const TimelineSegmentedBuf *seg, uint64_t index, const RawTimelineValuesBuf **segment, uint32_t *local);
+// aggregate_MinMax over inSamples (0: all) samples from inOffset; outMin / outMax from prepare_AggregationMinMax(&seg->layout, ...)
+int aggregate_MinMax_segmented(const TimelineSegmentedBuf *seg, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint64_t inSamples, uint64_t inOffset);
+// aggregate_RangeStats over inSamples (0: all) samples from inOffset (stats[c].count saturates at UINT32_MAX)
+int aggregate_RangeStats_segmented(const TimelineSegmentedBuf *seg, uint64_t inSamples, uint64_t inOffset, TimelineChannelStats *stats);
+
+// Compresses all samples of input (ring: the current window), output is overwritten (free_TimelineCompressedBuf)
+int compress_RawTimelineValues(const RawTimelineValuesBuf *input, TimelineCompressedBuf *output);
+void free_TimelineCompressedBuf(TimelineCompressedBuf *buf);
+// Decodes inSamples (0: all) samples from inOffset into output, allocated here as a linear buffer (free_RawTimelineValuesBuf)
+int decompress_RawTimelineValues(const TimelineCompressedBuf *input, RawTimelineValuesBuf *output, uint32_t inSamples, uint32_t inOffset);
+// aggregate_MinMax on the compressed samples (same columns and values); outMin / outMax from prepare_AggregationMinMax(&input->layout, ...),
+// -1 if the range holds no sample. The decoded block is kept in outMin->scratch (freed with outMin)
+int aggregate_MinMax_compressed(const TimelineCompressedBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t inSamples, uint32_t inOffset);
+
+// Writes the samples (ring: the current window) and the metadata of buf to a timeline file
+int write_TimelineFile(const char *path, const RawTimelineValuesBuf *buf);
+int open_TimelineFile(const char *path, TimelineFile *file);
+void close_TimelineFile(TimelineFile *file); // frees the optional parts (pyramid, block stats...) too
 
 #endif
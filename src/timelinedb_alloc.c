@@ -0,0 +1,157 @@
+/*
+    File: timelinedb_alloc.c
+    This file implements the allocators of the buffers: the heap default, the arena and the size-class pool.
+    Author: Barna Farago - MYND-Ideal kft.
+    Date: 2025-07-01
+    License: Modified MIT License. You can use it for learn, but I can sell it as closed source with some improvements...
+*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include "timelinedb.h"
+
+/*
+    ALLOCATORS
+    Every block is at least 64 byte aligned (a cache line, one AVX-512 register), larger alignments are refused.
+    The pool puts a 64 byte header in front of every block with its size class, so free needs no size and the
+    block after the header keeps the alignment. The heap default stays plain malloc / aligned_alloc / free.
+*/
+#define TIMELINE_ALLOC_ALIGNMENT 64
+#define TIMELINE_POOL_MIN_SHIFT 6   // class k holds blocks of 64 << k bytes
+
+typedef struct TimelinePoolBlock {
+    struct TimelinePoolBlock *next; // free list link while released
+    uint32_t size_class;
+} TimelinePoolBlock;
+
+void *alloc_TimelineMemory(const TimelineAllocator *allocator, size_t size, size_t alignment) {
+    if (allocator) {
+        return allocator->alloc(allocator->ctx, size, alignment);
+    }
+    if (alignment <= 1) {
+        return malloc(size ? size : 1);
+    }
+    // aligned_alloc needs a size multiple of the alignment
+    return aligned_alloc(alignment, ((size ? size : 1) + alignment - 1) & ~(alignment - 1));
+}
+
+void free_TimelineMemory(const TimelineAllocator *allocator, void *ptr) {
+    if (!ptr) return;
+    if (allocator) {
+        allocator->free(allocator->ctx, ptr);
+    } else {
+        free(ptr);
+    }
+}
+
+static void *alloc_ArenaMemory(void *ctx, size_t size, size_t alignment) {
+    TimelineArena *arena = (TimelineArena*)ctx;
+    if (alignment > TIMELINE_ALLOC_ALIGNMENT) {
+        fprintf(stderr, "ERROR: Arena alignment %zu is above %d\n", alignment, TIMELINE_ALLOC_ALIGNMENT);
+        return NULL;
+    }
+    size_t offset = (arena->used + TIMELINE_ALLOC_ALIGNMENT - 1) & ~(size_t)(TIMELINE_ALLOC_ALIGNMENT - 1);
+    if (offset > arena->size || size > arena->size - offset) {
+        fprintf(stderr, "ERROR: Arena of %zu bytes is exhausted (%zu bytes requested)\n", arena->size, size);
+        return NULL;
+    }
+    arena->used = offset + size;
+    if (arena->used > arena->peak) arena->peak = arena->used;
+    return &arena->base[offset];
+}
+
+static void free_ArenaMemory(void *ctx, void *ptr) {
+    (void)ctx; // released all at once by reset_TimelineArena
+    (void)ptr;
+}
+
+int init_TimelineArena(TimelineArena *arena, size_t size) {
+    if (!arena || size == 0) {
+        return -1;
+    }
+    memset(arena, 0, sizeof(*arena));
+    size = (size + TIMELINE_ALLOC_ALIGNMENT - 1) & ~(size_t)(TIMELINE_ALLOC_ALIGNMENT - 1);
+    arena->base = (unsigned char*)aligned_alloc(TIMELINE_ALLOC_ALIGNMENT, size);
+    if (!arena->base) {
+        fprintf(stderr, "ERROR: Memory allocation failed for an arena of %zu bytes\n", size);
+        return -1;
+    }
+    arena->size = size;
+    arena->allocator.alloc = alloc_ArenaMemory;
+    arena->allocator.free = free_ArenaMemory;
+    arena->allocator.ctx = arena;
+    return 0;
+}
+
+void reset_TimelineArena(TimelineArena *arena) {
+    if (arena) arena->used = 0;
+}
+
+void free_TimelineArena(TimelineArena *arena) {
+    if (!arena) return;
+    free(arena->base);
+    arena->base = NULL;
+    arena->size = 0;
+    arena->used = 0;
+}
+
+static void *alloc_PoolMemory(void *ctx, size_t size, size_t alignment) {
+    TimelinePool *pool = (TimelinePool*)ctx;
+    if (alignment > TIMELINE_ALLOC_ALIGNMENT) {
+        fprintf(stderr, "ERROR: Pool alignment %zu is above %d\n", alignment, TIMELINE_ALLOC_ALIGNMENT);
+        return NULL;
+    }
+    uint32_t size_class = 0;
+    while (size_class < TIMELINE_POOL_CLASSES && ((size_t)1 << (TIMELINE_POOL_MIN_SHIFT + size_class)) < size) {
+        size_class++;
+    }
+    if (size_class == TIMELINE_POOL_CLASSES) {
+        fprintf(stderr, "ERROR: Pool block of %zu bytes is too large\n", size);
+        return NULL;
+    }
+    TimelinePoolBlock *block = (TimelinePoolBlock*)pool->free_blocks[size_class];
+    if (block) {
+        pool->free_blocks[size_class] = block->next;
+        pool->reused_allocations++;
+    } else {
+        block = (TimelinePoolBlock*)aligned_alloc(TIMELINE_ALLOC_ALIGNMENT, TIMELINE_ALLOC_ALIGNMENT + ((size_t)1 << (TIMELINE_POOL_MIN_SHIFT + size_class)));
+        if (!block) {
+            fprintf(stderr, "ERROR: Memory allocation failed for a pool block of %zu bytes\n", size);
+            return NULL;
+        }
+        block->size_class = size_class;
+        pool->heap_allocations++;
+    }
+    block->next = NULL;
+    return (unsigned char*)block + TIMELINE_ALLOC_ALIGNMENT;
+}
+
+static void free_PoolMemory(void *ctx, void *ptr) {
+    TimelinePool *pool = (TimelinePool*)ctx;
+    TimelinePoolBlock *block = (TimelinePoolBlock*)((unsigned char*)ptr - TIMELINE_ALLOC_ALIGNMENT);
+    block->next = (TimelinePoolBlock*)pool->free_blocks[block->size_class];
+    pool->free_blocks[block->size_class] = block;
+}
+
+void init_TimelinePool(TimelinePool *pool) {
+    if (!pool) return;
+    memset(pool, 0, sizeof(*pool));
+    pool->allocator.alloc = alloc_PoolMemory;
+    pool->allocator.free = free_PoolMemory;
+    pool->allocator.ctx = pool;
+}
+
+void free_TimelinePool(TimelinePool *pool) {
+    if (!pool) return;
+    for (uint32_t k = 0; k < TIMELINE_POOL_CLASSES; ++k) {
+        TimelinePoolBlock *block = (TimelinePoolBlock*)pool->free_blocks[k];
+        while (block) {
+            TimelinePoolBlock *next = block->next;
+            free(block);
+            block = next;
+        }
+        pool->free_blocks[k] = NULL;
+    }
+}
@@ -0,0 +1,293 @@
+/*
+    File: timelinedb_blockstats.c
+    This file implements the per-block statistics sidecar and the range statistics queries built on it.
+    Author: Barna Farago - MYND-Ideal kft.
+    Date: 2025-07-01
+    License: Modified MIT License. You can use it for learn, but I can sell it as closed source with some improvements...
+*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include "timelinedb.h"
+#include "timelinedb_simd.h"
+
+/*
+    BLOCK STATISTICS
+    Every 2^block_shift storage slots get one TimelineChannelStats per channel (min, max, sum, sum of squares,
+    clip count), computed with the backend's aggregate_stats kernel when the block is complete. The clip count needs
+    a second look at the samples only when the block's min or max reaches a clip level, which is rare.
+    A range query ("max over the last 10 minutes", "did channel 17 clip in this hour") merges the complete blocks
+    inside the range and scans only the partial blocks at the two edges: O(range / block + 2 * block) instead of O(range).
+    The memory is 40 bytes per channel per block, ~2.5% of a 16-bit buffer with the default 1024 sample blocks.
+*/
+
+static inline int32_t read_block_sample(const RawTimelineValuesBuf *buf, uint32_t slot, uint32_t channel) {
+    const uint8_t *p = &buf->valueBuffer[(size_t)slot * buf->bytes_per_sample + channel * buf->bitwidth / 8];
+    switch (buf->bitwidth) {
+    case 8:
+        return *(const int8_t*)p;
+    case 16:
+        return *(const int16_t*)p;
+    default:
+        return (int32_t)((uint32_t)p[0] << 8 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 24) >> 8;
+    }
+}
+
+static uint32_t count_clipped(const RawTimelineValuesBuf *buf, uint32_t start, uint32_t end, uint32_t channel, int32_t clip_low, int32_t clip_high) {
+    uint32_t clipped = 0;
+    for (uint32_t j = start; j < end; ++j) {
+        int32_t v = read_block_sample(buf, j, channel);
+        clipped += (v <= clip_low || v >= clip_high);
+    }
+    return clipped;
+}
+
+// Full scale of the type, the default clip levels
+static inline void getFullScale(const RawTimelineValuesBuf *buf, int32_t *clip_low, int32_t *clip_high) {
+    *clip_high = (int32_t)((1u << (buf->bitwidth - 1)) - 1);
+    *clip_low = -*clip_high - 1;
+}
+
+// Statistics of the slots [start, end) into stats[], overwritten
+static void scan_ChannelStats(const RawTimelineValuesBuf *buf, fn_aggregate_stats stats_fn, uint32_t start, uint32_t end,
+                              int32_t clip_low, int32_t clip_high, TimelineChannelStats *stats) {
+    TimelineChannelSums sums[TIMELINE_STREAM_MAX_CHANNELS];
+    stats_fn(buf, start, end, sums);
+    for (uint32_t c = 0; c < buf->nr_of_channels; ++c) {
+        stats[c].sum = sums[c].sum;
+        stats[c].sum_sq = sums[c].sum_sq;
+        stats[c].sum_sq_hi = sums[c].sum_sq_hi;
+        stats[c].min = sums[c].min;
+        stats[c].max = sums[c].max;
+        stats[c].count = end - start;
+        stats[c].clip_count = (sums[c].min <= clip_low || sums[c].max >= clip_high) ? count_clipped(buf, start, end, c, clip_low, clip_high) : 0;
+    }
+}
+
+static inline void merge_ChannelStats(TimelineChannelStats *dst, const TimelineChannelStats *src) {
+    dst->sum += src->sum;
+    dst->sum_sq += src->sum_sq;
+    dst->sum_sq_hi += src->sum_sq_hi + (dst->sum_sq < src->sum_sq);
+    if (src->min < dst->min) dst->min = src->min;
+    if (src->max > dst->max) dst->max = src->max;
+    dst->clip_count += src->clip_count;
+    dst->count += src->count;
+}
+
+int init_BlockStats(RawTimelineValuesBuf *buf, uint32_t block_size, int32_t clip_level) {
+    if (!buf || buf->nr_of_channels == 0 || !getStatsKernel(buf->value_type)) {
+        return -1; // Unsupported value type
+    }
+    uint8_t shift = TIMELINE_BLOCKSTATS_DEFAULT_SHIFT;
+    if (block_size) {
+        if (block_size & (block_size - 1)) {
+            fprintf(stderr, "Block statistics size %u is not a power of two\n", block_size);
+            return -1;
+        }
+        for (shift = 0; (1u << shift) < block_size; ++shift) {}
+    }
+    free_BlockStats(buf);
+    // ring mode: the blocks index the ring slots, linear: the allocated samples, so the buffer can grow into them
+    uint32_t capacity = buf->capacity ? buf->capacity : (buf->bytes_per_sample ? buf->buffer_size / buf->bytes_per_sample : 0);
+    TimelineBlockStats *bs = (TimelineBlockStats*)alloc_TimelineMemory(buf->allocator, sizeof(TimelineBlockStats), 16);
+    if (!bs) {
+        fprintf(stderr, "ERROR: Memory allocation failed for TimelineBlockStats\n");
+        return -1;
+    }
+    memset(bs, 0, sizeof(*bs));
+    bs->block_shift = shift;
+    bs->nr_of_channels = buf->nr_of_channels;
+    bs->capacity = capacity;
+    getFullScale(buf, &bs->clip_low, &bs->clip_high);
+    if (clip_level > 0 && clip_level < bs->clip_high) {
+        bs->clip_high = clip_level;
+        bs->clip_low = -clip_level - 1;
+    }
+    size_t blocks = capacity >> shift;
+    if (blocks) {
+        bs->blocks = (TimelineChannelStats*)alloc_TimelineMemory(buf->allocator, blocks * buf->nr_of_channels * sizeof(TimelineChannelStats), 64);
+        if (!bs->blocks) {
+            fprintf(stderr, "ERROR: Memory allocation failed for %zu statistics blocks\n", blocks);
+            free_TimelineMemory(buf->allocator, bs);
+            return -1;
+        }
+    }
+    buf->block_stats = bs;
+    return update_BlockStats(buf);
+}
+
+void free_BlockStats(RawTimelineValuesBuf *buf) {
+    if (!buf || !buf->block_stats) return;
+    free_TimelineMemory(buf->allocator, buf->block_stats->blocks);
+    free_TimelineMemory(buf->allocator, buf->block_stats);
+    buf->block_stats = NULL;
+}
+
+static void blockstats_build(const RawTimelineValuesBuf *buf, TimelineBlockStats *bs, uint32_t b_lo, uint32_t b_hi) {
+    fn_aggregate_stats stats_fn = getStatsKernel(buf->value_type);
+    for (uint32_t b = b_lo; b < b_hi; ++b) {
+        uint32_t first = b << bs->block_shift;
+        scan_ChannelStats(buf, stats_fn, first, first + (1u << bs->block_shift), bs->clip_low, bs->clip_high,
+                          &bs->blocks[(size_t)b * bs->nr_of_channels]);
+    }
+}
+
+/*
+    Folds the samples written since the previous call into the sidecar, only the blocks touched by them are
+    recomputed (the same dirty range logic as update_MinMaxPyramid). Called by append_RawTimelineValues in ring mode.
+*/
+int update_BlockStats(RawTimelineValuesBuf *buf) {
+    if (!buf || !buf->block_stats) {
+        return -1;
+    }
+    TimelineBlockStats *bs = buf->block_stats;
+    uint32_t seen = buf->capacity ? buf->ring_total : buf->nr_of_samples;
+    if (seen < bs->built_samples) {
+        bs->built_samples = 0;
+        bs->nr_of_blocks = 0;
+    }
+    uint32_t valid = buf->capacity ? ((seen < buf->capacity) ? seen : buf->capacity) : buf->nr_of_samples;
+    if (valid > bs->capacity) valid = bs->capacity;
+    uint32_t blocks = valid >> bs->block_shift;
+    uint32_t block_size = 1u << bs->block_shift;
+
+    // dirty block ranges [lo, hi), at most two when the written slots wrap around the ring
+    uint32_t lo[2] = {0, 0};
+    uint32_t hi[2] = {0, 0};
+    uint32_t new_samples = seen - bs->built_samples;
+    if (buf->capacity == 0) {
+        lo[0] = bs->nr_of_blocks;
+        hi[0] = blocks;
+    } else if (new_samples >= buf->capacity) {
+        hi[0] = blocks;
+    } else if (new_samples > 0) {
+        uint32_t slot_lo = bs->built_samples % buf->capacity;
+        uint32_t slot_hi = slot_lo + new_samples;
+        lo[0] = slot_lo >> bs->block_shift;
+        hi[0] = (((slot_hi < buf->capacity) ? slot_hi : buf->capacity) + block_size - 1) >> bs->block_shift;
+        if (slot_hi > buf->capacity) {
+            hi[1] = (slot_hi - buf->capacity + block_size - 1) >> bs->block_shift;
+        }
+    }
+    for (int r = 0; r < 2; r++) {
+        if (hi[r] > blocks) hi[r] = blocks;
+        if (lo[r] < hi[r]) blockstats_build(buf, bs, lo[r], hi[r]);
+    }
+    bs->nr_of_blocks = blocks;
+    bs->built_samples = seen;
+    return 0;
+}
+
+// Merges the storage slots [start, end) into stats: complete built blocks from the sidecar, the edges from the samples.
+static void range_accumulate(const RawTimelineValuesBuf *buf, fn_aggregate_stats stats_fn, int32_t clip_low, int32_t clip_high,
+                             uint32_t start, uint32_t end, TimelineChannelStats *stats) {
+    const uint32_t ch = buf->nr_of_channels;
+    TimelineChannelStats part[TIMELINE_STREAM_MAX_CHANNELS];
+    const TimelineBlockStats *bs = buf->block_stats;
+    uint32_t b_first = 0, b_last = 0;
+    if (bs && bs->nr_of_channels == ch) {
+        b_first = (start + (1u << bs->block_shift) - 1) >> bs->block_shift;
+        b_last = end >> bs->block_shift;
+        if (b_last > bs->nr_of_blocks) b_last = bs->nr_of_blocks;
+    }
+    if (b_first >= b_last) {
+        scan_ChannelStats(buf, stats_fn, start, end, clip_low, clip_high, part);
+        for (uint32_t c = 0; c < ch; ++c) merge_ChannelStats(&stats[c], &part[c]);
+        return;
+    }
+    uint32_t inner_start = b_first << bs->block_shift;
+    uint32_t inner_end = b_last << bs->block_shift;
+    if (start < inner_start) {
+        scan_ChannelStats(buf, stats_fn, start, inner_start, clip_low, clip_high, part);
+        for (uint32_t c = 0; c < ch; ++c) merge_ChannelStats(&stats[c], &part[c]);
+    }
+    for (uint32_t b = b_first; b < b_last; ++b) {
+        const TimelineChannelStats *row = &bs->blocks[(size_t)b * ch];
+        for (uint32_t c = 0; c < ch; ++c) merge_ChannelStats(&stats[c], &row[c]);
+    }
+    if (inner_end < end) {
+        scan_ChannelStats(buf, stats_fn, inner_end, end, clip_low, clip_high, part);
+        for (uint32_t c = 0; c < ch; ++c) merge_ChannelStats(&stats[c], &part[c]);
+    }
+}
+
+int aggregate_RangeStats(const RawTimelineValuesBuf *buf, uint32_t inSamples, uint32_t inOffset, TimelineChannelStats *stats) {
+    if (!buf || !stats) {
+        return -1; // Invalid input
+    }
+    RawTimelineValuesView view;
+    make_RawTimelineValuesView(buf, inOffset, (inSamples > 0) ? inSamples : buf->nr_of_samples, &view);
+    return aggregate_RangeStats_view(&view, stats);
+}
+
+int aggregate_RangeStats_view(const RawTimelineValuesView *view, TimelineChannelStats *stats) {
+    if (!view || !view->buf || !view->buf->valueBuffer || !stats) {
+        return -1; // Invalid input
+    }
+    const RawTimelineValuesBuf *buf = view->buf;
+    fn_aggregate_stats stats_fn = getStatsKernel(buf->value_type);
+    if (!stats_fn) {
+        fprintf(stderr, "Unsupported value type for range statistics\n");
+        return -1;
+    }
+    for (uint32_t c = 0; c < buf->nr_of_channels; ++c) {
+        memset(&stats[c], 0, sizeof(stats[c]));
+        stats[c].min = INT32_MAX;
+        stats[c].max = INT32_MIN;
+    }
+    int32_t clip_low, clip_high;
+    if (buf->block_stats) {
+        clip_low = buf->block_stats->clip_low;
+        clip_high = buf->block_stats->clip_high;
+    } else {
+        getFullScale(buf, &clip_low, &clip_high);
+    }
+    // the window in the (mirrored) storage, folded back to the ring slots like aggregate_minmax_pyramid
+    uint32_t start = (buf->capacity ? buf->ring_head : 0) + view->offset;
+    uint32_t end = start + view->length;
+    uint32_t cap = buf->capacity;
+    if (cap == 0 || end <= cap) {
+        range_accumulate(buf, stats_fn, clip_low, clip_high, start, end, stats);
+    } else {
+        if (start < cap) {
+            range_accumulate(buf, stats_fn, clip_low, clip_high, start, cap, stats);
+            start = cap;
+        }
+        range_accumulate(buf, stats_fn, clip_low, clip_high, start - cap, end - cap, stats);
+    }
+    return 0;
+}
+
+// Range statistics of a segmented timeline: aggregate_RangeStats on the part of every segment in the range, merged.
+int aggregate_RangeStats_segmented(const TimelineSegmentedBuf *seg, uint64_t inSamples, uint64_t inOffset, TimelineChannelStats *stats) {
+    if (!seg || !stats) {
+        return -1; // Invalid input
+    }
+    if (inOffset > seg->nr_of_samples) inOffset = seg->nr_of_samples;
+    if (inSamples == 0 || inSamples > seg->nr_of_samples - inOffset) inSamples = seg->nr_of_samples - inOffset;
+    const uint32_t ch = seg->layout.nr_of_channels;
+    for (uint32_t c = 0; c < ch; ++c) {
+        memset(&stats[c], 0, sizeof(stats[c]));
+        stats[c].min = INT32_MAX;
+        stats[c].max = INT32_MIN;
+    }
+    TimelineChannelStats part[TIMELINE_STREAM_MAX_CHANNELS];
+    const uint64_t end = inOffset + inSamples;
+    for (uint64_t pos = inOffset; pos < end; ) {
+        const uint32_t s = (uint32_t)(pos >> seg->segment_shift);
+        const uint64_t segment_start = (uint64_t)s << seg->segment_shift;
+        const uint64_t part_end = (end < segment_start + seg->segments[s].nr_of_samples) ? end : segment_start + seg->segments[s].nr_of_samples;
+        if (aggregate_RangeStats(&seg->segments[s], (uint32_t)(part_end - pos), (uint32_t)(pos - segment_start), part) != 0) {
+            return -1;
+        }
+        for (uint32_t c = 0; c < ch; ++c) {
+            uint32_t count = stats[c].count;
+            merge_ChannelStats(&stats[c], &part[c]);
+            if (stats[c].count < count) stats[c].count = UINT32_MAX; // saturate beyond 4G samples
+        }
+        pos = part_end;
+    }
+    return 0;
+}
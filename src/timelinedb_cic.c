@@ -0,0 +1,201 @@
+/*
+    File: timelinedb_cic.c
+    This file implements the cascaded integrator-comb (CIC) decimator for very high reduction ratios.
+    Author: Barna Farago - MYND-Ideal kft.
+    Date: 2025-07-01
+    License: Modified MIT License. You can use it for learn, but I can sell it as closed source with some improvements...
+*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include "timelinedb.h"
+#include "timelinedb_simd.h"
+
+/*
+    CIC DECIMATION
+    N integrators run at the input rate, every R-th integrator output goes through N combs (differences) at the
+    output rate: a moving sum of R samples, N times, with N adds per input sample and channel and no multiply.
+    The integrators overflow by design. They run in wrapping 64-bit arithmetic, which gives the exact comb result
+    as long as the result fits a signed int64 with the rounding added: the integrators take the input minus the
+    offset (bitwidth + 1 bits), so bitwidth + 1 + N * ceil(log2 R) <= 63 bits, checked in prepare_CicDecimation.
+    The gain R^N is divided out once per output sample (rounded), so the output keeps the scale of the input.
+    The first input sample is subtracted before the integrators and added back to the outputs: the filter starts
+    as if the signal had been constant before the buffer, instead of ramping up from 0.
+    The optional compensation is the 3-tap FIR [-a, 1 + 2a, -a] (Q14) at the output rate. a = N / 24 flattens the
+    sinc^N droop of the CIC passband to the second order.
+*/
+#define TIMELINE_CIC_COMP_BITS 14
+
+static uint32_t ceil_log2_u32(uint32_t v) {
+    uint32_t bits = 0;
+    while (bits < 32 && ((uint64_t)1 << bits) < v) bits++;
+    return bits;
+}
+
+static inline int32_t load_cic_value(const RawTimelineValuesBuf *buf, const uint8_t *row, uint32_t c) {
+    if (buf->value_type == TR_SIMD_sint16x8) {
+        int16_t v;
+        memcpy(&v, &row[c * 2], sizeof(v));
+        return v;
+    }
+    const uint8_t *p = &row[c * 3];
+    int32_t v = p[0] | (p[1] << 8) | (p[2] << 16);
+    return (v & 0x800000) ? (v | ~0xFFFFFF) : v;
+}
+
+static inline void store_cic_value(RawTimelineValuesBuf *buf, uint8_t *row, uint32_t c, int64_t v) {
+    if (buf->value_type == TR_SIMD_sint16x8) {
+        int16_t s = (int16_t)((v > INT16_MAX) ? INT16_MAX : ((v < INT16_MIN) ? INT16_MIN : v));
+        memcpy(&row[c * 2], &s, sizeof(s));
+        return;
+    }
+    int32_t s = (int32_t)((v > 0x7FFFFF) ? 0x7FFFFF : ((v < -0x800000) ? -0x800000 : v));
+    row[c * 3 + 0] = (uint8_t)s;
+    row[c * 3 + 1] = (uint8_t)(s >> 8);
+    row[c * 3 + 2] = (uint8_t)(s >> 16);
+}
+
+// integrators and comb delays [stage][channel], the offset, and 3 output rows for the compensation
+static size_t scratch_size_Cic(uint32_t stages, uint32_t ch) {
+    return ((size_t)(2 * stages + 1) * ch + (size_t)3 * ch) * sizeof(uint64_t);
+}
+
+/*
+    Allocates the output (nr_of_samples / ratio samples, same type and channels) and stores the parameters in its
+    sample_rate_info, like prepare_SampleRateConversion. 'stages' is N (1..TIMELINE_CIC_MAX_STAGES).
+    The filter state goes to the output's scratch, so convert_decimate_cic does not allocate.
+*/
+int prepare_CicDecimation(const RawTimelineValuesBuf *input, uint32_t ratio, uint8_t stages, uint8_t compensate, RawTimelineValuesBuf *output) {
+    if (!input || !output) return -1;
+    if (input->value_type != TR_SIMD_sint16x8 && input->value_type != TR_SIMD_sint24x8) {
+        fprintf(stderr, "Unsupported value type for CIC decimation\n");
+        return -1;
+    }
+    if (ratio < 2 || stages < 1 || stages > TIMELINE_CIC_MAX_STAGES || input->nr_of_samples < ratio) {
+        fprintf(stderr, "Invalid CIC decimation parameters: ratio %u, %u stages, %u samples\n", ratio, stages, input->nr_of_samples);
+        return -1;
+    }
+    if (input->bitwidth + 1 + stages * ceil_log2_u32(ratio) > 63) {
+        fprintf(stderr, "CIC decimation by %u with %u stages overflows the 64-bit accumulators\n", ratio, stages);
+        return -1;
+    }
+    if (!output->sample_rate_info) {
+        output->sample_rate_info = (SampleRateInfo*)alloc_TimelineMemory(output->allocator, sizeof(SampleRateInfo), 16);
+        if (!output->sample_rate_info) {
+            fprintf(stderr, "Memory allocation failed for SampleRateInfo\n");
+            return -1;
+        }
+    }
+    SampleRateInfo *info = output->sample_rate_info;
+    alloc_RawTimelineValuesBuf(output, input->nr_of_samples / ratio, input->nr_of_channels, input->bitwidth, input->bytes_per_sample, input->value_type);
+    if (!output->valueBuffer) {
+        return -1;
+    }
+    output->sample_rate_info = info;
+    if (reserve_TimelineScratch(output, scratch_size_Cic(stages, input->nr_of_channels)) != 0) {
+        return -1;
+    }
+    info->rate_ratio = 1.0 / ratio;
+    info->cic_ratio = ratio;
+    info->cic_stages = stages;
+    info->cic_compensate = compensate;
+    output->time_exponent = input->time_exponent;
+    output->time_step = input->time_step * ratio;
+    return 0;
+}
+
+int convert_decimate_cic(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *output) {
+    if (!input || !output || !input->valueBuffer || !output->valueBuffer || !output->sample_rate_info ||
+        output->sample_rate_info->cic_ratio == 0) {
+        fprintf(stderr, "Output is not prepared for CIC decimation\n");
+        return -1;
+    }
+    const SampleRateInfo *info = output->sample_rate_info;
+    const uint32_t ratio = info->cic_ratio;
+    const uint32_t stages = info->cic_stages;
+    const uint32_t ch = input->nr_of_channels;
+    const uint32_t count = output->nr_of_samples;
+    if (input->value_type != output->value_type || ch != output->nr_of_channels || (uint64_t)count * ratio > input->nr_of_samples) {
+        fprintf(stderr, "Input does not match the CIC decimation output\n");
+        return -1;
+    }
+    if (!output->scratch || output->scratch_size < scratch_size_Cic(stages, ch)) {
+        fprintf(stderr, "Output is not prepared for CIC decimation of %u channels\n", ch);
+        return -1;
+    }
+    uint64_t *state = (uint64_t*)output->scratch;
+    int64_t *rows = (int64_t*)&state[(size_t)(2 * stages + 1) * ch];
+    memset(state, 0, (size_t)(2 * stages + 1) * ch * sizeof(uint64_t));
+    uint64_t *integ = state;
+    uint64_t *comb = &state[(size_t)stages * ch];
+    int64_t *offset = (int64_t*)&state[(size_t)2 * stages * ch];
+    int64_t gain = 1;
+    for (uint32_t s = 0; s < stages; ++s) gain *= ratio;
+    const int64_t a = (stages * (1 << TIMELINE_CIC_COMP_BITS) + 12) / 24;
+    const int64_t centre = (1 << TIMELINE_CIC_COMP_BITS) + 2 * a;
+
+    const uint8_t *src = input->valueBuffer;
+    for (uint32_t c = 0; c < ch; ++c) {
+        offset[c] = load_cic_value(input, src, c);
+    }
+    for (uint32_t k = 0; k < count; ++k) {
+        for (uint32_t r = 0; r < ratio; ++r, src += input->bytes_per_sample) {
+            if (input->value_type == TR_SIMD_sint16x8) {
+                const int16_t *v = (const int16_t*)src;
+                for (uint32_t c = 0; c < ch; ++c) {
+                    integ[c] += (uint64_t)(v[c] - offset[c]);
+                }
+            } else {
+                for (uint32_t c = 0; c < ch; ++c) {
+                    // sign extended by the arithmetic shift of the value placed in the upper 24 bits
+                    int32_t v = (int32_t)((uint32_t)src[c * 3] << 8 | (uint32_t)src[c * 3 + 1] << 16 | (uint32_t)src[c * 3 + 2] << 24) >> 8;
+                    integ[c] += (uint64_t)(v - offset[c]);
+                }
+            }
+            for (uint32_t s = 1; s < stages; ++s) {
+                uint64_t *cur = &integ[(size_t)s * ch];
+                const uint64_t *prev = &integ[(size_t)(s - 1) * ch];
+                for (uint32_t c = 0; c < ch; ++c) {
+                    cur[c] += prev[c];
+                }
+            }
+        }
+        int64_t *y = &rows[(size_t)(k % 3) * ch];
+        for (uint32_t c = 0; c < ch; ++c) {
+            uint64_t v = integ[(size_t)(stages - 1) * ch + c];
+            for (uint32_t s = 0; s < stages; ++s) {
+                uint64_t d = v - comb[(size_t)s * ch + c];
+                comb[(size_t)s * ch + c] = v;
+                v = d;
+            }
+            int64_t sum = (int64_t)v;
+            int64_t q = (sum >= 0) ? (sum + gain / 2) / gain : -((-sum + gain / 2) / gain);
+            y[c] = q + offset[c];
+        }
+        if (!info->cic_compensate) {
+            for (uint32_t c = 0; c < ch; ++c) {
+                store_cic_value(output, &output->valueBuffer[(size_t)k * output->bytes_per_sample], c, y[c]);
+            }
+            continue;
+        }
+        // output k - 1 is complete now, the first and last outputs repeat their missing neighbour
+        if (k == 0) continue;
+        const int64_t *mid = &rows[(size_t)((k - 1) % 3) * ch];
+        const int64_t *before = (k >= 2) ? &rows[(size_t)((k - 2) % 3) * ch] : mid;
+        for (uint32_t c = 0; c < ch; ++c) {
+            int64_t v = (centre * mid[c] - a * (before[c] + y[c]) + (1 << (TIMELINE_CIC_COMP_BITS - 1))) >> TIMELINE_CIC_COMP_BITS;
+            store_cic_value(output, &output->valueBuffer[(size_t)(k - 1) * output->bytes_per_sample], c, v);
+        }
+    }
+    if (info->cic_compensate && count > 0) {
+        const int64_t *last = &rows[(size_t)((count - 1) % 3) * ch];
+        const int64_t *before = (count >= 2) ? &rows[(size_t)((count - 2) % 3) * ch] : last;
+        for (uint32_t c = 0; c < ch; ++c) {
+            int64_t v = (centre * last[c] - a * (before[c] + last[c]) + (1 << (TIMELINE_CIC_COMP_BITS - 1))) >> TIMELINE_CIC_COMP_BITS;
+            store_cic_value(output, &output->valueBuffer[(size_t)(count - 1) * output->bytes_per_sample], c, v);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,264 @@
+/*
+    File: timelinedb_codec.c
+    This file implements the compressed timeline: lossless block compression, decompression and min/max aggregation.
+    Author: Barna Farago - MYND-Ideal kft.
+    Date: 2025-07-01
+    License: Modified MIT License. You can use it for learn, but I can sell it as closed source with some improvements...
+*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <math.h>
+#include "timelinedb.h"
+#include "timelinedb_simd.h"
+
+/*
+    COMPRESSED TIMELINE
+    Block b holds rows [b * TIMELINE_CODEC_BLOCK, (b + 1) * TIMELINE_CODEC_BLOCK), its encoded 8-channel groups follow
+    each other from block_offsets[b] (the backend's codec kernels, layout at TimelineCodecGroupHeader). A group of
+    slowly varying 24-bit channels needs a few bits per sample instead of 24, plus the 132 byte header per 128 rows.
+    Any block can be decoded on its own, so a range costs only the blocks it touches.
+*/
+
+static inline uint32_t rows_CompressedBlock(const TimelineCompressedBuf *buf, uint32_t b) {
+    uint32_t first = b * TIMELINE_CODEC_BLOCK;
+    return (buf->nr_of_samples - first < TIMELINE_CODEC_BLOCK) ? buf->nr_of_samples - first : TIMELINE_CODEC_BLOCK;
+}
+
+// Decodes all rows of block b to dst (row stride bytes_per_sample)
+static void decode_CompressedBlock(const TimelineCompressedBuf *buf, fn_codec_decode decode, uint32_t b, uint8_t *dst) {
+    const uint32_t ch = buf->layout.nr_of_channels;
+    const uint32_t lane_bytes = buf->layout.bitwidth / 8;
+    const uint32_t rows = rows_CompressedBlock(buf, b);
+    const uint8_t *p = &buf->data[buf->block_offsets[b]];
+    for (uint32_t g = 0; g < ch; g += 8) {
+        p += decode(p, (ch - g < 8) ? ch - g : 8, rows, &dst[g * lane_bytes], buf->layout.bytes_per_sample);
+    }
+}
+
+void free_TimelineCompressedBuf(TimelineCompressedBuf *buf) {
+    if (!buf) return;
+    free(buf->block_offsets);
+    free(buf->data);
+    buf->block_offsets = NULL;
+    buf->data = NULL;
+    buf->data_size = 0;
+    buf->nr_of_blocks = 0;
+    buf->nr_of_samples = 0;
+}
+
+int compress_RawTimelineValues(const RawTimelineValuesBuf *input, TimelineCompressedBuf *output) {
+    if (!input || !output || !input->valueBuffer) {
+        return -1; // Invalid input
+    }
+    fn_codec_encode encode;
+    fn_codec_decode decode;
+    if (getCodecKernels(input->value_type, &encode, &decode) != 0) {
+        fprintf(stderr, "Unsupported value type for compression\n");
+        return -1;
+    }
+    RawTimelineValuesView view;
+    RawTimelineValuesBuf window;
+    make_RawTimelineValuesView(input, 0, input->nr_of_samples, &view);
+    if (map_RawTimelineValuesView(&view, &window) != 0) {
+        fprintf(stderr, "Compression needs interleaved samples, planar buffers are not supported\n");
+        return -1;
+    }
+
+    const uint32_t ch = input->nr_of_channels;
+    const uint32_t lane_bytes = input->bitwidth / 8;
+    const uint32_t bps = input->bytes_per_sample;
+    const uint32_t groups = (ch + 7) / 8;
+    const uint32_t worst_block = groups * TIMELINE_CODEC_GROUP_BYTES(32);
+    memset(output, 0, sizeof(*output));
+    init_RawTimelineValuesBuf(&output->layout);
+    output->layout.value_type = input->value_type;
+    output->layout.nr_of_channels = ch;
+    output->layout.bitwidth = input->bitwidth;
+    output->layout.bytes_per_sample = bps;
+    output->layout.time_step = input->time_step;
+    output->layout.time_exponent = input->time_exponent;
+    output->nr_of_samples = window.nr_of_samples;
+    output->nr_of_blocks = (window.nr_of_samples + TIMELINE_CODEC_BLOCK - 1) / TIMELINE_CODEC_BLOCK;
+    output->block_offsets = (uint32_t*)malloc(((size_t)output->nr_of_blocks + 1) * sizeof(uint32_t));
+    // start with half of the raw size, grown when a worst case block would not fit
+    size_t capacity = (size_t)window.nr_of_samples * bps / 2 + worst_block;
+    output->data = (uint8_t*)malloc(capacity);
+    if (!output->block_offsets || !output->data) {
+        fprintf(stderr, "ERROR: Memory allocation failed for the compressed timeline\n");
+        free_TimelineCompressedBuf(output);
+        return -1;
+    }
+    size_t size = 0;
+    for (uint32_t b = 0; b < output->nr_of_blocks; ++b) {
+        if (capacity - size < worst_block) {
+            capacity *= 2;
+            uint8_t *data = (uint8_t*)realloc(output->data, capacity);
+            if (!data) {
+                fprintf(stderr, "ERROR: Memory allocation failed for the compressed timeline\n");
+                free_TimelineCompressedBuf(output);
+                return -1;
+            }
+            output->data = data;
+        }
+        if (size > UINT32_MAX - worst_block) {
+            fprintf(stderr, "Compressed timeline exceeds 4 GB\n");
+            free_TimelineCompressedBuf(output);
+            return -1;
+        }
+        output->block_offsets[b] = (uint32_t)size;
+        const uint32_t rows = rows_CompressedBlock(output, b);
+        const uint8_t *row0 = &window.valueBuffer[(size_t)b * TIMELINE_CODEC_BLOCK * bps];
+        for (uint32_t g = 0; g < ch; g += 8) {
+            size += encode(&row0[g * lane_bytes], bps, (ch - g < 8) ? ch - g : 8, rows, &output->data[size]);
+        }
+    }
+    output->block_offsets[output->nr_of_blocks] = (uint32_t)size;
+    output->data_size = (uint32_t)size;
+    uint8_t *data = (uint8_t*)realloc(output->data, size ? size : 1);
+    if (data) output->data = data;
+    return 0;
+}
+
+int decompress_RawTimelineValues(const TimelineCompressedBuf *input, RawTimelineValuesBuf *output, uint32_t inSamples, uint32_t inOffset) {
+    if (!input || !output || !input->data) {
+        return -1; // Invalid input
+    }
+    fn_codec_encode encode;
+    fn_codec_decode decode;
+    if (getCodecKernels(input->layout.value_type, &encode, &decode) != 0) {
+        return -1;
+    }
+    if (inOffset > input->nr_of_samples) inOffset = input->nr_of_samples;
+    if (inSamples == 0 || inSamples > input->nr_of_samples - inOffset) inSamples = input->nr_of_samples - inOffset;
+    const uint32_t bps = input->layout.bytes_per_sample;
+    alloc_RawTimelineValuesBuf(output, inSamples, input->layout.nr_of_channels, input->layout.bitwidth, 64, input->layout.value_type);
+    if (!output->valueBuffer) {
+        fprintf(stderr, "ERROR: Memory allocation failed for the decompressed timeline\n");
+        return -1;
+    }
+    output->time_step = input->layout.time_step;
+    output->time_exponent = input->layout.time_exponent;
+    uint8_t *scratch = NULL;
+    const uint32_t end = inOffset + inSamples;
+    for (uint32_t b = inOffset / TIMELINE_CODEC_BLOCK; b * TIMELINE_CODEC_BLOCK < end; ++b) {
+        const uint32_t first = b * TIMELINE_CODEC_BLOCK;
+        const uint32_t last = first + rows_CompressedBlock(input, b);
+        if (first >= inOffset && last <= end) {
+            decode_CompressedBlock(input, decode, b, &output->valueBuffer[(size_t)(first - inOffset) * bps]);
+            continue;
+        }
+        // a block cut by the range: decoded aside, the rows inside are copied
+        if (!scratch) {
+            scratch = (uint8_t*)malloc((size_t)TIMELINE_CODEC_BLOCK * bps);
+            if (!scratch) {
+                fprintf(stderr, "ERROR: Memory allocation failed for a decoded block\n");
+                return -1;
+            }
+        }
+        decode_CompressedBlock(input, decode, b, scratch);
+        const uint32_t lo = (first > inOffset) ? first : inOffset;
+        const uint32_t hi = (last < end) ? last : end;
+        memcpy(&output->valueBuffer[(size_t)(lo - inOffset) * bps], &scratch[(size_t)(lo - first) * bps], (size_t)(hi - lo) * bps);
+    }
+    free(scratch);
+    return 0;
+}
+
+/*
+    Min/max columns with the bounds of aggregate_MinMax. The blocks a column covers completely are folded from the
+    group headers (first / min / max of every channel), only the blocks at the two column edges are decoded, into a
+    one block buffer scanned by the backend's min/max kernel. The accumulators are in the output scale (24-bit: >> 16,
+    monotonic, so the min of the scaled values is the scaled min).
+    The block buffer is the scratch of outMin, allocated by the first call, so repeated redraws do not allocate.
+    The kernel writes its partial min / max into column i itself, which is overwritten by the folded result.
+*/
+int aggregate_MinMax_compressed(const TimelineCompressedBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t inSamples, uint32_t inOffset) {
+    if (!input || !outMin || !outMax || !input->data || !outMin->valueBuffer || !outMax->valueBuffer || outMin->nr_of_samples == 0) {
+        return -1; // Invalid input
+    }
+    fn_codec_encode encode;
+    fn_codec_decode decode;
+    if (getCodecKernels(input->layout.value_type, &encode, &decode) != 0) {
+        fprintf(stderr, "Unsupported value type for aggregation\n");
+        return -1;
+    }
+    if (inOffset > input->nr_of_samples) inOffset = input->nr_of_samples;
+    if (inSamples == 0 || inSamples > input->nr_of_samples - inOffset) inSamples = input->nr_of_samples - inOffset;
+    if (inSamples == 0) {
+        return -1; // no sample in the range, the columns would have nothing to hold
+    }
+    const uint32_t ch = input->layout.nr_of_channels;
+    const uint32_t columns = outMin->nr_of_samples;
+    const int out_shift = (input->layout.value_type == TR_SIMD_sint24x8) ? 16 : 0;
+    const float stride_f = (float)inSamples / (float)columns;
+
+    if (reserve_TimelineScratch(outMin, (size_t)TIMELINE_CODEC_BLOCK * input->layout.bytes_per_sample) != 0) {
+        return -1;
+    }
+    RawTimelineValuesBuf block = input->layout;
+    block.valueBuffer = outMin->scratch;
+    fn_aggregate_minmax minmax_fn = getMinMaxKernel(&block, stride_f);
+    if (!minmax_fn) {
+        return -1;
+    }
+    int32_t acc_min[256], acc_max[256]; // nr_of_channels is 8-bit
+    uint32_t decoded_block = UINT32_MAX;
+    for (uint32_t i = 0; i < columns; ++i) {
+        uint32_t start = inOffset + (uint32_t)floorf(i * stride_f);
+        uint32_t end = inOffset + (uint32_t)floorf((i + 1) * stride_f);
+        // every column covers at least one row (the last one if the float stride rounds past the range)
+        if (start >= inOffset + inSamples) start = inOffset + inSamples - 1;
+        if (end <= start) end = start + 1;
+        if (end > inOffset + inSamples) end = inOffset + inSamples;
+        for (uint32_t c = 0; c < ch; ++c) {
+            acc_min[c] = INT32_MAX;
+            acc_max[c] = INT32_MIN;
+        }
+        for (uint32_t pos = start; pos < end; ) {
+            const uint32_t b = pos / TIMELINE_CODEC_BLOCK;
+            const uint32_t first = b * TIMELINE_CODEC_BLOCK;
+            const uint32_t rows = rows_CompressedBlock(input, b);
+            const uint32_t hi = (first + rows < end) ? first + rows : end;
+            if (pos == first && hi == first + rows) {
+                // the whole block is in the column: its headers answer it
+                const uint8_t *p = &input->data[input->block_offsets[b]];
+                for (uint32_t g = 0; g < ch; g += 8) {
+                    const TimelineCodecGroupHeader *h = (const TimelineCodecGroupHeader*)p;
+                    for (uint32_t l = 0; l < 8 && g + l < ch; ++l) {
+                        if ((h->min[l] >> out_shift) < acc_min[g + l]) acc_min[g + l] = h->min[l] >> out_shift;
+                        if ((h->max[l] >> out_shift) > acc_max[g + l]) acc_max[g + l] = h->max[l] >> out_shift;
+                    }
+                    p += TIMELINE_CODEC_GROUP_BYTES(h->width);
+                }
+            } else {
+                if (b != decoded_block) {
+                    decode_CompressedBlock(input, decode, b, block.valueBuffer);
+                    block.nr_of_samples = rows;
+                    decoded_block = b;
+                }
+                minmax_fn(&block, outMin, outMax, i, pos - first, hi - first);
+                for (uint32_t c = 0; c < ch; ++c) {
+                    const size_t o = (size_t)i * ch + c;
+                    int32_t mn = (outMin->bitwidth == 16) ? ((const int16_t*)outMin->valueBuffer)[o] : ((const int8_t*)outMin->valueBuffer)[o];
+                    int32_t mx = (outMax->bitwidth == 16) ? ((const int16_t*)outMax->valueBuffer)[o] : ((const int8_t*)outMax->valueBuffer)[o];
+                    if (mn < acc_min[c]) acc_min[c] = mn;
+                    if (mx > acc_max[c]) acc_max[c] = mx;
+                }
+            }
+            pos = hi;
+        }
+        for (uint32_t c = 0; c < ch; ++c) {
+            if (outMin->bitwidth == 16) {
+                ((int16_t*)outMin->valueBuffer)[(size_t)i * ch + c] = (int16_t)acc_min[c];
+                ((int16_t*)outMax->valueBuffer)[(size_t)i * ch + c] = (int16_t)acc_max[c];
+            } else {
+                ((int8_t*)outMin->valueBuffer)[(size_t)i * ch + c] = (int8_t)acc_min[c];
+                ((int8_t*)outMax->valueBuffer)[(size_t)i * ch + c] = (int8_t)acc_max[c];
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,183 @@
+/*
+    File: timelinedb_file.c
+    This file implements the native timeline file format: writing a buffer, opening a file as a memory mapped buffer.
+    Author: Barna Farago - MYND-Ideal kft.
+    Date: 2025-07-01
+    License: Modified MIT License. You can use it for learn, but I can sell it as closed source with some improvements...
+*/
+#define _POSIX_C_SOURCE 200809L // mmap, fstat with -std=c99
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "timelinedb.h"
+
+/*
+    TIMELINE FILES
+    The samples are stored exactly as in a linear RawTimelineValuesBuf, so an opened file needs no decoding: the
+    buffer's valueBuffer is the mapping + 64. The mapping starts on a page boundary, the samples on a 64 byte (cache
+    line) boundary. The zero padding at the end lets the kernels' vector loads run over the last sample like in an
+    aligned_alloc'ed buffer. The sample count is 64-bit in the header; this version opens files up to 4 GB of samples
+    (the 32-bit buffer_size of RawTimelineValuesBuf).
+*/
+#define TIMELINE_FILE_MAGIC "TLDB0001"
+#define TIMELINE_FILE_BYTE_ORDER 0x1234
+#define TIMELINE_FILE_WRITE_CHUNK (1u << 20)
+
+typedef struct {
+    char     magic[8];
+    uint32_t header_size;       // offset of the first sample
+    uint32_t value_type;        // RawTimelineValueEnum
+    uint64_t nr_of_samples;
+    uint32_t time_step;
+    int8_t   time_exponent;
+    uint8_t  nr_of_channels;
+    uint8_t  bitwidth;
+    uint8_t  reserved0;
+    uint16_t bytes_per_sample;
+    uint16_t byte_order;        // TIMELINE_FILE_BYTE_ORDER in the writer's byte order
+    uint32_t reserved1;
+    double   total_time_sec;
+    uint8_t  reserved2[16];
+} TimelineFileHeader;
+
+int write_TimelineFile(const char *path, const RawTimelineValuesBuf *buf) {
+    if (!path || !buf || !buf->valueBuffer || buf->bytes_per_sample == 0) {
+        return -1;
+    }
+    // a ring is written as its current window, oldest sample first
+    RawTimelineValuesView view;
+    RawTimelineValuesBuf window;
+    make_RawTimelineValuesView(buf, 0, buf->nr_of_samples, &view);
+    if (map_RawTimelineValuesView(&view, &window) != 0) {
+        return -1;
+    }
+    TimelineFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TIMELINE_FILE_MAGIC, sizeof(header.magic));
+    header.header_size = TIMELINE_FILE_HEADER_SIZE;
+    header.value_type = (uint32_t)buf->value_type;
+    header.nr_of_samples = window.nr_of_samples;
+    header.time_step = buf->time_step;
+    header.time_exponent = buf->time_exponent;
+    header.nr_of_channels = buf->nr_of_channels;
+    header.bitwidth = buf->bitwidth;
+    header.bytes_per_sample = buf->bytes_per_sample;
+    header.byte_order = TIMELINE_FILE_BYTE_ORDER;
+    header.total_time_sec = buf->total_time_sec;
+
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "ERROR: Can not create timeline file %s\n", path);
+        return -1;
+    }
+    const uint64_t size = (uint64_t)window.nr_of_samples * window.bytes_per_sample;
+    static const unsigned char padding[64] = { 0 };
+    int ok = fwrite(&header, sizeof(header), 1, f) == 1;
+    for (uint64_t pos = 0; ok && pos < size; pos += TIMELINE_FILE_WRITE_CHUNK) {
+        size_t n = (size - pos < TIMELINE_FILE_WRITE_CHUNK) ? (size_t)(size - pos) : TIMELINE_FILE_WRITE_CHUNK;
+        ok = fwrite(&window.valueBuffer[pos], 1, n, f) == n;
+    }
+    size_t pad = (size_t)((64 - size % 64) % 64);
+    if (ok && pad > 0) {
+        ok = fwrite(padding, 1, pad, f) == pad;
+    }
+    if (fclose(f) != 0) ok = 0;
+    if (!ok) {
+        fprintf(stderr, "ERROR: Writing timeline file %s failed\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+// bits per value of the value types, 0 for TR_undefined and unknown types
+static uint8_t bitwidth_TimelineFileValue(uint32_t value_type) {
+    switch (value_type) {
+    case TR_digital1:       return 1;
+    case TR_digital4:       return 4;
+    case TR_digital8:       return 8;
+    case TR_analog_sint8:   return 8;
+    case TR_analog_float32: return 32;
+    case TR_analog_float64: return 64;
+    case TR_SIMD_sint16x8:  return 16;
+    case TR_SIMD_sint24x8:  return 24;
+    default:                return 0;
+    }
+}
+
+int open_TimelineFile(const char *path, TimelineFile *file) {
+    if (!path || !file) {
+        return -1;
+    }
+    memset(file, 0, sizeof(*file));
+    init_RawTimelineValuesBuf(&file->buf);
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "ERROR: Can not open timeline file %s\n", path);
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < TIMELINE_FILE_HEADER_SIZE) {
+        fprintf(stderr, "ERROR: %s is not a timeline file\n", path);
+        close(fd);
+        return -1;
+    }
+    void *mapping = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // the mapping keeps the file open
+    if (mapping == MAP_FAILED) {
+        fprintf(stderr, "ERROR: Can not map timeline file %s\n", path);
+        return -1;
+    }
+    TimelineFileHeader header;
+    memcpy(&header, mapping, sizeof(header));
+    const uint64_t data_size = header.nr_of_samples * header.bytes_per_sample;
+    const char *error = NULL;
+    if (memcmp(header.magic, TIMELINE_FILE_MAGIC, sizeof(header.magic)) != 0 || header.header_size < sizeof(header) || (header.header_size % 64) != 0) {
+        error = "is not a timeline file";
+    } else if (header.byte_order != TIMELINE_FILE_BYTE_ORDER) {
+        error = "was written with another byte order";
+    } else if (header.nr_of_channels == 0 || header.bitwidth == 0 || header.bitwidth != bitwidth_TimelineFileValue(header.value_type) ||
+               header.bytes_per_sample != ((uint32_t)header.nr_of_channels * header.bitwidth + 7) / 8) {
+        // the kernels read nr_of_channels values per row, a shorter row would let them run past the mapping
+        error = "has an invalid sample layout";
+    } else if (data_size / header.bytes_per_sample != header.nr_of_samples || header.header_size + data_size > (uint64_t)st.st_size) {
+        error = "is truncated";
+    } else if (data_size > UINT32_MAX) {
+        error = "holds more than 4 GB of samples";
+    }
+    if (error) {
+        fprintf(stderr, "ERROR: %s %s\n", path, error);
+        munmap(mapping, (size_t)st.st_size);
+        return -1;
+    }
+    RawTimelineValuesBuf *buf = &file->buf;
+    buf->value_type = (RawTimelineValueEnum)header.value_type;
+    buf->nr_of_channels = header.nr_of_channels;
+    buf->bitwidth = header.bitwidth;
+    buf->bytes_per_sample = header.bytes_per_sample;
+    buf->time_step = header.time_step;
+    buf->time_exponent = header.time_exponent;
+    buf->total_time_sec = header.total_time_sec;
+    buf->nr_of_samples = (uint32_t)header.nr_of_samples;
+    buf->buffer_size = (uint32_t)data_size;
+    buf->valueBuffer = (unsigned char*)mapping + header.header_size;
+    file->mapping = mapping;
+    file->mapping_size = (uint64_t)st.st_size;
+    return 0;
+}
+
+void close_TimelineFile(TimelineFile *file) {
+    if (!file) return;
+    file->buf.valueBuffer = NULL; // not owned by the buffer
+    free_RawTimelineValuesBuf(&file->buf);
+    if (file->mapping) {
+        munmap(file->mapping, (size_t)file->mapping_size);
+        file->mapping = NULL;
+        file->mapping_size = 0;
+    }
+}
@@ -0,0 +1,132 @@
+/*
+    File: timelinedb_planar.c
+    This file implements the planar (one plane per channel) copies of interleaved buffers and the per channel access.
+    Author: Barna Farago - MYND-Ideal kft.
+    Date: 2025-07-01
+    License: Modified MIT License. You can use it for learn, but I can sell it as closed source with some improvements...
+*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include "timelinedb.h"
+#include "timelinedb_simd.h"
+
+/*
+    PLANAR BUFFERS
+    Every plane starts on a 64 byte boundary (plane_stride is rounded up) and the allocation has 64 bytes of slack
+    after the last plane, so a plane mapped as a one channel buffer is aligned and padded like an allocated one.
+    The transposes run in chunks of samples small enough for the source rows to stay in the L2 cache while every
+    8-channel group of them is transposed: a wide buffer (e.g. 80 channels) is read from memory once, not per group.
+*/
+#define TIMELINE_PLANAR_CHUNK_BYTES (64u * 1024u)
+
+static inline uint32_t chunk_PlanarSamples(uint32_t bytes_per_sample) {
+    uint32_t chunk = (TIMELINE_PLANAR_CHUNK_BYTES / bytes_per_sample) & ~7u;
+    return (chunk < 8) ? 8 : chunk;
+}
+
+int prepare_PlanarBuffer(const RawTimelineValuesBuf *src, RawTimelineValuesBuf *dst) {
+    if (!src || !dst || src->plane_stride || src->nr_of_channels == 0) {
+        return -1; // Invalid input
+    }
+    if (src->value_type != TR_SIMD_sint16x8 && src->value_type != TR_SIMD_sint24x8) {
+        fprintf(stderr, "Unsupported value type for a planar buffer\n");
+        return -1;
+    }
+    const uint32_t lane_bytes = src->bitwidth / 8;
+    const uint64_t plane_stride = ((uint64_t)src->nr_of_samples * lane_bytes + 63) & ~(uint64_t)63;
+    const uint64_t size = plane_stride * src->nr_of_channels;
+    if (size + 64 > UINT32_MAX) {
+        fprintf(stderr, "Planar buffer of %u samples exceeds 4 GB\n", src->nr_of_samples);
+        return -1;
+    }
+    if (reserve_RawTimelineValuesBuf(dst, (size_t)size + 64, 64) != 0) {
+        return -1;
+    }
+    dst->capacity = 0;
+    dst->value_type = src->value_type;
+    dst->nr_of_channels = src->nr_of_channels;
+    dst->bitwidth = src->bitwidth;
+    dst->bytes_per_sample = src->bytes_per_sample;
+    dst->time_step = src->time_step;
+    dst->time_exponent = src->time_exponent;
+    dst->total_time_sec = src->total_time_sec;
+    dst->nr_of_samples = src->nr_of_samples;
+    dst->buffer_size = (uint32_t)size;
+    dst->plane_stride = (uint32_t)plane_stride;
+    return 0;
+}
+
+int convert_to_PlanarBuffer(const RawTimelineValuesBuf *src, RawTimelineValuesBuf *dst) {
+    if (!src || !dst || !dst->valueBuffer || !dst->plane_stride) {
+        return -1; // Invalid input
+    }
+    fn_transpose to_planar, from_planar;
+    RawTimelineValuesView view;
+    RawTimelineValuesBuf window;
+    make_RawTimelineValuesView(src, 0, src->nr_of_samples, &view);
+    if (map_RawTimelineValuesView(&view, &window) != 0 || getTransposeKernels(src->value_type, &to_planar, &from_planar) != 0 ||
+        dst->value_type != src->value_type || dst->nr_of_channels != src->nr_of_channels || dst->nr_of_samples != window.nr_of_samples) {
+        fprintf(stderr, "Unsupported or mismatching buffers for the planar conversion\n");
+        return -1;
+    }
+    const uint32_t ch = window.nr_of_channels;
+    const uint32_t lane_bytes = window.bitwidth / 8;
+    const uint32_t bps = window.bytes_per_sample;
+    const uint32_t chunk = chunk_PlanarSamples(bps);
+    for (uint32_t i = 0; i < window.nr_of_samples; i += chunk) {
+        const uint32_t n = (window.nr_of_samples - i < chunk) ? window.nr_of_samples - i : chunk;
+        for (uint32_t g = 0; g < ch; g += 8) {
+            to_planar(&window.valueBuffer[(size_t)i * bps + g * lane_bytes], bps,
+                      &dst->valueBuffer[(size_t)g * dst->plane_stride + (size_t)i * lane_bytes], dst->plane_stride,
+                      (ch - g < 8) ? ch - g : 8, n);
+        }
+    }
+    return 0;
+}
+
+int convert_from_PlanarBuffer(const RawTimelineValuesBuf *src, RawTimelineValuesBuf *dst) {
+    if (!src || !dst || !src->valueBuffer || !dst->valueBuffer || !src->plane_stride || dst->plane_stride || dst->capacity) {
+        return -1; // Invalid input
+    }
+    fn_transpose to_planar, from_planar;
+    if (getTransposeKernels(src->value_type, &to_planar, &from_planar) != 0 || dst->value_type != src->value_type ||
+        dst->nr_of_channels != src->nr_of_channels || dst->nr_of_samples != src->nr_of_samples) {
+        fprintf(stderr, "Unsupported or mismatching buffers for the planar conversion\n");
+        return -1;
+    }
+    const uint32_t ch = src->nr_of_channels;
+    const uint32_t lane_bytes = src->bitwidth / 8;
+    const uint32_t bps = dst->bytes_per_sample;
+    const uint32_t chunk = chunk_PlanarSamples(bps);
+    for (uint32_t i = 0; i < src->nr_of_samples; i += chunk) {
+        const uint32_t n = (src->nr_of_samples - i < chunk) ? src->nr_of_samples - i : chunk;
+        for (uint32_t g = 0; g < ch; g += 8) {
+            from_planar(&src->valueBuffer[(size_t)g * src->plane_stride + (size_t)i * lane_bytes], src->plane_stride,
+                        &dst->valueBuffer[(size_t)i * bps + g * lane_bytes], bps,
+                        (ch - g < 8) ? ch - g : 8, n);
+        }
+    }
+    return 0;
+}
+
+int map_PlanarChannel(const RawTimelineValuesBuf *buf, uint8_t channel, RawTimelineValuesBuf *plane) {
+    if (!buf || !plane || !buf->valueBuffer || !buf->plane_stride || channel >= buf->nr_of_channels) {
+        return -1; // Invalid input
+    }
+    const uint32_t lane_bytes = buf->bitwidth / 8;
+    init_RawTimelineValuesBuf(plane);
+    plane->value_type = buf->value_type;
+    plane->nr_of_channels = 1;
+    plane->bitwidth = buf->bitwidth;
+    plane->bytes_per_sample = (uint16_t)lane_bytes;
+    plane->time_step = buf->time_step;
+    plane->time_exponent = buf->time_exponent;
+    plane->total_time_sec = buf->total_time_sec;
+    plane->nr_of_samples = buf->nr_of_samples;
+    plane->buffer_size = buf->nr_of_samples * lane_bytes;
+    plane->valueBuffer = &buf->valueBuffer[(size_t)channel * buf->plane_stride];
+    return 0;
+}
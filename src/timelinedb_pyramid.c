@@ -0,0 +1,328 @@
+/*
+    File: timelinedb_pyramid.c
+    This file implements the multi-resolution min/max index (pyramid) for zoomed-out aggregation.
+    Author: Barna Farago - MYND-Ideal kft.
+    Date: 2025-07-01
+    License: Modified MIT License. You can use it for learn, but I can sell it as closed source with some improvements...
+*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include "timelinedb.h"
+#include "timelinedb_simd.h"
+
+/*
+    MIN/MAX PYRAMID
+    Level 0 holds the min/max of every 2^base_shift raw samples, level k merges two blocks of level k-1.
+    The total memory is below 2 * capacity / 2^base_shift blocks, so ~1/8 of a 16-bit buffer with the default shift.
+    A query for [start, end) walks from start to end, always taking the largest aligned block which still fits,
+    therefore one output column costs O(log n) block merges plus at most 2 * 2^base_shift raw samples at the edges.
+*/
+
+static inline int32_t read_raw_sample(const RawTimelineValuesBuf *buf, uint32_t sample_index, uint8_t channel) {
+    const uint8_t *p = &buf->valueBuffer[sample_index * buf->bytes_per_sample + channel * buf->bitwidth / 8];
+    switch (buf->bitwidth) {
+    case 8:
+        return *(const int8_t*)p;
+    case 16:
+        return *(const int16_t*)p;
+    case 24: {
+        int32_t val = (p[0] | (p[1] << 8) | (p[2] << 16));
+        if (val & 0x800000) val |= ~0xFFFFFF; // Sign extend
+        return val;
+    }
+    default:
+        return 0;
+    }
+}
+
+// Saturating store, an empty range ends up as (type max, type min) like the scalar kernels produce.
+static inline void write_out_sample(RawTimelineValuesBuf *buf, uint32_t sample_index, uint8_t channel, int32_t value) {
+    uint8_t *p = &buf->valueBuffer[sample_index * buf->bytes_per_sample + channel * buf->bitwidth / 8];
+    int32_t limit = (buf->bitwidth >= 32) ? INT32_MAX : (int32_t)((1u << (buf->bitwidth - 1)) - 1);
+    if (value > limit) value = limit;
+    if (value < -limit - 1) value = -limit - 1;
+    switch (buf->bitwidth) {
+    case 8:
+        *(int8_t*)p = (int8_t)value;
+        break;
+    case 16:
+        *(int16_t*)p = (int16_t)value;
+        break;
+    case 24:
+        p[0] = value & 0xFF;
+        p[1] = (value >> 8) & 0xFF;
+        p[2] = (value >> 16) & 0xFF;
+        break;
+    default:
+        break;
+    }
+}
+
+int init_MinMaxPyramid(RawTimelineValuesBuf *buf, uint32_t capacity) {
+    if (!buf || buf->nr_of_channels == 0) {
+        return -1;
+    }
+    if (buf->bitwidth != 8 && buf->bitwidth != 16 && buf->bitwidth != 24) {
+        return -1; // Unsupported value type
+    }
+    free_MinMaxPyramid(buf);
+    if (buf->capacity) capacity = buf->capacity; // ring mode: the pyramid indexes the ring slots
+    if (capacity == 0) capacity = buf->nr_of_samples;
+
+    TimelineMinMaxPyramid *pyr = (TimelineMinMaxPyramid*)alloc_TimelineMemory(buf->allocator, sizeof(TimelineMinMaxPyramid), 16);
+    if (!pyr) {
+        fprintf(stderr, "ERROR: Memory allocation failed for TimelineMinMaxPyramid\n");
+        return -1;
+    }
+    memset(pyr, 0, sizeof(*pyr));
+    pyr->base_shift = TIMELINE_PYRAMID_BASE_SHIFT;
+    pyr->nr_of_channels = buf->nr_of_channels;
+    pyr->capacity = capacity;
+    for (uint8_t k = 0; k < TIMELINE_PYRAMID_MAX_LEVELS; k++) {
+        uint32_t blocks = capacity >> (pyr->base_shift + k);
+        if (blocks == 0) break;
+        size_t size = (size_t)blocks * pyr->nr_of_channels * sizeof(int32_t);
+        pyr->level_min[k] = (int32_t*)alloc_TimelineMemory(buf->allocator, size, 64);
+        pyr->level_max[k] = (int32_t*)alloc_TimelineMemory(buf->allocator, size, 64);
+        if (!pyr->level_min[k] || !pyr->level_max[k]) {
+            fprintf(stderr, "ERROR: Memory allocation failed for pyramid level %u\n", k);
+            pyr->nr_of_levels = k + 1;
+            buf->minmax_pyramid = pyr;
+            free_MinMaxPyramid(buf);
+            return -1;
+        }
+        pyr->nr_of_levels = k + 1;
+    }
+    buf->minmax_pyramid = pyr;
+    return update_MinMaxPyramid(buf);
+}
+
+void free_MinMaxPyramid(RawTimelineValuesBuf *buf) {
+    if (!buf || !buf->minmax_pyramid) return;
+    TimelineMinMaxPyramid *pyr = buf->minmax_pyramid;
+    for (uint8_t k = 0; k < pyr->nr_of_levels; k++) {
+        free_TimelineMemory(buf->allocator, pyr->level_min[k]);
+        free_TimelineMemory(buf->allocator, pyr->level_max[k]);
+    }
+    free_TimelineMemory(buf->allocator, pyr);
+    buf->minmax_pyramid = NULL;
+}
+
+static void pyramid_build_level0(const RawTimelineValuesBuf *buf, TimelineMinMaxPyramid *pyr, uint32_t b_lo, uint32_t b_hi) {
+    uint32_t block_size = 1u << pyr->base_shift;
+    uint8_t ch = pyr->nr_of_channels;
+    for (uint32_t b = b_lo; b < b_hi; b++) {
+        int32_t *mn = &pyr->level_min[0][b * ch];
+        int32_t *mx = &pyr->level_max[0][b * ch];
+        for (uint8_t c = 0; c < ch; c++) {
+            mn[c] = INT32_MAX;
+            mx[c] = INT32_MIN;
+        }
+        uint32_t first = b << pyr->base_shift;
+        if (buf->bitwidth == 16) {
+            // most common case (TR_SIMD_sint16x8), plain loop which the compiler can vectorize
+            const int16_t *src = (const int16_t*)&buf->valueBuffer[first * buf->bytes_per_sample];
+            for (uint32_t j = 0; j < block_size; j++, src += ch) {
+                for (uint8_t c = 0; c < ch; c++) {
+                    if (src[c] < mn[c]) mn[c] = src[c];
+                    if (src[c] > mx[c]) mx[c] = src[c];
+                }
+            }
+            continue;
+        }
+        for (uint32_t j = first; j < first + block_size; j++) {
+            for (uint8_t c = 0; c < ch; c++) {
+                int32_t v = read_raw_sample(buf, j, c);
+                if (v < mn[c]) mn[c] = v;
+                if (v > mx[c]) mx[c] = v;
+            }
+        }
+    }
+}
+
+static void pyramid_merge_level(TimelineMinMaxPyramid *pyr, uint8_t k, uint32_t b_lo, uint32_t b_hi) {
+    uint8_t ch = pyr->nr_of_channels;
+    const int32_t *cmn = pyr->level_min[k - 1];
+    const int32_t *cmx = pyr->level_max[k - 1];
+    for (uint32_t b = b_lo; b < b_hi; b++) {
+        int32_t *mn = &pyr->level_min[k][b * ch];
+        int32_t *mx = &pyr->level_max[k][b * ch];
+        const int32_t *l_mn = &cmn[(2 * b) * ch];
+        const int32_t *r_mn = &cmn[(2 * b + 1) * ch];
+        const int32_t *l_mx = &cmx[(2 * b) * ch];
+        const int32_t *r_mx = &cmx[(2 * b + 1) * ch];
+        for (uint8_t c = 0; c < ch; c++) {
+            mn[c] = (l_mn[c] < r_mn[c]) ? l_mn[c] : r_mn[c];
+            mx[c] = (l_mx[c] > r_mx[c]) ? l_mx[c] : r_mx[c];
+        }
+    }
+}
+
+/*
+    Folds the samples appended since the previous call into the pyramid.
+    The cost is proportional to the new samples: only the blocks touched by them (and their parents) are recomputed.
+    In ring mode the pyramid indexes storage slots, so overwritten blocks are recomputed as well.
+    If the buffer was reset (fewer samples than already built), the pyramid is rebuilt from the beginning.
+*/
+int update_MinMaxPyramid(RawTimelineValuesBuf *buf) {
+    if (!buf || !buf->minmax_pyramid) {
+        return -1;
+    }
+    TimelineMinMaxPyramid *pyr = buf->minmax_pyramid;
+    if (pyr->nr_of_levels == 0) {
+        return 0;
+    }
+    uint32_t seen = buf->capacity ? buf->ring_total : buf->nr_of_samples;
+    if (seen < pyr->built_samples) {
+        pyr->built_samples = 0;
+        memset(pyr->level_blocks, 0, sizeof(pyr->level_blocks));
+    }
+    uint32_t valid = buf->capacity ? ((seen < buf->capacity) ? seen : buf->capacity) : buf->nr_of_samples;
+    if (valid > pyr->capacity) valid = pyr->capacity;
+    uint32_t blocks0 = valid >> pyr->base_shift;
+    uint32_t block_size = 1u << pyr->base_shift;
+
+    // Dirty level 0 block ranges [lo, hi), at most two when the written slots wrap around the ring
+    uint32_t lo[2] = {0, 0};
+    uint32_t hi[2] = {0, 0};
+    uint32_t new_samples = seen - pyr->built_samples;
+    if (buf->capacity == 0) {
+        lo[0] = pyr->level_blocks[0];
+        hi[0] = blocks0;
+    } else if (new_samples >= buf->capacity) {
+        hi[0] = blocks0;
+    } else if (new_samples > 0) {
+        uint32_t slot_lo = pyr->built_samples % buf->capacity;
+        uint32_t slot_hi = slot_lo + new_samples;
+        lo[0] = slot_lo >> pyr->base_shift;
+        hi[0] = (((slot_hi < buf->capacity) ? slot_hi : buf->capacity) + block_size - 1) >> pyr->base_shift;
+        if (slot_hi > buf->capacity) {
+            hi[1] = (slot_hi - buf->capacity + block_size - 1) >> pyr->base_shift;
+        }
+    }
+    for (int r = 0; r < 2; r++) {
+        if (hi[r] > blocks0) hi[r] = blocks0;
+        if (lo[r] < hi[r]) pyramid_build_level0(buf, pyr, lo[r], hi[r]);
+    }
+    pyr->level_blocks[0] = blocks0;
+
+    // Upper levels merge two blocks of the level below, only the parents of the dirty blocks
+    for (uint8_t k = 1; k < pyr->nr_of_levels; k++) {
+        uint32_t blocks = pyr->level_blocks[k - 1] >> 1;
+        if (buf->capacity == 0) {
+            lo[0] = pyr->level_blocks[k];
+            hi[0] = blocks;
+        }
+        for (int r = 0; r < 2; r++) {
+            if (buf->capacity) {
+                lo[r] >>= 1;
+                hi[r] = (hi[r] + 1) >> 1;
+            }
+            if (hi[r] > blocks) hi[r] = blocks;
+            if (lo[r] < hi[r]) pyramid_merge_level(pyr, k, lo[r], hi[r]);
+        }
+        pyr->level_blocks[k] = blocks;
+    }
+    pyr->built_samples = seen;
+    return 0;
+}
+
+static inline void pyramid_scan_raw(const RawTimelineValuesBuf *input, uint8_t ch, uint32_t start, uint32_t end, int32_t *mn, int32_t *mx) {
+    if (input->bitwidth == 16) {
+        const int16_t *src = (const int16_t*)&input->valueBuffer[start * input->bytes_per_sample];
+        for (uint32_t j = start; j < end; j++, src += ch) {
+            for (uint8_t c = 0; c < ch; c++) {
+                if (src[c] < mn[c]) mn[c] = src[c];
+                if (src[c] > mx[c]) mx[c] = src[c];
+            }
+        }
+        return;
+    }
+    for (uint32_t j = start; j < end; j++) {
+        for (uint8_t c = 0; c < ch; c++) {
+            int32_t v = read_raw_sample(input, j, c);
+            if (v < mn[c]) mn[c] = v;
+            if (v > mx[c]) mx[c] = v;
+        }
+    }
+}
+
+// Merges the storage slots [start, end) into mn/mx, using the largest aligned blocks that fit.
+static void pyramid_accumulate(const RawTimelineValuesBuf *input, const TimelineMinMaxPyramid *pyr, uint32_t start, uint32_t end, int32_t *mn, int32_t *mx) {
+    uint8_t ch = pyr->nr_of_channels;
+    uint32_t built = pyr->level_blocks[0] << pyr->base_shift;
+    uint32_t built_end = (end < built) ? end : built;
+    uint32_t pos = start;
+    while (pos < end) {
+        // Take the largest aligned block that fits in the remaining range
+        int level = -1;
+        if (pos < built_end) {
+            for (int k = pyr->nr_of_levels - 1; k >= 0; k--) {
+                uint32_t shift = pyr->base_shift + k;
+                uint32_t size = 1u << shift;
+                if ((pos & (size - 1)) == 0 && pos + size <= built_end && (pos >> shift) < pyr->level_blocks[k]) {
+                    level = k;
+                    break;
+                }
+            }
+        }
+        if (level >= 0) {
+            uint32_t shift = pyr->base_shift + level;
+            const int32_t *bmn = &pyr->level_min[level][(pos >> shift) * ch];
+            const int32_t *bmx = &pyr->level_max[level][(pos >> shift) * ch];
+            for (uint8_t c = 0; c < ch; c++) {
+                if (bmn[c] < mn[c]) mn[c] = bmn[c];
+                if (bmx[c] > mx[c]) mx[c] = bmx[c];
+            }
+            pos += 1u << shift;
+        } else {
+            // raw samples up to the next block boundary (or to the end, beyond the built part)
+            uint32_t block_size = 1u << pyr->base_shift;
+            uint32_t run_end = (pos < built_end) ? ((pos | (block_size - 1)) + 1) : end;
+            if (run_end > end) run_end = end;
+            pyramid_scan_raw(input, ch, pos, run_end, mn, mx);
+            pos = run_end;
+        }
+    }
+}
+
+/*
+    AGGREGATION MIN/MAX from the pyramid.
+    Same signature as the backend kernels, so aggregate_MinMax can select it like any other fn_aggregate_minmax.
+    The output value type follows the input (8, 16 or 24 bit).
+    In ring mode [start, end) may reach into the mirrored half of the storage, it is folded back to the ring slots.
+ */
+int aggregate_minmax_pyramid(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t i, uint32_t start, uint32_t end) {
+    const TimelineMinMaxPyramid *pyr = input->minmax_pyramid;
+    uint8_t ch = input->nr_of_channels;
+    int32_t mn[256];
+    int32_t mx[256];
+    if (!pyr || pyr->nr_of_channels != ch) {
+        return -1;
+    }
+    if (end > input->nr_of_samples) end = input->nr_of_samples;
+    for (uint8_t c = 0; c < ch; c++) {
+        mn[c] = INT32_MAX;
+        mx[c] = INT32_MIN;
+    }
+    uint32_t cap = input->capacity;
+    if (cap == 0 || end <= cap) {
+        pyramid_accumulate(input, pyr, start, end, mn, mx);
+    } else {
+        if (start < cap) {
+            pyramid_accumulate(input, pyr, start, cap, mn, mx);
+            start = cap;
+        }
+        pyramid_accumulate(input, pyr, start - cap, end - cap, mn, mx);
+    }
+    // a narrower output keeps the upper bits, like the 24-bit -> 8-bit scalar kernel (>> 16)
+    uint8_t shift = (input->bitwidth > outMin->bitwidth) ? input->bitwidth - outMin->bitwidth : 0;
+    for (uint8_t c = 0; c < ch; c++) {
+        write_out_sample(outMin, i, c, mn[c] >> shift);
+        write_out_sample(outMax, i, c, mx[c] >> shift);
+    }
+    return 0;
+}
@@ -0,0 +1,206 @@
+/*
+    File: timelinedb_segments.c
+    This file implements the segmented timeline: 64-bit sample addressing over fixed size linear segments.
+    Author: Barna Farago - MYND-Ideal kft.
+    Date: 2025-07-01
+    License: Modified MIT License. You can use it for learn, but I can sell it as closed source with some improvements...
+*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <math.h>
+#include "timelinedb.h"
+#include "timelinedb_simd.h"
+
+/*
+    SEGMENTS
+    Sample k is sample (k & mask) of segment (k >> segment_shift). A segment is allocated when the first sample goes
+    into it and has the optional indexes of the container (pyramid, block statistics) sized for the whole segment,
+    so the append only updates the indexes of the segments it touched. The segment table is the only thing that grows
+    by realloc, one RawTimelineValuesBuf per segment: a day at 48 kHz is ~4000 segments of 1M samples.
+*/
+
+static int add_TimelineSegment(TimelineSegmentedBuf *seg) {
+    if (seg->nr_of_segments == seg->max_segments) {
+        uint32_t max_segments = seg->max_segments ? 2 * seg->max_segments : 16;
+        RawTimelineValuesBuf *segments = (RawTimelineValuesBuf*)realloc(seg->segments, (size_t)max_segments * sizeof(RawTimelineValuesBuf));
+        if (!segments) {
+            fprintf(stderr, "ERROR: Memory allocation failed for %u segments\n", max_segments);
+            return -1;
+        }
+        seg->segments = segments;
+        seg->max_segments = max_segments;
+    }
+    const RawTimelineValuesBuf *layout = &seg->layout;
+    const uint32_t segment_samples = 1u << seg->segment_shift;
+    RawTimelineValuesBuf *s = &seg->segments[seg->nr_of_segments];
+    init_RawTimelineValuesBuf(s);
+    alloc_RawTimelineValuesBuf(s, segment_samples, layout->nr_of_channels, layout->bitwidth, seg->bytealignment, layout->value_type);
+    s->time_exponent = layout->time_exponent;
+    s->time_step = layout->time_step;
+    s->nr_of_samples = 0; // fills up by appending, the indexes are sized for the whole segment
+    if ((seg->flags & TIMELINE_SEGMENTS_PYRAMID) && init_MinMaxPyramid(s, segment_samples) != 0) {
+        free_RawTimelineValuesBuf(s);
+        return -1;
+    }
+    if ((seg->flags & TIMELINE_SEGMENTS_BLOCKSTATS) && init_BlockStats(s, 0, 0) != 0) {
+        free_RawTimelineValuesBuf(s);
+        return -1;
+    }
+    seg->nr_of_segments++;
+    return 0;
+}
+
+int init_TimelineSegmentedBuf(TimelineSegmentedBuf *seg, uint8_t segment_shift, uint8_t flags,
+    uint8_t nr_of_channels, uint8_t bitwidth, uint8_t bytealignment, RawTimelineValueEnum value_type) {
+    if (!seg || nr_of_channels == 0 || bitwidth == 0) {
+        return -1;
+    }
+    if (segment_shift == 0) segment_shift = TIMELINE_SEGMENT_DEFAULT_SHIFT;
+    const uint16_t bytes_per_sample = (uint16_t)((nr_of_channels * bitwidth + 7) / 8);
+    if (segment_shift > 31 || ((uint64_t)bytes_per_sample << segment_shift) > UINT32_MAX) {
+        fprintf(stderr, "Segment of 2^%u samples does not fit in a buffer\n", segment_shift);
+        return -1;
+    }
+    memset(seg, 0, sizeof(*seg));
+    init_RawTimelineValuesBuf(&seg->layout);
+    seg->layout.nr_of_channels = nr_of_channels;
+    seg->layout.bitwidth = bitwidth;
+    seg->layout.bytes_per_sample = bytes_per_sample;
+    seg->layout.value_type = value_type;
+    seg->segment_shift = segment_shift;
+    seg->bytealignment = bytealignment;
+    seg->flags = flags;
+    return 0;
+}
+
+void free_TimelineSegmentedBuf(TimelineSegmentedBuf *seg) {
+    if (!seg) return;
+    for (uint32_t s = 0; s < seg->nr_of_segments; ++s) {
+        free_RawTimelineValuesBuf(&seg->segments[s]);
+    }
+    free(seg->segments);
+    seg->segments = NULL;
+    seg->nr_of_segments = 0;
+    seg->max_segments = 0;
+    seg->nr_of_samples = 0;
+}
+
+int append_TimelineSegmentedBuf(TimelineSegmentedBuf *seg, const void *samples, uint64_t count) {
+    if (!seg || (!samples && count > 0)) {
+        return -1;
+    }
+    const uint32_t bps = seg->layout.bytes_per_sample;
+    const uint32_t segment_samples = 1u << seg->segment_shift;
+    const unsigned char *src = (const unsigned char*)samples;
+    while (count > 0) {
+        uint32_t used = (uint32_t)(seg->nr_of_samples & (segment_samples - 1));
+        if (used == 0 && add_TimelineSegment(seg) != 0) {
+            return -1;
+        }
+        RawTimelineValuesBuf *s = &seg->segments[seg->nr_of_segments - 1];
+        uint32_t n = segment_samples - used;
+        if (n > count) n = (uint32_t)count;
+        memcpy(&s->valueBuffer[(size_t)used * bps], src, (size_t)n * bps);
+        s->nr_of_samples = used + n;
+        if (s->minmax_pyramid) update_MinMaxPyramid(s);
+        if (s->block_stats) update_BlockStats(s);
+        seg->nr_of_samples += n;
+        src += (size_t)n * bps;
+        count -= n;
+    }
+    return 0;
+}
+
+int locate_TimelineSegmentedSample(const TimelineSegmentedBuf *seg, uint64_t index, const RawTimelineValuesBuf **segment, uint32_t *local) {
+    if (!seg || !segment || !local || index >= seg->nr_of_samples) {
+        return -1;
+    }
+    *segment = &seg->segments[index >> seg->segment_shift];
+    *local = (uint32_t)(index & ((1u << seg->segment_shift) - 1));
+    return 0;
+}
+
+// Column i of 'part' (one column written by a kernel) folded into column i of 'out'
+static void merge_MinMaxColumn(RawTimelineValuesBuf *out, const RawTimelineValuesBuf *part, uint32_t i, int is_max) {
+    const uint32_t ch = out->nr_of_channels;
+    if (out->bitwidth == 16) {
+        int16_t *dst = &((int16_t*)out->valueBuffer)[(size_t)i * ch];
+        const int16_t *src = (const int16_t*)part->valueBuffer;
+        for (uint32_t c = 0; c < ch; ++c) {
+            if (is_max ? (src[c] > dst[c]) : (src[c] < dst[c])) dst[c] = src[c];
+        }
+    } else {
+        int8_t *dst = &((int8_t*)out->valueBuffer)[(size_t)i * ch];
+        const int8_t *src = (const int8_t*)part->valueBuffer;
+        for (uint32_t c = 0; c < ch; ++c) {
+            if (is_max ? (src[c] > dst[c]) : (src[c] < dst[c])) dst[c] = src[c];
+        }
+    }
+}
+
+/*
+    The column bounds are computed in 64-bit (double stride, like the float stride of aggregate_MinMax, but exact
+    for sample counts beyond 2^24). A column inside one segment is one kernel call on that segment. A column that
+    crosses segment boundaries is computed per segment, the parts go to a one column min / max pair in the scratch
+    of outMin (allocated by the first such column, kept with outMin) and are merged; there are at most
+    nr_of_segments - 1 such columns.
+*/
+int aggregate_MinMax_segmented(const TimelineSegmentedBuf *seg, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint64_t inSamples, uint64_t inOffset) {
+    if (!seg || !outMin || !outMax || !outMin->valueBuffer || !outMax->valueBuffer || outMin->nr_of_samples == 0) {
+        return -1; // Invalid input
+    }
+    if (inOffset > seg->nr_of_samples) inOffset = seg->nr_of_samples;
+    if (inSamples == 0 || inSamples > seg->nr_of_samples - inOffset) inSamples = seg->nr_of_samples - inOffset;
+    if (inSamples == 0) {
+        return -1; // nothing to aggregate
+    }
+    const uint32_t columns = outMin->nr_of_samples;
+    const double stride = (double)inSamples / (double)columns;
+    const uint32_t shift = seg->segment_shift;
+    const uint64_t mask = (1ull << shift) - 1;
+    fn_aggregate_minmax minmax_fn = NULL; // kernel of kernel_segment (pyramid or not is decided per segment)
+    uint32_t kernel_segment = UINT32_MAX;
+    RawTimelineValuesBuf partMin = *outMin, partMax = *outMax; // one column each, in outMin->scratch
+    partMin.valueBuffer = NULL;
+    partMin.nr_of_samples = partMax.nr_of_samples = 1;
+    for (uint32_t i = 0; i < columns; ++i) {
+        uint64_t start = inOffset + (uint64_t)floor(i * stride);
+        uint64_t end = inOffset + (uint64_t)floor((i + 1) * stride);
+        if (end <= start) end = start + 1;
+        if (end > inOffset + inSamples) end = inOffset + inSamples;
+        for (uint64_t pos = start; pos < end; ) {
+            uint32_t s = (uint32_t)(pos >> shift);
+            uint64_t part_end = ((uint64_t)s + 1) << shift;
+            if (part_end > end) part_end = end;
+            const RawTimelineValuesBuf *segment = &seg->segments[s];
+            if (s != kernel_segment) {
+                minmax_fn = getMinMaxKernel(segment, stride);
+                kernel_segment = s;
+                if (!minmax_fn) {
+                    return -1;
+                }
+            }
+            uint32_t lo = (uint32_t)(pos & mask);
+            uint32_t hi = (uint32_t)(part_end - ((uint64_t)s << shift));
+            if (pos == start) {
+                minmax_fn(segment, outMin, outMax, i, lo, hi);
+            } else {
+                if (!partMin.valueBuffer) {
+                    if (reserve_TimelineScratch(outMin, (size_t)2 * outMin->bytes_per_sample) != 0) {
+                        return -1;
+                    }
+                    partMin.valueBuffer = outMin->scratch;
+                    partMax.valueBuffer = outMin->scratch + outMin->bytes_per_sample;
+                }
+                minmax_fn(segment, &partMin, &partMax, 0, lo, hi);
+                merge_MinMaxColumn(outMin, &partMin, i, 0);
+                merge_MinMaxColumn(outMax, &partMax, i, 1);
+            }
+            pos = part_end;
+        }
+    }
+    return 0;
+}
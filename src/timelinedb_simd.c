@@ -13,10 +13,10 @@
 #include <stddef.h>
 #include "timelinedb_simd.h"
 
-#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(NEON_ENABLED)
-    #include <arm_neon.h>
-#elif (defined(__AVX2__) || defined(__AVX__)) && defined(AVX_ENABLED)
-    #include <immintrin.h>
+#if defined(AVX_ENABLED)
+    #include <cpuid.h>
+#elif defined(NEON_ENABLED) && defined(__linux__)
+    #include <sys/auxv.h>
 #endif
 
 /*
@@ -34,6 +34,23 @@ This testcase was run with 1000000 samples, 8 channels, 16-bit signed integer au
 Aprox. 5.2Mbyte was moved in N ms, which is aprox 1.4GB/s RAM throughput (using the L1 cache as well).
 
 Without opt, like -O0, the performance is terrible, C Backend version even quicker then SIMD but both are slow, aprox 20 times.
+
+Min/max aggregation of 1000000 samples x 8 channels (16-bit) into 800 columns, measured by devtest on an AVX-512 capable Xeon (AVX2 build):
+C Backend min/max aggregation took ~24000-42000 microseconds
+Intel AVX2 SIMD Backend (vertical kernel) took ~1600-1800 microseconds
+=> ~15-20x speedup. The previous broadcast + horizontal reduction version took ~9000-14000 microseconds.
+
+Same machine, runtime dispatched backends (devtest, 1.2x upsampling of 1000000 x 8 channels and min/max into 700-800 columns):
+                        convert s16x8   min/max s16x8   min/max s8   min/max s24x8
+C Backend               ~46000          ~42000          ~43000       ~52000
+Intel AVX2 SIMD Backend ~7700-8400      ~1750           (C)          ~4200
+Intel AVX-512 Backend   ~6900-7200      ~1740           ~1300        ~2900-3100
+The s16x8 scan is memory bound at this size (16 MByte), so the wider registers do not help there.
+
+Big-endian 24-bit payload decoding (append_BE24_Payloads, 100000 packets x 80 channels into 10 ring buffers):
+                        -> s16x8        -> s24x8
+C Backend               ~13000-17000    ~28000
+Intel AVX2 SIMD Backend ~6300-7500      ~9000
 */
 
 /* SAMPLE RATE CONVERSION
@@ -41,13 +58,12 @@ Without opt, like -O0, the performance is terrible, C Backend version even quick
     It uses linear interpolation for the conversion.
     The input is expected to be a RawTimelineValuesBuf with 16-bit signed integer samples.
     The output will be a new RawTimelineValuesBuf with the converted sample rate.
-    The function returns 0 on success, or -1 on failure (e.g., if the number of channels is not 8).
+    The function returns 0 on success. Any number of channels is accepted.
 */
 static int convert_sample_rate_SIMD_s16x8_c(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *output) {
     int16_t *src = (int16_t*)input->valueBuffer;
     int16_t *dst = (int16_t*)output->valueBuffer;
     uint32_t ch = input->nr_of_channels;
-    if (ch != 8) return -1;
     uint32_t new_nr_samples = output->nr_of_samples;
 
     double rate_ratio = output->sample_rate_info->rate_ratio;
@@ -69,181 +85,53 @@ static int convert_sample_rate_SIMD_s16x8_c(const RawTimelineValuesBuf *input, R
     }
     return 0;
 }
-int init_InterpInfo(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *output) {
-    int16_t *src = (int16_t*)input->valueBuffer;
-    int16_t *dst = (int16_t*)output->valueBuffer;
-    uint32_t ch = input->nr_of_channels;
-    if (ch != 8) return -1;
-    uint32_t new_nr_samples=output->nr_of_samples;
-
-    SampleInterpInfo *interp_array = (SampleInterpInfo*)malloc(new_nr_samples * sizeof(SampleInterpInfo));
-    if (!interp_array) {
+/*
+    Interpolation positions for the ratio up / down. Output i sits at input position i * down / up, the pattern of
+    (position - integer input offset) repeats after up / gcd outputs, so only that period is stored:
+    O(up / gcd) entries instead of one per output sample (a 1M sample output needed 12 MB before).
+    Positions past the last input pair take the last sample (frac = 0x10000).
+*/
+int init_InterpInfo(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *output, uint32_t up, uint32_t down) {
+    if (!input || !output || up == 0 || down == 0 || input->nr_of_samples < 2) {
+        return -1;
+    }
+    uint32_t g = gcd_u32(up, down);
+    up /= g;
+    down /= g;
+    uint32_t nr_of_phases = (up < output->nr_of_samples) ? up : output->nr_of_samples;
+    SampleInterpTable *table = (SampleInterpTable*)alloc_TimelineMemory(output->allocator, sizeof(SampleInterpTable) + (size_t)nr_of_phases * sizeof(SampleInterpInfo), 16);
+    if (!table) {
         fprintf(stderr, "ERROR: Memory allocation failed for SampleInterpInfo\n");
         return -1;
     }
-    output->prepared_data_src = interp_array;
-
-    for (uint32_t i = 0; i < new_nr_samples; ++i) {
-        double original_index = (double)i / ((double)new_nr_samples / (double)input->nr_of_samples);
-        uint32_t idx0 = (uint32_t)original_index;
-        if (idx0 >= input->nr_of_samples - 1) idx0 = input->nr_of_samples - 2;
-        uint32_t idx1 = (idx0 + 1 < input->nr_of_samples) ? idx0 + 1 : idx0;
-        double frac = original_index - idx0;
-        uint16_t frac_fixed = (uint16_t)(frac * 65536.0);
-        uint16_t inv_frac_fixed = 0x10000 - frac_fixed;
-        interp_array[i].idx0 = idx0;
-        interp_array[i].idx1 = idx1;
-        interp_array[i].frac = frac_fixed;
-        interp_array[i].inv_frac = inv_frac_fixed;
+    table->period_outputs = up;
+    table->period_inputs = down;
+    table->nr_of_phases = nr_of_phases;
+    for (uint32_t j = 0; j < nr_of_phases; ++j) {
+        uint64_t pos = (uint64_t)j * down;
+        table->phases[j].idx0 = (uint32_t)(pos / up);
+        table->phases[j].frac = (uint32_t)(((pos % up) << 16) / up);
+        table->phases[j].inv_frac = 0x10000 - table->phases[j].frac;
     }
+    output->prepared_data_src = table;
     return 0;
 }
+const SampleInterpTable *get_SampleInterpTable(const RawTimelineValuesBuf *input, const RawTimelineValuesBuf *output) {
+    const SampleInterpTable *table = output->prepared_data_src;
+    if (!table || input->nr_of_samples < 2 ||
+        (table->nr_of_phases < table->period_outputs && output->nr_of_samples > table->nr_of_phases)) {
+        fprintf(stderr, "Output is not prepared for the sample rate conversion\n");
+        return NULL;
+    }
+    return table;
+}
 void free_InterpInfo(RawTimelineValuesBuf *output) {
     if (output->prepared_data_src) {
-        free(output->prepared_data_src);
+        free_TimelineMemory(output->allocator, output->prepared_data_src);
         output->prepared_data_src = NULL;
     }
 }
 
-#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(NEON_ENABLED)
-/*
-static int convert_sample_rate_SIMD_s16x8_neon(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *output, double rate_ratio, uint32_t new_nr_samples) {
-    int16_t *src = (int16_t*)input->valueBuffer;
-    int16_t *dst = (int16_t*)output->valueBuffer;
-    uint32_t ch = input->nr_of_channels;
-    if (ch != 8) return -1;
-
-    // Precompute fixed-point step in Q16.16
-    uint32_t step_fixed = (uint32_t)(65536.0 / rate_ratio);
-    uint32_t pos_fixed = 0;
-
-    for (uint32_t i = 0; i < new_nr_samples; ++i) {
-        uint32_t idx0 = pos_fixed >> 16;
-        uint32_t idx1 = (idx0 + 1 < input->nr_of_samples) ? idx0 + 1 : idx0;
-        uint32_t frac_fixed = pos_fixed & 0xFFFF;
-        uint32_t inv_frac_fixed = 0x10000 - frac_fixed;
-
-        int16x8_t v0 = vld1q_s16(&src[idx0 * ch]);
-        int16x8_t v1 = vld1q_s16(&src[idx1 * ch]);
-
-        int32x4_t v0_lo = vmovl_s16(vget_low_s16(v0));
-        int32x4_t v0_hi = vmovl_s16(vget_high_s16(v0));
-        int32x4_t v1_lo = vmovl_s16(vget_low_s16(v1));
-        int32x4_t v1_hi = vmovl_s16(vget_high_s16(v1));
-
-        int32x4_t interp_lo = vmlaq_n_s32(vmulq_n_s32(v0_lo, inv_frac_fixed), v1_lo, frac_fixed);
-        int32x4_t interp_hi = vmlaq_n_s32(vmulq_n_s32(v0_hi, inv_frac_fixed), v1_hi, frac_fixed);
-
-        // Normalize by shifting down from Q16.16 to Q0
-        interp_lo = vrshrq_n_s32(interp_lo, 16);
-        interp_hi = vrshrq_n_s32(interp_hi, 16);
-
-        int16x4_t res_lo = vmovn_s32(interp_lo);
-        int16x4_t res_hi = vmovn_s32(interp_hi);
-        int16x8_t result = vcombine_s16(res_lo, res_hi);
-
-        vst1q_s16(&dst[i * ch], result);
-
-        pos_fixed += step_fixed;
-    }
-    return 0;
-}
-*/
-
-static int convert_sample_rate_SIMD_s16x8_neon(
-    const RawTimelineValuesBuf *input, RawTimelineValuesBuf *output)
-{
-    int16_t *src = (int16_t*)input->valueBuffer;
-    int16_t *dst = (int16_t*)output->valueBuffer;
-    uint32_t ch = input->nr_of_channels;
-
-    uint32_t new_nr_samples = output->nr_of_samples;
-    SampleInterpInfo *interp_array = (SampleInterpInfo *)output->prepared_data_src;
-    if (1){
-        for (uint32_t i = 0; i + 1 < new_nr_samples; i++) {
-            const SampleInterpInfo *p0 = &interp_array[i];
-            uint16_t p0frac = p0->frac;
-            uint16_t p0inv_frac = p0->inv_frac;
-            
-            int16x8_t v0_0 = vld1q_s16(&src[p0->idx0 * ch]);
-            int16x8_t v1_0 = vld1q_s16(&src[p0->idx1 * ch]);
-            int32x4_t interp_lo_0 = vmlaq_n_s32(vmulq_n_s32(vmovl_s16(vget_low_s16(v0_0)), p0inv_frac), vmovl_s16(vget_low_s16(v1_0)), p0frac);
-            int32x4_t interp_hi_0 = vmlaq_n_s32(vmulq_n_s32(vmovl_s16(vget_high_s16(v0_0)), p0inv_frac), vmovl_s16(vget_high_s16(v1_0)), p0frac);
-            int16x8_t result_0 = vcombine_s16(vmovn_s32(vrshrq_n_s32(interp_lo_0, 16)), vmovn_s32(vrshrq_n_s32(interp_hi_0, 16)));
-            vst1q_s16(&dst[i * ch], result_0);
-        }
-    } else {
-        /* This is a more optimized version that processes 4 samples at a time
-        // but actually it is not better than the loop version above.
-        // which is strange, it should be better. It is on invenstigation yet.
-        */
-        int16x8_t* optr = (int16x8_t*)dst;
-        for (uint32_t i = 0; i + 1 < new_nr_samples; i += 4) {
-            const SampleInterpInfo *p0 = &interp_array[i];
-            uint16_t p0frac = p0->frac;
-            uint16_t p0inv_frac = p0->inv_frac;
-            uint16_t p0idx0 = p0->idx0 *8;
-            int16_t *base_ptr = &src[p0idx0];
-            p0++;
-            uint16_t p1frac = p0->frac;
-            uint16_t p1inv_frac = p0->inv_frac;
-            int16x8_t v0, v1;
-            int16x8x2_t v_pair0 = vld1q_s16_x2(base_ptr); // Loads 2 x 16 bytes (32 bytes total)
-            int16x8x2_t v_pair1 = vld1q_s16_x2(base_ptr+8); // Loads 2 x 16 bytes (32 bytes total)
-
-            p0++;
-            uint16_t p2frac = p0->frac;
-            uint16_t p2inv_frac = p0->inv_frac;
-            uint16_t p2idx0 = p0->idx0 *8;
-            int16_t *base_ptr2 = &src[p2idx0];
-            p0++;
-            uint16_t p3frac = p0->frac;
-            uint16_t p3inv_frac = p0->inv_frac;
-            int16x8_t v2, v3;
-            
-            int16x8x2_t v_pair2 = vld1q_s16_x2(base_ptr2); // Loads 2 x 16 bytes (32 bytes total)
-            int16x8x2_t v_pair3 = vld1q_s16_x2(base_ptr2+8); // Loads 2 x 16 bytes (32 bytes total)
-
-            v0 = v_pair0.val[0];  // src[p0idx0]
-            v1 = v_pair0.val[1];  // src[p0idx1]
-            int32x4_t interp_lo_0 = vmlaq_n_s32(vmulq_n_s32(vmovl_s16(vget_low_s16(v0)), p0inv_frac), vmovl_s16(vget_low_s16(v1)), p0frac);
-            int32x4_t interp_hi_0 = vmlaq_n_s32(vmulq_n_s32(vmovl_s16(vget_high_s16(v0)), p0inv_frac), vmovl_s16(vget_high_s16(v1)), p0frac);
-            int16x8_t result_0 = vcombine_s16(vmovn_s32(vrshrq_n_s32(interp_lo_0, 16)), vmovn_s32(vrshrq_n_s32(interp_hi_0, 16)));
-            vst1q_s16((int16_t*)optr, result_0);
-            optr++;
-
-            // i + 1
-            v0 = v_pair1.val[0];  // src[p0idx0]
-            v1 = v_pair1.val[1];  // src[p0idx1]
-            int32x4_t interp_lo_1 = vmlaq_n_s32(vmulq_n_s32(vmovl_s16(vget_low_s16(v0)), p1inv_frac), vmovl_s16(vget_low_s16(v1)), p1frac);
-            int32x4_t interp_hi_1 = vmlaq_n_s32(vmulq_n_s32(vmovl_s16(vget_high_s16(v0)), p1inv_frac), vmovl_s16(vget_high_s16(v1)), p1frac);
-            int16x8_t result_1 = vcombine_s16(vmovn_s32(vrshrq_n_s32(interp_lo_1, 16)), vmovn_s32(vrshrq_n_s32(interp_hi_1, 16)));
-            vst1q_s16((int16_t*)optr, result_1);
-            optr++;
-            
-            // i + 2
-            v0 = v_pair2.val[0];  // src[p0idx0]
-            v1 = v_pair2.val[1];  // src[p0idx1]
-            int32x4_t interp_lo_2 = vmlaq_n_s32(vmulq_n_s32(vmovl_s16(vget_low_s16(v0)), p2inv_frac), vmovl_s16(vget_low_s16(v1)), p2frac);
-            int32x4_t interp_hi_2 = vmlaq_n_s32(vmulq_n_s32(vmovl_s16(vget_high_s16(v0)), p2inv_frac), vmovl_s16(vget_high_s16(v1)), p2frac);
-            int16x8_t result_2 = vcombine_s16(vmovn_s32(vrshrq_n_s32(interp_lo_2, 16)), vmovn_s32(vrshrq_n_s32(interp_hi_2, 16)));
-            vst1q_s16((int16_t*)optr, result_2);
-            optr++;
-            
-            // i + 3
-            v0 = v_pair3.val[0];  // src[p0idx0]
-            v1 = v_pair3.val[1];  // src[p0idx1]
-            int32x4_t interp_lo_3 = vmlaq_n_s32(vmulq_n_s32(vmovl_s16(vget_low_s16(v0)), p3inv_frac), vmovl_s16(vget_low_s16(v1)), p3frac);
-            int32x4_t interp_hi_3 = vmlaq_n_s32(vmulq_n_s32(vmovl_s16(vget_high_s16(v0)), p3inv_frac), vmovl_s16(vget_high_s16(v1)), p3frac);
-            int16x8_t result_3 = vcombine_s16(vmovn_s32(vrshrq_n_s32(interp_lo_3, 16)), vmovn_s32(vrshrq_n_s32(interp_hi_3, 16)));
-            vst1q_s16((int16_t*)optr, result_3);
-            optr++;
-        }
-    }
-    return 0;
-}
-#endif
-
 /* AGGREGATION MIN/MAX - Downsample.
     This function computes the minimum and maximum values for each channel in the specified range of samples.
     It is used to downsample the data by aggregating the min and max values over a range of samples.
@@ -251,6 +139,24 @@ static int convert_sample_rate_SIMD_s16x8_neon(
     The output will be two RawTimelineValuesBufs containing the min and max values for each channel.
  */
 int aggregate_minmax_SIMD_s16x8_c(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t i, uint32_t start, uint32_t end) {
+    if (!input->plane_stride) {
+        // interleaved rows: read in place, every channel with its min / max in registers
+        const uint32_t nr_of_channels = input->nr_of_channels;
+        const int16_t *src = (const int16_t*)input->valueBuffer;
+        if (end > input->nr_of_samples) end = input->nr_of_samples;
+        for (uint32_t ch = 0; ch < nr_of_channels; ++ch) {
+            int16_t min_val = INT16_MAX;
+            int16_t max_val = INT16_MIN;
+            for (uint32_t j = start; j < end; ++j) {
+                int16_t value = src[(size_t)j * nr_of_channels + ch];
+                if (value < min_val) min_val = value;
+                if (value > max_val) max_val = value;
+            }
+            ((int16_t*)outMin->valueBuffer)[i * nr_of_channels + ch] = min_val;
+            ((int16_t*)outMax->valueBuffer)[i * nr_of_channels + ch] = max_val;
+        }
+        return 0;
+    }
     for (uint8_t ch = 0; ch < input->nr_of_channels; ++ch) {
         int16_t min_val = INT16_MAX;
         int16_t max_val = INT16_MIN;
@@ -296,316 +202,535 @@ int aggregate_minmax_SIMD_s24x8_c(const RawTimelineValuesBuf *input, RawTimeline
     return 0;
 }
 
-#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(NEON_ENABLED)
-int aggregate_minmax_SIMD_s16x8_neon(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t i, uint32_t start, uint32_t end) {
+int aggregate_minmax_s8_c(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t i, uint32_t start, uint32_t end) {
     for (uint8_t ch = 0; ch < input->nr_of_channels; ++ch) {
-        int16x8_t min_val = vdupq_n_s16(INT16_MAX);
-        int16x8_t max_val = vdupq_n_s16(INT16_MIN);
+        int8_t min_val = INT8_MAX;
+        int8_t max_val = INT8_MIN;
 
         for (uint32_t j = start; j < end; ++j) {
-            int16x8_t sample = vld1q_s16(((int16_t*)input->valueBuffer) + (j * input->nr_of_channels + ch));
-            min_val = vminq_s16(min_val, sample);
-            max_val = vmaxq_s16(max_val, sample);
+            int8_t value;
+            if (getSampleValue_int8(input, j, ch, &value) == 0) {
+                if (value < min_val) min_val = value;
+                if (value > max_val) max_val = value;
+            } else {
+                fprintf(stderr, "Error accessing sample %u, channel %u\n", j, ch);
+                return -1; // Error accessing sample
+            }
         }
-        vst1q_s16(((int16_t*)outMin->valueBuffer) + (i * input->nr_of_channels + ch), min_val);
-        vst1q_s16(((int16_t*)outMax->valueBuffer) + (i * input->nr_of_channels + ch), max_val);
+        ((int8_t*)outMin->valueBuffer)[i * input->nr_of_channels + ch] = min_val;
+        ((int8_t*)outMax->valueBuffer)[i * input->nr_of_channels + ch] = max_val;
     }
     return 0;
 }
-#elif (defined(__AVX2__) || defined(__AVX__)) && defined(AVX_ENABLED)
-int aggregate_minmax_SIMD_s16x8_avx(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t i, uint32_t start, uint32_t end) {
-      for (uint8_t ch = 0; ch < input->nr_of_channels; ++ch) {
-        // Inicializáljuk a minimumot és maximumot 16 bites egész típusokra, 256 bites AVX regiszterben (8 x int32 miatt)
-        __m128i min_s16 = _mm_set1_epi16(INT16_MAX);
-        __m128i max_s16 = _mm_set1_epi16(INT16_MIN);
-
-        for (uint32_t j = start; j < end; ++j) {
-            uint32_t idx = j * input->nr_of_channels + ch;
-            if (idx >= input->nr_of_samples * input->nr_of_channels) {
-                //fprintf(stderr, "Index out of bounds: %u\n", idx);
-                return -1; // Index out of bounds
-            }
-            int16_t sample = ((int16_t*)input->valueBuffer)[idx];
-            __m128i current = _mm_set1_epi16(sample);
 
-            min_s16 = _mm_min_epi16(min_s16, current);
-            max_s16 = _mm_max_epi16(max_s16, current);
+/*
+    AGGREGATION STATISTICS
+    Sum, sum of squares, min and max of every channel over [start, end) in one pass (the mean / RMS of a column
+    come from the sums, see aggregate_Stats). The sums are exact integers, so every backend gives the same result.
+    The samples are read row by row directly from the buffer, the column is clamped to the buffer like the SIMD kernels.
+ */
+int aggregate_stats_s8_c(const RawTimelineValuesBuf *input, uint32_t start, uint32_t end, TimelineChannelSums *sums) {
+    const uint32_t ch = input->nr_of_channels;
+    if (end > input->nr_of_samples) end = input->nr_of_samples;
+    init_TimelineChannelSums(sums, ch);
+    for (uint32_t j = start; j < end; ++j) {
+        const int8_t *row = (const int8_t*)&input->valueBuffer[(size_t)j * input->bytes_per_sample];
+        for (uint32_t c = 0; c < ch; ++c) {
+            int32_t v = row[c];
+            sums[c].sum += v;
+            sums[c].sum_sq += (uint64_t)(v * v); // 2^14 per sample, 64 bits cannot overflow for 2^32 samples
+            if (v < sums[c].min) sums[c].min = v;
+            if (v > sums[c].max) sums[c].max = v;
         }
+    }
+    return 0;
+}
 
-        // Kiválasztjuk az egyetlen minimumot és maximumot az AVX regiszterekből
-        int16_t min_vals[8], max_vals[8];
-        _mm_storeu_si128((__m128i*)min_vals, min_s16);
-        _mm_storeu_si128((__m128i*)max_vals, max_s16);
+int aggregate_stats_s16x8_c(const RawTimelineValuesBuf *input, uint32_t start, uint32_t end, TimelineChannelSums *sums) {
+    const uint32_t ch = input->nr_of_channels;
+    if (end > input->nr_of_samples) end = input->nr_of_samples;
+    init_TimelineChannelSums(sums, ch);
+    for (uint32_t j = start; j < end; ++j) {
+        const int16_t *row = (const int16_t*)&input->valueBuffer[(size_t)j * input->bytes_per_sample];
+        for (uint32_t c = 0; c < ch; ++c) {
+            int32_t v = row[c];
+            sums[c].sum += v;
+            sums[c].sum_sq += (uint64_t)((int64_t)v * v); // 2^30 per sample, no overflow for 2^32 samples
+            if (v < sums[c].min) sums[c].min = v;
+            if (v > sums[c].max) sums[c].max = v;
+        }
+    }
+    return 0;
+}
 
-        int16_t min_final = INT16_MAX;
-        int16_t max_final = INT16_MIN;
-        for (int k = 0; k < 8; ++k) {
-            if (min_vals[k] < min_final) min_final = min_vals[k];
-            if (max_vals[k] > max_final) max_final = max_vals[k];
+int aggregate_stats_s24x8_c(const RawTimelineValuesBuf *input, uint32_t start, uint32_t end, TimelineChannelSums *sums) {
+    const uint32_t ch = input->nr_of_channels;
+    if (end > input->nr_of_samples) end = input->nr_of_samples;
+    init_TimelineChannelSums(sums, ch);
+    for (uint32_t j = start; j < end; ++j) {
+        const uint8_t *row = &input->valueBuffer[(size_t)j * input->bytes_per_sample];
+        for (uint32_t c = 0; c < ch; ++c) {
+            // sign extended by the arithmetic shift of the value placed in the upper 24 bits
+            int32_t v = (int32_t)((uint32_t)row[c * 3] << 8 | (uint32_t)row[c * 3 + 1] << 16 | (uint32_t)row[c * 3 + 2] << 24) >> 8;
+            sums[c].sum += v;
+            add_TimelineChannelSumSq(&sums[c], (uint64_t)((int64_t)v * v));
+            if (v < sums[c].min) sums[c].min = v;
+            if (v > sums[c].max) sums[c].max = v;
         }
+    }
+    return 0;
+}
+
+/*
+    Fixed-point sample rate conversion for interleaved 16-bit signed integer audio (any channel count).
+    The positions come from the prepared table (init_InterpInfo), walked phase by phase like Bresenham's algorithm:
+    no division in the loop, and the input advances by as many samples per output as the ratio needs (downsampling too).
+    It performs Q16 linear interpolation between nearest samples (interp_s16_q16), the SIMD backends compute the same.
+    The cursor seeks to 'first', so any output range converts on its own (convert_sample_rate_parallel).
+*/
+
+// C version as fallback and dispatcher
+static int convert_sample_rate_SIMD_s16x8_bresenham(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *output, uint32_t first, uint32_t count)
+{
+    const SampleInterpTable *table = get_SampleInterpTable(input, output);
+    if (!table) return -1;
+    const int16_t *src = (const int16_t*)input->valueBuffer;
+    int16_t *dst = (int16_t*)output->valueBuffer;
+    uint32_t ch = input->nr_of_channels;
+    uint32_t in_samples = input->nr_of_samples;
 
-        ((int16_t*)outMin->valueBuffer)[i * input->nr_of_channels + ch] = min_final;
-        ((int16_t*)outMax->valueBuffer)[i * input->nr_of_channels + ch] = max_final;
+    SampleInterpCursor cur;
+    seek_SampleInterpCursor(table, first, &cur);
+    for (uint32_t i = first; i < first + count; ++i) {
+        uint32_t frac;
+        const int16_t *r0 = &src[(size_t)pos_SampleInterpCursor(table, &cur, in_samples, &frac) * ch];
+        int16_t *out = &dst[(size_t)i * ch];
+        for (uint32_t j = 0; j < ch; ++j) {
+            out[j] = interp_s16_q16(r0[j], r0[ch + j], frac);
+        }
+        next_SampleInterpCursor(table, &cur);
     }
     return 0;
 }
-#endif
 
-#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(NEON_ENABLED)
-int aggregate_minmax_s8_neon(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t i, uint32_t start, uint32_t end) {
-    for (uint8_t ch = 0; ch < input->nr_of_channels; ++ch) {
-        int8x16_t min_vec = vdupq_n_s8(INT8_MAX);
-        int8x16_t max_vec = vdupq_n_s8(INT8_MIN);
-
-        for (uint32_t j = start; j < end; j += 16) {
-            uint32_t remaining = end - j;
-            int8x16_t vals;
-            if (remaining >= 16) {
-                vals = vld1q_s8(&((int8_t*)input->valueBuffer)[j * input->nr_of_channels + ch]);
-            } else {
-                int8_t tmp[16] = {0};
-                for (uint32_t k = 0; k < remaining; ++k) {
-                    tmp[k] = ((int8_t*)input->valueBuffer)[(j + k) * input->nr_of_channels + ch];
-                }
-                vals = vld1q_s8(tmp);
+/*
+    STREAMING RESAMPLING
+    Q16 linear interpolation of a run of output samples from an explicit phase (see SampleRateStream).
+    The phase is explicit instead of a prepared table, every backend uses the same integer formula, so the output does
+    not depend on the backend or the chunking. The positions are stepped a block at a time (positions_SampleRatePhase).
+*/
+void resample_span_s16x8_c(const int16_t *src, uint32_t nr_of_channels, SampleRatePhase *phase, int16_t *dst, uint32_t count) {
+    const uint32_t ch = nr_of_channels;
+    uint32_t pos_idx[TIMELINE_RESAMPLE_BLOCK];
+    uint32_t pos_frac[TIMELINE_RESAMPLE_BLOCK];
+    for (uint32_t done = 0; done < count; ) {
+        const uint32_t n = (count - done < TIMELINE_RESAMPLE_BLOCK) ? count - done : TIMELINE_RESAMPLE_BLOCK;
+        positions_SampleRatePhase(phase, n, pos_idx, pos_frac);
+        for (uint32_t k = 0; k < n; ++k) {
+            const int16_t *r0 = &src[(size_t)pos_idx[k] * ch];
+            const int16_t *r1 = r0 + ch;
+            const uint32_t frac = pos_frac[k];
+            if (k + TIMELINE_RESAMPLE_PREFETCH < n) prefetch_SampleRows(src, ch, pos_idx[k + TIMELINE_RESAMPLE_PREFETCH]);
+            int16_t *out = &dst[(size_t)(done + k) * ch];
+            for (uint32_t c = 0; c < ch; ++c) {
+                out[c] = interp_s16_q16(r0[c], r1[c], frac);
             }
+        }
+        done += n;
+    }
+}
 
-            min_vec = vminq_s8(min_vec, vals);
-            max_vec = vmaxq_s8(max_vec, vals);
+/*
+    Fused resampling and min/max: the interpolated samples are only folded into the column's min / max,
+    they are never stored (no intermediate buffer between convert and aggregate).
+    The positions are stepped by the caller for many columns at once. The channels run over the column in runs of
+    TIMELINE_RESAMPLE_MINMAX_LANES with their min / max in local rows, so the row loop can be vectorized.
+*/
+#define TIMELINE_RESAMPLE_MINMAX_LANES 64
+void resample_minmax_s16x8_c(const int16_t *src, uint32_t nr_of_channels, const uint32_t *pos_idx, const uint32_t *pos_frac, uint32_t count, int16_t *min, int16_t *max) {
+    const uint32_t ch = nr_of_channels;
+    for (uint32_t c0 = 0; c0 < ch; c0 += TIMELINE_RESAMPLE_MINMAX_LANES) {
+        const uint32_t w = (ch - c0 < TIMELINE_RESAMPLE_MINMAX_LANES) ? ch - c0 : TIMELINE_RESAMPLE_MINMAX_LANES;
+        int16_t vmin[TIMELINE_RESAMPLE_MINMAX_LANES];
+        int16_t vmax[TIMELINE_RESAMPLE_MINMAX_LANES];
+        for (uint32_t c = 0; c < w; ++c) {
+            vmin[c] = min[c0 + c];
+            vmax[c] = max[c0 + c];
+        }
+        for (uint32_t k = 0; k < count; ++k) {
+            // the first run of channels brings the rows in
+            if (c0 == 0 && k + TIMELINE_RESAMPLE_PREFETCH < count) prefetch_SampleRows(src, ch, pos_idx[k + TIMELINE_RESAMPLE_PREFETCH]);
+            const int16_t *r0 = &src[(size_t)pos_idx[k] * ch + c0];
+            const int16_t *r1 = r0 + ch;
+            const uint32_t frac = pos_frac[k];
+            for (uint32_t c = 0; c < w; ++c) {
+                int16_t v = interp_s16_q16(r0[c], r1[c], frac);
+                if (v < vmin[c]) vmin[c] = v;
+                if (v > vmax[c]) vmax[c] = v;
+            }
+        }
+        for (uint32_t c = 0; c < w; ++c) {
+            min[c0 + c] = vmin[c];
+            max[c0 + c] = vmax[c];
         }
+    }
+}
 
-        // Reduce vector to scalar min and max using temporary arrays
-        int8_t tmp_min[16], tmp_max[16];
-        vst1q_s8(tmp_min, min_vec);
-        vst1q_s8(tmp_max, max_vec);
+/*
+    Polyphase FIR, one output row per step. The taps walk the input rows, every channel has its own int32 sum
+    (the bank keeps the sum of |coefficients| below 4.0, so 16-bit samples cannot overflow it).
+*/
+void polyphase_span_s16x8_c(const int16_t *src, uint32_t nr_of_channels, const PolyphaseFilterBank *bank, SampleRatePhase *phase, int16_t *dst, uint32_t count) {
+    const uint32_t ch = nr_of_channels;
+    const uint32_t taps = bank->taps;
+    int32_t acc[TIMELINE_STREAM_MAX_CHANNELS];
+    uint32_t idx = phase->idx;
+    uint32_t accum = phase->accum;
+    for (uint32_t i = 0; i < count; ++i) {
+        const int16_t *coef = coeffs_PolyphaseFilterBank(bank, phase, accum);
+        const int16_t *row = &src[(size_t)idx * ch];
+        int16_t *out = &dst[(size_t)i * ch];
+        memset(acc, 0, ch * sizeof(int32_t));
+        for (uint32_t j = 0; j < taps; ++j, row += ch) {
+            for (uint32_t c = 0; c < ch; ++c) {
+                acc[c] += coef[j] * row[c];
+            }
+        }
+        for (uint32_t c = 0; c < ch; ++c) {
+            out[c] = round_fir_s16(acc[c]);
+        }
+        step_SampleRatePhase(phase, &idx, &accum);
+    }
+    phase->idx = idx;
+    phase->accum = accum;
+}
 
-        int8_t min_val = tmp_min[0], max_val = tmp_max[0];
-        for (int i_tmp = 1; i_tmp < 16; ++i_tmp) {
-            if (tmp_min[i_tmp] < min_val) min_val = tmp_min[i_tmp];
-            if (tmp_max[i_tmp] > max_val) max_val = tmp_max[i_tmp];
+/*
+    CIC pre-decimation, N = TIMELINE_POLYPHASE_CIC_STAGES integrators at the input rate and N combs at the output rate,
+    in wrapping 32-bit arithmetic: the comb result is exact as long as it fits, |row - row 0| * R^N < 2^31.
+    Row 0 is subtracted before the integrators, so the zero history stands for row 0 repeated before the buffer.
+    The impulse response is N * (R - 1) + 1 rows long, centred D = N * (R - 1) / 2 rows before the newest one, so the
+    combs run on the rows j * R + D: the grid starts at D % R and the first D / R results are dropped.
+*/
+void cic_predecimate_s16x8_c(const int16_t *src, uint32_t nr_of_channels, uint32_t nr_of_samples, uint32_t ratio_shift, int16_t *dst, uint32_t count) {
+    const uint32_t ch = nr_of_channels;
+    const uint32_t ratio = 1u << ratio_shift;
+    const uint32_t shift = TIMELINE_POLYPHASE_CIC_STAGES * ratio_shift;
+    const uint32_t delay = TIMELINE_POLYPHASE_CIC_STAGES * (ratio - 1) / 2;
+    const int32_t round = (shift > 0) ? 1 << (shift - 1) : 0;
+    uint32_t integ[TIMELINE_POLYPHASE_CIC_STAGES][TIMELINE_STREAM_MAX_CHANNELS];
+    uint32_t comb[TIMELINE_POLYPHASE_CIC_STAGES][TIMELINE_STREAM_MAX_CHANNELS];
+    memset(integ, 0, sizeof(integ));
+    memset(comb, 0, sizeof(comb));
+    uint32_t v = 0; // next input row into the integrators
+    for (int64_t j = -(int64_t)(delay / ratio); j < (int64_t)count; ++j) {
+        const uint64_t last = (uint64_t)(j * ratio + delay);
+        for (; v <= last; ++v) {
+            const int16_t *row = &src[(size_t)((v < nr_of_samples) ? v : nr_of_samples - 1) * ch];
+            for (uint32_t c = 0; c < ch; ++c) {
+                integ[0][c] += (uint32_t)(row[c] - src[c]);
+            }
+            for (uint32_t s = 1; s < TIMELINE_POLYPHASE_CIC_STAGES; ++s) {
+                for (uint32_t c = 0; c < ch; ++c) {
+                    integ[s][c] += integ[s - 1][c];
+                }
+            }
         }
+        for (uint32_t c = 0; c < ch; ++c) {
+            uint32_t y = integ[TIMELINE_POLYPHASE_CIC_STAGES - 1][c];
+            for (uint32_t s = 0; s < TIMELINE_POLYPHASE_CIC_STAGES; ++s) {
+                uint32_t d = y - comb[s][c];
+                comb[s][c] = y;
+                y = d;
+            }
+            if (j >= 0) {
+                int32_t out = src[c] + (((int32_t)y + round) >> shift);
+                dst[(size_t)j * ch + c] = (int16_t)((out > INT16_MAX) ? INT16_MAX : ((out < INT16_MIN) ? INT16_MIN : out));
+            }
+        }
+    }
+}
 
-        ((int8_t*)outMin->valueBuffer)[i * input->nr_of_channels + ch] = min_val;
-        ((int8_t*)outMax->valueBuffer)[i * input->nr_of_channels + ch] = max_val;
+/*
+    PAYLOAD DECODING
+    The capture hardware sends N channels per packet, each channel as a big-endian 24-bit two's complement value.
+    Channel c goes to block c / 8, lane c % 8. The lanes of the last block beyond nr_of_channels are set to 0.
+    s16x8: the upper 16 bits of the value (val >> 8), s24x8: the full value, packed little-endian.
+*/
+int decode_be24_s16x8_c(const uint8_t *payload, uint32_t nr_of_channels, uint8_t *dst, uint32_t dst_stride) {
+    uint32_t nr_of_blocks = (nr_of_channels + 7) / 8;
+    for (uint32_t b = 0; b < nr_of_blocks; ++b) {
+        int16_t *out = (int16_t*)&dst[b * dst_stride];
+        for (uint32_t lane = 0; lane < 8; ++lane) {
+            uint32_t ch = b * 8 + lane;
+            if (ch < nr_of_channels) {
+                const uint8_t *p = &payload[ch * 3];
+                out[lane] = (int16_t)((p[0] << 8) | p[1]);
+            } else {
+                out[lane] = 0;
+            }
+        }
     }
     return 0;
 }
-#endif
-
-int aggregate_minmax_s8_c(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t i, uint32_t start, uint32_t end) {
-    for (uint8_t ch = 0; ch < input->nr_of_channels; ++ch) {
-        int8_t min_val = INT8_MAX;
-        int8_t max_val = INT8_MIN;
 
-        for (uint32_t j = start; j < end; ++j) {
-            int8_t value;
-            if (getSampleValue_int8(input, j, ch, &value) == 0) {
-                if (value < min_val) min_val = value;
-                if (value > max_val) max_val = value;
+int decode_be24_s24x8_c(const uint8_t *payload, uint32_t nr_of_channels, uint8_t *dst, uint32_t dst_stride) {
+    uint32_t nr_of_blocks = (nr_of_channels + 7) / 8;
+    for (uint32_t b = 0; b < nr_of_blocks; ++b) {
+        uint8_t *out = &dst[b * dst_stride];
+        for (uint32_t lane = 0; lane < 8; ++lane) {
+            uint32_t ch = b * 8 + lane;
+            if (ch < nr_of_channels) {
+                const uint8_t *p = &payload[ch * 3];
+                out[lane * 3 + 0] = p[2];
+                out[lane * 3 + 1] = p[1];
+                out[lane * 3 + 2] = p[0];
             } else {
-                fprintf(stderr, "Error accessing sample %u, channel %u\n", j, ch);
-                return -1; // Error accessing sample
+                out[lane * 3 + 0] = 0;
+                out[lane * 3 + 1] = 0;
+                out[lane * 3 + 2] = 0;
             }
         }
-        ((int8_t*)outMin->valueBuffer)[i * input->nr_of_channels + ch] = min_val;
-        ((int8_t*)outMax->valueBuffer)[i * input->nr_of_channels + ch] = max_val;
     }
     return 0;
 }
 
 /*
-    Bresenham-style fixed-point sample rate conversion for 8-channel 16-bit signed integer audio.
-    This function avoids division in the loop, using an accumulator and step size (like Bresenham's algorithm).
-    It performs linear interpolation between nearest samples.
+    BLOCK CODEC
+    Reference kernels of the delta + zigzag + frame of reference codec, the layout is described at
+    TimelineCodecGroupHeader. The lanes are read and written with the s16x8 / s24x8 sample layout of the buffers.
 */
-// NEON-optimized Bresenham sample rate conversion for 8x int16
-#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(NEON_ENABLED)
-int convert_sample_rate_SIMD_s16x8_bresenham_neon(const RawTimelineValuesBuf* input, RawTimelineValuesBuf* output)
-{
-    int16_t *src = (int16_t*)input->valueBuffer;
-    int16_t *dst = (int16_t*)output->valueBuffer;
-    uint32_t ch = input->nr_of_channels;
-    if (ch != 8) return -1;
+static inline int32_t codec_load_lane(const uint8_t *row, uint32_t lane, int is_s24) {
+    if (is_s24) {
+        const uint8_t *p = &row[lane * 3];
+        return (int32_t)((uint32_t)p[0] << 8 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 24) >> 8;
+    }
+    int16_t v;
+    memcpy(&v, &row[lane * 2], sizeof(v));
+    return v;
+}
 
-    uint32_t in_samples = input->nr_of_samples;
-    uint32_t out_samples = output->nr_of_samples;
-
-    // Bresenham/fixed-point accumulators
-    uint32_t accum = 0;
-    uint32_t step = in_samples;
-    uint32_t scale = out_samples;
-    uint32_t idx0 = 0;
-
-    for (uint32_t i = 0; i < out_samples; ++i) {
-        uint32_t idx1 = (idx0 + 1 < in_samples) ? idx0 + 1 : idx0;
-        // Compute frac in Q16
-        uint32_t frac_fixed = ((uint64_t)accum << 16) / scale;
-        uint32_t inv_frac_fixed = 0x10000 - frac_fixed;
-
-        // Load 8 channels for idx0 and idx1
-        int16x8_t v0 = vld1q_s16(&src[idx0 * ch]);
-        int16x8_t v1 = vld1q_s16(&src[idx1 * ch]);
-        // Widen to 32-bit
-        int32x4_t v0_lo = vmovl_s16(vget_low_s16(v0));
-        int32x4_t v0_hi = vmovl_s16(vget_high_s16(v0));
-        int32x4_t v1_lo = vmovl_s16(vget_low_s16(v1));
-        int32x4_t v1_hi = vmovl_s16(vget_high_s16(v1));
-
-        // Interpolate: (v0 * inv_frac + v1 * frac) >> 16
-        int32x4_t interp_lo = vmlaq_n_s32(vmulq_n_s32(v0_lo, inv_frac_fixed), v1_lo, frac_fixed);
-        int32x4_t interp_hi = vmlaq_n_s32(vmulq_n_s32(v0_hi, inv_frac_fixed), v1_hi, frac_fixed);
-        interp_lo = vrshrq_n_s32(interp_lo, 16);
-        interp_hi = vrshrq_n_s32(interp_hi, 16);
-        int16x8_t result = vcombine_s16(vmovn_s32(interp_lo), vmovn_s32(interp_hi));
-        vst1q_s16(&dst[i * ch], result);
-
-        accum += step;
-        if (accum >= scale) {
-            idx0++;
-            accum -= scale;
+static inline void codec_store_lane(uint8_t *row, uint32_t lane, int32_t v, int is_s24) {
+    if (is_s24) {
+        uint8_t *p = &row[lane * 3];
+        p[0] = (uint8_t)v;
+        p[1] = (uint8_t)(v >> 8);
+        p[2] = (uint8_t)(v >> 16);
+    } else {
+        int16_t s = (int16_t)v;
+        memcpy(&row[lane * 2], &s, sizeof(s));
+    }
+}
+
+static uint32_t codec_encode_c(const uint8_t *src, uint32_t src_stride, uint32_t nr_lanes, uint32_t count, uint8_t *dst, int is_s24) {
+    TimelineCodecGroupHeader h;
+    uint32_t zz[TIMELINE_CODEC_BLOCK][8];
+    uint32_t zmin[8], zmax[8];
+    for (uint32_t l = 0; l < 8; ++l) {
+        int32_t prev = (l < nr_lanes) ? codec_load_lane(src, l, is_s24) : 0;
+        h.first[l] = h.min[l] = h.max[l] = prev;
+        zmin[l] = UINT32_MAX;
+        zmax[l] = 0;
+        for (uint32_t j = 0; j + 1 < count; ++j) {
+            int32_t v = (l < nr_lanes) ? codec_load_lane(&src[(size_t)(j + 1) * src_stride], l, is_s24) : 0;
+            zz[j][l] = zigzag_encode_s32(v - prev);
+            prev = v;
+            if (v < h.min[l]) h.min[l] = v;
+            if (v > h.max[l]) h.max[l] = v;
+            if (zz[j][l] < zmin[l]) zmin[l] = zz[j][l];
+            if (zz[j][l] > zmax[l]) zmax[l] = zz[j][l];
         }
-        if (idx0 >= in_samples - 1) {
-            idx0 = in_samples - 2;
-            accum = 0;
+        for (uint32_t j = (count > 1) ? count - 1 : 0; j < TIMELINE_CODEC_BLOCK; ++j) {
+            zz[j][l] = (count > 1) ? zz[count - 2][l] : 0;
         }
+        if (count < 2) zmin[l] = 0;
     }
-    return 0;
+    uint32_t range = 0;
+    for (uint32_t l = 0; l < 8; ++l) {
+        h.base[l] = zmin[l];
+        range |= zmax[l] - zmin[l];
+    }
+    h.width = bit_width_u32(range);
+    memcpy(dst, &h, sizeof(h));
+    uint32_t *words = (uint32_t*)(dst + sizeof(h));
+    memset(words, 0, (size_t)TIMELINE_CODEC_BLOCK * h.width);
+    for (uint32_t j = 0; h.width > 0 && j < TIMELINE_CODEC_BLOCK; ++j) {
+        const uint32_t pos = j * h.width;
+        const uint32_t w = pos >> 5, shift = pos & 31;
+        for (uint32_t l = 0; l < 8; ++l) {
+            uint32_t v = zz[j][l] - h.base[l];
+            words[w * 8 + l] |= v << shift;
+            if (shift + h.width > 32) words[(w + 1) * 8 + l] |= v >> (32 - shift);
+        }
+    }
+    return TIMELINE_CODEC_GROUP_BYTES(h.width);
 }
-#endif
 
-#if (defined(__AVX2__) || defined(__AVX__)) && defined(AVX_ENABLED)
-int convert_sample_rate_SIMD_s16x8_bresenham_avx(const RawTimelineValuesBuf* input, RawTimelineValuesBuf* output)
-{
-    int16_t *src = (int16_t*)input->valueBuffer;
-    int16_t *dst = (int16_t*)output->valueBuffer;
-    uint32_t ch = input->nr_of_channels;
-    if (ch != 8) return -1;
+static uint32_t codec_decode_c(const uint8_t *src, uint32_t nr_lanes, uint32_t count, uint8_t *dst, uint32_t dst_stride, int is_s24) {
+    TimelineCodecGroupHeader h;
+    memcpy(&h, src, sizeof(h));
+    const uint32_t *words = (const uint32_t*)(src + sizeof(h));
+    const uint32_t mask = (h.width >= 32) ? UINT32_MAX : ((1u << h.width) - 1);
+    int32_t acc[8];
+    memcpy(acc, h.first, sizeof(acc));
+    for (uint32_t j = 0; j < count; ++j) {
+        uint8_t *row = &dst[(size_t)j * dst_stride];
+        const uint32_t pos = j * h.width;
+        const uint32_t w = pos >> 5, shift = pos & 31;
+        for (uint32_t l = 0; l < nr_lanes; ++l) {
+            codec_store_lane(row, l, acc[l], is_s24);
+            if (h.width > 0) {
+                uint32_t v = words[w * 8 + l] >> shift;
+                if (shift + h.width > 32) v |= words[(w + 1) * 8 + l] << (32 - shift);
+                acc[l] += zigzag_decode_u32((v & mask) + h.base[l]);
+            } else {
+                acc[l] += zigzag_decode_u32(h.base[l]);
+            }
+        }
+    }
+    return TIMELINE_CODEC_GROUP_BYTES(h.width);
+}
 
-    uint32_t in_samples = input->nr_of_samples;
-    uint32_t out_samples = output->nr_of_samples;
+uint32_t codec_encode_s16x8_c(const uint8_t *src, uint32_t src_stride, uint32_t nr_lanes, uint32_t count, uint8_t *dst) {
+    return codec_encode_c(src, src_stride, nr_lanes, count, dst, 0);
+}
 
-    uint32_t accum = 0;
-    uint32_t step = in_samples;
-    uint32_t scale = out_samples;
-    uint32_t idx0 = 0;
+uint32_t codec_encode_s24x8_c(const uint8_t *src, uint32_t src_stride, uint32_t nr_lanes, uint32_t count, uint8_t *dst) {
+    return codec_encode_c(src, src_stride, nr_lanes, count, dst, 1);
+}
 
-    for (uint32_t i = 0; i < out_samples; ++i) {
-        uint32_t idx1 = (idx0 + 1 < in_samples) ? idx0 + 1 : idx0;
+uint32_t codec_decode_s16x8_c(const uint8_t *src, uint32_t nr_lanes, uint32_t count, uint8_t *dst, uint32_t dst_stride) {
+    return codec_decode_c(src, nr_lanes, count, dst, dst_stride, 0);
+}
 
-        uint32_t frac_fixed = ((uint64_t)accum << 16) / scale;
-        uint32_t inv_frac_fixed = 0x10000 - frac_fixed;
+uint32_t codec_decode_s24x8_c(const uint8_t *src, uint32_t nr_lanes, uint32_t count, uint8_t *dst, uint32_t dst_stride) {
+    return codec_decode_c(src, nr_lanes, count, dst, dst_stride, 1);
+}
 
-        // Load 8 int16 samples from idx0 and idx1
-        __m128i v0_s16 = _mm_loadu_si128((__m128i*)&src[idx0 * ch]);
-        __m128i v1_s16 = _mm_loadu_si128((__m128i*)&src[idx1 * ch]);
+/*
+    PLANAR TRANSPOSES
+    Reference kernels: one value copied at a time, sample by sample, so the source rows (to_planar) or the planes
+    (from_planar) are read sequentially and each of the <= 8 destination streams is written sequentially.
+*/
+static inline void transpose_lanes_c(const uint8_t *src, uint32_t src_sample, uint32_t src_lane,
+    uint8_t *dst, uint32_t dst_sample, uint32_t dst_lane, uint32_t nr_lanes, uint32_t count, uint32_t lane_bytes) {
+    for (uint32_t i = 0; i < count; ++i) {
+        for (uint32_t l = 0; l < nr_lanes; ++l) {
+            memcpy(&dst[(size_t)i * dst_sample + (size_t)l * dst_lane], &src[(size_t)i * src_sample + (size_t)l * src_lane], lane_bytes);
+        }
+    }
+}
 
-        // Extend to int32: low + high
-        __m256i v0_s32 = _mm256_cvtepi16_epi32(v0_s16);
-        __m256i v1_s32 = _mm256_cvtepi16_epi32(v1_s16);
+void transpose_to_planar_s16x8_c(const uint8_t *src, uint32_t src_stride, uint8_t *dst, uint32_t dst_stride, uint32_t nr_lanes, uint32_t count) {
+    transpose_lanes_c(src, src_stride, 2, dst, 2, dst_stride, nr_lanes, count, 2);
+}
 
-        // Multiply each with fixed-point factors
-        __m256i v0_scaled = _mm256_mullo_epi32(v0_s32, _mm256_set1_epi32(inv_frac_fixed));
-        __m256i v1_scaled = _mm256_mullo_epi32(v1_s32, _mm256_set1_epi32(frac_fixed));
+void transpose_to_planar_s24x8_c(const uint8_t *src, uint32_t src_stride, uint8_t *dst, uint32_t dst_stride, uint32_t nr_lanes, uint32_t count) {
+    transpose_lanes_c(src, src_stride, 3, dst, 3, dst_stride, nr_lanes, count, 3);
+}
 
-        __m256i interp = _mm256_add_epi32(v0_scaled, v1_scaled);
-        __m256i rounded = _mm256_add_epi32(interp, _mm256_set1_epi32(1 << 15));
-        __m256i shifted = _mm256_srli_epi32(rounded, 16);
+void transpose_from_planar_s16x8_c(const uint8_t *src, uint32_t src_stride, uint8_t *dst, uint32_t dst_stride, uint32_t nr_lanes, uint32_t count) {
+    transpose_lanes_c(src, 2, src_stride, dst, dst_stride, 2, nr_lanes, count, 2);
+}
 
-        // Narrow back to int16
-        __m128i result = _mm256_castsi256_si128(_mm256_packs_epi32(shifted, _mm256_setzero_si256()));
+void transpose_from_planar_s24x8_c(const uint8_t *src, uint32_t src_stride, uint8_t *dst, uint32_t dst_stride, uint32_t nr_lanes, uint32_t count) {
+    transpose_lanes_c(src, 3, src_stride, dst, dst_stride, 3, nr_lanes, count, 3);
+}
 
-        // Store
-        _mm_storeu_si128((__m128i*)&dst[i * ch], result);
+// ---- C Backend Global Instance, always available and always the first one in the registry ----
+const TimelineBackendFunctions gTimelineBackendFunctionsC = {
+    .name = "C Backend",
+    .convert_sample_rate_s16x8 = convert_sample_rate_SIMD_s16x8_bresenham, //convert_sample_rate_SIMD_s16x8_c,
+    .aggregate_minmax_s8 = aggregate_minmax_s8_c,
+    .aggregate_minmax_s16x8 = aggregate_minmax_SIMD_s16x8_c,
+    .aggregate_minmax_s24x8 = aggregate_minmax_SIMD_s24x8_c,
+    .decode_be24_s16x8 = decode_be24_s16x8_c,
+    .decode_be24_s24x8 = decode_be24_s24x8_c,
+    .resample_span_s16x8 = resample_span_s16x8_c,
+    .polyphase_span_s16x8 = polyphase_span_s16x8_c,
+    .cic_predecimate_s16x8 = cic_predecimate_s16x8_c,
+    .resample_minmax_s16x8 = resample_minmax_s16x8_c,
+    .aggregate_stats_s8 = aggregate_stats_s8_c,
+    .aggregate_stats_s16x8 = aggregate_stats_s16x8_c,
+    .aggregate_stats_s24x8 = aggregate_stats_s24x8_c,
+    .codec_encode_s16x8 = codec_encode_s16x8_c,
+    .codec_encode_s24x8 = codec_encode_s24x8_c,
+    .codec_decode_s16x8 = codec_decode_s16x8_c,
+    .codec_decode_s24x8 = codec_decode_s24x8_c,
+    .transpose_to_planar_s16x8 = transpose_to_planar_s16x8_c,
+    .transpose_to_planar_s24x8 = transpose_to_planar_s24x8_c,
+    .transpose_from_planar_s16x8 = transpose_from_planar_s16x8_c,
+    .transpose_from_planar_s24x8 = transpose_from_planar_s24x8_c,
+};
 
-        // Bresenham increment
-        accum += step;
-        if (accum >= scale) {
-            idx0++;
-            accum -= scale;
-        }
-        if (idx0 >= in_samples - 1) {
-            idx0 = in_samples - 2;
-            accum = 0;
-        }
-    }
-    return 0;
+/*
+    Runtime CPU feature detection.
+    x86: cpuid leaf 1/7, and xgetbv to check that the OS saves the wider registers on context switch.
+    ARM: AArch64 always has NEON (ASIMD), on 32-bit ARM Linux the kernel hwcaps are checked.
+*/
+#if defined(AVX_ENABLED)
+static uint64_t read_xcr0(void) {
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((uint64_t)edx << 32) | eax;
 }
 #endif
 
-// C version as fallback and dispatcher
-static int convert_sample_rate_SIMD_s16x8_bresenham(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *output)
-{
-    int16_t *src = (int16_t*)input->valueBuffer;
-    int16_t *dst = (int16_t*)output->valueBuffer;
-    uint32_t ch = input->nr_of_channels;
-    if (ch != 8) return -1;
+static uint32_t detect_CpuFeatures(void) {
+    uint32_t features = 0;
+#if defined(AVX_ENABLED)
+    uint32_t eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return 0;
+    const uint32_t osxsave_avx = bit_OSXSAVE | bit_AVX;
+    if ((ecx & osxsave_avx) != osxsave_avx) return 0;
+    uint64_t xcr0 = read_xcr0();
+    if ((xcr0 & 0x6) != 0x6) return 0; // XMM and YMM state
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return 0;
+    if (ebx & bit_AVX2) features |= TIMELINE_CPU_AVX2;
+    const uint32_t avx512 = bit_AVX512F | bit_AVX512BW;
+    if ((ebx & avx512) == avx512 && (xcr0 & 0xE0) == 0xE0) features |= TIMELINE_CPU_AVX512; // opmask and ZMM state
+#elif defined(NEON_ENABLED)
+  #if defined(__aarch64__) || defined(__APPLE__)
+    features |= TIMELINE_CPU_NEON;
+  #elif defined(__linux__) && defined(HWCAP_NEON)
+    if (getauxval(AT_HWCAP) & HWCAP_NEON) features |= TIMELINE_CPU_NEON;
+  #elif defined(__linux__) && defined(HWCAP_ARM_NEON)
+    if (getauxval(AT_HWCAP) & HWCAP_ARM_NEON) features |= TIMELINE_CPU_NEON;
+  #else
+    features |= TIMELINE_CPU_NEON; // compiled with NEON enabled, so the target requires it anyway
+  #endif
+#endif
+    return features;
+}
 
-    uint32_t in_samples = input->nr_of_samples;
-    uint32_t out_samples = output->nr_of_samples;
-
-    // Fixed-point step: numerator = in_samples, denominator = out_samples
-    uint32_t accum = 0;
-    uint32_t step = in_samples;
-    uint32_t scale = out_samples;
-    uint32_t idx0 = 0;
-
-    for (uint32_t i = 0; i < out_samples; ++i) {
-        uint32_t idx1 = (idx0 + 1 < in_samples) ? idx0 + 1 : idx0;
-        // frac in [0, 1): how far between idx0 and idx1
-        double frac = (double)accum / (double)scale;
-        for (uint8_t j = 0; j < ch; ++j) {
-            int16_t v0 = src[idx0 * ch + j];
-            int16_t v1 = src[idx1 * ch + j];
-            double interp = (1.0 - frac) * v0 + frac * v1;
-            dst[i * ch + j] = (int16_t)(round(interp));
-        }
-        accum += step;
-        if (accum >= scale) {
-            idx0++;
-            accum -= scale;
-        }
-        // Clamp idx0 to avoid reading out of bounds
-        if (idx0 >= in_samples - 1) {
-            idx0 = in_samples - 2;
-            accum = 0;
-        }
+uint32_t getCpuFeatures(void) {
+    static uint32_t features = 0;
+    static int detected = 0;
+    if (!detected) {
+        features = detect_CpuFeatures();
+        detected = 1;
     }
-    return 0;
+    return features;
 }
 
 /*
-    This file implements the backend functions for the TimelineDB using SIMD technology.
-    It provides functions for sample rate conversion and aggregation of min/max values.
-    The implementation is designed to be flexible, allowing for different SIMD backends (e.g., NEON, AVX2).
+    Fills the backend registry with the tables usable on this CPU.
+    Index 0 is always the C backend, the rest is ordered from the fastest to the slowest,
+    so index 1 (the historical "SIMD backend" index) is the best available one.
+    Returns the number of registered backends.
 */
-// ---- SIMD Backend Global Config Instance for the virtual funtion table ----
-const TimelineBackendFunctions gTimelineBackendFunctionsSIMD = {
-#if (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(NEON_ENABLED)
-    .name = "Neon SIMD Backend",
-    .convert_sample_rate_s16x8 = convert_sample_rate_SIMD_s16x8_bresenham_neon, // Use dispatcher
-    .aggregate_minmax_s8 = aggregate_minmax_s8_neon,
-    .aggregate_minmax_s16x8 = aggregate_minmax_SIMD_s16x8_neon,
-    .aggregate_minmax_s24x8 = aggregate_minmax_SIMD_s24x8_c,
-#elif defined(__AVX2__) || defined(__AVX__)
-    .name = "Intel AVX2 SIMD Backend",
-    .convert_sample_rate_s16x8 = convert_sample_rate_SIMD_s16x8_bresenham_avx,//convert_sample_rate_SIMD_s16x8_avx, // AVX2 fallback
-    .aggregate_minmax_s8 = aggregate_minmax_s8_c, // AVX2 fallback
-    .aggregate_minmax_s16x8 = aggregate_minmax_SIMD_s16x8_avx, // AVX2 fallback
-    .aggregate_minmax_s24x8 = aggregate_minmax_SIMD_s24x8_c,
-#else   //fallback to C version implemented version of SIMD technology is not available or disabled
-    .name = "Fallback C Backend",
-    .convert_sample_rate_s16x8 = convert_sample_rate_SIMD_s16x8_bresenham,
-    .aggregate_minmax_s8 = aggregate_minmax_s8_c,
-    .aggregate_minmax_s16x8 = aggregate_minmax_SIMD_s16x8_c,
-    .aggregate_minmax_s24x8 = aggregate_minmax_SIMD_s24x8_c,
+uint8_t init_TimelineBackendRegistry(const TimelineBackendFunctions **registry, uint8_t max_count) {
+    uint8_t count = 0;
+    if (!registry || max_count == 0) return 0;
+    uint32_t features = getCpuFeatures();
+    (void)features;
+    registry[count++] = &gTimelineBackendFunctionsC;
+#if defined(AVX_ENABLED)
+    if ((features & TIMELINE_CPU_AVX512) && count < max_count) registry[count++] = &gTimelineBackendFunctionsAVX512;
+    if ((features & TIMELINE_CPU_AVX2) && count < max_count) registry[count++] = &gTimelineBackendFunctionsAVX2;
 #endif
-};
-
-// ---- SIMD Backend Global Instance for the c version of the funcions ----
-const TimelineBackendFunctions gTimelineBackendFunctionsC = {
-    .name = "C Backend",
-    .convert_sample_rate_s16x8 = convert_sample_rate_SIMD_s16x8_bresenham, //convert_sample_rate_SIMD_s16x8_c,
-    .aggregate_minmax_s8 = aggregate_minmax_s8_c,
-    .aggregate_minmax_s16x8 = aggregate_minmax_SIMD_s16x8_c,
-    .aggregate_minmax_s24x8 = aggregate_minmax_SIMD_s24x8_c,
-};
+#if defined(NEON_ENABLED)
+    if ((features & TIMELINE_CPU_NEON) && count < max_count) registry[count++] = &gTimelineBackendFunctionsNEON;
+#endif
+    return count;
+}
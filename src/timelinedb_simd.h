@@ -10,14 +10,98 @@
 #include <stdint.h>
 #include "timelinedb.h"
 
+/*
+ The ISA variants live in their own translation units (timelinedb_simd_avx2.c, timelinedb_simd_avx512.c, timelinedb_simd_neon.c).
+ AVX_ENABLED means the x86 variants are compiled in via target attributes, independently of the -m flags of the build,
+ they are used only when the CPU reports the feature at runtime.
+*/
 #if defined(__ARM_NEON) || defined(__ARM_NEON__)
     #define NEON_ENABLED
-#elif defined(__AVX2__) || defined(__AVX__)
+#elif (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
     #define AVX_ENABLED
+    #define TIMELINE_TARGET(isa) __attribute__((target(isa)))
 #endif
 
-typedef int (*fn_convert)(const RawTimelineValuesBuf *, RawTimelineValuesBuf *);
+// CPU feature bits reported by getCpuFeatures()
+#define TIMELINE_CPU_AVX2   0x01
+#define TIMELINE_CPU_NEON   0x02
+#define TIMELINE_CPU_AVX512 0x04    // AVX512F + AVX512BW
+
+#define TIMELINE_MAX_BACKENDS 8
+
+// Converts the outputs [first, first + count) of a prepared output (prepare_SampleRateConversion), any range gives the
+// same values as the whole conversion
+typedef int (*fn_convert)(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *output, uint32_t first, uint32_t count);
 typedef int (*fn_aggregate_minmax)(const RawTimelineValuesBuf *, RawTimelineValuesBuf *, RawTimelineValuesBuf *, uint32_t, uint32_t, uint32_t);
+/*
+ Exact statistics of one channel over a range of samples, the result of the aggregate_stats kernels.
+ min / max are in the scale of the input (24-bit values are not downscaled). sum_sq is 128-bit (sum_sq_hi:sum_sq),
+ 24-bit squares (2^46) would overflow 64 bits after 2^18 samples.
+*/
+typedef struct {
+    int64_t  sum;
+    uint64_t sum_sq;
+    uint64_t sum_sq_hi;
+    int32_t  min;
+    int32_t  max;
+} TimelineChannelSums;
+// sums[c] for every channel of [start, end), overwritten (not accumulated)
+typedef int (*fn_aggregate_stats)(const RawTimelineValuesBuf *input, uint32_t start, uint32_t end, TimelineChannelSums *sums);
+// The SIMD kernels keep narrow (int32 / 64-bit square) accumulators for at most this many rows before flushing them
+#define TIMELINE_STATS_BLOCK 32768
+
+// payload of big-endian 24-bit channels -> 8-channel blocks, block b is written at dst + b * dst_stride
+typedef int (*fn_decode_be24)(const uint8_t *payload, uint32_t nr_of_channels, uint8_t *dst, uint32_t dst_stride);
+
+/*
+ Resampling position of the streaming converter: the next output interpolates input rows idx and idx + 1
+ at frac = accum / scale, then the position advances by step_int + step_rem / scale input samples.
+*/
+typedef struct {
+    uint32_t idx;
+    uint32_t accum;
+    uint32_t step_int;
+    uint32_t step_rem;
+    uint32_t scale;
+} SampleRatePhase;
+// 'count' interleaved int16 outputs from the rows of src, starting at (and updating) the phase. Rows idx + 1 must exist.
+typedef void (*fn_resample_span)(const int16_t *src, uint32_t nr_of_channels, SampleRatePhase *phase, int16_t *dst, uint32_t count);
+// Folds 'count' outputs interpolated at rows pos_idx[k], pos_idx[k] + 1 with the Q16 weights pos_frac[k] (positions_SampleRatePhase,
+// same rounding as fn_resample_span) into the min / max rows.
+typedef void (*fn_resample_minmax)(const int16_t *src, uint32_t nr_of_channels, const uint32_t *pos_idx, const uint32_t *pos_frac, uint32_t count, int16_t *min, int16_t *max);
+// Outputs whose positions the resampling kernels step at a time (positions_SampleRatePhase)
+#define TIMELINE_RESAMPLE_BLOCK 256
+// 'count' polyphase FIR outputs: the sum of the phase's taps * rows idx .. idx + taps - 1, the phase is advanced like above.
+typedef void (*fn_polyphase_span)(const int16_t *src, uint32_t nr_of_channels, const PolyphaseFilterBank *bank, SampleRatePhase *phase, int16_t *dst, uint32_t count);
+// Pre-decimation of the polyphase resampler: 'count' rows, row j is the CIC (TIMELINE_POLYPHASE_CIC_STAGES moving sums
+// of 1 << ratio_shift rows) centred on input row j << ratio_shift, rows outside [0, nr_of_samples) repeat the edge rows.
+typedef void (*fn_cic_predecimate)(const int16_t *src, uint32_t nr_of_channels, uint32_t nr_of_samples, uint32_t ratio_shift, int16_t *dst, uint32_t count);
+
+/*
+ Block codec (timelinedb_codec.c): one encoded block is TIMELINE_CODEC_BLOCK rows of an 8-channel group, a header and
+ 4 * width 8-lane vectors of packed slots. Slot j of a lane is the zigzag delta row[j + 1] - row[j] minus the lane's
+ frame of reference 'base'; slots from count - 1 on repeat slot count - 2 (the decoder never uses them, repeating
+ keeps the frame tight). Packing is vertical: bit (j * width + k) of a lane goes to bit (j * width + k) % 32 of the
+ lane's word (j * width + k) / 32, and word w of the 8 lanes is one 32-byte vector, so unpacking slot j is the same
+ shift and mask on all lanes, and the delta decoding is a running sum down the rows (no horizontal step).
+ The width is common to the group (the widest lane), first / min / max are the raw values of each lane.
+*/
+typedef struct {
+    int32_t  first[8];  // row 0
+    int32_t  min[8];    // of rows [0, count)
+    int32_t  max[8];
+    uint32_t base[8];   // frame of reference of the zigzag deltas
+    uint32_t width;     // bits per packed slot, 0..32
+} TimelineCodecGroupHeader;   // followed by TIMELINE_CODEC_BLOCK / 4 * width uint32 words
+#define TIMELINE_CODEC_GROUP_BYTES(width) ((uint32_t)sizeof(TimelineCodecGroupHeader) + TIMELINE_CODEC_BLOCK * (width))
+// Encodes rows [0, count) (count <= TIMELINE_CODEC_BLOCK) of the nr_lanes (<= 8) channels at src, the missing lanes as 0.
+// dst must be 4-byte aligned, returns the bytes written.
+typedef uint32_t (*fn_codec_encode)(const uint8_t *src, uint32_t src_stride, uint32_t nr_lanes, uint32_t count, uint8_t *dst);
+// Decodes rows [0, count) of an encoded group block, writes nr_lanes channels per row, returns the bytes consumed.
+typedef uint32_t (*fn_codec_decode)(const uint8_t *src, uint32_t nr_lanes, uint32_t count, uint8_t *dst, uint32_t dst_stride);
+// Planar transposes of count samples x nr_lanes (<= 8) channels. to_planar: src rows (src_stride bytes apart) to
+// dst planes (dst_stride bytes apart), from_planar: src planes to dst rows.
+typedef void (*fn_transpose)(const uint8_t *src, uint32_t src_stride, uint8_t *dst, uint32_t dst_stride, uint32_t nr_lanes, uint32_t count);
 
 typedef struct TimelineBackendFunctions {
     const char *name;
@@ -25,13 +109,254 @@ typedef struct TimelineBackendFunctions {
     fn_aggregate_minmax aggregate_minmax_s8;
     fn_aggregate_minmax aggregate_minmax_s16x8;
     fn_aggregate_minmax aggregate_minmax_s24x8;
+    fn_decode_be24      decode_be24_s16x8;
+    fn_decode_be24      decode_be24_s24x8;
+    fn_resample_span    resample_span_s16x8;
+    fn_polyphase_span   polyphase_span_s16x8;
+    fn_cic_predecimate  cic_predecimate_s16x8;
+    fn_resample_minmax  resample_minmax_s16x8;
+    fn_aggregate_stats  aggregate_stats_s8;
+    fn_aggregate_stats  aggregate_stats_s16x8;
+    fn_aggregate_stats  aggregate_stats_s24x8;
+    fn_codec_encode     codec_encode_s16x8;
+    fn_codec_encode     codec_encode_s24x8;
+    fn_codec_decode     codec_decode_s16x8;
+    fn_codec_decode     codec_decode_s24x8;
+    fn_transpose        transpose_to_planar_s16x8;
+    fn_transpose        transpose_to_planar_s24x8;
+    fn_transpose        transpose_from_planar_s16x8;
+    fn_transpose        transpose_from_planar_s24x8;
 } TimelineBackendFunctions;
 
 //Backend templates
-extern const TimelineBackendFunctions gTimelineBackendFunctionsSIMD;
 extern const TimelineBackendFunctions gTimelineBackendFunctionsC;
+#if defined(AVX_ENABLED)
+extern const TimelineBackendFunctions gTimelineBackendFunctionsAVX2;
+extern const TimelineBackendFunctions gTimelineBackendFunctionsAVX512;
+#endif
+#if defined(NEON_ENABLED)
+extern const TimelineBackendFunctions gTimelineBackendFunctionsNEON;
+#endif
 
-int init_InterpInfo(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *output) ;
+uint32_t getCpuFeatures(void);
+uint8_t init_TimelineBackendRegistry(const TimelineBackendFunctions **registry, uint8_t max_count);
+
+// Portable kernels, shared by the ISA variants as fallback
+int aggregate_minmax_s8_c(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t i, uint32_t start, uint32_t end);
+int aggregate_minmax_SIMD_s16x8_c(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t i, uint32_t start, uint32_t end);
+int aggregate_minmax_SIMD_s24x8_c(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t i, uint32_t start, uint32_t end);
+int aggregate_stats_s8_c(const RawTimelineValuesBuf *input, uint32_t start, uint32_t end, TimelineChannelSums *sums);
+int aggregate_stats_s16x8_c(const RawTimelineValuesBuf *input, uint32_t start, uint32_t end, TimelineChannelSums *sums);
+int aggregate_stats_s24x8_c(const RawTimelineValuesBuf *input, uint32_t start, uint32_t end, TimelineChannelSums *sums);
+int decode_be24_s16x8_c(const uint8_t *payload, uint32_t nr_of_channels, uint8_t *dst, uint32_t dst_stride);
+int decode_be24_s24x8_c(const uint8_t *payload, uint32_t nr_of_channels, uint8_t *dst, uint32_t dst_stride);
+void resample_span_s16x8_c(const int16_t *src, uint32_t nr_of_channels, SampleRatePhase *phase, int16_t *dst, uint32_t count);
+void resample_minmax_s16x8_c(const int16_t *src, uint32_t nr_of_channels, const uint32_t *pos_idx, const uint32_t *pos_frac, uint32_t count, int16_t *min, int16_t *max);
+void polyphase_span_s16x8_c(const int16_t *src, uint32_t nr_of_channels, const PolyphaseFilterBank *bank, SampleRatePhase *phase, int16_t *dst, uint32_t count);
+void cic_predecimate_s16x8_c(const int16_t *src, uint32_t nr_of_channels, uint32_t nr_of_samples, uint32_t ratio_shift, int16_t *dst, uint32_t count);
+uint32_t codec_encode_s16x8_c(const uint8_t *src, uint32_t src_stride, uint32_t nr_lanes, uint32_t count, uint8_t *dst);
+uint32_t codec_encode_s24x8_c(const uint8_t *src, uint32_t src_stride, uint32_t nr_lanes, uint32_t count, uint8_t *dst);
+uint32_t codec_decode_s16x8_c(const uint8_t *src, uint32_t nr_lanes, uint32_t count, uint8_t *dst, uint32_t dst_stride);
+uint32_t codec_decode_s24x8_c(const uint8_t *src, uint32_t nr_lanes, uint32_t count, uint8_t *dst, uint32_t dst_stride);
+void transpose_to_planar_s16x8_c(const uint8_t *src, uint32_t src_stride, uint8_t *dst, uint32_t dst_stride, uint32_t nr_lanes, uint32_t count);
+void transpose_to_planar_s24x8_c(const uint8_t *src, uint32_t src_stride, uint8_t *dst, uint32_t dst_stride, uint32_t nr_lanes, uint32_t count);
+void transpose_from_planar_s16x8_c(const uint8_t *src, uint32_t src_stride, uint8_t *dst, uint32_t dst_stride, uint32_t nr_lanes, uint32_t count);
+void transpose_from_planar_s24x8_c(const uint8_t *src, uint32_t src_stride, uint8_t *dst, uint32_t dst_stride, uint32_t nr_lanes, uint32_t count);
+#if defined(AVX_ENABLED)
+// AVX2 kernels reused by the AVX-512 table
+int decode_be24_s16x8_avx(const uint8_t *payload, uint32_t nr_of_channels, uint8_t *dst, uint32_t dst_stride);
+int decode_be24_s24x8_avx(const uint8_t *payload, uint32_t nr_of_channels, uint8_t *dst, uint32_t dst_stride);
+void polyphase_span_s16x8_avx(const int16_t *src, uint32_t nr_of_channels, const PolyphaseFilterBank *bank, SampleRatePhase *phase, int16_t *dst, uint32_t count);
+void cic_predecimate_s16x8_avx(const int16_t *src, uint32_t nr_of_channels, uint32_t nr_of_samples, uint32_t ratio_shift, int16_t *dst, uint32_t count);
+int aggregate_stats_s8_avx(const RawTimelineValuesBuf *input, uint32_t start, uint32_t end, TimelineChannelSums *sums);
+int aggregate_stats_s16x8_avx(const RawTimelineValuesBuf *input, uint32_t start, uint32_t end, TimelineChannelSums *sums);
+int aggregate_stats_s24x8_avx(const RawTimelineValuesBuf *input, uint32_t start, uint32_t end, TimelineChannelSums *sums);
+uint32_t codec_encode_s16x8_avx(const uint8_t *src, uint32_t src_stride, uint32_t nr_lanes, uint32_t count, uint8_t *dst);
+uint32_t codec_encode_s24x8_avx(const uint8_t *src, uint32_t src_stride, uint32_t nr_lanes, uint32_t count, uint8_t *dst);
+uint32_t codec_decode_s16x8_avx(const uint8_t *src, uint32_t nr_lanes, uint32_t count, uint8_t *dst, uint32_t dst_stride);
+uint32_t codec_decode_s24x8_avx(const uint8_t *src, uint32_t nr_lanes, uint32_t count, uint8_t *dst, uint32_t dst_stride);
+void transpose_to_planar_s16x8_avx(const uint8_t *src, uint32_t src_stride, uint8_t *dst, uint32_t dst_stride, uint32_t nr_lanes, uint32_t count);
+void transpose_to_planar_s24x8_avx(const uint8_t *src, uint32_t src_stride, uint8_t *dst, uint32_t dst_stride, uint32_t nr_lanes, uint32_t count);
+void transpose_from_planar_s16x8_avx(const uint8_t *src, uint32_t src_stride, uint8_t *dst, uint32_t dst_stride, uint32_t nr_lanes, uint32_t count);
+void transpose_from_planar_s24x8_avx(const uint8_t *src, uint32_t src_stride, uint8_t *dst, uint32_t dst_stride, uint32_t nr_lanes, uint32_t count);
+#endif
+
+/*
+ Any channel count is accepted by the s16x8 / s24x8 kernels: the channels are processed in 8 (AVX-512: 16) lane groups,
+ a remainder group is either masked, or it is the group ending at the last channel (overlapping the previous one,
+ which only recomputes the same values). Buffers with less than 8 channels use scalar code.
+ Scalar Q16 interpolation for these tails, same rounding as the vector kernels.
+*/
+static inline int16_t interp_s16_q16(int16_t v0, int16_t v1, uint32_t frac) {
+    int32_t v = (v0 * (int32_t)(0x10000 - frac) + v1 * (int32_t)frac + (1 << 15)) >> 16;
+    return (int16_t)((v > INT16_MAX) ? INT16_MAX : ((v < INT16_MIN) ? INT16_MIN : v));
+}
+
+/*
+ Rows of the interpolation TIMELINE_RESAMPLE_PREFETCH outputs ahead. Decimating positions skip cache lines and pages,
+ which the hardware prefetchers do not follow, so the resampling kernels prefetch the two rows from the positions.
+*/
+#define TIMELINE_RESAMPLE_PREFETCH 8
+static inline void prefetch_SampleRows(const int16_t *src, uint32_t nr_of_channels, uint32_t idx) {
+    const int16_t *r0 = &src[(size_t)idx * nr_of_channels];
+    __builtin_prefetch(r0);
+    __builtin_prefetch(r0 + 2 * nr_of_channels - 1);
+}
+
+// Adds a 64-bit partial sum of squares to the 128-bit total
+static inline void add_TimelineChannelSumSq(TimelineChannelSums *sums, uint64_t sum_sq) {
+    sums->sum_sq += sum_sq;
+    if (sums->sum_sq < sum_sq) sums->sum_sq_hi++;
+}
+static inline void init_TimelineChannelSums(TimelineChannelSums *sums, uint32_t nr_of_channels) {
+    for (uint32_t c = 0; c < nr_of_channels; ++c) {
+        sums[c].sum = 0;
+        sums[c].sum_sq = 0;
+        sums[c].sum_sq_hi = 0;
+        sums[c].min = INT32_MAX;
+        sums[c].max = INT32_MIN;
+    }
+}
+// adds the statistics of another part of the same channel (the lanes and the tail rows of the narrow kernels)
+static inline void merge_TimelineChannelSums(TimelineChannelSums *sums, const TimelineChannelSums *part) {
+    sums->sum += part->sum;
+    add_TimelineChannelSumSq(sums, part->sum_sq);
+    sums->sum_sq_hi += part->sum_sq_hi;
+    if (part->min < sums->min) sums->min = part->min;
+    if (part->max > sums->max) sums->max = part->max;
+}
+
+// Q16 fraction of the phase and the move to the next output (shared by the resample_span kernels)
+static inline uint32_t frac_SampleRatePhase(const SampleRatePhase *phase, uint32_t accum) {
+    return (uint32_t)(((uint64_t)accum << 16) / phase->scale);
+}
+static inline void step_SampleRatePhase(const SampleRatePhase *phase, uint32_t *idx, uint32_t *accum) {
+    *idx += phase->step_int;
+    *accum += phase->step_rem;
+    if (*accum >= phase->scale) {
+        *accum -= phase->scale;
+        (*idx)++;
+    }
+}
+
+/*
+    Input rows and Q16 fractions of the next count outputs, the phase is advanced past them. The fraction
+    (accum << 16) / scale is stepped as quotient + remainder, so there is one division per call instead of
+    one per output, the fractions are identical to frac_SampleRatePhase.
+*/
+static inline void positions_SampleRatePhase(SampleRatePhase *phase, uint32_t count, uint32_t *pos_idx, uint32_t *pos_frac) {
+    const uint64_t scale = phase->scale;
+    uint64_t frac_q = ((uint64_t)phase->accum << 16) / scale;
+    uint64_t frac_r = ((uint64_t)phase->accum << 16) % scale;
+    uint64_t step_q = 0;
+    uint64_t step_r = 0;
+    if (count > 1) { // narrow columns of a zoomed in view take a single output
+        step_q = ((uint64_t)phase->step_rem << 16) / scale;
+        step_r = ((uint64_t)phase->step_rem << 16) % scale;
+    }
+    uint32_t idx = phase->idx;
+    uint32_t accum = phase->accum;
+    for (uint32_t k = 0; k < count; ++k) {
+        pos_idx[k] = idx;
+        pos_frac[k] = (uint32_t)frac_q;
+        idx += phase->step_int;
+        accum += phase->step_rem;
+        frac_q += step_q;
+        frac_r += step_r;
+        if (frac_r >= scale) {
+            frac_q++;
+            frac_r -= scale;
+        }
+        if (accum >= phase->scale) {
+            accum -= phase->scale;
+            idx++;
+            frac_q -= 0x10000;
+        }
+    }
+    phase->idx = idx;
+    phase->accum = accum;
+}
+
+// Coefficient row of the polyphase bank for the phase accum / scale, and the rounding of the Q14 sums (same on every backend)
+static inline const int16_t *coeffs_PolyphaseFilterBank(const PolyphaseFilterBank *bank, const SampleRatePhase *phase, uint32_t accum) {
+    uint32_t p = (bank->nr_of_phases == phase->scale) ? accum : (uint32_t)((uint64_t)accum * bank->nr_of_phases / phase->scale);
+    return &bank->coeffs[(size_t)p * bank->taps];
+}
+static inline int16_t round_fir_s16(int32_t acc) {
+    int32_t v = (acc + (1 << (TIMELINE_POLYPHASE_COEF_BITS - 1))) >> TIMELINE_POLYPHASE_COEF_BITS;
+    return (int16_t)((v > INT16_MAX) ? INT16_MAX : ((v < INT16_MIN) ? INT16_MIN : v));
+}
+
+// Zigzag mapping of the codec deltas (small magnitudes of either sign -> small unsigned values) and its inverse
+static inline uint32_t zigzag_encode_s32(int32_t d) {
+    return ((uint32_t)d << 1) ^ (uint32_t)(d >> 31);
+}
+static inline int32_t zigzag_decode_u32(uint32_t z) {
+    return (int32_t)(z >> 1) ^ -(int32_t)(z & 1);
+}
+static inline uint32_t bit_width_u32(uint32_t v) {
+    uint32_t width = 0;
+    while (v) {
+        width++;
+        v >>= 1;
+    }
+    return width;
+}
+
+static inline uint32_t gcd_u32(uint32_t a, uint32_t b) {
+    while (b) {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+int init_InterpInfo(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *output, uint32_t up, uint32_t down);
+/*
+    Walks the outputs of a prepared table in order, without a division per output: seek once to the first output,
+    then pos_SampleInterpCursor gives the absolute idx0 (idx1 = idx0 + 1) and the Q16 weight of sample idx1,
+    clamped to the last input pair, and next_SampleInterpCursor moves to the following output.
+*/
+typedef struct {
+    uint64_t base;  // first input sample of the current period
+    uint32_t j;     // phase in the period
+} SampleInterpCursor;
+
+static inline void seek_SampleInterpCursor(const SampleInterpTable *table, uint32_t i, SampleInterpCursor *cur) {
+    cur->j = i % table->period_outputs;
+    cur->base = (uint64_t)(i / table->period_outputs) * table->period_inputs;
+}
+static inline uint32_t pos_SampleInterpCursor(const SampleInterpTable *table, const SampleInterpCursor *cur, uint32_t in_samples, uint32_t *frac) {
+    uint64_t idx0 = cur->base + table->phases[cur->j].idx0;
+    if (idx0 + 1 >= in_samples) {
+        *frac = 0x10000;
+        return in_samples - 2;
+    }
+    *frac = table->phases[cur->j].frac;
+    return (uint32_t)idx0;
+}
+static inline void next_SampleInterpCursor(const SampleInterpTable *table, SampleInterpCursor *cur) {
+    if (++cur->j == table->period_outputs) {
+        cur->j = 0;
+        cur->base += table->period_inputs;
+    }
+}
+// The prepared table of output (prepare_SampleRateConversion), NULL with an error message if it is missing or shorter than the output
+const SampleInterpTable *get_SampleInterpTable(const RawTimelineValuesBuf *input, const RawTimelineValuesBuf *output);
 void free_InterpInfo(RawTimelineValuesBuf *output);
 
+int reserve_RawTimelineValuesBuf(RawTimelineValuesBuf *buf, size_t size, uint8_t alignment);
+// buf->scratch with at least 'size' bytes (64 byte aligned, contents undefined), grown through buf->allocator only if smaller
+int reserve_TimelineScratch(RawTimelineValuesBuf *buf, size_t size);
+fn_aggregate_stats getStatsKernel(RawTimelineValueEnum value_type);
+fn_aggregate_minmax getMinMaxKernel(const RawTimelineValuesBuf *input, double stride);
+int getCodecKernels(RawTimelineValueEnum value_type, fn_codec_encode *encode, fn_codec_decode *decode);
+int getTransposeKernels(RawTimelineValueEnum value_type, fn_transpose *to_planar, fn_transpose *from_planar);
+
+// Worker pool (timelinedb_workers.c): runs task(ctx, 0 .. nr_of_tasks - 1), returns when all are done
+typedef void (*fn_timeline_task)(void *ctx, uint32_t task);
+void run_TimelineWorkers(fn_timeline_task task, void *ctx, uint32_t nr_of_tasks);
+int aggregate_minmax_pyramid(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t i, uint32_t start, uint32_t end);
+
 #endif // TIMELINEDB_SIMD_H
\ No newline at end of file
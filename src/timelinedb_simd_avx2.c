@@ -0,0 +1,1137 @@
+/*
+    File: timelinedb_simd_avx2.c
+    This file implements the Intel AVX2 variant of the sample rate conversion and aggregation functions.
+    The functions are compiled with target attributes, so the rest of the library can be built for the baseline x86-64 ISA,
+    and this backend is registered only when the CPU reports AVX2 at runtime (see init_TimelineBackendRegistry).
+    Author: Barna Farago - MYND-Ideal kft.
+    Date: 2025-07-01
+    License: Modified MIT License. You can use it for learn, but I can sell it as closed source with some improvements...
+*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "timelinedb_simd.h"
+
+#if defined(AVX_ENABLED)
+#include <immintrin.h>
+
+/*
+    Channel counts other than 8: every 8-channel group is scanned vertically on its own (row stride = channels), two rows per
+    256-bit register. A remainder group is the group ending at the last channel, it overlaps the previous one.
+ */
+TIMELINE_TARGET("avx2")
+static void aggregate_minmax_s16_groups_avx(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t i, uint32_t start, uint32_t end) {
+    const uint32_t ch = input->nr_of_channels;
+    const int16_t *src = (const int16_t*)input->valueBuffer;
+    int16_t *dmin = &((int16_t*)outMin->valueBuffer)[i * ch];
+    int16_t *dmax = &((int16_t*)outMax->valueBuffer)[i * ch];
+    for (uint32_t c = 0; c < ch; c += 8) {
+        const uint32_t g = (c + 8 <= ch) ? c : ch - 8;
+        const int16_t *p = &src[(size_t)start * ch + g];
+        __m256i min0 = _mm256_set1_epi16(INT16_MAX);
+        __m256i max0 = _mm256_set1_epi16(INT16_MIN);
+        __m256i min1 = min0;
+        __m256i max1 = max0;
+        uint32_t j = start;
+        for (; j + 4 <= end; j += 4, p += 4 * ch) {
+            __m256i s01 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)p)),
+                                                  _mm_loadu_si128((const __m128i*)(p + ch)), 1);
+            __m256i s23 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(p + 2 * ch))),
+                                                  _mm_loadu_si128((const __m128i*)(p + 3 * ch)), 1);
+            min0 = _mm256_min_epi16(min0, s01);
+            max0 = _mm256_max_epi16(max0, s01);
+            min1 = _mm256_min_epi16(min1, s23);
+            max1 = _mm256_max_epi16(max1, s23);
+        }
+        min0 = _mm256_min_epi16(min0, min1);
+        max0 = _mm256_max_epi16(max0, max1);
+        __m128i min_s16 = _mm_min_epi16(_mm256_castsi256_si128(min0), _mm256_extracti128_si256(min0, 1));
+        __m128i max_s16 = _mm_max_epi16(_mm256_castsi256_si128(max0), _mm256_extracti128_si256(max0, 1));
+        for (; j < end; ++j, p += ch) {
+            __m128i s = _mm_loadu_si128((const __m128i*)p);
+            min_s16 = _mm_min_epi16(min_s16, s);
+            max_s16 = _mm_max_epi16(max_s16, s);
+        }
+        _mm_storeu_si128((__m128i*)&dmin[g], min_s16);
+        _mm_storeu_si128((__m128i*)&dmax[g], max_s16);
+    }
+}
+
+/*
+    Vertical AVX2 min/max: the interleaved 8 x int16 layout means one 128-bit load is one sample of all 8 channels,
+    so a 256-bit register holds 2 samples and min/max run lane-wise without any horizontal reduction in the loop.
+    8 samples are processed per iteration with two independent accumulator pairs (to hide the instruction latency),
+    the two 128-bit halves are folded only once at the end.
+ */
+TIMELINE_TARGET("avx2")
+int aggregate_minmax_SIMD_s16x8_avx(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t i, uint32_t start, uint32_t end) {
+    if (input->nr_of_channels < 8) {
+        return aggregate_minmax_SIMD_s16x8_c(input, outMin, outMax, i, start, end);
+    }
+    if (end > input->nr_of_samples) end = input->nr_of_samples;
+    if (input->nr_of_channels != 8) {
+        aggregate_minmax_s16_groups_avx(input, outMin, outMax, i, start, end);
+        return 0;
+    }
+    const int16_t *src = (const int16_t*)input->valueBuffer;
+    __m256i min0 = _mm256_set1_epi16(INT16_MAX);
+    __m256i max0 = _mm256_set1_epi16(INT16_MIN);
+    __m256i min1 = min0;
+    __m256i max1 = max0;
+
+    uint32_t j = start;
+    for (; j + 8 <= end; j += 8) {
+        const __m256i *p = (const __m256i*)&src[j * 8];
+        __m256i s01 = _mm256_loadu_si256(p);
+        __m256i s23 = _mm256_loadu_si256(p + 1);
+        __m256i s45 = _mm256_loadu_si256(p + 2);
+        __m256i s67 = _mm256_loadu_si256(p + 3);
+        min0 = _mm256_min_epi16(min0, _mm256_min_epi16(s01, s23));
+        max0 = _mm256_max_epi16(max0, _mm256_max_epi16(s01, s23));
+        min1 = _mm256_min_epi16(min1, _mm256_min_epi16(s45, s67));
+        max1 = _mm256_max_epi16(max1, _mm256_max_epi16(s45, s67));
+    }
+    for (; j + 2 <= end; j += 2) {
+        __m256i s01 = _mm256_loadu_si256((const __m256i*)&src[j * 8]);
+        min0 = _mm256_min_epi16(min0, s01);
+        max0 = _mm256_max_epi16(max0, s01);
+    }
+    min0 = _mm256_min_epi16(min0, min1);
+    max0 = _mm256_max_epi16(max0, max1);
+    // fold the two samples of the register into one
+    __m128i min_s16 = _mm_min_epi16(_mm256_castsi256_si128(min0), _mm256_extracti128_si256(min0, 1));
+    __m128i max_s16 = _mm_max_epi16(_mm256_castsi256_si128(max0), _mm256_extracti128_si256(max0, 1));
+    if (j < end) {
+        __m128i last = _mm_loadu_si128((const __m128i*)&src[j * 8]);
+        min_s16 = _mm_min_epi16(min_s16, last);
+        max_s16 = _mm_max_epi16(max_s16, last);
+    }
+    _mm_storeu_si128((__m128i*)&((int16_t*)outMin->valueBuffer)[i * 8], min_s16);
+    _mm_storeu_si128((__m128i*)&((int16_t*)outMax->valueBuffer)[i * 8], max_s16);
+    return 0;
+}
+
+/*
+    Min/max of 24-bit samples (3 bytes per channel), output downscaled to int8 (>> 16) like the C version.
+    One 8-channel group is expanded into 8 int32 lanes: the two 16-byte loads (bytes 0..15 and 8..23, no read past the sample)
+    give each 128-bit lane its 4 packed values, a byte shuffle places every value into the top 3 bytes of a dword
+    and an arithmetic shift right by 8 sign-extends it.
+ */
+TIMELINE_TARGET("avx2")
+static inline __m256i load_s24x8(const uint8_t *p) {
+    const __m256i byte_idx = _mm256_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+                                              -1, 4, 5, 6, -1, 7, 8, 9, -1, 10, 11, 12, -1, 13, 14, 15);
+    __m256i raw = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)p)),
+                                          _mm_loadu_si128((const __m128i*)(p + 8)), 1);
+    return _mm256_srai_epi32(_mm256_shuffle_epi8(raw, byte_idx), 8);
+}
+
+TIMELINE_TARGET("avx2")
+int aggregate_minmax_SIMD_s24x8_avx(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t i, uint32_t start, uint32_t end) {
+    const uint32_t ch = input->nr_of_channels;
+    if (ch < 8 || input->bytes_per_sample != ch * 3) {
+        return aggregate_minmax_SIMD_s24x8_c(input, outMin, outMax, i, start, end);
+    }
+    if (end > input->nr_of_samples) end = input->nr_of_samples;
+    const uint32_t row = ch * 3;
+    const uint8_t *src = (const uint8_t*)input->valueBuffer;
+    // 8-channel groups, the remainder group overlaps the previous one (see timelinedb_simd.h)
+    for (uint32_t c = 0; c < ch; c += 8) {
+        const uint32_t g = (c + 8 <= ch) ? c : ch - 8;
+        const uint8_t *p = &src[(size_t)start * row + g * 3];
+        __m256i min0 = _mm256_set1_epi32(INT32_MAX);
+        __m256i max0 = _mm256_set1_epi32(INT32_MIN);
+        __m256i min1 = min0;
+        __m256i max1 = max0;
+
+        uint32_t j = start;
+        for (; j + 2 <= end; j += 2, p += 2 * row) {
+            __m256i s0 = load_s24x8(p);
+            __m256i s1 = load_s24x8(p + row);
+            min0 = _mm256_min_epi32(min0, s0);
+            max0 = _mm256_max_epi32(max0, s0);
+            min1 = _mm256_min_epi32(min1, s1);
+            max1 = _mm256_max_epi32(max1, s1);
+        }
+        if (j < end) {
+            __m256i s0 = load_s24x8(p);
+            min0 = _mm256_min_epi32(min0, s0);
+            max0 = _mm256_max_epi32(max0, s0);
+        }
+        min0 = _mm256_min_epi32(min0, min1);
+        max0 = _mm256_max_epi32(max0, max1);
+        int32_t vmin[8], vmax[8];
+        _mm256_storeu_si256((__m256i*)vmin, min0);
+        _mm256_storeu_si256((__m256i*)vmax, max0);
+        // Downscale from 24-bit to 8-bit (>>16)
+        for (uint32_t k = 0; k < 8; ++k) {
+            ((int8_t*)outMin->valueBuffer)[i * ch + g + k] = (int8_t)(vmin[k] >> 16);
+            ((int8_t*)outMax->valueBuffer)[i * ch + g + k] = (int8_t)(vmax[k] >> 16);
+        }
+    }
+    return 0;
+}
+
+/*
+    1..7 channels: the rows are contiguous, so consecutive values are the lanes. A step takes the largest multiple
+    of ch that fits the vector (used), lane L always holds channel L % ch and the lanes past used are not summed.
+    The lanes are folded into their channels at the end, the rows left after the last full vector load go through
+    the C kernel (merge_TimelineChannelSums).
+    int16 / int8 (widened to int16): two steps are interleaved like the rows r and r + 2 of the 8-channel kernel.
+ */
+TIMELINE_TARGET("avx2")
+static void aggregate_stats_narrow_s16_avx(const RawTimelineValuesBuf *input, uint32_t start, uint32_t end, TimelineChannelSums *sums, int is_s8) {
+    const uint32_t ch = input->nr_of_channels;
+    const uint32_t bytes = is_s8 ? 1 : 2;
+    const uint32_t rows = 16 / ch;                     // rows per step
+    const uint32_t used = rows * ch;
+    const uint32_t need = (used + 16 + ch - 1) / ch;  // rows covered by the loads of a step pair
+    if (end > input->nr_of_samples) end = input->nr_of_samples;
+    init_TimelineChannelSums(sums, ch);
+    const uint8_t *p = &input->valueBuffer[(size_t)start * ch * bytes];
+    const __m256i ones = _mm256_set1_epi16(1);
+    // uint64: value lanes 0..3, 8..11, 4..7, 12..15 (the order of unpacklo / unpackhi)
+    __m256i sq[4] = { _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256() };
+    __m256i min0 = _mm256_set1_epi16(INT16_MAX);
+    __m256i max0 = _mm256_set1_epi16(INT16_MIN);
+    int64_t sum[16] = { 0 };
+    uint32_t j = start;
+    while (j + need <= end) {
+        const uint32_t block_end = (end - j > TIMELINE_STATS_BLOCK) ? j + TIMELINE_STATS_BLOCK : end;
+        __m256i sum_lo = _mm256_setzero_si256(); // int32: value lanes 0..3, 8..11
+        __m256i sum_hi = _mm256_setzero_si256(); // int32: value lanes 4..7, 12..15
+        for (; j + need <= block_end; j += 2 * rows, p += 2 * used * bytes) {
+            __m256i a, b;
+            if (is_s8) {
+                a = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)p));
+                b = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(p + used)));
+            } else {
+                a = _mm256_loadu_si256((const __m256i*)p);
+                b = _mm256_loadu_si256((const __m256i*)(p + 2 * used));
+            }
+            min0 = _mm256_min_epi16(min0, _mm256_min_epi16(a, b));
+            max0 = _mm256_max_epi16(max0, _mm256_max_epi16(a, b));
+            __m256i lo = _mm256_unpacklo_epi16(a, b);
+            __m256i hi = _mm256_unpackhi_epi16(a, b);
+            sum_lo = _mm256_add_epi32(sum_lo, _mm256_madd_epi16(lo, ones));
+            sum_hi = _mm256_add_epi32(sum_hi, _mm256_madd_epi16(hi, ones));
+            __m256i q_lo = _mm256_madd_epi16(lo, lo);
+            __m256i q_hi = _mm256_madd_epi16(hi, hi);
+            sq[0] = _mm256_add_epi64(sq[0], _mm256_cvtepu32_epi64(_mm256_castsi256_si128(q_lo)));
+            sq[1] = _mm256_add_epi64(sq[1], _mm256_cvtepu32_epi64(_mm256_extracti128_si256(q_lo, 1)));
+            sq[2] = _mm256_add_epi64(sq[2], _mm256_cvtepu32_epi64(_mm256_castsi256_si128(q_hi)));
+            sq[3] = _mm256_add_epi64(sq[3], _mm256_cvtepu32_epi64(_mm256_extracti128_si256(q_hi, 1)));
+        }
+        int32_t part[16];
+        _mm256_storeu_si256((__m256i*)part, sum_lo);
+        _mm256_storeu_si256((__m256i*)&part[8], sum_hi);
+        for (uint32_t k = 0; k < 4; ++k) {
+            sum[k] += part[k];
+            sum[8 + k] += part[4 + k];
+            sum[4 + k] += part[8 + k];
+            sum[12 + k] += part[12 + k];
+        }
+    }
+    if (j > start) {
+        uint64_t vsq[16];
+        int16_t vmin[16], vmax[16];
+        for (uint32_t k = 0; k < 4; ++k) {
+            _mm256_storeu_si256((__m256i*)&vsq[4 * k], sq[k]);
+        }
+        _mm256_storeu_si256((__m256i*)vmin, min0);
+        _mm256_storeu_si256((__m256i*)vmax, max0);
+        static const uint8_t sq_lane[16] = { 0, 1, 2, 3, 8, 9, 10, 11, 4, 5, 6, 7, 12, 13, 14, 15 };
+        for (uint32_t k = 0; k < 16; ++k) {
+            if (sq_lane[k] >= used) continue;
+            TimelineChannelSums *s = &sums[sq_lane[k] % ch];
+            add_TimelineChannelSumSq(s, vsq[k]);
+        }
+        for (uint32_t l = 0; l < used; ++l) {
+            TimelineChannelSums *s = &sums[l % ch];
+            s->sum += sum[l];
+            if (vmin[l] < s->min) s->min = vmin[l];
+            if (vmax[l] > s->max) s->max = vmax[l];
+        }
+    }
+    TimelineChannelSums tail[8];
+    if (is_s8) {
+        aggregate_stats_s8_c(input, j, end, tail);
+    } else {
+        aggregate_stats_s16x8_c(input, j, end, tail);
+    }
+    for (uint32_t c = 0; c < ch; ++c) {
+        merge_TimelineChannelSums(&sums[c], &tail[c]);
+    }
+}
+
+/*
+    Statistics (sum, sum of squares, min, max) of 8-channel groups, the last group overlaps the previous one and
+    recomputes the same values. The narrow accumulators are flushed every TIMELINE_STATS_BLOCK rows.
+    int16: rows r and r + 2 are interleaved per channel (unpack), so madd gives r^2 + (r + 2)^2 per channel
+    (< 2^32 unsigned) and, with ones, the sum of the two samples. The squares are widened to 64 bits every step.
+ */
+TIMELINE_TARGET("avx2")
+int aggregate_stats_s16x8_avx(const RawTimelineValuesBuf *input, uint32_t start, uint32_t end, TimelineChannelSums *sums) {
+    const uint32_t ch = input->nr_of_channels;
+    if (ch < 8) {
+        if (input->bytes_per_sample != ch * 2) {
+            return aggregate_stats_s16x8_c(input, start, end, sums);
+        }
+        aggregate_stats_narrow_s16_avx(input, start, end, sums, 0);
+        return 0;
+    }
+    if (end > input->nr_of_samples) end = input->nr_of_samples;
+    init_TimelineChannelSums(sums, ch);
+    const int16_t *src = (const int16_t*)input->valueBuffer;
+    const __m256i ones = _mm256_set1_epi16(1);
+    for (uint32_t c = 0; c < ch; c += 8) {
+        const uint32_t g = (c + 8 <= ch) ? c : ch - 8;
+        const int16_t *p = &src[(size_t)start * ch + g];
+        __m256i sq_lo = _mm256_setzero_si256(); // uint64: channels 0..3
+        __m256i sq_hi = _mm256_setzero_si256(); // uint64: channels 4..7
+        __m256i min0 = _mm256_set1_epi16(INT16_MAX);
+        __m256i max0 = _mm256_set1_epi16(INT16_MIN);
+        int64_t sum[8] = { 0 };
+        uint32_t j = start;
+        while (j + 4 <= end) {
+            const uint32_t block_end = (end - j > TIMELINE_STATS_BLOCK) ? j + TIMELINE_STATS_BLOCK : end;
+            __m256i sum_lo = _mm256_setzero_si256(); // int32: channels 0..3 of rows (0, 2) and (1, 3)
+            __m256i sum_hi = _mm256_setzero_si256();
+            for (; j + 4 <= block_end; j += 4, p += 4 * ch) {
+                __m256i s01 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)p)),
+                                                      _mm_loadu_si128((const __m128i*)(p + ch)), 1);
+                __m256i s23 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(p + 2 * ch))),
+                                                      _mm_loadu_si128((const __m128i*)(p + 3 * ch)), 1);
+                min0 = _mm256_min_epi16(min0, _mm256_min_epi16(s01, s23));
+                max0 = _mm256_max_epi16(max0, _mm256_max_epi16(s01, s23));
+                __m256i lo = _mm256_unpacklo_epi16(s01, s23);
+                __m256i hi = _mm256_unpackhi_epi16(s01, s23);
+                sum_lo = _mm256_add_epi32(sum_lo, _mm256_madd_epi16(lo, ones));
+                sum_hi = _mm256_add_epi32(sum_hi, _mm256_madd_epi16(hi, ones));
+                __m256i q_lo = _mm256_madd_epi16(lo, lo);
+                __m256i q_hi = _mm256_madd_epi16(hi, hi);
+                sq_lo = _mm256_add_epi64(sq_lo, _mm256_add_epi64(_mm256_cvtepu32_epi64(_mm256_castsi256_si128(q_lo)),
+                                                                 _mm256_cvtepu32_epi64(_mm256_extracti128_si256(q_lo, 1))));
+                sq_hi = _mm256_add_epi64(sq_hi, _mm256_add_epi64(_mm256_cvtepu32_epi64(_mm256_castsi256_si128(q_hi)),
+                                                                 _mm256_cvtepu32_epi64(_mm256_extracti128_si256(q_hi, 1))));
+            }
+            int32_t part[16];
+            _mm256_storeu_si256((__m256i*)part, sum_lo);
+            _mm256_storeu_si256((__m256i*)&part[8], sum_hi);
+            for (uint32_t k = 0; k < 4; ++k) {
+                sum[k] += (int64_t)part[k] + part[4 + k];
+                sum[4 + k] += (int64_t)part[8 + k] + part[12 + k];
+            }
+        }
+        uint64_t sq[8];
+        int16_t vmin[8], vmax[8];
+        _mm256_storeu_si256((__m256i*)sq, sq_lo);
+        _mm256_storeu_si256((__m256i*)&sq[4], sq_hi);
+        _mm_storeu_si128((__m128i*)vmin, _mm_min_epi16(_mm256_castsi256_si128(min0), _mm256_extracti128_si256(min0, 1)));
+        _mm_storeu_si128((__m128i*)vmax, _mm_max_epi16(_mm256_castsi256_si128(max0), _mm256_extracti128_si256(max0, 1)));
+        for (; j < end; ++j, p += ch) {
+            for (uint32_t k = 0; k < 8; ++k) {
+                int32_t v = p[k];
+                sum[k] += v;
+                sq[k] += (uint64_t)((int64_t)v * v);
+                if (v < vmin[k]) vmin[k] = (int16_t)v;
+                if (v > vmax[k]) vmax[k] = (int16_t)v;
+            }
+        }
+        for (uint32_t k = 0; k < 8; ++k) {
+            sums[g + k].sum = sum[k];
+            sums[g + k].sum_sq = sq[k];
+            sums[g + k].min = vmin[k];
+            sums[g + k].max = vmax[k];
+        }
+    }
+    return 0;
+}
+
+/*
+    24-bit, 1..7 channels: 8 consecutive values per step (load_s24x8), the per-lane totals are kept like the groups
+    of the 8-channel kernel and folded into the channels at the end (see aggregate_stats_narrow_s16_avx).
+ */
+TIMELINE_TARGET("avx2")
+static void aggregate_stats_narrow_s24_avx(const RawTimelineValuesBuf *input, uint32_t start, uint32_t end, TimelineChannelSums *sums) {
+    const uint32_t ch = input->nr_of_channels;
+    const uint32_t rows = 8 / ch;
+    const uint32_t used = rows * ch;
+    const uint32_t need = (8 + ch - 1) / ch;  // rows covered by one load
+    if (end > input->nr_of_samples) end = input->nr_of_samples;
+    init_TimelineChannelSums(sums, ch);
+    const uint8_t *p = &input->valueBuffer[(size_t)start * ch * 3];
+    __m256i sum_lo = _mm256_setzero_si256(); // int64: value lanes 0..3
+    __m256i sum_hi = _mm256_setzero_si256(); // int64: value lanes 4..7
+    __m256i min0 = _mm256_set1_epi32(INT32_MAX);
+    __m256i max0 = _mm256_set1_epi32(INT32_MIN);
+    TimelineChannelSums lane[8];
+    init_TimelineChannelSums(lane, 8);
+    uint32_t j = start;
+    while (j + need <= end) {
+        const uint32_t block_end = (end - j > TIMELINE_STATS_BLOCK) ? j + TIMELINE_STATS_BLOCK : end;
+        __m256i sq_even = _mm256_setzero_si256(); // uint64: value lanes 0, 2, 4, 6
+        __m256i sq_odd = _mm256_setzero_si256();  // uint64: value lanes 1, 3, 5, 7
+        for (; j + need <= block_end; j += rows, p += used * 3) {
+            __m256i v = load_s24x8(p);
+            min0 = _mm256_min_epi32(min0, v);
+            max0 = _mm256_max_epi32(max0, v);
+            sum_lo = _mm256_add_epi64(sum_lo, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+            sum_hi = _mm256_add_epi64(sum_hi, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+            __m256i odd = _mm256_srli_epi64(v, 32);
+            sq_even = _mm256_add_epi64(sq_even, _mm256_mul_epi32(v, v));
+            sq_odd = _mm256_add_epi64(sq_odd, _mm256_mul_epi32(odd, odd));
+        }
+        uint64_t sq[8];
+        _mm256_storeu_si256((__m256i*)sq, sq_even);
+        _mm256_storeu_si256((__m256i*)&sq[4], sq_odd);
+        for (uint32_t k = 0; k < 4; ++k) {
+            add_TimelineChannelSumSq(&lane[2 * k], sq[k]);
+            add_TimelineChannelSumSq(&lane[2 * k + 1], sq[4 + k]);
+        }
+    }
+    int64_t sum[8];
+    int32_t vmin[8], vmax[8];
+    _mm256_storeu_si256((__m256i*)sum, sum_lo);
+    _mm256_storeu_si256((__m256i*)&sum[4], sum_hi);
+    _mm256_storeu_si256((__m256i*)vmin, min0);
+    _mm256_storeu_si256((__m256i*)vmax, max0);
+    for (uint32_t l = 0; l < used; ++l) {
+        lane[l].sum = sum[l];
+        lane[l].min = vmin[l];
+        lane[l].max = vmax[l];
+        merge_TimelineChannelSums(&sums[l % ch], &lane[l]);
+    }
+    TimelineChannelSums tail[8];
+    aggregate_stats_s24x8_c(input, j, end, tail);
+    for (uint32_t c = 0; c < ch; ++c) {
+        merge_TimelineChannelSums(&sums[c], &tail[c]);
+    }
+}
+
+/*
+    24-bit: one row of a group is expanded to 8 int32 lanes (load_s24x8). The sums are widened to 64 bits,
+    the squares (< 2^46) come from mul_epi32 on the even and the odd lanes, each 64-bit lane holds 2^17 squares
+    before the block is flushed into the 128-bit totals.
+ */
+TIMELINE_TARGET("avx2")
+int aggregate_stats_s24x8_avx(const RawTimelineValuesBuf *input, uint32_t start, uint32_t end, TimelineChannelSums *sums) {
+    const uint32_t ch = input->nr_of_channels;
+    if (input->bytes_per_sample != ch * 3) {
+        return aggregate_stats_s24x8_c(input, start, end, sums);
+    }
+    if (ch < 8) {
+        aggregate_stats_narrow_s24_avx(input, start, end, sums);
+        return 0;
+    }
+    if (end > input->nr_of_samples) end = input->nr_of_samples;
+    init_TimelineChannelSums(sums, ch);
+    const uint32_t row = ch * 3;
+    const uint8_t *src = (const uint8_t*)input->valueBuffer;
+    for (uint32_t c = 0; c < ch; c += 8) {
+        const uint32_t g = (c + 8 <= ch) ? c : ch - 8;
+        const uint8_t *p = &src[(size_t)start * row + g * 3];
+        __m256i sum_lo = _mm256_setzero_si256(); // int64: channels 0..3
+        __m256i sum_hi = _mm256_setzero_si256(); // int64: channels 4..7
+        __m256i min0 = _mm256_set1_epi32(INT32_MAX);
+        __m256i max0 = _mm256_set1_epi32(INT32_MIN);
+        TimelineChannelSums group[8];
+        init_TimelineChannelSums(group, 8);
+        uint32_t j = start;
+        while (j < end) {
+            const uint32_t block_end = (end - j > TIMELINE_STATS_BLOCK) ? j + TIMELINE_STATS_BLOCK : end;
+            __m256i sq_even = _mm256_setzero_si256(); // uint64: channels 0, 2, 4, 6
+            __m256i sq_odd = _mm256_setzero_si256();  // uint64: channels 1, 3, 5, 7
+            for (; j < block_end; ++j, p += row) {
+                __m256i v = load_s24x8(p);
+                min0 = _mm256_min_epi32(min0, v);
+                max0 = _mm256_max_epi32(max0, v);
+                sum_lo = _mm256_add_epi64(sum_lo, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+                sum_hi = _mm256_add_epi64(sum_hi, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+                __m256i odd = _mm256_srli_epi64(v, 32);
+                sq_even = _mm256_add_epi64(sq_even, _mm256_mul_epi32(v, v));
+                sq_odd = _mm256_add_epi64(sq_odd, _mm256_mul_epi32(odd, odd));
+            }
+            uint64_t sq[8];
+            _mm256_storeu_si256((__m256i*)sq, sq_even);
+            _mm256_storeu_si256((__m256i*)&sq[4], sq_odd);
+            for (uint32_t k = 0; k < 4; ++k) {
+                add_TimelineChannelSumSq(&group[2 * k], sq[k]);
+                add_TimelineChannelSumSq(&group[2 * k + 1], sq[4 + k]);
+            }
+        }
+        int64_t sum[8];
+        int32_t vmin[8], vmax[8];
+        _mm256_storeu_si256((__m256i*)sum, sum_lo);
+        _mm256_storeu_si256((__m256i*)&sum[4], sum_hi);
+        _mm256_storeu_si256((__m256i*)vmin, min0);
+        _mm256_storeu_si256((__m256i*)vmax, max0);
+        for (uint32_t k = 0; k < 8; ++k) {
+            group[k].sum = sum[k];
+            group[k].min = vmin[k];
+            group[k].max = vmax[k];
+            sums[g + k] = group[k];
+        }
+    }
+    return 0;
+}
+
+/*
+    int8: one row of a group is widened to 8 int32 lanes, the sums and the squares (< 2^14) both stay in int32 for a block.
+ */
+TIMELINE_TARGET("avx2")
+int aggregate_stats_s8_avx(const RawTimelineValuesBuf *input, uint32_t start, uint32_t end, TimelineChannelSums *sums) {
+    const uint32_t ch = input->nr_of_channels;
+    if (input->bytes_per_sample != ch) {
+        return aggregate_stats_s8_c(input, start, end, sums);
+    }
+    if (ch < 8) {
+        aggregate_stats_narrow_s16_avx(input, start, end, sums, 1);
+        return 0;
+    }
+    if (end > input->nr_of_samples) end = input->nr_of_samples;
+    init_TimelineChannelSums(sums, ch);
+    const int8_t *src = (const int8_t*)input->valueBuffer;
+    for (uint32_t c = 0; c < ch; c += 8) {
+        const uint32_t g = (c + 8 <= ch) ? c : ch - 8;
+        const int8_t *p = &src[(size_t)start * ch + g];
+        __m256i min0 = _mm256_set1_epi32(INT32_MAX);
+        __m256i max0 = _mm256_set1_epi32(INT32_MIN);
+        int64_t sum[8] = { 0 };
+        uint64_t sq[8] = { 0 };
+        uint32_t j = start;
+        while (j < end) {
+            const uint32_t block_end = (end - j > TIMELINE_STATS_BLOCK) ? j + TIMELINE_STATS_BLOCK : end;
+            __m256i sum32 = _mm256_setzero_si256();
+            __m256i sq32 = _mm256_setzero_si256();
+            for (; j < block_end; ++j, p += ch) {
+                __m256i v = _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)p));
+                min0 = _mm256_min_epi32(min0, v);
+                max0 = _mm256_max_epi32(max0, v);
+                sum32 = _mm256_add_epi32(sum32, v);
+                sq32 = _mm256_add_epi32(sq32, _mm256_mullo_epi32(v, v));
+            }
+            int32_t part_sum[8], part_sq[8];
+            _mm256_storeu_si256((__m256i*)part_sum, sum32);
+            _mm256_storeu_si256((__m256i*)part_sq, sq32);
+            for (uint32_t k = 0; k < 8; ++k) {
+                sum[k] += part_sum[k];
+                sq[k] += (uint32_t)part_sq[k];
+            }
+        }
+        int32_t vmin[8], vmax[8];
+        _mm256_storeu_si256((__m256i*)vmin, min0);
+        _mm256_storeu_si256((__m256i*)vmax, max0);
+        for (uint32_t k = 0; k < 8; ++k) {
+            sums[g + k].sum = sum[k];
+            sums[g + k].sum_sq = sq[k];
+            sums[g + k].min = vmin[k];
+            sums[g + k].max = vmax[k];
+        }
+    }
+    return 0;
+}
+
+/*
+    Q16 linear interpolation of one 8-channel group: (v0 * inv_frac + v1 * frac + 0.5) >> 16, saturated to int16.
+ */
+TIMELINE_TARGET("avx2")
+static inline __m256i interp_s16x8_s32_avx(const int16_t *r0, const int16_t *r1, __m256i frac, __m256i inv_frac) {
+    // Load 8 int16 samples from idx0 and idx1, extend to int32
+    __m256i v0_s32 = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)r0));
+    __m256i v1_s32 = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)r1));
+
+    // Multiply each with fixed-point factors
+    __m256i interp = _mm256_add_epi32(_mm256_mullo_epi32(v0_s32, inv_frac), _mm256_mullo_epi32(v1_s32, frac));
+    __m256i rounded = _mm256_add_epi32(interp, _mm256_set1_epi32(1 << 15));
+    return _mm256_srai_epi32(rounded, 16); // arithmetic shift, the samples are signed
+}
+
+TIMELINE_TARGET("avx2")
+static inline __m128i interp_s16x8_vec_avx(const int16_t *r0, const int16_t *r1, __m256i frac, __m256i inv_frac) {
+    __m256i shifted = interp_s16x8_s32_avx(r0, r1, frac, inv_frac);
+    // Narrow back to int16 (packs works per 128-bit lane, so the two halves are packed with the SSE form)
+    return _mm_packs_epi32(_mm256_castsi256_si128(shifted), _mm256_extracti128_si256(shifted, 1));
+}
+
+TIMELINE_TARGET("avx2")
+static inline void interp_s16x8_avx(const int16_t *r0, const int16_t *r1, int16_t *out, __m256i frac, __m256i inv_frac) {
+    _mm_storeu_si128((__m128i*)out, interp_s16x8_vec_avx(r0, r1, frac, inv_frac));
+}
+
+// Sample rate conversion at the prepared positions (see convert_sample_rate_SIMD_s16x8_bresenham), 8-channel groups
+TIMELINE_TARGET("avx2")
+int convert_sample_rate_SIMD_s16x8_bresenham_avx(const RawTimelineValuesBuf* input, RawTimelineValuesBuf* output, uint32_t first, uint32_t count)
+{
+    const SampleInterpTable *table = get_SampleInterpTable(input, output);
+    if (!table) return -1;
+    const int16_t *src = (const int16_t*)input->valueBuffer;
+    int16_t *dst = (int16_t*)output->valueBuffer;
+    uint32_t ch = input->nr_of_channels;
+    uint32_t in_samples = input->nr_of_samples;
+
+    SampleInterpCursor cur;
+    seek_SampleInterpCursor(table, first, &cur);
+    for (uint32_t i = first; i < first + count; ++i) {
+        uint32_t frac_fixed;
+        const int16_t *r0 = &src[(size_t)pos_SampleInterpCursor(table, &cur, in_samples, &frac_fixed) * ch];
+        const int16_t *r1 = r0 + ch;
+        int16_t *out = &dst[(size_t)i * ch];
+        if (ch >= 8) {
+            __m256i frac = _mm256_set1_epi32((int32_t)frac_fixed);
+            __m256i inv_frac = _mm256_set1_epi32((int32_t)(0x10000 - frac_fixed));
+            // 8-channel groups, the remainder group overlaps the previous one
+            for (uint32_t c = 0; c < ch; c += 8) {
+                uint32_t g = (c + 8 <= ch) ? c : ch - 8;
+                interp_s16x8_avx(&r0[g], &r1[g], &out[g], frac, inv_frac);
+            }
+        } else {
+            for (uint32_t c = 0; c < ch; ++c) {
+                out[c] = interp_s16_q16(r0[c], r1[c], frac_fixed);
+            }
+        }
+        next_SampleInterpCursor(table, &cur);
+    }
+    return 0;
+}
+
+// Streaming resampling (see resample_span_s16x8_c), 8-channel groups like the converter above
+TIMELINE_TARGET("avx2")
+void resample_span_s16x8_avx(const int16_t *src, uint32_t nr_of_channels, SampleRatePhase *phase, int16_t *dst, uint32_t count) {
+    const uint32_t ch = nr_of_channels;
+    if (ch < 8) {
+        resample_span_s16x8_c(src, nr_of_channels, phase, dst, count);
+        return;
+    }
+    uint32_t pos_idx[TIMELINE_RESAMPLE_BLOCK];
+    uint32_t pos_frac[TIMELINE_RESAMPLE_BLOCK];
+    for (uint32_t done = 0; done < count; ) {
+        const uint32_t n = (count - done < TIMELINE_RESAMPLE_BLOCK) ? count - done : TIMELINE_RESAMPLE_BLOCK;
+        positions_SampleRatePhase(phase, n, pos_idx, pos_frac);
+        for (uint32_t k = 0; k < n; ++k) {
+            const int16_t *r0 = &src[(size_t)pos_idx[k] * ch];
+            int16_t *out = &dst[(size_t)(done + k) * ch];
+            if (k + TIMELINE_RESAMPLE_PREFETCH < n) prefetch_SampleRows(src, ch, pos_idx[k + TIMELINE_RESAMPLE_PREFETCH]);
+            __m256i frac = _mm256_set1_epi32((int32_t)pos_frac[k]);
+            __m256i inv_frac = _mm256_set1_epi32((int32_t)(0x10000 - pos_frac[k]));
+            for (uint32_t c = 0; c < ch; c += 8) {
+                uint32_t g = (c + 8 <= ch) ? c : ch - 8;
+                interp_s16x8_avx(&r0[g], &r0[ch + g], &out[g], frac, inv_frac);
+            }
+        }
+        done += n;
+    }
+}
+
+/*
+    Folds the outputs of the 8-channel group g into vmin / vmax. Two outputs are narrowed with one 256-bit packs,
+    its lanes are (k: ch 0-3, k + 1: ch 0-3 | k: ch 4-7, k + 1: ch 4-7), the min / max of the pairs are put back
+    in channel order when the run ends.
+ */
+TIMELINE_TARGET("avx2")
+static inline void resample_minmax_group_avx(const int16_t *src, uint32_t ch, uint32_t g, const uint32_t *pos_idx, const uint32_t *pos_frac, uint32_t n,
+                                             __m128i *vmin, __m128i *vmax) {
+    __m128i lo = *vmin;
+    __m128i hi = *vmax;
+    uint32_t k = 0;
+    if (n >= 2) {
+        __m256i lo2 = _mm256_set1_epi16(INT16_MAX);
+        __m256i hi2 = _mm256_set1_epi16(INT16_MIN);
+        for (; k + 2 <= n; k += 2) {
+            // the first group brings the rows in
+            if (g == 0 && k + TIMELINE_RESAMPLE_PREFETCH + 1 < n) {
+                prefetch_SampleRows(src, ch, pos_idx[k + TIMELINE_RESAMPLE_PREFETCH]);
+                prefetch_SampleRows(src, ch, pos_idx[k + TIMELINE_RESAMPLE_PREFETCH + 1]);
+            }
+            const int16_t *r0 = &src[(size_t)pos_idx[k] * ch + g];
+            const int16_t *r1 = &src[(size_t)pos_idx[k + 1] * ch + g];
+            __m256i a = interp_s16x8_s32_avx(r0, r0 + ch, _mm256_set1_epi32((int32_t)pos_frac[k]), _mm256_set1_epi32((int32_t)(0x10000 - pos_frac[k])));
+            __m256i b = interp_s16x8_s32_avx(r1, r1 + ch, _mm256_set1_epi32((int32_t)pos_frac[k + 1]), _mm256_set1_epi32((int32_t)(0x10000 - pos_frac[k + 1])));
+            __m256i v = _mm256_packs_epi32(a, b);
+            lo2 = _mm256_min_epi16(lo2, v);
+            hi2 = _mm256_max_epi16(hi2, v);
+        }
+        // 64-bit quarters (k 0-3, k+1 0-3, k 4-7, k+1 4-7) -> (k 0-3, k 4-7 | k+1 0-3, k+1 4-7)
+        lo2 = _mm256_permute4x64_epi64(lo2, _MM_SHUFFLE(3, 1, 2, 0));
+        hi2 = _mm256_permute4x64_epi64(hi2, _MM_SHUFFLE(3, 1, 2, 0));
+        lo = _mm_min_epi16(lo, _mm_min_epi16(_mm256_castsi256_si128(lo2), _mm256_extracti128_si256(lo2, 1)));
+        hi = _mm_max_epi16(hi, _mm_max_epi16(_mm256_castsi256_si128(hi2), _mm256_extracti128_si256(hi2, 1)));
+    }
+    if (k < n) {
+        const int16_t *r0 = &src[(size_t)pos_idx[k] * ch + g];
+        __m128i v = interp_s16x8_vec_avx(r0, r0 + ch, _mm256_set1_epi32((int32_t)pos_frac[k]), _mm256_set1_epi32((int32_t)(0x10000 - pos_frac[k])));
+        lo = _mm_min_epi16(lo, v);
+        hi = _mm_max_epi16(hi, v);
+    }
+    *vmin = lo;
+    *vmax = hi;
+}
+
+/*
+    Fused resampling and min/max, 8-channel groups, every group runs over the column with its min / max in registers.
+    The overlapping last group is loaded before the other groups are stored: its overlapped lanes see the same
+    samples, so the stale start values give the same min / max, and the load does not wait for the overlapping store.
+ */
+TIMELINE_TARGET("avx2")
+void resample_minmax_s16x8_avx(const int16_t *src, uint32_t nr_of_channels, const uint32_t *pos_idx, const uint32_t *pos_frac, uint32_t count, int16_t *min, int16_t *max) {
+    const uint32_t ch = nr_of_channels;
+    if (ch < 8) {
+        resample_minmax_s16x8_c(src, nr_of_channels, pos_idx, pos_frac, count, min, max);
+        return;
+    }
+    const uint32_t full = ch & ~7u;
+    __m128i tail_min = _mm_setzero_si128();
+    __m128i tail_max = _mm_setzero_si128();
+    if (full < ch) {
+        tail_min = _mm_loadu_si128((const __m128i*)&min[ch - 8]);
+        tail_max = _mm_loadu_si128((const __m128i*)&max[ch - 8]);
+    }
+    for (uint32_t g = 0; g < full; g += 8) {
+        __m128i vmin = _mm_loadu_si128((const __m128i*)&min[g]);
+        __m128i vmax = _mm_loadu_si128((const __m128i*)&max[g]);
+        resample_minmax_group_avx(src, ch, g, pos_idx, pos_frac, count, &vmin, &vmax);
+        _mm_storeu_si128((__m128i*)&min[g], vmin);
+        _mm_storeu_si128((__m128i*)&max[g], vmax);
+    }
+    if (full < ch) {
+        resample_minmax_group_avx(src, ch, ch - 8, pos_idx, pos_frac, count, &tail_min, &tail_max);
+        _mm_storeu_si128((__m128i*)&min[ch - 8], tail_min);
+        _mm_storeu_si128((__m128i*)&max[ch - 8], tail_max);
+    }
+}
+
+/*
+    Polyphase FIR, 8-channel groups (overlapping last group). Two taps per step: the rows j and j + 1 are
+    interleaved with unpack, so one vpmaddwd with the coefficient pair (c[j], c[j + 1]) adds both products
+    of each channel into its int32 lane.
+ */
+TIMELINE_TARGET("avx2")
+static inline void fir_s16x8_avx(const int16_t *row, uint32_t ch, const int16_t *coef, uint32_t taps, int16_t *out) {
+    __m256i acc = _mm256_setzero_si256();
+    for (uint32_t j = 0; j < taps; j += 2, row += 2 * ch) {
+        __m128i a = _mm_loadu_si128((const __m128i*)row);
+        __m128i b = _mm_loadu_si128((const __m128i*)(row + ch));
+        __m256i x = _mm256_set_m128i(_mm_unpackhi_epi16(a, b), _mm_unpacklo_epi16(a, b));
+        int32_t pair;
+        memcpy(&pair, &coef[j], sizeof(pair));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(x, _mm256_set1_epi32(pair)));
+    }
+    acc = _mm256_srai_epi32(_mm256_add_epi32(acc, _mm256_set1_epi32(1 << (TIMELINE_POLYPHASE_COEF_BITS - 1))), TIMELINE_POLYPHASE_COEF_BITS);
+    _mm_storeu_si128((__m128i*)out, _mm_packs_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1)));
+}
+
+TIMELINE_TARGET("avx2")
+void polyphase_span_s16x8_avx(const int16_t *src, uint32_t nr_of_channels, const PolyphaseFilterBank *bank, SampleRatePhase *phase, int16_t *dst, uint32_t count) {
+    const uint32_t ch = nr_of_channels;
+    if (ch < 8) {
+        polyphase_span_s16x8_c(src, nr_of_channels, bank, phase, dst, count);
+        return;
+    }
+    uint32_t idx = phase->idx;
+    uint32_t accum = phase->accum;
+    for (uint32_t i = 0; i < count; ++i) {
+        const int16_t *coef = coeffs_PolyphaseFilterBank(bank, phase, accum);
+        const int16_t *row = &src[(size_t)idx * ch];
+        int16_t *out = &dst[(size_t)i * ch];
+        for (uint32_t c = 0; c < ch; c += 8) {
+            uint32_t g = (c + 8 <= ch) ? c : ch - 8;
+            fir_s16x8_avx(&row[g], ch, coef, bank->taps, &out[g]);
+        }
+        step_SampleRatePhase(phase, &idx, &accum);
+    }
+    phase->idx = idx;
+    phase->accum = accum;
+}
+
+/*
+    CIC pre-decimation (see cic_predecimate_s16x8_c), one 8-channel group at a time (overlapping last group):
+    the integrators and combs of the group stay in registers for the whole buffer.
+ */
+TIMELINE_TARGET("avx2")
+void cic_predecimate_s16x8_avx(const int16_t *src, uint32_t nr_of_channels, uint32_t nr_of_samples, uint32_t ratio_shift, int16_t *dst, uint32_t count) {
+    const uint32_t ch = nr_of_channels;
+    if (ch < 8) {
+        cic_predecimate_s16x8_c(src, nr_of_channels, nr_of_samples, ratio_shift, dst, count);
+        return;
+    }
+    const uint32_t ratio = 1u << ratio_shift;
+    const uint32_t shift = TIMELINE_POLYPHASE_CIC_STAGES * ratio_shift;
+    const uint32_t delay = TIMELINE_POLYPHASE_CIC_STAGES * (ratio - 1) / 2;
+    const __m256i round = _mm256_set1_epi32((shift > 0) ? 1 << (shift - 1) : 0);
+    const __m128i count_shift = _mm_cvtsi32_si128((int)shift);
+    for (uint32_t c = 0; c < ch; c += 8) {
+        const uint32_t g = (c + 8 <= ch) ? c : ch - 8;
+        const __m256i first = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)&src[g]));
+        __m256i integ[TIMELINE_POLYPHASE_CIC_STAGES];
+        __m256i comb[TIMELINE_POLYPHASE_CIC_STAGES];
+        for (uint32_t s = 0; s < TIMELINE_POLYPHASE_CIC_STAGES; ++s) {
+            integ[s] = _mm256_setzero_si256();
+            comb[s] = _mm256_setzero_si256();
+        }
+        const int16_t *row = &src[g];
+        const int16_t *last_row = &src[(size_t)(nr_of_samples - 1) * ch + g];
+        uint64_t v = 0;
+        for (int64_t j = -(int64_t)(delay / ratio); j < (int64_t)count; ++j) {
+            const uint64_t last = (uint64_t)(j * ratio + delay);
+            for (; v <= last; ++v) {
+                __m256i x = _mm256_sub_epi32(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)row)), first);
+                if (row != last_row) row += ch; // rows past the end repeat the last one
+                integ[0] = _mm256_add_epi32(integ[0], x);
+                for (uint32_t s = 1; s < TIMELINE_POLYPHASE_CIC_STAGES; ++s) {
+                    integ[s] = _mm256_add_epi32(integ[s], integ[s - 1]);
+                }
+            }
+            __m256i y = integ[TIMELINE_POLYPHASE_CIC_STAGES - 1];
+            for (uint32_t s = 0; s < TIMELINE_POLYPHASE_CIC_STAGES; ++s) {
+                __m256i d = _mm256_sub_epi32(y, comb[s]);
+                comb[s] = y;
+                y = d;
+            }
+            if (j >= 0) {
+                y = _mm256_add_epi32(first, _mm256_sra_epi32(_mm256_add_epi32(y, round), count_shift));
+                _mm_storeu_si128((__m128i*)&dst[(size_t)j * ch + g], _mm_packs_epi32(_mm256_castsi256_si128(y), _mm256_extracti128_si256(y, 1)));
+            }
+        }
+    }
+}
+
+/*
+    Big-endian 24-bit payload decoding, one block of 8 channels (24 bytes) per step.
+    Two overlapping 16-byte loads (bytes 0..15 and 8..23) cover the block without reading past it,
+    the channels are reordered with pshufb. A partial last block is done by the C version.
+ */
+TIMELINE_TARGET("avx2")
+int decode_be24_s16x8_avx(const uint8_t *payload, uint32_t nr_of_channels, uint8_t *dst, uint32_t dst_stride) {
+    // upper 16 bits of each value, as little-endian int16: out[2k] = in[3k + 1], out[2k + 1] = in[3k]
+    const __m128i idx_lo = _mm_setr_epi8(1, 0, 4, 3, 7, 6, 10, 9, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i idx_hi = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, 5, 4, 8, 7, 11, 10, 14, 13);
+    uint32_t full_blocks = nr_of_channels / 8;
+    for (uint32_t b = 0; b < full_blocks; ++b) {
+        const uint8_t *p = &payload[b * 24];
+        __m128i lo = _mm_loadu_si128((const __m128i*)p);
+        __m128i hi = _mm_loadu_si128((const __m128i*)(p + 8));
+        __m128i out = _mm_or_si128(_mm_shuffle_epi8(lo, idx_lo), _mm_shuffle_epi8(hi, idx_hi));
+        _mm_storeu_si128((__m128i*)&dst[b * dst_stride], out);
+    }
+    if (nr_of_channels % 8) {
+        decode_be24_s16x8_c(&payload[full_blocks * 24], nr_of_channels % 8, &dst[full_blocks * dst_stride], dst_stride);
+    }
+    return 0;
+}
+
+TIMELINE_TARGET("avx2")
+int decode_be24_s24x8_avx(const uint8_t *payload, uint32_t nr_of_channels, uint8_t *dst, uint32_t dst_stride) {
+    // byte order of every triplet reversed: out[3k + i] = in[3k + 2 - i]
+    const __m128i idx_a = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, -1, -1, -1, -1);
+    const __m128i idx_b = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 6, 5, 4, 9);
+    const __m128i idx_c = _mm_setr_epi8(8, 7, 12, 11, 10, 15, 14, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+    uint32_t full_blocks = nr_of_channels / 8;
+    for (uint32_t b = 0; b < full_blocks; ++b) {
+        const uint8_t *p = &payload[b * 24];
+        uint8_t *out = &dst[b * dst_stride];
+        __m128i lo = _mm_loadu_si128((const __m128i*)p);
+        __m128i hi = _mm_loadu_si128((const __m128i*)(p + 8));
+        _mm_storeu_si128((__m128i*)out, _mm_or_si128(_mm_shuffle_epi8(lo, idx_a), _mm_shuffle_epi8(hi, idx_b)));
+        _mm_storel_epi64((__m128i*)(out + 16), _mm_shuffle_epi8(hi, idx_c));
+    }
+    if (nr_of_channels % 8) {
+        decode_be24_s24x8_c(&payload[full_blocks * 24], nr_of_channels % 8, &dst[full_blocks * dst_stride], dst_stride);
+    }
+    return 0;
+}
+
+/*
+    Block codec: the 8 lanes of a group are the 8 int32 lanes of a register. Encoding computes the zigzag deltas of
+    the block row by row (the lane min / max of the values and of the deltas on the way), then packs the slots with
+    the same shift pair for all lanes. Decoding unpacks slot j with one or two shifts of the word vectors, undoes the
+    frame of reference and the zigzag, and adds it to the running row. Partial groups (< 8 lanes) go through a row copy.
+ */
+TIMELINE_TARGET("avx2")
+static inline __m256i codec_load_row_avx(const uint8_t *row, uint32_t nr_lanes, int is_s24) {
+    if (nr_lanes == 8) {
+        return is_s24 ? load_s24x8(row) : _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)row));
+    }
+    int32_t lanes[8] = { 0 };
+    for (uint32_t l = 0; l < nr_lanes; ++l) {
+        const uint8_t *p = &row[l * (is_s24 ? 3 : 2)];
+        lanes[l] = is_s24 ? (int32_t)((uint32_t)p[0] << 8 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 24) >> 8 : (int16_t)(p[0] | p[1] << 8);
+    }
+    return _mm256_loadu_si256((const __m256i*)lanes);
+}
+
+TIMELINE_TARGET("avx2")
+static inline void codec_store_row_avx(uint8_t *row, __m256i v, uint32_t nr_lanes, int is_s24) {
+    if (is_s24) {
+        // the low 3 bytes of every dword, 12 bytes per 128-bit lane
+        const __m256i pack24 = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                                0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+        __m256i p = _mm256_shuffle_epi8(v, pack24);
+        __m128i lo = _mm256_castsi256_si128(p);
+        __m128i hi = _mm256_extracti128_si256(p, 1);
+        if (nr_lanes == 8) {
+            uint32_t lo_tail = (uint32_t)_mm_extract_epi32(lo, 2), hi_tail = (uint32_t)_mm_extract_epi32(hi, 2);
+            _mm_storel_epi64((__m128i*)row, lo);
+            memcpy(row + 8, &lo_tail, 4);
+            _mm_storel_epi64((__m128i*)(row + 12), hi);
+            memcpy(row + 20, &hi_tail, 4);
+        } else {
+            uint8_t bytes[32];
+            _mm_storeu_si128((__m128i*)bytes, lo);
+            _mm_storeu_si128((__m128i*)(bytes + 12), hi);
+            memcpy(row, bytes, nr_lanes * 3);
+        }
+    } else {
+        __m128i p = _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packs_epi32(v, v), 0x08));
+        if (nr_lanes == 8) {
+            _mm_storeu_si128((__m128i*)row, p);
+        } else {
+            uint8_t bytes[16];
+            _mm_storeu_si128((__m128i*)bytes, p);
+            memcpy(row, bytes, nr_lanes * 2);
+        }
+    }
+}
+
+TIMELINE_TARGET("avx2")
+static uint32_t codec_encode_avx(const uint8_t *src, uint32_t src_stride, uint32_t nr_lanes, uint32_t count, uint8_t *dst, int is_s24) {
+    __m256i zz[TIMELINE_CODEC_BLOCK];
+    __m256i prev = codec_load_row_avx(src, nr_lanes, is_s24);
+    const __m256i first = prev;
+    __m256i vmin = prev, vmax = prev;
+    __m256i zmin = _mm256_set1_epi32(-1), zmax = _mm256_setzero_si256();
+    uint32_t j = 0;
+    for (; j + 1 < count; ++j) {
+        __m256i v = codec_load_row_avx(&src[(size_t)(j + 1) * src_stride], nr_lanes, is_s24);
+        __m256i d = _mm256_sub_epi32(v, prev);
+        __m256i z = _mm256_xor_si256(_mm256_slli_epi32(d, 1), _mm256_srai_epi32(d, 31));
+        zz[j] = z;
+        prev = v;
+        vmin = _mm256_min_epi32(vmin, v);
+        vmax = _mm256_max_epi32(vmax, v);
+        zmin = _mm256_min_epu32(zmin, z);
+        zmax = _mm256_max_epu32(zmax, z);
+    }
+    const __m256i fill = (count > 1) ? zz[count - 2] : _mm256_setzero_si256();
+    if (count < 2) zmin = _mm256_setzero_si256();
+    for (; j < TIMELINE_CODEC_BLOCK; ++j) {
+        zz[j] = fill;
+    }
+    // common width: the widest lane range, OR-reduced over the 8 lanes
+    __m256i r = _mm256_sub_epi32(zmax, zmin);
+    __m128i r4 = _mm_or_si128(_mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1));
+    r4 = _mm_or_si128(r4, _mm_shuffle_epi32(r4, 0x4e));
+    r4 = _mm_or_si128(r4, _mm_shuffle_epi32(r4, 0xb1));
+    const uint32_t width = bit_width_u32((uint32_t)_mm_cvtsi128_si32(r4));
+
+    TimelineCodecGroupHeader *h = (TimelineCodecGroupHeader*)dst;
+    _mm256_storeu_si256((__m256i*)h->first, first);
+    _mm256_storeu_si256((__m256i*)h->min, vmin);
+    _mm256_storeu_si256((__m256i*)h->max, vmax);
+    _mm256_storeu_si256((__m256i*)h->base, zmin);
+    h->width = width;
+    __m256i *words = (__m256i*)(dst + sizeof(TimelineCodecGroupHeader));
+    const uint32_t nr_words = TIMELINE_CODEC_BLOCK * width / 32;
+    __m256i acc = _mm256_setzero_si256();
+    uint32_t w = 0, shift = 0;
+    for (j = 0; width > 0 && j < TIMELINE_CODEC_BLOCK; ++j) {
+        __m256i v = _mm256_sub_epi32(zz[j], zmin);
+        acc = _mm256_or_si256(acc, _mm256_sll_epi32(v, _mm_cvtsi32_si128((int)shift)));
+        shift += width;
+        if (shift >= 32) {
+            _mm256_storeu_si256(&words[w++], acc);
+            shift -= 32;
+            // the high bits of v that did not fit (none when the slot ended exactly at the word boundary)
+            acc = shift ? _mm256_srl_epi32(v, _mm_cvtsi32_si128((int)(width - shift))) : _mm256_setzero_si256();
+        }
+    }
+    if (w < nr_words) {
+        _mm256_storeu_si256(&words[w], acc);
+    }
+    return TIMELINE_CODEC_GROUP_BYTES(width);
+}
+
+TIMELINE_TARGET("avx2")
+static uint32_t codec_decode_avx(const uint8_t *src, uint32_t nr_lanes, uint32_t count, uint8_t *dst, uint32_t dst_stride, int is_s24) {
+    const TimelineCodecGroupHeader *h = (const TimelineCodecGroupHeader*)src;
+    const __m256i *words = (const __m256i*)(src + sizeof(TimelineCodecGroupHeader));
+    const uint32_t width = h->width;
+    const __m256i mask = _mm256_set1_epi32((width >= 32) ? -1 : (int)((1u << width) - 1));
+    const __m256i base = _mm256_loadu_si256((const __m256i*)h->base);
+    const __m256i one = _mm256_set1_epi32(1);
+    __m256i acc = _mm256_loadu_si256((const __m256i*)h->first);
+    __m256i cur = (width > 0) ? _mm256_loadu_si256(&words[0]) : _mm256_setzero_si256();
+    uint32_t w = 0, shift = 0;
+    for (uint32_t j = 0; j < count; ++j) {
+        codec_store_row_avx(&dst[(size_t)j * dst_stride], acc, nr_lanes, is_s24);
+        __m256i v = _mm256_srl_epi32(cur, _mm_cvtsi32_si128((int)shift));
+        shift += width;
+        if (shift >= 32 && j + 1 < count) {
+            shift -= 32;
+            cur = _mm256_loadu_si256(&words[++w]);
+            if (shift) v = _mm256_or_si256(v, _mm256_sll_epi32(cur, _mm_cvtsi32_si128((int)(width - shift))));
+        }
+        __m256i z = _mm256_add_epi32(_mm256_and_si256(v, mask), base);
+        __m256i d = _mm256_xor_si256(_mm256_srli_epi32(z, 1), _mm256_sub_epi32(_mm256_setzero_si256(), _mm256_and_si256(z, one)));
+        acc = _mm256_add_epi32(acc, d);
+    }
+    return TIMELINE_CODEC_GROUP_BYTES(width);
+}
+
+TIMELINE_TARGET("avx2")
+uint32_t codec_encode_s16x8_avx(const uint8_t *src, uint32_t src_stride, uint32_t nr_lanes, uint32_t count, uint8_t *dst) {
+    return codec_encode_avx(src, src_stride, nr_lanes, count, dst, 0);
+}
+
+TIMELINE_TARGET("avx2")
+uint32_t codec_encode_s24x8_avx(const uint8_t *src, uint32_t src_stride, uint32_t nr_lanes, uint32_t count, uint8_t *dst) {
+    return codec_encode_avx(src, src_stride, nr_lanes, count, dst, 1);
+}
+
+TIMELINE_TARGET("avx2")
+uint32_t codec_decode_s16x8_avx(const uint8_t *src, uint32_t nr_lanes, uint32_t count, uint8_t *dst, uint32_t dst_stride) {
+    return codec_decode_avx(src, nr_lanes, count, dst, dst_stride, 0);
+}
+
+TIMELINE_TARGET("avx2")
+uint32_t codec_decode_s24x8_avx(const uint8_t *src, uint32_t nr_lanes, uint32_t count, uint8_t *dst, uint32_t dst_stride) {
+    return codec_decode_avx(src, nr_lanes, count, dst, dst_stride, 1);
+}
+
+/*
+    Planar transposes: blocks of 8 samples x 8 channels. 16-bit: the 8 rows are 8 xmm registers, three rounds of
+    unpack (16, 32, 64-bit) turn them into the 8 channel vectors. 24-bit: the rows are expanded to int32 (load_s24x8),
+    transposed with unpack 32 / 64 and a 128-bit lane permute, and packed back to 3 bytes. An 8 x 8 transpose is its
+    own inverse, so both directions use the same block, only the strides differ. Tails (< 8 samples or lanes) are C.
+ */
+TIMELINE_TARGET("avx2")
+static inline void transpose8x8_epi16_avx(__m128i r[8]) {
+    __m128i a0 = _mm_unpacklo_epi16(r[0], r[1]), a1 = _mm_unpackhi_epi16(r[0], r[1]);
+    __m128i a2 = _mm_unpacklo_epi16(r[2], r[3]), a3 = _mm_unpackhi_epi16(r[2], r[3]);
+    __m128i a4 = _mm_unpacklo_epi16(r[4], r[5]), a5 = _mm_unpackhi_epi16(r[4], r[5]);
+    __m128i a6 = _mm_unpacklo_epi16(r[6], r[7]), a7 = _mm_unpackhi_epi16(r[6], r[7]);
+    __m128i b0 = _mm_unpacklo_epi32(a0, a2), b1 = _mm_unpackhi_epi32(a0, a2);
+    __m128i b2 = _mm_unpacklo_epi32(a1, a3), b3 = _mm_unpackhi_epi32(a1, a3);
+    __m128i b4 = _mm_unpacklo_epi32(a4, a6), b5 = _mm_unpackhi_epi32(a4, a6);
+    __m128i b6 = _mm_unpacklo_epi32(a5, a7), b7 = _mm_unpackhi_epi32(a5, a7);
+    r[0] = _mm_unpacklo_epi64(b0, b4);
+    r[1] = _mm_unpackhi_epi64(b0, b4);
+    r[2] = _mm_unpacklo_epi64(b1, b5);
+    r[3] = _mm_unpackhi_epi64(b1, b5);
+    r[4] = _mm_unpacklo_epi64(b2, b6);
+    r[5] = _mm_unpackhi_epi64(b2, b6);
+    r[6] = _mm_unpacklo_epi64(b3, b7);
+    r[7] = _mm_unpackhi_epi64(b3, b7);
+}
+
+TIMELINE_TARGET("avx2")
+static inline void transpose8x8_epi32_avx(__m256i r[8]) {
+    __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]), t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+    __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]), t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+    __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]), t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+    __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]), t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+    __m256i u0 = _mm256_unpacklo_epi64(t0, t2), u1 = _mm256_unpackhi_epi64(t0, t2);
+    __m256i u2 = _mm256_unpacklo_epi64(t1, t3), u3 = _mm256_unpackhi_epi64(t1, t3);
+    __m256i u4 = _mm256_unpacklo_epi64(t4, t6), u5 = _mm256_unpackhi_epi64(t4, t6);
+    __m256i u6 = _mm256_unpacklo_epi64(t5, t7), u7 = _mm256_unpackhi_epi64(t5, t7);
+    r[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+    r[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+    r[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+    r[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+    r[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+    r[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+    r[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+    r[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+// 8 vectors of 8 values at src + k * src_stride -> 8 vectors at dst + k * dst_stride, transposed
+TIMELINE_TARGET("avx2")
+static void transpose_blocks_avx(const uint8_t *src, uint32_t src_stride, uint32_t src_step,
+    uint8_t *dst, uint32_t dst_stride, uint32_t dst_step, uint32_t nr_blocks, int is_s24) {
+    for (uint32_t b = 0; b < nr_blocks; ++b) {
+        const uint8_t *s = &src[(size_t)b * src_step];
+        uint8_t *d = &dst[(size_t)b * dst_step];
+        if (is_s24) {
+            __m256i r[8];
+            for (int k = 0; k < 8; ++k) r[k] = load_s24x8(&s[(size_t)k * src_stride]);
+            transpose8x8_epi32_avx(r);
+            for (int k = 0; k < 8; ++k) codec_store_row_avx(&d[(size_t)k * dst_stride], r[k], 8, 1);
+        } else {
+            __m128i r[8];
+            for (int k = 0; k < 8; ++k) r[k] = _mm_loadu_si128((const __m128i*)&s[(size_t)k * src_stride]);
+            transpose8x8_epi16_avx(r);
+            for (int k = 0; k < 8; ++k) _mm_storeu_si128((__m128i*)&d[(size_t)k * dst_stride], r[k]);
+        }
+    }
+}
+
+TIMELINE_TARGET("avx2")
+void transpose_to_planar_s16x8_avx(const uint8_t *src, uint32_t src_stride, uint8_t *dst, uint32_t dst_stride, uint32_t nr_lanes, uint32_t count) {
+    if (nr_lanes < 8) {
+        transpose_to_planar_s16x8_c(src, src_stride, dst, dst_stride, nr_lanes, count);
+        return;
+    }
+    const uint32_t blocks = count / 8;
+    transpose_blocks_avx(src, src_stride, 8 * src_stride, dst, dst_stride, 16, blocks, 0);
+    transpose_to_planar_s16x8_c(&src[(size_t)blocks * 8 * src_stride], src_stride, &dst[(size_t)blocks * 16], dst_stride, 8, count % 8);
+}
+
+TIMELINE_TARGET("avx2")
+void transpose_to_planar_s24x8_avx(const uint8_t *src, uint32_t src_stride, uint8_t *dst, uint32_t dst_stride, uint32_t nr_lanes, uint32_t count) {
+    if (nr_lanes < 8) {
+        transpose_to_planar_s24x8_c(src, src_stride, dst, dst_stride, nr_lanes, count);
+        return;
+    }
+    const uint32_t blocks = count / 8;
+    transpose_blocks_avx(src, src_stride, 8 * src_stride, dst, dst_stride, 24, blocks, 1);
+    transpose_to_planar_s24x8_c(&src[(size_t)blocks * 8 * src_stride], src_stride, &dst[(size_t)blocks * 24], dst_stride, 8, count % 8);
+}
+
+TIMELINE_TARGET("avx2")
+void transpose_from_planar_s16x8_avx(const uint8_t *src, uint32_t src_stride, uint8_t *dst, uint32_t dst_stride, uint32_t nr_lanes, uint32_t count) {
+    if (nr_lanes < 8) {
+        transpose_from_planar_s16x8_c(src, src_stride, dst, dst_stride, nr_lanes, count);
+        return;
+    }
+    const uint32_t blocks = count / 8;
+    transpose_blocks_avx(src, src_stride, 16, dst, dst_stride, 8 * dst_stride, blocks, 0);
+    transpose_from_planar_s16x8_c(&src[(size_t)blocks * 16], src_stride, &dst[(size_t)blocks * 8 * dst_stride], dst_stride, 8, count % 8);
+}
+
+TIMELINE_TARGET("avx2")
+void transpose_from_planar_s24x8_avx(const uint8_t *src, uint32_t src_stride, uint8_t *dst, uint32_t dst_stride, uint32_t nr_lanes, uint32_t count) {
+    if (nr_lanes < 8) {
+        transpose_from_planar_s24x8_c(src, src_stride, dst, dst_stride, nr_lanes, count);
+        return;
+    }
+    const uint32_t blocks = count / 8;
+    transpose_blocks_avx(src, src_stride, 24, dst, dst_stride, 8 * dst_stride, blocks, 1);
+    transpose_from_planar_s24x8_c(&src[(size_t)blocks * 24], src_stride, &dst[(size_t)blocks * 8 * dst_stride], dst_stride, 8, count % 8);
+}
+
+// ---- AVX2 Backend Global Instance for the virtual funtion table ----
+const TimelineBackendFunctions gTimelineBackendFunctionsAVX2 = {
+    .name = "Intel AVX2 SIMD Backend",
+    .convert_sample_rate_s16x8 = convert_sample_rate_SIMD_s16x8_bresenham_avx,
+    .aggregate_minmax_s8 = aggregate_minmax_s8_c, // AVX2 fallback
+    .aggregate_minmax_s16x8 = aggregate_minmax_SIMD_s16x8_avx,
+    .aggregate_minmax_s24x8 = aggregate_minmax_SIMD_s24x8_avx,
+    .decode_be24_s16x8 = decode_be24_s16x8_avx,
+    .decode_be24_s24x8 = decode_be24_s24x8_avx,
+    .resample_span_s16x8 = resample_span_s16x8_avx,
+    .polyphase_span_s16x8 = polyphase_span_s16x8_avx,
+    .cic_predecimate_s16x8 = cic_predecimate_s16x8_avx,
+    .resample_minmax_s16x8 = resample_minmax_s16x8_avx,
+    .aggregate_stats_s8 = aggregate_stats_s8_avx,
+    .aggregate_stats_s16x8 = aggregate_stats_s16x8_avx,
+    .aggregate_stats_s24x8 = aggregate_stats_s24x8_avx,
+    .codec_encode_s16x8 = codec_encode_s16x8_avx,
+    .codec_encode_s24x8 = codec_encode_s24x8_avx,
+    .codec_decode_s16x8 = codec_decode_s16x8_avx,
+    .codec_decode_s24x8 = codec_decode_s24x8_avx,
+    .transpose_to_planar_s16x8 = transpose_to_planar_s16x8_avx,
+    .transpose_to_planar_s24x8 = transpose_to_planar_s24x8_avx,
+    .transpose_from_planar_s16x8 = transpose_from_planar_s16x8_avx,
+    .transpose_from_planar_s24x8 = transpose_from_planar_s24x8_avx,
+};
+#endif
@@ -0,0 +1,712 @@
+/*
+    File: timelinedb_simd_avx512.c
+    This file implements the Intel AVX-512 (F + BW) variant of the sample rate conversion and aggregation functions.
+    The functions are compiled with target attributes like the AVX2 variant, and this backend is registered only when
+    the CPU reports AVX512F and AVX512BW and the OS saves the ZMM state (see init_TimelineBackendRegistry).
+    Author: Barna Farago - MYND-Ideal kft.
+    Date: 2025-07-01
+    License: Modified MIT License. You can use it for learn, but I can sell it as closed source with some improvements...
+*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "timelinedb_simd.h"
+
+#if defined(AVX_ENABLED)
+#include <immintrin.h>
+
+#define TIMELINE_TARGET_AVX512 TIMELINE_TARGET("avx512f,avx512bw")
+
+/*
+    Channel counts other than 8: 32-channel groups, one row per 512-bit register (row stride = channels). The last group is
+    loaded with a lane mask (masked off lanes are zero and never stored), the result is written with a masked store.
+    When the channel count divides 32 (e.g. 16), the rows are scanned as one contiguous run and the lanes are folded
+    into the channels at the end, like the s8 kernel does, so no lane is wasted.
+ */
+TIMELINE_TARGET_AVX512
+static void aggregate_minmax_s16_groups_avx512(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t i, uint32_t start, uint32_t end) {
+    const uint32_t ch = input->nr_of_channels;
+    const int16_t *src = (const int16_t*)input->valueBuffer;
+    int16_t *dmin = &((int16_t*)outMin->valueBuffer)[i * ch];
+    int16_t *dmax = &((int16_t*)outMax->valueBuffer)[i * ch];
+    if (32 % ch == 0) {
+        const int16_t *p = &src[(size_t)start * ch];
+        uint32_t left = (end - start) * ch;
+        __m512i min0 = _mm512_set1_epi16(INT16_MAX);
+        __m512i max0 = _mm512_set1_epi16(INT16_MIN);
+        __m512i min1 = min0;
+        __m512i max1 = max0;
+        for (; left >= 64; left -= 64, p += 64) {
+            __m512i s0 = _mm512_loadu_si512(p);
+            __m512i s1 = _mm512_loadu_si512(p + 32);
+            min0 = _mm512_min_epi16(min0, s0);
+            max0 = _mm512_max_epi16(max0, s0);
+            min1 = _mm512_min_epi16(min1, s1);
+            max1 = _mm512_max_epi16(max1, s1);
+        }
+        if (left >= 32) {
+            __m512i s0 = _mm512_loadu_si512(p);
+            min0 = _mm512_min_epi16(min0, s0);
+            max0 = _mm512_max_epi16(max0, s0);
+            left -= 32;
+            p += 32;
+        }
+        if (left) {
+            __mmask32 k = (__mmask32)((1u << left) - 1);
+            __m512i s0 = _mm512_maskz_loadu_epi16(k, p);
+            min1 = _mm512_mask_min_epi16(min1, k, min1, s0);
+            max1 = _mm512_mask_max_epi16(max1, k, max1, s0);
+        }
+        int16_t lane_min[32], lane_max[32];
+        _mm512_storeu_si512(lane_min, _mm512_min_epi16(min0, min1));
+        _mm512_storeu_si512(lane_max, _mm512_max_epi16(max0, max1));
+        for (uint32_t c = 0; c < ch; ++c) {
+            dmin[c] = INT16_MAX;
+            dmax[c] = INT16_MIN;
+        }
+        for (uint32_t l = 0; l < 32; ++l) {
+            uint32_t c = l % ch;
+            if (lane_min[l] < dmin[c]) dmin[c] = lane_min[l];
+            if (lane_max[l] > dmax[c]) dmax[c] = lane_max[l];
+        }
+        return;
+    }
+    for (uint32_t g = 0; g < ch; g += 32) {
+        const uint32_t lanes = (ch - g < 32) ? ch - g : 32;
+        const __mmask32 k = (lanes == 32) ? 0xFFFFFFFFu : (__mmask32)((1u << lanes) - 1);
+        const int16_t *p = &src[(size_t)start * ch + g];
+        __m512i min0 = _mm512_set1_epi16(INT16_MAX);
+        __m512i max0 = _mm512_set1_epi16(INT16_MIN);
+        __m512i min1 = min0;
+        __m512i max1 = max0;
+        uint32_t j = start;
+        for (; j + 2 <= end; j += 2, p += 2 * ch) {
+            __m512i s0 = _mm512_maskz_loadu_epi16(k, p);
+            __m512i s1 = _mm512_maskz_loadu_epi16(k, p + ch);
+            min0 = _mm512_min_epi16(min0, s0);
+            max0 = _mm512_max_epi16(max0, s0);
+            min1 = _mm512_min_epi16(min1, s1);
+            max1 = _mm512_max_epi16(max1, s1);
+        }
+        if (j < end) {
+            __m512i s0 = _mm512_maskz_loadu_epi16(k, p);
+            min0 = _mm512_min_epi16(min0, s0);
+            max0 = _mm512_max_epi16(max0, s0);
+        }
+        _mm512_mask_storeu_epi16(&dmin[g], k, _mm512_min_epi16(min0, min1));
+        _mm512_mask_storeu_epi16(&dmax[g], k, _mm512_max_epi16(max0, max1));
+    }
+}
+
+/*
+    Vertical min/max of 8 x int16 samples: a 512-bit register holds 4 samples of all 8 channels.
+    16 samples per iteration with two accumulator pairs, then 4 at a time, the remaining 1..3 samples
+    are loaded with a mask. The 4 samples of the register are folded only once at the end.
+ */
+TIMELINE_TARGET_AVX512
+int aggregate_minmax_SIMD_s16x8_avx512(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t i, uint32_t start, uint32_t end) {
+    if (input->nr_of_channels == 0) {
+        return 0;
+    }
+    if (end > input->nr_of_samples) end = input->nr_of_samples;
+    if (input->nr_of_channels != 8) {
+        aggregate_minmax_s16_groups_avx512(input, outMin, outMax, i, start, end);
+        return 0;
+    }
+    const int16_t *src = (const int16_t*)input->valueBuffer;
+    __m512i min0 = _mm512_set1_epi16(INT16_MAX);
+    __m512i max0 = _mm512_set1_epi16(INT16_MIN);
+    __m512i min1 = min0;
+    __m512i max1 = max0;
+
+    uint32_t j = start;
+    for (; j + 16 <= end; j += 16) {
+        const int16_t *p = &src[j * 8];
+        __m512i s0 = _mm512_loadu_si512(p);
+        __m512i s1 = _mm512_loadu_si512(p + 32);
+        __m512i s2 = _mm512_loadu_si512(p + 64);
+        __m512i s3 = _mm512_loadu_si512(p + 96);
+        min0 = _mm512_min_epi16(min0, _mm512_min_epi16(s0, s1));
+        max0 = _mm512_max_epi16(max0, _mm512_max_epi16(s0, s1));
+        min1 = _mm512_min_epi16(min1, _mm512_min_epi16(s2, s3));
+        max1 = _mm512_max_epi16(max1, _mm512_max_epi16(s2, s3));
+    }
+    for (; j + 4 <= end; j += 4) {
+        __m512i s0 = _mm512_loadu_si512(&src[j * 8]);
+        min0 = _mm512_min_epi16(min0, s0);
+        max0 = _mm512_max_epi16(max0, s0);
+    }
+    if (j < end) {
+        __mmask32 k = (__mmask32)((1u << ((end - j) * 8)) - 1);
+        __m512i s0 = _mm512_maskz_loadu_epi16(k, &src[j * 8]);
+        min1 = _mm512_mask_min_epi16(min1, k, min1, s0);
+        max1 = _mm512_mask_max_epi16(max1, k, max1, s0);
+    }
+    min0 = _mm512_min_epi16(min0, min1);
+    max0 = _mm512_max_epi16(max0, max1);
+    // fold 4 samples -> 2 -> 1
+    __m256i min256 = _mm256_min_epi16(_mm512_castsi512_si256(min0), _mm512_extracti64x4_epi64(min0, 1));
+    __m256i max256 = _mm256_max_epi16(_mm512_castsi512_si256(max0), _mm512_extracti64x4_epi64(max0, 1));
+    __m128i min_s16 = _mm_min_epi16(_mm256_castsi256_si128(min256), _mm256_extracti128_si256(min256, 1));
+    __m128i max_s16 = _mm_max_epi16(_mm256_castsi256_si128(max256), _mm256_extracti128_si256(max256, 1));
+    _mm_storeu_si128((__m128i*)&((int16_t*)outMin->valueBuffer)[i * 8], min_s16);
+    _mm_storeu_si128((__m128i*)&((int16_t*)outMax->valueBuffer)[i * 8], max_s16);
+    return 0;
+}
+
+/*
+    Min/max of interleaved int8 samples. When the channel count divides 64, every byte lane of a 512-bit load
+    belongs to the same channel (lane % ch), so the scan is vertical and the lanes are folded once per column.
+    Other channel counts use the C version.
+ */
+TIMELINE_TARGET_AVX512
+int aggregate_minmax_s8_avx512(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t i, uint32_t start, uint32_t end) {
+    uint32_t ch = input->nr_of_channels;
+    if (ch == 0 || 64 % ch != 0 || input->bytes_per_sample != ch || end > input->nr_of_samples) {
+        return aggregate_minmax_s8_c(input, outMin, outMax, i, start, end);
+    }
+    const int8_t *src = (const int8_t*)input->valueBuffer;
+    __m512i min0 = _mm512_set1_epi8(INT8_MAX);
+    __m512i max0 = _mm512_set1_epi8(INT8_MIN);
+    __m512i min1 = min0;
+    __m512i max1 = max0;
+
+    const uint32_t first = start * ch;
+    const uint32_t last = end * ch;
+    uint32_t b = first;
+    for (; b + 128 <= last; b += 128) {
+        __m512i s0 = _mm512_loadu_si512(&src[b]);
+        __m512i s1 = _mm512_loadu_si512(&src[b + 64]);
+        min0 = _mm512_min_epi8(min0, s0);
+        max0 = _mm512_max_epi8(max0, s0);
+        min1 = _mm512_min_epi8(min1, s1);
+        max1 = _mm512_max_epi8(max1, s1);
+    }
+    if (b + 64 <= last) {
+        __m512i s0 = _mm512_loadu_si512(&src[b]);
+        min0 = _mm512_min_epi8(min0, s0);
+        max0 = _mm512_max_epi8(max0, s0);
+        b += 64;
+    }
+    if (b < last) {
+        __mmask64 k = (__mmask64)((1ull << (last - b)) - 1);
+        __m512i s0 = _mm512_maskz_loadu_epi8(k, &src[b]);
+        min1 = _mm512_mask_min_epi8(min1, k, min1, s0);
+        max1 = _mm512_mask_max_epi8(max1, k, max1, s0);
+    }
+    min0 = _mm512_min_epi8(min0, min1);
+    max0 = _mm512_max_epi8(max0, max1);
+
+    // Lane l holds channel (first + l) % ch, fold the 64 lanes into the channels once per column
+    int8_t lane_min[64], lane_max[64];
+    _mm512_storeu_si512(lane_min, min0);
+    _mm512_storeu_si512(lane_max, max0);
+    int8_t *dmin = &((int8_t*)outMin->valueBuffer)[i * ch];
+    int8_t *dmax = &((int8_t*)outMax->valueBuffer)[i * ch];
+    for (uint32_t c = 0; c < ch; ++c) {
+        dmin[c] = INT8_MAX;
+        dmax[c] = INT8_MIN;
+    }
+    for (uint32_t l = 0; l < 64; ++l) {
+        uint32_t c = (first + l) % ch;
+        if (lane_min[l] < dmin[c]) dmin[c] = lane_min[l];
+        if (lane_max[l] > dmax[c]) dmax[c] = lane_max[l];
+    }
+    return 0;
+}
+
+/*
+    Min/max of 8 x 24-bit samples (24 bytes per sample), output downscaled to int8 (>> 16) like the C version.
+    Two samples (48 bytes = 12 dwords) are expanded per step: a dword permute moves 3 dwords (4 packed values) into each
+    128-bit lane, a byte shuffle places every 24-bit value into the top 3 bytes of a dword, and an arithmetic
+    shift right by 8 sign-extends it.
+ */
+TIMELINE_TARGET_AVX512
+static inline __m512i expand_s24x16(__m512i raw) {
+    const __m512i dword_idx = _mm512_set_epi32(0, 11, 10, 9, 0, 8, 7, 6, 0, 5, 4, 3, 0, 2, 1, 0);
+    const __m512i byte_idx = _mm512_broadcast_i32x4(_mm_set_epi8(11, 10, 9, -1, 8, 7, 6, -1, 5, 4, 3, -1, 2, 1, 0, -1));
+    __m512i lanes = _mm512_permutexvar_epi32(dword_idx, raw);
+    return _mm512_srai_epi32(_mm512_shuffle_epi8(lanes, byte_idx), 8);
+}
+
+TIMELINE_TARGET_AVX512
+static inline __m512i load_s24x8_pair(const uint8_t *p, __mmask16 k) {
+    return expand_s24x16(_mm512_maskz_loadu_epi32(k, p));
+}
+
+/*
+    Other channel counts: 16 consecutive 24-bit channels (48 bytes) of one row are expanded the same way as two 8-channel
+    samples. The last group is loaded with a byte mask, its lanes beyond the channel count are not stored.
+ */
+TIMELINE_TARGET_AVX512
+static void aggregate_minmax_s24_groups_avx512(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t i, uint32_t start, uint32_t end) {
+    const uint32_t ch = input->nr_of_channels;
+    const uint32_t row = ch * 3;
+    const uint8_t *src = (const uint8_t*)input->valueBuffer;
+    for (uint32_t g = 0; g < ch; g += 16) {
+        const uint32_t lanes = (ch - g < 16) ? ch - g : 16;
+        const __mmask64 k = (1ull << (lanes * 3)) - 1;
+        const uint8_t *p = &src[(size_t)start * row + g * 3];
+        __m512i min0 = _mm512_set1_epi32(INT32_MAX);
+        __m512i max0 = _mm512_set1_epi32(INT32_MIN);
+        __m512i min1 = min0;
+        __m512i max1 = max0;
+        uint32_t j = start;
+        for (; j + 2 <= end; j += 2, p += 2 * row) {
+            __m512i s0 = expand_s24x16(_mm512_maskz_loadu_epi8(k, p));
+            __m512i s1 = expand_s24x16(_mm512_maskz_loadu_epi8(k, p + row));
+            min0 = _mm512_min_epi32(min0, s0);
+            max0 = _mm512_max_epi32(max0, s0);
+            min1 = _mm512_min_epi32(min1, s1);
+            max1 = _mm512_max_epi32(max1, s1);
+        }
+        if (j < end) {
+            __m512i s0 = expand_s24x16(_mm512_maskz_loadu_epi8(k, p));
+            min0 = _mm512_min_epi32(min0, s0);
+            max0 = _mm512_max_epi32(max0, s0);
+        }
+        // Downscale from 24-bit to 8-bit (>>16) and narrow, only the valid lanes are stored
+        __m128i vmin = _mm512_cvtepi32_epi8(_mm512_srai_epi32(_mm512_min_epi32(min0, min1), 16));
+        __m128i vmax = _mm512_cvtepi32_epi8(_mm512_srai_epi32(_mm512_max_epi32(max0, max1), 16));
+        const __mmask64 kout = (1ull << lanes) - 1;
+        _mm512_mask_storeu_epi8(&((int8_t*)outMin->valueBuffer)[i * ch + g], kout, _mm512_castsi128_si512(vmin));
+        _mm512_mask_storeu_epi8(&((int8_t*)outMax->valueBuffer)[i * ch + g], kout, _mm512_castsi128_si512(vmax));
+    }
+}
+
+TIMELINE_TARGET_AVX512
+int aggregate_minmax_SIMD_s24x8_avx512(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t i, uint32_t start, uint32_t end) {
+    if (input->nr_of_channels == 0 || input->bytes_per_sample != input->nr_of_channels * 3) {
+        return aggregate_minmax_SIMD_s24x8_c(input, outMin, outMax, i, start, end);
+    }
+    if (end > input->nr_of_samples) end = input->nr_of_samples;
+    if (input->nr_of_channels != 8) {
+        aggregate_minmax_s24_groups_avx512(input, outMin, outMax, i, start, end);
+        return 0;
+    }
+    const uint8_t *src = (const uint8_t*)input->valueBuffer;
+    __m512i min0 = _mm512_set1_epi32(INT32_MAX);
+    __m512i max0 = _mm512_set1_epi32(INT32_MIN);
+    __m512i min1 = min0;
+    __m512i max1 = max0;
+
+    uint32_t j = start;
+    for (; j + 4 <= end; j += 4) {
+        __m512i s0 = load_s24x8_pair(&src[j * 24], 0x0FFF);
+        __m512i s1 = load_s24x8_pair(&src[j * 24 + 48], 0x0FFF);
+        min0 = _mm512_min_epi32(min0, s0);
+        max0 = _mm512_max_epi32(max0, s0);
+        min1 = _mm512_min_epi32(min1, s1);
+        max1 = _mm512_max_epi32(max1, s1);
+    }
+    for (; j + 2 <= end; j += 2) {
+        __m512i s0 = load_s24x8_pair(&src[j * 24], 0x0FFF);
+        min0 = _mm512_min_epi32(min0, s0);
+        max0 = _mm512_max_epi32(max0, s0);
+    }
+    if (j < end) {
+        // one sample left: 6 dwords, only the lower 8 lanes are valid
+        __m512i s0 = load_s24x8_pair(&src[j * 24], 0x003F);
+        min1 = _mm512_mask_min_epi32(min1, 0x00FF, min1, s0);
+        max1 = _mm512_mask_max_epi32(max1, 0x00FF, max1, s0);
+    }
+    min0 = _mm512_min_epi32(min0, min1);
+    max0 = _mm512_max_epi32(max0, max1);
+    __m256i min256 = _mm256_min_epi32(_mm512_castsi512_si256(min0), _mm512_extracti64x4_epi64(min0, 1));
+    __m256i max256 = _mm256_max_epi32(_mm512_castsi512_si256(max0), _mm512_extracti64x4_epi64(max0, 1));
+    int32_t vmin[8], vmax[8];
+    _mm256_storeu_si256((__m256i*)vmin, min256);
+    _mm256_storeu_si256((__m256i*)vmax, max256);
+    // Downscale from 24-bit to 8-bit (>>16)
+    for (uint32_t c = 0; c < 8; ++c) {
+        ((int8_t*)outMin->valueBuffer)[i * 8 + c] = (int8_t)(vmin[c] >> 16);
+        ((int8_t*)outMax->valueBuffer)[i * 8 + c] = (int8_t)(vmax[c] >> 16);
+    }
+    return 0;
+}
+
+/*
+    Statistics (sum, sum of squares, min, max) in masked 16-channel groups, every row of a group is widened to
+    16 int32 lanes. Below 16 channels the AVX2 kernels are used (a 16-lane group would be mostly masked off).
+    The narrow accumulators are flushed every TIMELINE_STATS_BLOCK rows, only the valid lanes are written.
+ */
+TIMELINE_TARGET_AVX512
+static void store_stats_group_avx512(TimelineChannelSums *sums, uint32_t lanes, __m512i sum_lo, __m512i sum_hi, __m512i min0, __m512i max0) {
+    int64_t sum[16];
+    int32_t vmin[16], vmax[16];
+    _mm512_storeu_si512(sum, sum_lo);
+    _mm512_storeu_si512(&sum[8], sum_hi);
+    _mm512_storeu_si512(vmin, min0);
+    _mm512_storeu_si512(vmax, max0);
+    for (uint32_t k = 0; k < lanes; ++k) {
+        sums[k].sum = sum[k];
+        sums[k].min = vmin[k];
+        sums[k].max = vmax[k];
+    }
+}
+
+TIMELINE_TARGET_AVX512
+int aggregate_stats_s16x8_avx512(const RawTimelineValuesBuf *input, uint32_t start, uint32_t end, TimelineChannelSums *sums) {
+    const uint32_t ch = input->nr_of_channels;
+    if (ch < 16) {
+        return aggregate_stats_s16x8_avx(input, start, end, sums);
+    }
+    if (end > input->nr_of_samples) end = input->nr_of_samples;
+    init_TimelineChannelSums(sums, ch);
+    const int16_t *src = (const int16_t*)input->valueBuffer;
+    for (uint32_t g = 0; g < ch; g += 16) {
+        const uint32_t lanes = (ch - g < 16) ? ch - g : 16;
+        const __mmask32 k = (__mmask32)((1u << lanes) - 1);
+        const int16_t *p = &src[(size_t)start * ch + g];
+        __m512i sum_lo = _mm512_setzero_si512(); // int64: channels 0..7
+        __m512i sum_hi = _mm512_setzero_si512(); // int64: channels 8..15
+        __m512i sq_lo = _mm512_setzero_si512();  // uint64, squares < 2^30: no overflow for 2^32 rows
+        __m512i sq_hi = _mm512_setzero_si512();
+        __m512i min0 = _mm512_set1_epi32(INT32_MAX);
+        __m512i max0 = _mm512_set1_epi32(INT32_MIN);
+        uint32_t j = start;
+        while (j < end) {
+            const uint32_t block_end = (end - j > TIMELINE_STATS_BLOCK) ? j + TIMELINE_STATS_BLOCK : end;
+            __m512i sum32 = _mm512_setzero_si512();
+            for (; j < block_end; ++j, p += ch) {
+                __m512i v = _mm512_cvtepi16_epi32(_mm512_castsi512_si256(_mm512_maskz_loadu_epi16(k, p)));
+                min0 = _mm512_min_epi32(min0, v);
+                max0 = _mm512_max_epi32(max0, v);
+                sum32 = _mm512_add_epi32(sum32, v);
+                __m512i q = _mm512_mullo_epi32(v, v);
+                sq_lo = _mm512_add_epi64(sq_lo, _mm512_cvtepu32_epi64(_mm512_castsi512_si256(q)));
+                sq_hi = _mm512_add_epi64(sq_hi, _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(q, 1)));
+            }
+            sum_lo = _mm512_add_epi64(sum_lo, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(sum32)));
+            sum_hi = _mm512_add_epi64(sum_hi, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(sum32, 1)));
+        }
+        uint64_t sq[16];
+        _mm512_storeu_si512(sq, sq_lo);
+        _mm512_storeu_si512(&sq[8], sq_hi);
+        for (uint32_t l = 0; l < lanes; ++l) {
+            sums[g + l].sum_sq = sq[l];
+        }
+        store_stats_group_avx512(&sums[g], lanes, sum_lo, sum_hi, min0, max0);
+    }
+    return 0;
+}
+
+TIMELINE_TARGET_AVX512
+int aggregate_stats_s24x8_avx512(const RawTimelineValuesBuf *input, uint32_t start, uint32_t end, TimelineChannelSums *sums) {
+    const uint32_t ch = input->nr_of_channels;
+    if (ch < 16 || input->bytes_per_sample != ch * 3) {
+        return aggregate_stats_s24x8_avx(input, start, end, sums);
+    }
+    if (end > input->nr_of_samples) end = input->nr_of_samples;
+    init_TimelineChannelSums(sums, ch);
+    const uint32_t row = ch * 3;
+    const uint8_t *src = (const uint8_t*)input->valueBuffer;
+    for (uint32_t g = 0; g < ch; g += 16) {
+        const uint32_t lanes = (ch - g < 16) ? ch - g : 16;
+        const __mmask64 k = (1ull << (lanes * 3)) - 1;
+        const uint8_t *p = &src[(size_t)start * row + g * 3];
+        __m512i sum_lo = _mm512_setzero_si512();
+        __m512i sum_hi = _mm512_setzero_si512();
+        __m512i min0 = _mm512_set1_epi32(INT32_MAX);
+        __m512i max0 = _mm512_set1_epi32(INT32_MIN);
+        uint32_t j = start;
+        while (j < end) {
+            const uint32_t block_end = (end - j > TIMELINE_STATS_BLOCK) ? j + TIMELINE_STATS_BLOCK : end;
+            __m512i sq_even = _mm512_setzero_si512(); // uint64, squares < 2^46: channels 0, 2, .. 14
+            __m512i sq_odd = _mm512_setzero_si512();  // channels 1, 3, .. 15
+            for (; j < block_end; ++j, p += row) {
+                __m512i v = expand_s24x16(_mm512_maskz_loadu_epi8(k, p));
+                min0 = _mm512_min_epi32(min0, v);
+                max0 = _mm512_max_epi32(max0, v);
+                sum_lo = _mm512_add_epi64(sum_lo, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(v)));
+                sum_hi = _mm512_add_epi64(sum_hi, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(v, 1)));
+                __m512i odd = _mm512_srli_epi64(v, 32);
+                sq_even = _mm512_add_epi64(sq_even, _mm512_mul_epi32(v, v));
+                sq_odd = _mm512_add_epi64(sq_odd, _mm512_mul_epi32(odd, odd));
+            }
+            uint64_t sq[16];
+            _mm512_storeu_si512(sq, sq_even);
+            _mm512_storeu_si512(&sq[8], sq_odd);
+            for (uint32_t l = 0; l < lanes; ++l) {
+                add_TimelineChannelSumSq(&sums[g + l], sq[(l & 1) * 8 + l / 2]);
+            }
+        }
+        store_stats_group_avx512(&sums[g], lanes, sum_lo, sum_hi, min0, max0);
+    }
+    return 0;
+}
+
+TIMELINE_TARGET_AVX512
+int aggregate_stats_s8_avx512(const RawTimelineValuesBuf *input, uint32_t start, uint32_t end, TimelineChannelSums *sums) {
+    const uint32_t ch = input->nr_of_channels;
+    if (ch < 16 || input->bytes_per_sample != ch) {
+        return aggregate_stats_s8_avx(input, start, end, sums);
+    }
+    if (end > input->nr_of_samples) end = input->nr_of_samples;
+    init_TimelineChannelSums(sums, ch);
+    const int8_t *src = (const int8_t*)input->valueBuffer;
+    for (uint32_t g = 0; g < ch; g += 16) {
+        const uint32_t lanes = (ch - g < 16) ? ch - g : 16;
+        const __mmask64 k = (1ull << lanes) - 1;
+        const int8_t *p = &src[(size_t)start * ch + g];
+        __m512i sum_lo = _mm512_setzero_si512();
+        __m512i sum_hi = _mm512_setzero_si512();
+        __m512i sq_lo = _mm512_setzero_si512();
+        __m512i sq_hi = _mm512_setzero_si512();
+        __m512i min0 = _mm512_set1_epi32(INT32_MAX);
+        __m512i max0 = _mm512_set1_epi32(INT32_MIN);
+        uint32_t j = start;
+        while (j < end) {
+            const uint32_t block_end = (end - j > TIMELINE_STATS_BLOCK) ? j + TIMELINE_STATS_BLOCK : end;
+            __m512i sum32 = _mm512_setzero_si512();
+            __m512i sq32 = _mm512_setzero_si512(); // squares < 2^14
+            for (; j < block_end; ++j, p += ch) {
+                __m512i v = _mm512_cvtepi8_epi32(_mm512_castsi512_si128(_mm512_maskz_loadu_epi8(k, p)));
+                min0 = _mm512_min_epi32(min0, v);
+                max0 = _mm512_max_epi32(max0, v);
+                sum32 = _mm512_add_epi32(sum32, v);
+                sq32 = _mm512_add_epi32(sq32, _mm512_mullo_epi32(v, v));
+            }
+            sum_lo = _mm512_add_epi64(sum_lo, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(sum32)));
+            sum_hi = _mm512_add_epi64(sum_hi, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(sum32, 1)));
+            sq_lo = _mm512_add_epi64(sq_lo, _mm512_cvtepu32_epi64(_mm512_castsi512_si256(sq32)));
+            sq_hi = _mm512_add_epi64(sq_hi, _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(sq32, 1)));
+        }
+        uint64_t sq[16];
+        _mm512_storeu_si512(sq, sq_lo);
+        _mm512_storeu_si512(&sq[8], sq_hi);
+        for (uint32_t l = 0; l < lanes; ++l) {
+            sums[g + l].sum_sq = sq[l];
+        }
+        store_stats_group_avx512(&sums[g], lanes, sum_lo, sum_hi, min0, max0);
+    }
+    return 0;
+}
+
+// Q16 interpolation of one output row, 16-channel groups widened to 16 x int32 lanes, the last group with a lane mask
+TIMELINE_TARGET_AVX512
+static inline void interp_s16_row_avx512(const int16_t *r0, const int16_t *r1, int16_t *out, uint32_t ch, uint32_t frac_fixed) {
+    const __m512i round = _mm512_set1_epi32(1 << 15);
+    __m512i frac = _mm512_set1_epi32((int32_t)frac_fixed);
+    __m512i inv_frac = _mm512_set1_epi32((int32_t)(0x10000 - frac_fixed));
+    for (uint32_t g = 0; g < ch; g += 16) {
+        const __mmask32 k = (ch - g < 16) ? (__mmask32)((1u << (ch - g)) - 1) : 0xFFFF;
+        __m256i v0 = _mm512_castsi512_si256(_mm512_maskz_loadu_epi16(k, &r0[g]));
+        __m256i v1 = _mm512_castsi512_si256(_mm512_maskz_loadu_epi16(k, &r1[g]));
+        __m512i interp = _mm512_add_epi32(_mm512_mullo_epi32(_mm512_cvtepi16_epi32(v0), inv_frac),
+                                          _mm512_mullo_epi32(_mm512_cvtepi16_epi32(v1), frac));
+        __m256i result = _mm512_cvtsepi32_epi16(_mm512_srai_epi32(_mm512_add_epi32(interp, round), 16));
+        _mm512_mask_storeu_epi16(&out[g], k, _mm512_castsi256_si512(result));
+    }
+}
+
+/*
+    Sample rate conversion at the prepared positions (see convert_sample_rate_SIMD_s16x8_bresenham).
+    8 channels: 2 output samples (16 x int32 lanes) per iteration, other channel counts one output row per iteration.
+ */
+TIMELINE_TARGET_AVX512
+int convert_sample_rate_SIMD_s16x8_bresenham_avx512(const RawTimelineValuesBuf* input, RawTimelineValuesBuf* output, uint32_t first, uint32_t count)
+{
+    const SampleInterpTable *table = get_SampleInterpTable(input, output);
+    if (!table) return -1;
+    const int16_t *src = (const int16_t*)input->valueBuffer;
+    int16_t *dst = (int16_t*)output->valueBuffer;
+    uint32_t ch = input->nr_of_channels;
+    uint32_t in_samples = input->nr_of_samples;
+    const uint32_t out_end = first + count;
+
+    SampleInterpCursor cur;
+    seek_SampleInterpCursor(table, first, &cur);
+    if (ch != 8) {
+        for (uint32_t i = first; i < out_end; ++i) {
+            uint32_t frac_fixed;
+            const int16_t *r0 = &src[(size_t)pos_SampleInterpCursor(table, &cur, in_samples, &frac_fixed) * ch];
+            interp_s16_row_avx512(r0, r0 + ch, &dst[(size_t)i * ch], ch, frac_fixed);
+            next_SampleInterpCursor(table, &cur);
+        }
+        return 0;
+    }
+
+    uint32_t pos_idx[2];
+    uint32_t pos_frac[2];
+    const __m512i round = _mm512_set1_epi32(1 << 15);
+    const __m512i one = _mm512_set1_epi32(0x10000);
+    for (uint32_t i = first; i < out_end; i += 2) {
+        uint32_t n = (out_end - i >= 2) ? 2 : 1;
+        for (uint32_t k = 0; k < n; ++k) {
+            pos_idx[k] = pos_SampleInterpCursor(table, &cur, in_samples, &pos_frac[k]);
+            next_SampleInterpCursor(table, &cur);
+        }
+        if (n == 1) {
+            pos_idx[1] = pos_idx[0];
+            pos_frac[1] = pos_frac[0];
+        }
+        const int16_t *a0 = &src[(size_t)pos_idx[0] * ch];
+        const int16_t *b0 = &src[(size_t)pos_idx[1] * ch];
+        __m256i v0_s16 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)a0)),
+                                                 _mm_loadu_si128((const __m128i*)b0), 1);
+        __m256i v1_s16 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(a0 + ch))),
+                                                 _mm_loadu_si128((const __m128i*)(b0 + ch)), 1);
+        __m512i frac = _mm512_inserti64x4(_mm512_set1_epi32((int32_t)pos_frac[0]), _mm256_set1_epi32((int32_t)pos_frac[1]), 1);
+        __m512i inv_frac = _mm512_sub_epi32(one, frac);
+
+        __m512i interp = _mm512_add_epi32(_mm512_mullo_epi32(_mm512_cvtepi16_epi32(v0_s16), inv_frac),
+                                          _mm512_mullo_epi32(_mm512_cvtepi16_epi32(v1_s16), frac));
+        __m256i result = _mm512_cvtsepi32_epi16(_mm512_srai_epi32(_mm512_add_epi32(interp, round), 16));
+        if (n == 2) {
+            _mm256_storeu_si256((__m256i*)&dst[(size_t)i * ch], result);
+        } else {
+            _mm_storeu_si128((__m128i*)&dst[(size_t)i * ch], _mm256_castsi256_si128(result));
+        }
+    }
+    return 0;
+}
+
+// Streaming resampling (see resample_span_s16x8_c), masked 16-channel groups
+TIMELINE_TARGET_AVX512
+void resample_span_s16x8_avx512(const int16_t *src, uint32_t nr_of_channels, SampleRatePhase *phase, int16_t *dst, uint32_t count) {
+    const uint32_t ch = nr_of_channels;
+    uint32_t pos_idx[TIMELINE_RESAMPLE_BLOCK];
+    uint32_t pos_frac[TIMELINE_RESAMPLE_BLOCK];
+    for (uint32_t done = 0; done < count; ) {
+        const uint32_t n = (count - done < TIMELINE_RESAMPLE_BLOCK) ? count - done : TIMELINE_RESAMPLE_BLOCK;
+        positions_SampleRatePhase(phase, n, pos_idx, pos_frac);
+        for (uint32_t k = 0; k < n; ++k) {
+            const int16_t *r0 = &src[(size_t)pos_idx[k] * ch];
+            int16_t *out = &dst[(size_t)(done + k) * ch];
+            if (k + TIMELINE_RESAMPLE_PREFETCH < n) prefetch_SampleRows(src, ch, pos_idx[k + TIMELINE_RESAMPLE_PREFETCH]);
+            interp_s16_row_avx512(r0, r0 + ch, out, ch, pos_frac[k]);
+        }
+        done += n;
+    }
+}
+
+/*
+    Fused resampling and min/max.
+    8 channels: two outputs per 16 x int32 iteration, the two halves are folded at the end of the column.
+    Other channel counts: masked 16-channel groups, the min / max of a group stay in registers over the column
+    (masked off lanes are never stored).
+ */
+TIMELINE_TARGET_AVX512
+void resample_minmax_s16x8_avx512(const int16_t *src, uint32_t nr_of_channels, const uint32_t *pos_idx, const uint32_t *pos_frac, uint32_t count, int16_t *min, int16_t *max) {
+    const uint32_t ch = nr_of_channels;
+    const __m512i round = _mm512_set1_epi32(1 << 15);
+    const __m512i one = _mm512_set1_epi32(0x10000);
+    if (ch == 8) {
+        __m256i vmin = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)min));
+        __m256i vmax = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)max));
+        for (uint32_t k = 0; k < count; k += 2) {
+            // an odd last output is paired with itself
+            const uint32_t k1 = (k + 1 < count) ? k + 1 : k;
+            if (k + TIMELINE_RESAMPLE_PREFETCH + 1 < count) {
+                prefetch_SampleRows(src, 8, pos_idx[k + TIMELINE_RESAMPLE_PREFETCH]);
+                prefetch_SampleRows(src, 8, pos_idx[k + TIMELINE_RESAMPLE_PREFETCH + 1]);
+            }
+            const int16_t *a0 = &src[(size_t)pos_idx[k] * 8];
+            const int16_t *b0 = &src[(size_t)pos_idx[k1] * 8];
+            __m256i v0 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)a0)),
+                                                 _mm_loadu_si128((const __m128i*)b0), 1);
+            __m256i v1 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(a0 + 8))),
+                                                 _mm_loadu_si128((const __m128i*)(b0 + 8)), 1);
+            __m512i frac = _mm512_inserti64x4(_mm512_set1_epi32((int32_t)pos_frac[k]), _mm256_set1_epi32((int32_t)pos_frac[k1]), 1);
+            __m512i interp = _mm512_add_epi32(_mm512_mullo_epi32(_mm512_cvtepi16_epi32(v0), _mm512_sub_epi32(one, frac)),
+                                              _mm512_mullo_epi32(_mm512_cvtepi16_epi32(v1), frac));
+            __m256i v = _mm512_cvtsepi32_epi16(_mm512_srai_epi32(_mm512_add_epi32(interp, round), 16));
+            vmin = _mm256_min_epi16(vmin, v);
+            vmax = _mm256_max_epi16(vmax, v);
+        }
+        _mm_storeu_si128((__m128i*)min, _mm_min_epi16(_mm256_castsi256_si128(vmin), _mm256_extracti128_si256(vmin, 1)));
+        _mm_storeu_si128((__m128i*)max, _mm_max_epi16(_mm256_castsi256_si128(vmax), _mm256_extracti128_si256(vmax, 1)));
+        return;
+    }
+    for (uint32_t g = 0; g < ch; g += 16) {
+        const __mmask32 m = (ch - g < 16) ? (__mmask32)((1u << (ch - g)) - 1) : 0xFFFF;
+        __m256i vmin = _mm512_castsi512_si256(_mm512_maskz_loadu_epi16(m, &min[g]));
+        __m256i vmax = _mm512_castsi512_si256(_mm512_maskz_loadu_epi16(m, &max[g]));
+        for (uint32_t k = 0; k < count; ++k) {
+            // the first group brings the rows in
+            if (g == 0 && k + TIMELINE_RESAMPLE_PREFETCH < count) prefetch_SampleRows(src, ch, pos_idx[k + TIMELINE_RESAMPLE_PREFETCH]);
+            const int16_t *r0 = &src[(size_t)pos_idx[k] * ch + g];
+            __m256i v0 = _mm512_castsi512_si256(_mm512_maskz_loadu_epi16(m, r0));
+            __m256i v1 = _mm512_castsi512_si256(_mm512_maskz_loadu_epi16(m, r0 + ch));
+            __m512i frac = _mm512_set1_epi32((int32_t)pos_frac[k]);
+            __m512i interp = _mm512_add_epi32(_mm512_mullo_epi32(_mm512_cvtepi16_epi32(v0), _mm512_sub_epi32(one, frac)),
+                                              _mm512_mullo_epi32(_mm512_cvtepi16_epi32(v1), frac));
+            __m256i v = _mm512_cvtsepi32_epi16(_mm512_srai_epi32(_mm512_add_epi32(interp, round), 16));
+            vmin = _mm256_min_epi16(vmin, v);
+            vmax = _mm256_max_epi16(vmax, v);
+        }
+        _mm512_mask_storeu_epi16(&min[g], m, _mm512_castsi256_si512(vmin));
+        _mm512_mask_storeu_epi16(&max[g], m, _mm512_castsi256_si512(vmax));
+    }
+}
+
+/*
+    Polyphase FIR, masked 16-channel groups, two taps per vpmaddwd like the AVX2 kernel. The 256-bit unpacks
+    work per 128-bit lane, so the int32 sums come out as channels 0-3, 8-11, 4-7, 12-15 and are put back in
+    order with one 128-bit lane shuffle before the saturating store. Less than 16 channels use the AVX2 kernel.
+ */
+TIMELINE_TARGET_AVX512
+void polyphase_span_s16x8_avx512(const int16_t *src, uint32_t nr_of_channels, const PolyphaseFilterBank *bank, SampleRatePhase *phase, int16_t *dst, uint32_t count) {
+    const uint32_t ch = nr_of_channels;
+    if (ch < 16) {
+        polyphase_span_s16x8_avx(src, nr_of_channels, bank, phase, dst, count);
+        return;
+    }
+    const uint32_t taps = bank->taps;
+    const __m512i round = _mm512_set1_epi32(1 << (TIMELINE_POLYPHASE_COEF_BITS - 1));
+    uint32_t idx = phase->idx;
+    uint32_t accum = phase->accum;
+    for (uint32_t i = 0; i < count; ++i) {
+        const int16_t *coef = coeffs_PolyphaseFilterBank(bank, phase, accum);
+        const int16_t *row = &src[(size_t)idx * ch];
+        int16_t *out = &dst[(size_t)i * ch];
+        for (uint32_t g = 0; g < ch; g += 16) {
+            const __mmask32 k = (ch - g < 16) ? (__mmask32)((1u << (ch - g)) - 1) : 0xFFFF;
+            const int16_t *p = &row[g];
+            __m512i acc = _mm512_setzero_si512();
+            for (uint32_t j = 0; j < taps; j += 2, p += 2 * ch) {
+                __m256i a = _mm512_castsi512_si256(_mm512_maskz_loadu_epi16(k, p));
+                __m256i b = _mm512_castsi512_si256(_mm512_maskz_loadu_epi16(k, p + ch));
+                __m512i x = _mm512_inserti64x4(_mm512_castsi256_si512(_mm256_unpacklo_epi16(a, b)), _mm256_unpackhi_epi16(a, b), 1);
+                int32_t pair;
+                memcpy(&pair, &coef[j], sizeof(pair));
+                acc = _mm512_add_epi32(acc, _mm512_madd_epi16(x, _mm512_set1_epi32(pair)));
+            }
+            acc = _mm512_shuffle_i32x4(acc, acc, _MM_SHUFFLE(3, 1, 2, 0));
+            acc = _mm512_srai_epi32(_mm512_add_epi32(acc, round), TIMELINE_POLYPHASE_COEF_BITS);
+            _mm512_mask_cvtsepi32_storeu_epi16(&out[g], (__mmask16)k, acc);
+        }
+        step_SampleRatePhase(phase, &idx, &accum);
+    }
+    phase->idx = idx;
+    phase->accum = accum;
+}
+
+// ---- AVX-512 Backend Global Instance for the virtual funtion table ----
+const TimelineBackendFunctions gTimelineBackendFunctionsAVX512 = {
+    .name = "Intel AVX-512 SIMD Backend",
+    .convert_sample_rate_s16x8 = convert_sample_rate_SIMD_s16x8_bresenham_avx512,
+    .aggregate_minmax_s8 = aggregate_minmax_s8_avx512,
+    .aggregate_minmax_s16x8 = aggregate_minmax_SIMD_s16x8_avx512,
+    .aggregate_minmax_s24x8 = aggregate_minmax_SIMD_s24x8_avx512,
+    .decode_be24_s16x8 = decode_be24_s16x8_avx, // one 24-byte block per step, 512-bit registers do not help
+    .decode_be24_s24x8 = decode_be24_s24x8_avx,
+    .resample_span_s16x8 = resample_span_s16x8_avx512,
+    .polyphase_span_s16x8 = polyphase_span_s16x8_avx512,
+    .cic_predecimate_s16x8 = cic_predecimate_s16x8_avx, // bound by the row loads, 512-bit registers do not help
+    .resample_minmax_s16x8 = resample_minmax_s16x8_avx512,
+    .aggregate_stats_s8 = aggregate_stats_s8_avx512,
+    .aggregate_stats_s16x8 = aggregate_stats_s16x8_avx512,
+    .aggregate_stats_s24x8 = aggregate_stats_s24x8_avx512,
+    .codec_encode_s16x8 = codec_encode_s16x8_avx, // one 8-lane group per block, 512-bit registers do not help
+    .codec_encode_s24x8 = codec_encode_s24x8_avx,
+    .codec_decode_s16x8 = codec_decode_s16x8_avx,
+    .codec_decode_s24x8 = codec_decode_s24x8_avx,
+    .transpose_to_planar_s16x8 = transpose_to_planar_s16x8_avx,
+    .transpose_to_planar_s24x8 = transpose_to_planar_s24x8_avx,
+    .transpose_from_planar_s16x8 = transpose_from_planar_s16x8_avx,
+    .transpose_from_planar_s24x8 = transpose_from_planar_s24x8_avx,
+};
+#endif
@@ -0,0 +1,850 @@
+/*
+    File: timelinedb_simd_neon.c
+    This file implements the ARM NEON variant of the sample rate conversion and aggregation functions.
+    NEON is part of the AArch64 baseline; on 32-bit ARM builds the backend is registered only when the kernel reports NEON (getauxval).
+    Author: Barna Farago - MYND-Ideal kft.
+    Date: 2025-07-01
+    License: Modified MIT License. You can use it for learn, but I can sell it as closed source with some improvements...
+*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "timelinedb_simd.h"
+
+#if defined(NEON_ENABLED)
+#include <arm_neon.h>
+
+/*
+    Vertical min/max: every 8-channel group of a row is one int16x8 load (row stride = channels), so min/max run
+    lane-wise over the samples. A remainder group is the group ending at the last channel (see timelinedb_simd.h).
+ */
+int aggregate_minmax_SIMD_s16x8_neon(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t i, uint32_t start, uint32_t end) {
+    const uint32_t ch = input->nr_of_channels;
+    if (ch < 8) {
+        return aggregate_minmax_SIMD_s16x8_c(input, outMin, outMax, i, start, end);
+    }
+    if (end > input->nr_of_samples) end = input->nr_of_samples;
+    const int16_t *src = (const int16_t*)input->valueBuffer;
+    for (uint32_t c = 0; c < ch; c += 8) {
+        const uint32_t g = (c + 8 <= ch) ? c : ch - 8;
+        const int16_t *p = &src[(size_t)start * ch + g];
+        int16x8_t min0 = vdupq_n_s16(INT16_MAX);
+        int16x8_t max0 = vdupq_n_s16(INT16_MIN);
+        int16x8_t min1 = min0;
+        int16x8_t max1 = max0;
+        uint32_t j = start;
+        for (; j + 2 <= end; j += 2, p += 2 * ch) {
+            int16x8_t s0 = vld1q_s16(p);
+            int16x8_t s1 = vld1q_s16(p + ch);
+            min0 = vminq_s16(min0, s0);
+            max0 = vmaxq_s16(max0, s0);
+            min1 = vminq_s16(min1, s1);
+            max1 = vmaxq_s16(max1, s1);
+        }
+        if (j < end) {
+            int16x8_t s0 = vld1q_s16(p);
+            min0 = vminq_s16(min0, s0);
+            max0 = vmaxq_s16(max0, s0);
+        }
+        vst1q_s16(&((int16_t*)outMin->valueBuffer)[i * ch + g], vminq_s16(min0, min1));
+        vst1q_s16(&((int16_t*)outMax->valueBuffer)[i * ch + g], vmaxq_s16(max0, max1));
+    }
+    return 0;
+}
+
+/*
+    int8 min/max, vertical like the 16-bit version with int8x8 groups of 8 channels.
+    A single channel is scanned 16 samples at a time, other channel counts below 8 use the C version.
+ */
+int aggregate_minmax_s8_neon(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t i, uint32_t start, uint32_t end) {
+    const uint32_t ch = input->nr_of_channels;
+    if (end > input->nr_of_samples) end = input->nr_of_samples;
+    const int8_t *src = (const int8_t*)input->valueBuffer;
+    if (ch >= 8) {
+        for (uint32_t c = 0; c < ch; c += 8) {
+            const uint32_t g = (c + 8 <= ch) ? c : ch - 8;
+            const int8_t *p = &src[(size_t)start * ch + g];
+            int8x8_t min_vec = vdup_n_s8(INT8_MAX);
+            int8x8_t max_vec = vdup_n_s8(INT8_MIN);
+            for (uint32_t j = start; j < end; ++j, p += ch) {
+                int8x8_t vals = vld1_s8(p);
+                min_vec = vmin_s8(min_vec, vals);
+                max_vec = vmax_s8(max_vec, vals);
+            }
+            vst1_s8(&((int8_t*)outMin->valueBuffer)[i * ch + g], min_vec);
+            vst1_s8(&((int8_t*)outMax->valueBuffer)[i * ch + g], max_vec);
+        }
+        return 0;
+    }
+    if (ch != 1) {
+        return aggregate_minmax_s8_c(input, outMin, outMax, i, start, end);
+    }
+    int8x16_t min_vec = vdupq_n_s8(INT8_MAX);
+    int8x16_t max_vec = vdupq_n_s8(INT8_MIN);
+    uint32_t j = start;
+    for (; j + 16 <= end; j += 16) {
+        int8x16_t vals = vld1q_s8(&src[j]);
+        min_vec = vminq_s8(min_vec, vals);
+        max_vec = vmaxq_s8(max_vec, vals);
+    }
+    // Reduce vector to scalar min and max using temporary arrays
+    int8_t tmp_min[16], tmp_max[16];
+    vst1q_s8(tmp_min, min_vec);
+    vst1q_s8(tmp_max, max_vec);
+
+    int8_t min_val = tmp_min[0], max_val = tmp_max[0];
+    for (int i_tmp = 1; i_tmp < 16; ++i_tmp) {
+        if (tmp_min[i_tmp] < min_val) min_val = tmp_min[i_tmp];
+        if (tmp_max[i_tmp] > max_val) max_val = tmp_max[i_tmp];
+    }
+    for (; j < end; ++j) {
+        if (src[j] < min_val) min_val = src[j];
+        if (src[j] > max_val) max_val = src[j];
+    }
+    ((int8_t*)outMin->valueBuffer)[i] = min_val;
+    ((int8_t*)outMax->valueBuffer)[i] = max_val;
+    return 0;
+}
+
+/*
+    Min/max of 24-bit samples (3 bytes per channel) in 8-channel groups, output downscaled to int8 (>> 16) like the C version.
+    vld3 de-interleaves the packed little-endian triplets into low/mid/high byte vectors, the low and mid bytes are
+    zipped into uint16, the high byte is sign-extended to int16 and zipped above them, which gives the int32 values.
+ */
+static inline void unpack_s24x8(uint8x8x3_t v, int32x4_t *lo, int32x4_t *hi) {
+    uint8x8x2_t b01 = vzip_u8(v.val[0], v.val[1]);
+    uint16x8_t low16 = vreinterpretq_u16_u8(vcombine_u8(b01.val[0], b01.val[1]));
+    uint16x8_t high16 = vreinterpretq_u16_s16(vmovl_s8(vreinterpret_s8_u8(v.val[2])));
+    uint16x8x2_t w = vzipq_u16(low16, high16);
+    *lo = vreinterpretq_s32_u16(w.val[0]); // channels 0..3
+    *hi = vreinterpretq_s32_u16(w.val[1]); // channels 4..7
+}
+
+int aggregate_minmax_SIMD_s24x8_neon(const RawTimelineValuesBuf *input, RawTimelineValuesBuf *outMin, RawTimelineValuesBuf *outMax, uint32_t i, uint32_t start, uint32_t end) {
+    const uint32_t ch = input->nr_of_channels;
+    if (ch < 8 || input->bytes_per_sample != ch * 3) {
+        return aggregate_minmax_SIMD_s24x8_c(input, outMin, outMax, i, start, end);
+    }
+    if (end > input->nr_of_samples) end = input->nr_of_samples;
+    const uint32_t row = ch * 3;
+    const uint8_t *src = (const uint8_t*)input->valueBuffer;
+    // 8-channel groups, the remainder group overlaps the previous one
+    for (uint32_t c = 0; c < ch; c += 8) {
+        const uint32_t g = (c + 8 <= ch) ? c : ch - 8;
+        const uint8_t *p = &src[(size_t)start * row + g * 3];
+        int32x4_t min_lo = vdupq_n_s32(INT32_MAX);
+        int32x4_t min_hi = min_lo;
+        int32x4_t max_lo = vdupq_n_s32(INT32_MIN);
+        int32x4_t max_hi = max_lo;
+
+        for (uint32_t j = start; j < end; ++j, p += row) {
+            int32x4_t lo, hi;
+            unpack_s24x8(vld3_u8(p), &lo, &hi);
+            min_lo = vminq_s32(min_lo, lo);
+            max_lo = vmaxq_s32(max_lo, lo);
+            min_hi = vminq_s32(min_hi, hi);
+            max_hi = vmaxq_s32(max_hi, hi);
+        }
+        int32_t vmin[8], vmax[8];
+        vst1q_s32(vmin, min_lo);
+        vst1q_s32(vmin + 4, min_hi);
+        vst1q_s32(vmax, max_lo);
+        vst1q_s32(vmax + 4, max_hi);
+        // Downscale from 24-bit to 8-bit (>>16)
+        for (uint32_t k = 0; k < 8; ++k) {
+            ((int8_t*)outMin->valueBuffer)[i * ch + g + k] = (int8_t)(vmin[k] >> 16);
+            ((int8_t*)outMax->valueBuffer)[i * ch + g + k] = (int8_t)(vmax[k] >> 16);
+        }
+    }
+    return 0;
+}
+
+/*
+    Statistics (sum, sum of squares, min, max) of 8-channel groups (overlapping last group, see aggregate_stats_s16x8_c).
+    The rows are widened with vaddw / vmull, the int32 accumulators are flushed every TIMELINE_STATS_BLOCK rows,
+    the squares go to uint64x2 accumulators (channel pairs).
+ */
+static inline void store_stats_group_neon(TimelineChannelSums *sums, const int64_t *sum, const uint64x2_t *sq, int32x4_t min_lo, int32x4_t min_hi, int32x4_t max_lo, int32x4_t max_hi) {
+    uint64_t vsq[8];
+    int32_t vmin[8], vmax[8];
+    for (uint32_t k = 0; k < 4; ++k) {
+        vst1q_u64(&vsq[2 * k], sq[k]);
+    }
+    vst1q_s32(vmin, min_lo);
+    vst1q_s32(vmin + 4, min_hi);
+    vst1q_s32(vmax, max_lo);
+    vst1q_s32(vmax + 4, max_hi);
+    for (uint32_t k = 0; k < 8; ++k) {
+        sums[k].sum = sum[k];
+        sums[k].sum_sq = vsq[k];
+        sums[k].min = vmin[k];
+        sums[k].max = vmax[k];
+    }
+}
+
+// int16 and int8 rows as int16x8 (int8 widened), the squares (< 2^30) are widened to 64 bits every row
+static inline void stats_row_s16x8_neon(int16x8_t v, int32x4_t *sum_lo, int32x4_t *sum_hi, uint64x2_t *sq, int16x8_t *vmin, int16x8_t *vmax) {
+    *vmin = vminq_s16(*vmin, v);
+    *vmax = vmaxq_s16(*vmax, v);
+    *sum_lo = vaddw_s16(*sum_lo, vget_low_s16(v));
+    *sum_hi = vaddw_s16(*sum_hi, vget_high_s16(v));
+    uint32x4_t q_lo = vreinterpretq_u32_s32(vmull_s16(vget_low_s16(v), vget_low_s16(v)));
+    uint32x4_t q_hi = vreinterpretq_u32_s32(vmull_s16(vget_high_s16(v), vget_high_s16(v)));
+    sq[0] = vaddw_u32(sq[0], vget_low_u32(q_lo));
+    sq[1] = vaddw_u32(sq[1], vget_high_u32(q_lo));
+    sq[2] = vaddw_u32(sq[2], vget_low_u32(q_hi));
+    sq[3] = vaddw_u32(sq[3], vget_high_u32(q_hi));
+}
+
+static int aggregate_stats_rows_neon(const RawTimelineValuesBuf *input, uint32_t start, uint32_t end, TimelineChannelSums *sums, int is_s8) {
+    const uint32_t ch = input->nr_of_channels;
+    if (end > input->nr_of_samples) end = input->nr_of_samples;
+    init_TimelineChannelSums(sums, ch);
+    for (uint32_t c = 0; c < ch; c += 8) {
+        const uint32_t g = (c + 8 <= ch) ? c : ch - 8;
+        const uint8_t *p = &input->valueBuffer[(size_t)start * input->bytes_per_sample + g * (is_s8 ? 1 : 2)];
+        int16x8_t vmin = vdupq_n_s16(INT16_MAX);
+        int16x8_t vmax = vdupq_n_s16(INT16_MIN);
+        uint64x2_t sq[4] = { vdupq_n_u64(0), vdupq_n_u64(0), vdupq_n_u64(0), vdupq_n_u64(0) };
+        int64_t sum[8] = { 0 };
+        uint32_t j = start;
+        while (j < end) {
+            const uint32_t block_end = (end - j > TIMELINE_STATS_BLOCK) ? j + TIMELINE_STATS_BLOCK : end;
+            int32x4_t sum_lo = vdupq_n_s32(0);
+            int32x4_t sum_hi = vdupq_n_s32(0);
+            for (; j < block_end; ++j, p += input->bytes_per_sample) {
+                int16x8_t v = is_s8 ? vmovl_s8(vld1_s8((const int8_t*)p)) : vld1q_s16((const int16_t*)p);
+                stats_row_s16x8_neon(v, &sum_lo, &sum_hi, sq, &vmin, &vmax);
+            }
+            int32_t part[8];
+            vst1q_s32(part, sum_lo);
+            vst1q_s32(part + 4, sum_hi);
+            for (uint32_t k = 0; k < 8; ++k) {
+                sum[k] += part[k];
+            }
+        }
+        store_stats_group_neon(&sums[g], sum, sq, vmovl_s16(vget_low_s16(vmin)), vmovl_s16(vget_high_s16(vmin)),
+                               vmovl_s16(vget_low_s16(vmax)), vmovl_s16(vget_high_s16(vmax)));
+    }
+    return 0;
+}
+
+/*
+    1..7 channels: the rows are contiguous, so consecutive values are the lanes. A step takes the largest multiple
+    of ch that fits the 8 lanes (used), lane L always holds channel L % ch and the lanes past used are not summed.
+    The lanes are folded into their channels at the end, the rows left after the last full vector load go through
+    the C kernel (merge_TimelineChannelSums).
+ */
+static void aggregate_stats_narrow_neon(const RawTimelineValuesBuf *input, uint32_t start, uint32_t end, TimelineChannelSums *sums, int is_s8) {
+    const uint32_t ch = input->nr_of_channels;
+    const uint32_t bytes = is_s8 ? 1 : 2;
+    const uint32_t rows = 8 / ch;
+    const uint32_t used = rows * ch;
+    const uint32_t need = (8 + ch - 1) / ch;  // rows covered by one load
+    if (end > input->nr_of_samples) end = input->nr_of_samples;
+    init_TimelineChannelSums(sums, ch);
+    const uint8_t *p = &input->valueBuffer[(size_t)start * ch * bytes];
+    int16x8_t vmin = vdupq_n_s16(INT16_MAX);
+    int16x8_t vmax = vdupq_n_s16(INT16_MIN);
+    uint64x2_t sq[4] = { vdupq_n_u64(0), vdupq_n_u64(0), vdupq_n_u64(0), vdupq_n_u64(0) };
+    int64_t sum[8] = { 0 };
+    uint32_t j = start;
+    while (j + need <= end) {
+        const uint32_t block_end = (end - j > TIMELINE_STATS_BLOCK) ? j + TIMELINE_STATS_BLOCK : end;
+        int32x4_t sum_lo = vdupq_n_s32(0);
+        int32x4_t sum_hi = vdupq_n_s32(0);
+        for (; j + need <= block_end; j += rows, p += used * bytes) {
+            int16x8_t v = is_s8 ? vmovl_s8(vld1_s8((const int8_t*)p)) : vld1q_s16((const int16_t*)p);
+            stats_row_s16x8_neon(v, &sum_lo, &sum_hi, sq, &vmin, &vmax);
+        }
+        int32_t part[8];
+        vst1q_s32(part, sum_lo);
+        vst1q_s32(part + 4, sum_hi);
+        for (uint32_t k = 0; k < 8; ++k) {
+            sum[k] += part[k];
+        }
+    }
+    if (j > start) {
+        TimelineChannelSums lane[8];
+        init_TimelineChannelSums(lane, 8);
+        store_stats_group_neon(lane, sum, sq, vmovl_s16(vget_low_s16(vmin)), vmovl_s16(vget_high_s16(vmin)),
+                               vmovl_s16(vget_low_s16(vmax)), vmovl_s16(vget_high_s16(vmax)));
+        for (uint32_t l = 0; l < used; ++l) {
+            merge_TimelineChannelSums(&sums[l % ch], &lane[l]);
+        }
+    }
+    TimelineChannelSums tail[8];
+    if (is_s8) {
+        aggregate_stats_s8_c(input, j, end, tail);
+    } else {
+        aggregate_stats_s16x8_c(input, j, end, tail);
+    }
+    for (uint32_t c = 0; c < ch; ++c) {
+        merge_TimelineChannelSums(&sums[c], &tail[c]);
+    }
+}
+
+int aggregate_stats_s16x8_neon(const RawTimelineValuesBuf *input, uint32_t start, uint32_t end, TimelineChannelSums *sums) {
+    if (input->nr_of_channels < 8) {
+        if (input->bytes_per_sample != input->nr_of_channels * 2) {
+            return aggregate_stats_s16x8_c(input, start, end, sums);
+        }
+        aggregate_stats_narrow_neon(input, start, end, sums, 0);
+        return 0;
+    }
+    return aggregate_stats_rows_neon(input, start, end, sums, 0);
+}
+
+int aggregate_stats_s8_neon(const RawTimelineValuesBuf *input, uint32_t start, uint32_t end, TimelineChannelSums *sums) {
+    if (input->bytes_per_sample != input->nr_of_channels) {
+        return aggregate_stats_s8_c(input, start, end, sums);
+    }
+    if (input->nr_of_channels < 8) {
+        aggregate_stats_narrow_neon(input, start, end, sums, 1);
+        return 0;
+    }
+    return aggregate_stats_rows_neon(input, start, end, sums, 1);
+}
+
+// 24-bit, 1..7 channels: 8 consecutive values per step (vld3 + unpack_s24x8), folded like aggregate_stats_narrow_neon
+static void aggregate_stats_narrow_s24_neon(const RawTimelineValuesBuf *input, uint32_t start, uint32_t end, TimelineChannelSums *sums) {
+    const uint32_t ch = input->nr_of_channels;
+    const uint32_t rows = 8 / ch;
+    const uint32_t used = rows * ch;
+    const uint32_t need = (8 + ch - 1) / ch;
+    if (end > input->nr_of_samples) end = input->nr_of_samples;
+    init_TimelineChannelSums(sums, ch);
+    const uint8_t *p = &input->valueBuffer[(size_t)start * ch * 3];
+    int32x4_t min_lo = vdupq_n_s32(INT32_MAX);
+    int32x4_t min_hi = min_lo;
+    int32x4_t max_lo = vdupq_n_s32(INT32_MIN);
+    int32x4_t max_hi = max_lo;
+    int64x2_t sum[4] = { vdupq_n_s64(0), vdupq_n_s64(0), vdupq_n_s64(0), vdupq_n_s64(0) };
+    TimelineChannelSums lane[8];
+    init_TimelineChannelSums(lane, 8);
+    uint32_t j = start;
+    while (j + need <= end) {
+        const uint32_t block_end = (end - j > TIMELINE_STATS_BLOCK) ? j + TIMELINE_STATS_BLOCK : end;
+        uint64x2_t sq[4] = { vdupq_n_u64(0), vdupq_n_u64(0), vdupq_n_u64(0), vdupq_n_u64(0) };
+        for (; j + need <= block_end; j += rows, p += used * 3) {
+            int32x4_t lo, hi;
+            unpack_s24x8(vld3_u8(p), &lo, &hi);
+            min_lo = vminq_s32(min_lo, lo);
+            max_lo = vmaxq_s32(max_lo, lo);
+            min_hi = vminq_s32(min_hi, hi);
+            max_hi = vmaxq_s32(max_hi, hi);
+            sum[0] = vaddw_s32(sum[0], vget_low_s32(lo));
+            sum[1] = vaddw_s32(sum[1], vget_high_s32(lo));
+            sum[2] = vaddw_s32(sum[2], vget_low_s32(hi));
+            sum[3] = vaddw_s32(sum[3], vget_high_s32(hi));
+            sq[0] = vaddq_u64(sq[0], vreinterpretq_u64_s64(vmull_s32(vget_low_s32(lo), vget_low_s32(lo))));
+            sq[1] = vaddq_u64(sq[1], vreinterpretq_u64_s64(vmull_s32(vget_high_s32(lo), vget_high_s32(lo))));
+            sq[2] = vaddq_u64(sq[2], vreinterpretq_u64_s64(vmull_s32(vget_low_s32(hi), vget_low_s32(hi))));
+            sq[3] = vaddq_u64(sq[3], vreinterpretq_u64_s64(vmull_s32(vget_high_s32(hi), vget_high_s32(hi))));
+        }
+        uint64_t vsq[8];
+        for (uint32_t k = 0; k < 4; ++k) {
+            vst1q_u64(&vsq[2 * k], sq[k]);
+        }
+        for (uint32_t k = 0; k < 8; ++k) {
+            add_TimelineChannelSumSq(&lane[k], vsq[k]);
+        }
+    }
+    int64_t vsum[8];
+    int32_t vmin[8], vmax[8];
+    for (uint32_t k = 0; k < 4; ++k) {
+        vst1q_s64(&vsum[2 * k], sum[k]);
+    }
+    vst1q_s32(vmin, min_lo);
+    vst1q_s32(vmin + 4, min_hi);
+    vst1q_s32(vmax, max_lo);
+    vst1q_s32(vmax + 4, max_hi);
+    for (uint32_t l = 0; l < used; ++l) {
+        lane[l].sum = vsum[l];
+        lane[l].min = vmin[l];
+        lane[l].max = vmax[l];
+        merge_TimelineChannelSums(&sums[l % ch], &lane[l]);
+    }
+    TimelineChannelSums tail[8];
+    aggregate_stats_s24x8_c(input, j, end, tail);
+    for (uint32_t c = 0; c < ch; ++c) {
+        merge_TimelineChannelSums(&sums[c], &tail[c]);
+    }
+}
+
+// 24-bit: unpack_s24x8 rows, the sums are widened to int64, the squares (< 2^46) come from vmull_s32
+int aggregate_stats_s24x8_neon(const RawTimelineValuesBuf *input, uint32_t start, uint32_t end, TimelineChannelSums *sums) {
+    const uint32_t ch = input->nr_of_channels;
+    if (input->bytes_per_sample != ch * 3) {
+        return aggregate_stats_s24x8_c(input, start, end, sums);
+    }
+    if (ch < 8) {
+        aggregate_stats_narrow_s24_neon(input, start, end, sums);
+        return 0;
+    }
+    if (end > input->nr_of_samples) end = input->nr_of_samples;
+    init_TimelineChannelSums(sums, ch);
+    const uint32_t row = ch * 3;
+    const uint8_t *src = (const uint8_t*)input->valueBuffer;
+    for (uint32_t c = 0; c < ch; c += 8) {
+        const uint32_t g = (c + 8 <= ch) ? c : ch - 8;
+        const uint8_t *p = &src[(size_t)start * row + g * 3];
+        int32x4_t min_lo = vdupq_n_s32(INT32_MAX);
+        int32x4_t min_hi = min_lo;
+        int32x4_t max_lo = vdupq_n_s32(INT32_MIN);
+        int32x4_t max_hi = max_lo;
+        int64x2_t sum[4] = { vdupq_n_s64(0), vdupq_n_s64(0), vdupq_n_s64(0), vdupq_n_s64(0) };
+        TimelineChannelSums group[8];
+        init_TimelineChannelSums(group, 8);
+        uint32_t j = start;
+        while (j < end) {
+            const uint32_t block_end = (end - j > TIMELINE_STATS_BLOCK) ? j + TIMELINE_STATS_BLOCK : end;
+            uint64x2_t sq[4] = { vdupq_n_u64(0), vdupq_n_u64(0), vdupq_n_u64(0), vdupq_n_u64(0) };
+            for (; j < block_end; ++j, p += row) {
+                int32x4_t lo, hi;
+                unpack_s24x8(vld3_u8(p), &lo, &hi);
+                min_lo = vminq_s32(min_lo, lo);
+                max_lo = vmaxq_s32(max_lo, lo);
+                min_hi = vminq_s32(min_hi, hi);
+                max_hi = vmaxq_s32(max_hi, hi);
+                sum[0] = vaddw_s32(sum[0], vget_low_s32(lo));
+                sum[1] = vaddw_s32(sum[1], vget_high_s32(lo));
+                sum[2] = vaddw_s32(sum[2], vget_low_s32(hi));
+                sum[3] = vaddw_s32(sum[3], vget_high_s32(hi));
+                sq[0] = vaddq_u64(sq[0], vreinterpretq_u64_s64(vmull_s32(vget_low_s32(lo), vget_low_s32(lo))));
+                sq[1] = vaddq_u64(sq[1], vreinterpretq_u64_s64(vmull_s32(vget_high_s32(lo), vget_high_s32(lo))));
+                sq[2] = vaddq_u64(sq[2], vreinterpretq_u64_s64(vmull_s32(vget_low_s32(hi), vget_low_s32(hi))));
+                sq[3] = vaddq_u64(sq[3], vreinterpretq_u64_s64(vmull_s32(vget_high_s32(hi), vget_high_s32(hi))));
+            }
+            uint64_t vsq[8];
+            for (uint32_t k = 0; k < 4; ++k) {
+                vst1q_u64(&vsq[2 * k], sq[k]);
+            }
+            for (uint32_t k = 0; k < 8; ++k) {
+                add_TimelineChannelSumSq(&group[k], vsq[k]);
+            }
+        }
+        int64_t vsum[8];
+        int32_t vmin[8], vmax[8];
+        for (uint32_t k = 0; k < 4; ++k) {
+            vst1q_s64(&vsum[2 * k], sum[k]);
+        }
+        vst1q_s32(vmin, min_lo);
+        vst1q_s32(vmin + 4, min_hi);
+        vst1q_s32(vmax, max_lo);
+        vst1q_s32(vmax + 4, max_hi);
+        for (uint32_t k = 0; k < 8; ++k) {
+            group[k].sum = vsum[k];
+            group[k].min = vmin[k];
+            group[k].max = vmax[k];
+            sums[g + k] = group[k];
+        }
+    }
+    return 0;
+}
+
+/*
+    Big-endian 24-bit payload decoding, one block of 8 channels (24 bytes) per step.
+    vld3 splits the triplets into MSB / middle / LSB byte vectors, so no shuffle table is needed:
+    s16x8 zips (middle, MSB) into little-endian int16, s24x8 stores the three planes back in reversed order.
+    A partial last block is done by the C version.
+ */
+int decode_be24_s16x8_neon(const uint8_t *payload, uint32_t nr_of_channels, uint8_t *dst, uint32_t dst_stride) {
+    uint32_t full_blocks = nr_of_channels / 8;
+    for (uint32_t b = 0; b < full_blocks; ++b) {
+        uint8x8x3_t v = vld3_u8(&payload[b * 24]);
+        uint8x8x2_t le = vzip_u8(v.val[1], v.val[0]);
+        vst1q_u8(&dst[b * dst_stride], vcombine_u8(le.val[0], le.val[1]));
+    }
+    if (nr_of_channels % 8) {
+        decode_be24_s16x8_c(&payload[full_blocks * 24], nr_of_channels % 8, &dst[full_blocks * dst_stride], dst_stride);
+    }
+    return 0;
+}
+
+int decode_be24_s24x8_neon(const uint8_t *payload, uint32_t nr_of_channels, uint8_t *dst, uint32_t dst_stride) {
+    uint32_t full_blocks = nr_of_channels / 8;
+    for (uint32_t b = 0; b < full_blocks; ++b) {
+        uint8x8x3_t v = vld3_u8(&payload[b * 24]);
+        uint8x8x3_t le;
+        le.val[0] = v.val[2];
+        le.val[1] = v.val[1];
+        le.val[2] = v.val[0];
+        vst3_u8(&dst[b * dst_stride], le);
+    }
+    if (nr_of_channels % 8) {
+        decode_be24_s24x8_c(&payload[full_blocks * 24], nr_of_channels % 8, &dst[full_blocks * dst_stride], dst_stride);
+    }
+    return 0;
+}
+
+/*
+    Bresenham-style fixed-point sample rate conversion for interleaved 16-bit signed integer audio.
+    This function avoids division in the loop, using an accumulator and step size (like Bresenham's algorithm).
+    It performs linear interpolation between nearest samples, 8 channels per step (the last group overlaps the previous one).
+*/
+static inline int16x8_t interp_s16x8_vec_neon(const int16_t *r0, const int16_t *r1, uint32_t frac_fixed, uint32_t inv_frac_fixed) {
+    // Load 8 channels for idx0 and idx1
+    int16x8_t v0 = vld1q_s16(r0);
+    int16x8_t v1 = vld1q_s16(r1);
+    // Widen to 32-bit
+    int32x4_t v0_lo = vmovl_s16(vget_low_s16(v0));
+    int32x4_t v0_hi = vmovl_s16(vget_high_s16(v0));
+    int32x4_t v1_lo = vmovl_s16(vget_low_s16(v1));
+    int32x4_t v1_hi = vmovl_s16(vget_high_s16(v1));
+
+    // Interpolate: (v0 * inv_frac + v1 * frac) >> 16
+    int32x4_t interp_lo = vmlaq_n_s32(vmulq_n_s32(v0_lo, inv_frac_fixed), v1_lo, frac_fixed);
+    int32x4_t interp_hi = vmlaq_n_s32(vmulq_n_s32(v0_hi, inv_frac_fixed), v1_hi, frac_fixed);
+    interp_lo = vrshrq_n_s32(interp_lo, 16);
+    interp_hi = vrshrq_n_s32(interp_hi, 16);
+    return vcombine_s16(vmovn_s32(interp_lo), vmovn_s32(interp_hi));
+}
+
+static inline void interp_s16x8_neon(const int16_t *r0, const int16_t *r1, int16_t *out, uint32_t frac_fixed, uint32_t inv_frac_fixed) {
+    vst1q_s16(out, interp_s16x8_vec_neon(r0, r1, frac_fixed, inv_frac_fixed));
+}
+
+int convert_sample_rate_SIMD_s16x8_bresenham_neon(const RawTimelineValuesBuf* input, RawTimelineValuesBuf* output, uint32_t first, uint32_t count)
+{
+    const SampleInterpTable *table = get_SampleInterpTable(input, output);
+    if (!table) return -1;
+    const int16_t *src = (const int16_t*)input->valueBuffer;
+    int16_t *dst = (int16_t*)output->valueBuffer;
+    uint32_t ch = input->nr_of_channels;
+    uint32_t in_samples = input->nr_of_samples;
+
+    SampleInterpCursor cur;
+    seek_SampleInterpCursor(table, first, &cur);
+    for (uint32_t i = first; i < first + count; ++i) {
+        uint32_t frac_fixed;
+        const int16_t *r0 = &src[(size_t)pos_SampleInterpCursor(table, &cur, in_samples, &frac_fixed) * ch];
+        const int16_t *r1 = r0 + ch;
+        int16_t *out = &dst[(size_t)i * ch];
+        if (ch >= 8) {
+            for (uint32_t c = 0; c < ch; c += 8) {
+                uint32_t g = (c + 8 <= ch) ? c : ch - 8;
+                interp_s16x8_neon(&r0[g], &r1[g], &out[g], frac_fixed, 0x10000 - frac_fixed);
+            }
+        } else {
+            for (uint32_t c = 0; c < ch; ++c) {
+                out[c] = interp_s16_q16(r0[c], r1[c], frac_fixed);
+            }
+        }
+        next_SampleInterpCursor(table, &cur);
+    }
+    return 0;
+}
+
+// Streaming resampling (see resample_span_s16x8_c), 8-channel groups like the converter above
+void resample_span_s16x8_neon(const int16_t *src, uint32_t nr_of_channels, SampleRatePhase *phase, int16_t *dst, uint32_t count) {
+    const uint32_t ch = nr_of_channels;
+    if (ch < 8) {
+        resample_span_s16x8_c(src, nr_of_channels, phase, dst, count);
+        return;
+    }
+    uint32_t pos_idx[TIMELINE_RESAMPLE_BLOCK];
+    uint32_t pos_frac[TIMELINE_RESAMPLE_BLOCK];
+    for (uint32_t done = 0; done < count; ) {
+        const uint32_t n = (count - done < TIMELINE_RESAMPLE_BLOCK) ? count - done : TIMELINE_RESAMPLE_BLOCK;
+        positions_SampleRatePhase(phase, n, pos_idx, pos_frac);
+        for (uint32_t k = 0; k < n; ++k) {
+            const int16_t *r0 = &src[(size_t)pos_idx[k] * ch];
+            int16_t *out = &dst[(size_t)(done + k) * ch];
+            if (k + TIMELINE_RESAMPLE_PREFETCH < n) prefetch_SampleRows(src, ch, pos_idx[k + TIMELINE_RESAMPLE_PREFETCH]);
+            for (uint32_t c = 0; c < ch; c += 8) {
+                uint32_t g = (c + 8 <= ch) ? c : ch - 8;
+                interp_s16x8_neon(&r0[g], &r0[ch + g], &out[g], pos_frac[k], 0x10000 - pos_frac[k]);
+            }
+        }
+        done += n;
+    }
+}
+
+// Folds the outputs of the 8-channel group g into vmin / vmax
+static inline void resample_minmax_group_neon(const int16_t *src, uint32_t ch, uint32_t g, const uint32_t *pos_idx, const uint32_t *pos_frac, uint32_t n,
+                                              int16x8_t *vmin, int16x8_t *vmax) {
+    int16x8_t lo = *vmin;
+    int16x8_t hi = *vmax;
+    for (uint32_t k = 0; k < n; ++k) {
+        // the first group brings the rows in
+        if (g == 0 && k + TIMELINE_RESAMPLE_PREFETCH < n) prefetch_SampleRows(src, ch, pos_idx[k + TIMELINE_RESAMPLE_PREFETCH]);
+        const int16_t *r0 = &src[(size_t)pos_idx[k] * ch + g];
+        int16x8_t v = interp_s16x8_vec_neon(r0, r0 + ch, pos_frac[k], 0x10000 - pos_frac[k]);
+        lo = vminq_s16(lo, v);
+        hi = vmaxq_s16(hi, v);
+    }
+    *vmin = lo;
+    *vmax = hi;
+}
+
+/*
+    Fused resampling and min/max (see resample_minmax_s16x8_avx): every 8-channel group runs over the column with its
+    min / max in registers, the overlapping last group is loaded first.
+ */
+void resample_minmax_s16x8_neon(const int16_t *src, uint32_t nr_of_channels, const uint32_t *pos_idx, const uint32_t *pos_frac, uint32_t count, int16_t *min, int16_t *max) {
+    const uint32_t ch = nr_of_channels;
+    if (ch < 8) {
+        resample_minmax_s16x8_c(src, nr_of_channels, pos_idx, pos_frac, count, min, max);
+        return;
+    }
+    const uint32_t full = ch & ~7u;
+    int16x8_t tail_min = vdupq_n_s16(0);
+    int16x8_t tail_max = vdupq_n_s16(0);
+    if (full < ch) {
+        tail_min = vld1q_s16(&min[ch - 8]);
+        tail_max = vld1q_s16(&max[ch - 8]);
+    }
+    for (uint32_t g = 0; g < full; g += 8) {
+        int16x8_t vmin = vld1q_s16(&min[g]);
+        int16x8_t vmax = vld1q_s16(&max[g]);
+        resample_minmax_group_neon(src, ch, g, pos_idx, pos_frac, count, &vmin, &vmax);
+        vst1q_s16(&min[g], vmin);
+        vst1q_s16(&max[g], vmax);
+    }
+    if (full < ch) {
+        resample_minmax_group_neon(src, ch, ch - 8, pos_idx, pos_frac, count, &tail_min, &tail_max);
+        vst1q_s16(&min[ch - 8], tail_min);
+        vst1q_s16(&max[ch - 8], tail_max);
+    }
+}
+
+// Polyphase FIR (see polyphase_span_s16x8_c), 8-channel groups, widening multiply-accumulate by the scalar tap
+void polyphase_span_s16x8_neon(const int16_t *src, uint32_t nr_of_channels, const PolyphaseFilterBank *bank, SampleRatePhase *phase, int16_t *dst, uint32_t count) {
+    const uint32_t ch = nr_of_channels;
+    if (ch < 8) {
+        polyphase_span_s16x8_c(src, nr_of_channels, bank, phase, dst, count);
+        return;
+    }
+    const uint32_t taps = bank->taps;
+    const int32x4_t round = vdupq_n_s32(1 << (TIMELINE_POLYPHASE_COEF_BITS - 1));
+    uint32_t idx = phase->idx;
+    uint32_t accum = phase->accum;
+    for (uint32_t i = 0; i < count; ++i) {
+        const int16_t *coef = coeffs_PolyphaseFilterBank(bank, phase, accum);
+        const int16_t *row = &src[(size_t)idx * ch];
+        int16_t *out = &dst[(size_t)i * ch];
+        for (uint32_t c = 0; c < ch; c += 8) {
+            uint32_t g = (c + 8 <= ch) ? c : ch - 8;
+            const int16_t *p = &row[g];
+            int32x4_t acc_lo = vdupq_n_s32(0);
+            int32x4_t acc_hi = vdupq_n_s32(0);
+            for (uint32_t j = 0; j < taps; ++j, p += ch) {
+                int16x8_t x = vld1q_s16(p);
+                acc_lo = vmlal_n_s16(acc_lo, vget_low_s16(x), coef[j]);
+                acc_hi = vmlal_n_s16(acc_hi, vget_high_s16(x), coef[j]);
+            }
+            acc_lo = vshrq_n_s32(vaddq_s32(acc_lo, round), TIMELINE_POLYPHASE_COEF_BITS);
+            acc_hi = vshrq_n_s32(vaddq_s32(acc_hi, round), TIMELINE_POLYPHASE_COEF_BITS);
+            vst1q_s16(&out[g], vcombine_s16(vqmovn_s32(acc_lo), vqmovn_s32(acc_hi)));
+        }
+        step_SampleRatePhase(phase, &idx, &accum);
+    }
+    phase->idx = idx;
+    phase->accum = accum;
+}
+
+// CIC pre-decimation (see cic_predecimate_s16x8_c), one 8-channel group at a time, integrators and combs in registers
+void cic_predecimate_s16x8_neon(const int16_t *src, uint32_t nr_of_channels, uint32_t nr_of_samples, uint32_t ratio_shift, int16_t *dst, uint32_t count) {
+    const uint32_t ch = nr_of_channels;
+    if (ch < 8) {
+        cic_predecimate_s16x8_c(src, nr_of_channels, nr_of_samples, ratio_shift, dst, count);
+        return;
+    }
+    const uint32_t ratio = 1u << ratio_shift;
+    const uint32_t delay = TIMELINE_POLYPHASE_CIC_STAGES * (ratio - 1) / 2;
+    // rounding shift left by a negative count: (y + 2^(shift - 1)) >> shift
+    const int32x4_t count_shift = vdupq_n_s32(-(int32_t)(TIMELINE_POLYPHASE_CIC_STAGES * ratio_shift));
+    for (uint32_t c = 0; c < ch; c += 8) {
+        const uint32_t g = (c + 8 <= ch) ? c : ch - 8;
+        const int16x8_t first16 = vld1q_s16(&src[g]);
+        const int32x4_t first_lo = vmovl_s16(vget_low_s16(first16));
+        const int32x4_t first_hi = vmovl_s16(vget_high_s16(first16));
+        int32x4_t integ_lo[TIMELINE_POLYPHASE_CIC_STAGES], integ_hi[TIMELINE_POLYPHASE_CIC_STAGES];
+        int32x4_t comb_lo[TIMELINE_POLYPHASE_CIC_STAGES], comb_hi[TIMELINE_POLYPHASE_CIC_STAGES];
+        for (uint32_t s = 0; s < TIMELINE_POLYPHASE_CIC_STAGES; ++s) {
+            integ_lo[s] = integ_hi[s] = comb_lo[s] = comb_hi[s] = vdupq_n_s32(0);
+        }
+        uint32_t v = 0;
+        for (int64_t j = -(int64_t)(delay / ratio); j < (int64_t)count; ++j) {
+            const uint64_t last = (uint64_t)(j * ratio + delay);
+            for (; v <= last; ++v) {
+                int16x8_t x = vld1q_s16(&src[(size_t)((v < nr_of_samples) ? v : nr_of_samples - 1) * ch + g]);
+                integ_lo[0] = vaddq_s32(integ_lo[0], vsubq_s32(vmovl_s16(vget_low_s16(x)), first_lo));
+                integ_hi[0] = vaddq_s32(integ_hi[0], vsubq_s32(vmovl_s16(vget_high_s16(x)), first_hi));
+                for (uint32_t s = 1; s < TIMELINE_POLYPHASE_CIC_STAGES; ++s) {
+                    integ_lo[s] = vaddq_s32(integ_lo[s], integ_lo[s - 1]);
+                    integ_hi[s] = vaddq_s32(integ_hi[s], integ_hi[s - 1]);
+                }
+            }
+            int32x4_t y_lo = integ_lo[TIMELINE_POLYPHASE_CIC_STAGES - 1];
+            int32x4_t y_hi = integ_hi[TIMELINE_POLYPHASE_CIC_STAGES - 1];
+            for (uint32_t s = 0; s < TIMELINE_POLYPHASE_CIC_STAGES; ++s) {
+                int32x4_t d_lo = vsubq_s32(y_lo, comb_lo[s]);
+                int32x4_t d_hi = vsubq_s32(y_hi, comb_hi[s]);
+                comb_lo[s] = y_lo;
+                comb_hi[s] = y_hi;
+                y_lo = d_lo;
+                y_hi = d_hi;
+            }
+            if (j >= 0) {
+                y_lo = vaddq_s32(first_lo, vrshlq_s32(y_lo, count_shift));
+                y_hi = vaddq_s32(first_hi, vrshlq_s32(y_hi, count_shift));
+                vst1q_s16(&dst[(size_t)j * ch + g], vcombine_s16(vqmovn_s32(y_lo), vqmovn_s32(y_hi)));
+            }
+        }
+    }
+}
+
+/*
+    Block codec decoding (see TimelineCodecGroupHeader): the 8 lanes are two uint32x4 halves, the slot shifts are
+    vshlq_u32 by a signed count (negative: right). The encoder is the C kernel, it is not on the read path.
+ */
+static uint32_t codec_decode_neon(const uint8_t *src, uint32_t nr_lanes, uint32_t count, uint8_t *dst, uint32_t dst_stride, int is_s24) {
+    TimelineCodecGroupHeader h;
+    memcpy(&h, src, sizeof(h));
+    const uint32_t *words = (const uint32_t*)(src + sizeof(h));
+    const uint32_t width = h.width;
+    const uint32x4_t mask = vdupq_n_u32((width >= 32) ? UINT32_MAX : ((1u << width) - 1));
+    const uint32x4_t one = vdupq_n_u32(1);
+    const uint32x4_t base_lo = vld1q_u32(h.base), base_hi = vld1q_u32(h.base + 4);
+    int32x4_t acc_lo = vld1q_s32(h.first), acc_hi = vld1q_s32(h.first + 4);
+    uint32x4_t cur_lo = vdupq_n_u32(0), cur_hi = vdupq_n_u32(0);
+    if (width > 0) {
+        cur_lo = vld1q_u32(words);
+        cur_hi = vld1q_u32(words + 4);
+    }
+    uint32_t w = 0, shift = 0;
+    for (uint32_t j = 0; j < count; ++j) {
+        uint8_t *row = &dst[(size_t)j * dst_stride];
+        if (!is_s24 && nr_lanes == 8) {
+            vst1q_s16((int16_t*)row, vcombine_s16(vmovn_s32(acc_lo), vmovn_s32(acc_hi)));
+        } else {
+            int32_t lanes[8];
+            vst1q_s32(lanes, acc_lo);
+            vst1q_s32(lanes + 4, acc_hi);
+            for (uint32_t l = 0; l < nr_lanes; ++l) {
+                if (is_s24) {
+                    row[l * 3 + 0] = (uint8_t)lanes[l];
+                    row[l * 3 + 1] = (uint8_t)(lanes[l] >> 8);
+                    row[l * 3 + 2] = (uint8_t)(lanes[l] >> 16);
+                } else {
+                    int16_t v = (int16_t)lanes[l];
+                    memcpy(&row[l * 2], &v, sizeof(v));
+                }
+            }
+        }
+        const int32x4_t right = vdupq_n_s32(-(int32_t)shift);
+        uint32x4_t v_lo = vshlq_u32(cur_lo, right);
+        uint32x4_t v_hi = vshlq_u32(cur_hi, right);
+        shift += width;
+        if (shift >= 32 && j + 1 < count) {
+            shift -= 32;
+            ++w;
+            cur_lo = vld1q_u32(&words[w * 8]);
+            cur_hi = vld1q_u32(&words[w * 8 + 4]);
+            if (shift) {
+                const int32x4_t left = vdupq_n_s32((int32_t)(width - shift));
+                v_lo = vorrq_u32(v_lo, vshlq_u32(cur_lo, left));
+                v_hi = vorrq_u32(v_hi, vshlq_u32(cur_hi, left));
+            }
+        }
+        uint32x4_t z_lo = vaddq_u32(vandq_u32(v_lo, mask), base_lo);
+        uint32x4_t z_hi = vaddq_u32(vandq_u32(v_hi, mask), base_hi);
+        acc_lo = vaddq_s32(acc_lo, veorq_s32(vreinterpretq_s32_u32(vshrq_n_u32(z_lo, 1)), vnegq_s32(vreinterpretq_s32_u32(vandq_u32(z_lo, one)))));
+        acc_hi = vaddq_s32(acc_hi, veorq_s32(vreinterpretq_s32_u32(vshrq_n_u32(z_hi, 1)), vnegq_s32(vreinterpretq_s32_u32(vandq_u32(z_hi, one)))));
+    }
+    return TIMELINE_CODEC_GROUP_BYTES(width);
+}
+
+static uint32_t codec_decode_s16x8_neon(const uint8_t *src, uint32_t nr_lanes, uint32_t count, uint8_t *dst, uint32_t dst_stride) {
+    return codec_decode_neon(src, nr_lanes, count, dst, dst_stride, 0);
+}
+
+static uint32_t codec_decode_s24x8_neon(const uint8_t *src, uint32_t nr_lanes, uint32_t count, uint8_t *dst, uint32_t dst_stride) {
+    return codec_decode_neon(src, nr_lanes, count, dst, dst_stride, 1);
+}
+
+/*
+    Planar transposes of 16-bit samples: 8 samples x 8 channels per block, vtrnq on 16-bit then on 32-bit pairs,
+    the 64-bit halves are recombined. The same block serves both directions. 24-bit samples use the C kernels.
+ */
+static inline void transpose8x8_s16_neon(int16x8_t r[8]) {
+    int16x8x2_t t0 = vtrnq_s16(r[0], r[1]);
+    int16x8x2_t t1 = vtrnq_s16(r[2], r[3]);
+    int16x8x2_t t2 = vtrnq_s16(r[4], r[5]);
+    int16x8x2_t t3 = vtrnq_s16(r[6], r[7]);
+    int32x4x2_t u0 = vtrnq_s32(vreinterpretq_s32_s16(t0.val[0]), vreinterpretq_s32_s16(t1.val[0])); // channels 0 4 | 2 6 of rows 0..3
+    int32x4x2_t u1 = vtrnq_s32(vreinterpretq_s32_s16(t0.val[1]), vreinterpretq_s32_s16(t1.val[1])); // channels 1 5 | 3 7
+    int32x4x2_t u2 = vtrnq_s32(vreinterpretq_s32_s16(t2.val[0]), vreinterpretq_s32_s16(t3.val[0])); // rows 4..7
+    int32x4x2_t u3 = vtrnq_s32(vreinterpretq_s32_s16(t2.val[1]), vreinterpretq_s32_s16(t3.val[1]));
+    r[0] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(u0.val[0]), vget_low_s32(u2.val[0])));
+    r[1] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(u1.val[0]), vget_low_s32(u3.val[0])));
+    r[2] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(u0.val[1]), vget_low_s32(u2.val[1])));
+    r[3] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(u1.val[1]), vget_low_s32(u3.val[1])));
+    r[4] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(u0.val[0]), vget_high_s32(u2.val[0])));
+    r[5] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(u1.val[0]), vget_high_s32(u3.val[0])));
+    r[6] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(u0.val[1]), vget_high_s32(u2.val[1])));
+    r[7] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(u1.val[1]), vget_high_s32(u3.val[1])));
+}
+
+static void transpose_blocks_s16_neon(const uint8_t *src, uint32_t src_stride, uint32_t src_step,
+    uint8_t *dst, uint32_t dst_stride, uint32_t dst_step, uint32_t nr_blocks) {
+    for (uint32_t b = 0; b < nr_blocks; ++b) {
+        const uint8_t *s = &src[(size_t)b * src_step];
+        uint8_t *d = &dst[(size_t)b * dst_step];
+        int16x8_t r[8];
+        for (int k = 0; k < 8; ++k) r[k] = vreinterpretq_s16_u8(vld1q_u8(&s[(size_t)k * src_stride]));
+        transpose8x8_s16_neon(r);
+        for (int k = 0; k < 8; ++k) vst1q_u8(&d[(size_t)k * dst_stride], vreinterpretq_u8_s16(r[k]));
+    }
+}
+
+static void transpose_to_planar_s16x8_neon(const uint8_t *src, uint32_t src_stride, uint8_t *dst, uint32_t dst_stride, uint32_t nr_lanes, uint32_t count) {
+    if (nr_lanes < 8) {
+        transpose_to_planar_s16x8_c(src, src_stride, dst, dst_stride, nr_lanes, count);
+        return;
+    }
+    const uint32_t blocks = count / 8;
+    transpose_blocks_s16_neon(src, src_stride, 8 * src_stride, dst, dst_stride, 16, blocks);
+    transpose_to_planar_s16x8_c(&src[(size_t)blocks * 8 * src_stride], src_stride, &dst[(size_t)blocks * 16], dst_stride, 8, count % 8);
+}
+
+static void transpose_from_planar_s16x8_neon(const uint8_t *src, uint32_t src_stride, uint8_t *dst, uint32_t dst_stride, uint32_t nr_lanes, uint32_t count) {
+    if (nr_lanes < 8) {
+        transpose_from_planar_s16x8_c(src, src_stride, dst, dst_stride, nr_lanes, count);
+        return;
+    }
+    const uint32_t blocks = count / 8;
+    transpose_blocks_s16_neon(src, src_stride, 16, dst, dst_stride, 8 * dst_stride, blocks);
+    transpose_from_planar_s16x8_c(&src[(size_t)blocks * 16], src_stride, &dst[(size_t)blocks * 8 * dst_stride], dst_stride, 8, count % 8);
+}
+
+// ---- NEON Backend Global Instance for the virtual funtion table ----
+const TimelineBackendFunctions gTimelineBackendFunctionsNEON = {
+    .name = "Neon SIMD Backend",
+    .convert_sample_rate_s16x8 = convert_sample_rate_SIMD_s16x8_bresenham_neon,
+    .aggregate_minmax_s8 = aggregate_minmax_s8_neon,
+    .aggregate_minmax_s16x8 = aggregate_minmax_SIMD_s16x8_neon,
+    .aggregate_minmax_s24x8 = aggregate_minmax_SIMD_s24x8_neon,
+    .decode_be24_s16x8 = decode_be24_s16x8_neon,
+    .decode_be24_s24x8 = decode_be24_s24x8_neon,
+    .resample_span_s16x8 = resample_span_s16x8_neon,
+    .polyphase_span_s16x8 = polyphase_span_s16x8_neon,
+    .cic_predecimate_s16x8 = cic_predecimate_s16x8_neon,
+    .resample_minmax_s16x8 = resample_minmax_s16x8_neon,
+    .aggregate_stats_s8 = aggregate_stats_s8_neon,
+    .aggregate_stats_s16x8 = aggregate_stats_s16x8_neon,
+    .aggregate_stats_s24x8 = aggregate_stats_s24x8_neon,
+    .codec_encode_s16x8 = codec_encode_s16x8_c,
+    .codec_encode_s24x8 = codec_encode_s24x8_c,
+    .codec_decode_s16x8 = codec_decode_s16x8_neon,
+    .codec_decode_s24x8 = codec_decode_s24x8_neon,
+    .transpose_to_planar_s16x8 = transpose_to_planar_s16x8_neon,
+    .transpose_to_planar_s24x8 = transpose_to_planar_s24x8_c,
+    .transpose_from_planar_s16x8 = transpose_from_planar_s16x8_neon,
+    .transpose_from_planar_s24x8 = transpose_from_planar_s24x8_c,
+};
+#endif
+
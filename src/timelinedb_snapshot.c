@@ -0,0 +1,201 @@
+/*
+    File: timelinedb_snapshot.c
+    This file implements the copy-on-write shared buffer: one appending writer, snapshots for concurrent readers.
+    Author: Barna Farago - MYND-Ideal kft.
+    Date: 2025-07-01
+    License: Modified MIT License. You can use it for learn, but I can sell it as closed source with some improvements...
+*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include "timelinedb.h"
+
+/*
+    SNAPSHOTS
+    A version is one allocation of 'capacity' samples. Its first 'committed' samples are immutable: the writer only
+    writes the slots after them, then publishes the new count with a release store, so a reader that loads the count
+    with acquire sees every sample below it. When a version is full, the writer copies the kept samples into a new
+    version (twice as large, or 2 x max_samples with a retention limit) and swaps the current pointer: the appends go
+    to the new version, snapshots of the old one stay valid.
+
+    Reclamation: a version has a reference count, 1 for being current (or retired) plus 1 for every snapshot.
+    The count can only be incremented safely while the version can not be freed, between loading the current pointer
+    and the increment a reader pins the global epoch in a reader slot. A replaced version is retired with the epoch
+    after the swap, its 'current' reference is dropped by the writer once no slot holds an older epoch: every reader
+    pinned later has loaded the new pointer. Whoever drops the last reference (writer or reader) frees the version.
+    All atomics are the GCC / clang __atomic builtins (sequentially consistent where the epoch protocol needs it).
+*/
+struct TimelineSnapshotVersion {
+    uint32_t refcount;
+    uint32_t committed;         // immutable samples (release store by the writer)
+    uint32_t capacity;
+    uint64_t first_sample;      // absolute index of the first sample of the version
+    uint64_t retire_epoch;
+    TimelineSnapshotVersion *next_retired;
+    unsigned char *valueBuffer;
+};
+
+static TimelineSnapshotVersion *alloc_SnapshotVersion(const TimelineSharedBuf *shared, uint32_t capacity, uint64_t first_sample) {
+    TimelineSnapshotVersion *v = (TimelineSnapshotVersion*)calloc(1, sizeof(TimelineSnapshotVersion));
+    if (!v) {
+        fprintf(stderr, "ERROR: Memory allocation failed for TimelineSnapshotVersion\n");
+        return NULL;
+    }
+    size_t size = (size_t)capacity * shared->layout.bytes_per_sample;
+    v->valueBuffer = (unsigned char*)aligned_alloc(64, (size + 63) & ~(size_t)63);
+    if (!v->valueBuffer) {
+        fprintf(stderr, "ERROR: Memory allocation failed for %u snapshot samples\n", capacity);
+        free(v);
+        return NULL;
+    }
+    v->refcount = 1;
+    v->capacity = capacity;
+    v->first_sample = first_sample;
+    return v;
+}
+
+static void unref_SnapshotVersion(TimelineSnapshotVersion *v) {
+    if (__atomic_sub_fetch(&v->refcount, 1, __ATOMIC_ACQ_REL) == 0) {
+        free(v->valueBuffer);
+        free(v);
+    }
+}
+
+// Writer: drops the 'current' reference of the retired versions no reader can be picking up any more
+static void reclaim_SnapshotVersions(TimelineSharedBuf *shared) {
+    uint64_t oldest = UINT64_MAX;
+    for (uint32_t r = 0; r < TIMELINE_SNAPSHOT_READERS; ++r) {
+        uint64_t e = __atomic_load_n(&shared->reader_epochs[r], __ATOMIC_SEQ_CST);
+        if (e && e < oldest) oldest = e;
+    }
+    TimelineSnapshotVersion **link = &shared->retired;
+    while (*link) {
+        TimelineSnapshotVersion *v = *link;
+        if (v->retire_epoch <= oldest) {
+            *link = v->next_retired;
+            unref_SnapshotVersion(v);
+        } else {
+            link = &v->next_retired;
+        }
+    }
+}
+
+int init_TimelineSharedBuf(TimelineSharedBuf *shared, uint32_t initial_capacity, uint32_t max_samples, uint8_t nr_of_channels, uint8_t bitwidth, uint16_t bytes_per_sample, RawTimelineValueEnum value_type) {
+    if (!shared || nr_of_channels == 0 || bytes_per_sample == 0) {
+        return -1;
+    }
+    memset(shared, 0, sizeof(*shared));
+    init_RawTimelineValuesBuf(&shared->layout);
+    shared->layout.nr_of_channels = nr_of_channels;
+    shared->layout.bitwidth = bitwidth;
+    shared->layout.bytes_per_sample = bytes_per_sample;
+    shared->layout.value_type = value_type;
+    shared->max_samples = max_samples;
+    // with a retention limit every version holds 2 x max_samples: max_samples kept, max_samples appended
+    shared->initial_capacity = max_samples ? 2 * max_samples : ((initial_capacity > 0) ? initial_capacity : 4096);
+    shared->epoch = 1;
+    shared->current = alloc_SnapshotVersion(shared, shared->initial_capacity, 0);
+    return shared->current ? 0 : -1;
+}
+
+void free_TimelineSharedBuf(TimelineSharedBuf *shared) {
+    if (!shared) return;
+    while (shared->retired) {
+        TimelineSnapshotVersion *v = shared->retired;
+        shared->retired = v->next_retired;
+        unref_SnapshotVersion(v);
+    }
+    if (shared->current) {
+        unref_SnapshotVersion(shared->current);
+        shared->current = NULL;
+    }
+}
+
+// Writer: replaces the full current version by one holding the kept samples and room for more
+static int grow_TimelineSharedBuf(TimelineSharedBuf *shared) {
+    TimelineSnapshotVersion *old = shared->current;
+    const uint32_t bps = shared->layout.bytes_per_sample;
+    uint32_t keep = old->committed;
+    uint32_t capacity = 2 * old->capacity;
+    if (shared->max_samples) {
+        capacity = shared->initial_capacity;
+        if (keep > shared->max_samples) keep = shared->max_samples;
+    }
+    TimelineSnapshotVersion *v = alloc_SnapshotVersion(shared, capacity, old->first_sample + old->committed - keep);
+    if (!v) {
+        return -1;
+    }
+    memcpy(v->valueBuffer, &old->valueBuffer[(size_t)(old->committed - keep) * bps], (size_t)keep * bps);
+    v->committed = keep;
+    __atomic_store_n(&shared->current, v, __ATOMIC_SEQ_CST);
+    // readers pinned from now on see the new version, the old one waits for the ones pinned before
+    old->retire_epoch = __atomic_add_fetch(&shared->epoch, 1, __ATOMIC_SEQ_CST);
+    old->next_retired = shared->retired;
+    shared->retired = old;
+    reclaim_SnapshotVersions(shared);
+    return 0;
+}
+
+int append_TimelineSharedBuf(TimelineSharedBuf *shared, const void *samples, uint32_t count) {
+    if (!shared || !shared->current || (!samples && count > 0)) {
+        return -1;
+    }
+    const uint32_t bps = shared->layout.bytes_per_sample;
+    const unsigned char *src = (const unsigned char*)samples;
+    while (count > 0) {
+        TimelineSnapshotVersion *v = shared->current;
+        if (v->committed == v->capacity && grow_TimelineSharedBuf(shared) != 0) {
+            return -1;
+        }
+        v = shared->current;
+        uint32_t n = v->capacity - v->committed;
+        if (n > count) n = count;
+        // slots after 'committed' are not visible to any reader yet
+        memcpy(&v->valueBuffer[(size_t)v->committed * bps], src, (size_t)n * bps);
+        __atomic_store_n(&v->committed, v->committed + n, __ATOMIC_RELEASE);
+        src += (size_t)n * bps;
+        count -= n;
+    }
+    if (shared->retired) {
+        reclaim_SnapshotVersions(shared); // readers that were pinned at the last replacement may be gone by now
+    }
+    return 0;
+}
+
+int acquire_TimelineSnapshot(TimelineSharedBuf *shared, TimelineSnapshot *snap) {
+    if (!shared || !snap) {
+        return -1;
+    }
+    // pin the current epoch in a free reader slot (the slot is held only for the few instructions below)
+    uint32_t slot = 0;
+    for (;;) {
+        uint64_t expected = 0;
+        uint64_t e = __atomic_load_n(&shared->epoch, __ATOMIC_SEQ_CST);
+        if (__atomic_compare_exchange_n(&shared->reader_epochs[slot], &expected, e, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+            break;
+        }
+        slot = (slot + 1) % TIMELINE_SNAPSHOT_READERS;
+    }
+    TimelineSnapshotVersion *v = __atomic_load_n(&shared->current, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&v->refcount, 1, __ATOMIC_ACQ_REL);
+    __atomic_store_n(&shared->reader_epochs[slot], 0, __ATOMIC_RELEASE);
+
+    uint32_t committed = __atomic_load_n(&v->committed, __ATOMIC_ACQUIRE);
+    snap->buf = shared->layout;
+    snap->buf.valueBuffer = v->valueBuffer;
+    snap->buf.nr_of_samples = committed;
+    snap->buf.buffer_size = committed * shared->layout.bytes_per_sample;
+    snap->first_sample = v->first_sample;
+    snap->version = v;
+    return 0;
+}
+
+void release_TimelineSnapshot(TimelineSnapshot *snap) {
+    if (!snap || !snap->version) return;
+    unref_SnapshotVersion(snap->version);
+    snap->version = NULL;
+    snap->buf.valueBuffer = NULL;
+    snap->buf.nr_of_samples = 0;
+}
@@ -79,18 +79,10 @@ void generate_sine_wave(RawTimelineValuesBuf *buf, uint32_t num_samples, uint8_t
     }
     buf->time_exponent = -exponent;
     buf->time_step = sample_rate_hz / (uint32_t)pow(10, exponent);
-    // Set buffer_size as per new signature
-    buf->buffer_size = num_samples * num_channels * buf->bytes_per_sample;
 
     if (buf->value_type == TR_SIMD_sint16x8) {
-        buf->bitwidth = 16;
-        buf->bytes_per_sample = sizeof(int16_t) * 8;
-        buf->buffer_size = num_samples * buf->bytes_per_sample;
-        buf->valueBuffer = aligned_alloc(16, buf->buffer_size);
-        if (!buf->valueBuffer) {
-            fprintf(stderr, "Memory allocation failed\n");
-            exit(1);
-        }
+        // an already allocated buffer is reused (alloc_RawTimelineValuesBuf keeps a large enough allocation)
+        alloc_RawTimelineValuesBuf(buf, num_samples, 8, 16, 16, TR_SIMD_sint16x8);
 
         int16_t *data = (int16_t *)buf->valueBuffer;
         for (uint32_t i = 0; i < num_samples; i++) {
@@ -103,14 +95,7 @@ void generate_sine_wave(RawTimelineValuesBuf *buf, uint32_t num_samples, uint8_t
         }
     }
     else if (buf->value_type == TR_analog_sint8) {
-        buf->bitwidth = 8;
-        buf->bytes_per_sample = 1;
-        buf->buffer_size = num_samples * num_channels;
-        buf->valueBuffer = malloc(buf->buffer_size);
-        if (!buf->valueBuffer) {
-            fprintf(stderr, "ERROR: Memory allocation failed\n");
-            exit(1);
-        }
+        alloc_RawTimelineValuesBuf(buf, num_samples, num_channels, 8, 1, TR_analog_sint8);
 
         uint8_t *data = (uint8_t *)buf->valueBuffer;
         for (uint32_t i = 0; i < num_samples; i++) {
@@ -124,7 +109,7 @@ void generate_sine_wave(RawTimelineValuesBuf *buf, uint32_t num_samples, uint8_t
     }
     else {
         fprintf(stderr, "Unsupported value type for sine wave generation\n");
-        free(buf->valueBuffer);
+        free_RawTimelineValuesBuf(buf);
         exit(1);
     }
 }
@@ -0,0 +1,184 @@
+/*
+    File: timelinedb_workers.c
+    This file implements the library-owned worker pool used by the parallel aggregation and conversion calls.
+    Author: Barna Farago - MYND-Ideal kft.
+    Date: 2025-07-01
+    License: Modified MIT License. You can use it for learn, but I can sell it as closed source with some improvements...
+*/
+#define _POSIX_C_SOURCE 200809L
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "timelinedb.h"
+#include "timelinedb_simd.h"
+
+/*
+    WORKER POOL
+    The threads are started once (init_TimelineWorkers, or lazily by the first parallel call) and sleep on a condition
+    variable between calls, a frame costs two wakeups instead of thread creation. run_TimelineWorkers publishes a batch
+    of independent tasks, the workers and the calling thread take the next task index under the lock until the batch
+    is done. Tasks write disjoint outputs, so the result does not depend on which thread ran which task.
+    Batches from different caller threads are serialized.
+*/
+typedef struct {
+    pthread_t *threads;
+    uint32_t nr_of_threads;     // worker threads, the caller is one more
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    fn_timeline_task task;
+    void *ctx;
+    uint32_t nr_of_tasks;
+    uint32_t next_task;
+    uint32_t finished_tasks;
+    uint32_t generation;        // incremented by every batch, a worker wakes up for a generation it has not seen
+    int stop;
+} TimelineWorkers;
+
+static TimelineWorkers g_TimelineWorkers = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+    .done = PTHREAD_COND_INITIALIZER,
+};
+static pthread_mutex_t g_TimelineWorkersSubmit = PTHREAD_MUTEX_INITIALIZER;
+static int g_TimelineWorkersStarted = 0;
+
+// Runs tasks of the current batch until none is left, called with the lock held
+static void drain_TimelineWorkers(TimelineWorkers *w) {
+    while (w->next_task < w->nr_of_tasks) {
+        uint32_t t = w->next_task++;
+        fn_timeline_task task = w->task;
+        void *ctx = w->ctx;
+        pthread_mutex_unlock(&w->lock);
+        task(ctx, t);
+        pthread_mutex_lock(&w->lock);
+        if (++w->finished_tasks == w->nr_of_tasks) {
+            pthread_cond_signal(&w->done);
+        }
+    }
+}
+
+static void *worker_TimelineWorkers(void *arg) {
+    TimelineWorkers *w = (TimelineWorkers*)arg;
+    pthread_mutex_lock(&w->lock);
+    uint32_t seen = w->generation;
+    while (!w->stop) {
+        if (seen == w->generation) {
+            pthread_cond_wait(&w->wake, &w->lock);
+            continue;
+        }
+        seen = w->generation;
+        drain_TimelineWorkers(w);
+    }
+    pthread_mutex_unlock(&w->lock);
+    return NULL;
+}
+
+static void stop_TimelineWorkers(void) {
+    TimelineWorkers *w = &g_TimelineWorkers;
+    if (!g_TimelineWorkersStarted) return;
+    pthread_mutex_lock(&w->lock);
+    w->stop = 1;
+    pthread_cond_broadcast(&w->wake);
+    pthread_mutex_unlock(&w->lock);
+    for (uint32_t t = 0; t < w->nr_of_threads; ++t) {
+        pthread_join(w->threads[t], NULL);
+    }
+    free(w->threads);
+    w->threads = NULL;
+    w->nr_of_threads = 0;
+    w->stop = 0;
+    g_TimelineWorkersStarted = 0;
+}
+
+static int start_TimelineWorkers(uint32_t nr_of_threads) {
+    TimelineWorkers *w = &g_TimelineWorkers;
+    if (nr_of_threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        nr_of_threads = (cpus > 1) ? (uint32_t)cpus : 1;
+    }
+    if (nr_of_threads > TIMELINE_WORKERS_MAX) nr_of_threads = TIMELINE_WORKERS_MAX;
+    g_TimelineWorkersStarted = 1;
+    if (nr_of_threads == 1) {
+        return 0; // the caller runs every task
+    }
+    w->threads = (pthread_t*)malloc((nr_of_threads - 1) * sizeof(pthread_t));
+    if (!w->threads) {
+        fprintf(stderr, "ERROR: Memory allocation failed for %u worker threads\n", nr_of_threads - 1);
+        return -1;
+    }
+    for (uint32_t t = 0; t + 1 < nr_of_threads; ++t) {
+        if (pthread_create(&w->threads[t], NULL, worker_TimelineWorkers, w) != 0) {
+            fprintf(stderr, "Failed to start worker thread %u, running with %u\n", t, t + 1);
+            break;
+        }
+        w->nr_of_threads = t + 1;
+    }
+    return 0;
+}
+
+/*
+    Starts the pool with nr_of_threads threads in total, the calling thread included (0: one per online CPU,
+    1: no worker, every task runs on the caller). An already running pool is stopped first.
+*/
+int init_TimelineWorkers(uint32_t nr_of_threads) {
+    pthread_mutex_lock(&g_TimelineWorkersSubmit);
+    stop_TimelineWorkers();
+    int rc = start_TimelineWorkers(nr_of_threads);
+    pthread_mutex_unlock(&g_TimelineWorkersSubmit);
+    return rc;
+}
+
+void free_TimelineWorkers(void) {
+    pthread_mutex_lock(&g_TimelineWorkersSubmit);
+    stop_TimelineWorkers();
+    pthread_mutex_unlock(&g_TimelineWorkersSubmit);
+}
+
+uint32_t getTimelineWorkersCount(void) {
+    pthread_mutex_lock(&g_TimelineWorkersSubmit);
+    if (!g_TimelineWorkersStarted) {
+        start_TimelineWorkers(0);
+    }
+    uint32_t count = g_TimelineWorkers.nr_of_threads + 1;
+    pthread_mutex_unlock(&g_TimelineWorkersSubmit);
+    return count;
+}
+
+/*
+    Runs task(ctx, 0 .. nr_of_tasks - 1) on the pool and returns when all of them are done.
+    The order of the tasks is not defined, each task must write its own part of the output.
+*/
+void run_TimelineWorkers(fn_timeline_task task, void *ctx, uint32_t nr_of_tasks) {
+    TimelineWorkers *w = &g_TimelineWorkers;
+    pthread_mutex_lock(&g_TimelineWorkersSubmit);
+    if (!g_TimelineWorkersStarted) {
+        start_TimelineWorkers(0);
+    }
+    if (w->nr_of_threads == 0 || nr_of_tasks <= 1) {
+        pthread_mutex_unlock(&g_TimelineWorkersSubmit);
+        for (uint32_t t = 0; t < nr_of_tasks; ++t) {
+            task(ctx, t);
+        }
+        return;
+    }
+    pthread_mutex_lock(&w->lock);
+    w->task = task;
+    w->ctx = ctx;
+    w->nr_of_tasks = nr_of_tasks;
+    w->next_task = 0;
+    w->finished_tasks = 0;
+    w->generation++;
+    pthread_cond_broadcast(&w->wake);
+    drain_TimelineWorkers(w);
+    while (w->finished_tasks < w->nr_of_tasks) {
+        pthread_cond_wait(&w->done, &w->lock);
+    }
+    w->nr_of_tasks = 0;
+    pthread_mutex_unlock(&w->lock);
+    pthread_mutex_unlock(&g_TimelineWorkersSubmit);
+}